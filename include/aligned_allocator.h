@@ -0,0 +1,75 @@
+// -- aligned_allocator.h 按指定边界对齐的分配器
+// aligned_allocator<T, Align> 分配的每块内存起始地址都是 Align 的倍数，
+// 用于 SIMD 对齐加载 (如 AVX-512 需要 64 字节对齐) 或让缓冲区独占缓存行
+#ifndef ALIGNED_ALLOCATOR_H_
+#define ALIGNED_ALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+#include "allocator.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+template <typename T, size_t Align = 64>
+class aligned_allocator
+{
+    static_assert((Align & (Align - 1)) == 0, "aligned_allocator: Align must be a power of two");
+    static_assert(Align >= alignof(T), "aligned_allocator: Align must not be less than alignof(T)");
+
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    typedef m_true_type propagate_on_container_move_assignment;
+    typedef m_true_type is_always_equal;
+
+    static constexpr size_t alignment = Align;
+
+    // rebind 后保持相同的对齐，但不低于新类型自身的对齐
+    template <typename U>
+    struct rebind
+    {
+        typedef aligned_allocator<U, (Align > alignof(U) ? Align : alignof(U))> other;
+    };
+
+    aligned_allocator() noexcept = default;
+    template <typename U, size_t A>
+    aligned_allocator(const aligned_allocator<U, A>&) noexcept {}
+
+    static T* allocate(size_type n)
+    {
+        if(n == 0) return nullptr;
+        THROW_LENGTH_ERROR_IF(n > static_cast<size_type>(-1) / sizeof(T),
+                              "aligned_allocator<T>'s allocate size too big");
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+
+    static void deallocate(T* ptr, size_type) noexcept
+    {
+        if(ptr == nullptr) return;
+        ::operator delete(ptr, std::align_val_t(Align));
+    }
+};
+
+template <typename T1, size_t A1, typename T2, size_t A2>
+bool operator== (const aligned_allocator<T1, A1>&, const aligned_allocator<T2, A2>&) noexcept
+{
+    return A1 == A2;
+}
+
+template <typename T1, size_t A1, typename T2, size_t A2>
+bool operator!= (const aligned_allocator<T1, A1>&, const aligned_allocator<T2, A2>&) noexcept
+{
+    return A1 != A2;
+}
+
+} // end of namespace mystl
+#endif // !ALIGNED_ALLOCATOR_H_
@@ -1,12 +1,55 @@
 // -- allocator.h 空间分配器实现 tested 
 #ifndef ALLOCATOR_HPP_  
+#define ALLOCATOR_HPP_
 #include <cstddef>
+#include <cstring>
+#include <new>
 #include <climits> 
+#include <type_traits>
 #include "construct.h"
+#include "type_traits.h"
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+// operator new 是否直接转发给 malloc (libstdc++ 的默认实现如此)
+// 替换了全局 operator new 时应定义为 0，allocate_at_least 不再查询 malloc_usable_size
+#ifndef MYSTL_NEW_USES_MALLOC
+#if defined(__GLIBC__)
+#define MYSTL_NEW_USES_MALLOC 1
+#else
+#define MYSTL_NEW_USES_MALLOC 0
+#endif
+#endif
 
 namespace mystl
 {
 
+// allocate_at_least 的结果: 得到的空间至少能容纳 count 个元素
+template <typename Pointer, typename SizeType = size_t>
+struct allocation_result
+{
+    Pointer     ptr;
+    SizeType    count;
+};
+
+// 按 alignment 分配原始内存：超过 operator new 默认对齐时使用带 std::align_val_t 的版本
+inline void* aligned_new(size_t bytes, size_t alignment)
+{
+    if(alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        return ::operator new(bytes, std::align_val_t(alignment));
+    return ::operator new(bytes);
+}
+
+inline void aligned_delete(void* ptr, size_t alignment) noexcept
+{
+    if(alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        ::operator delete(ptr, std::align_val_t(alignment));
+    else
+        ::operator delete(ptr);
+}
+
 template<typename T> 
 class allocator
 {
@@ -20,9 +63,26 @@ public:
     typedef const T&    const_reference; 
     typedef size_t      size_type; 
     typedef ptrdiff_t   difference_type; 
-    
+
+    // 无状态分配器：任意两个实例都相等，移动赋值时随容器一起转移
+    typedef m_true_type propagate_on_container_move_assignment;
+    typedef m_true_type is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef allocator<U> other;
+    };
+
+    // ctor
+    allocator() noexcept = default;
+    template <typename U>
+    allocator(const allocator<U>&) noexcept {}
+
     static pointer allocate();
     static pointer allocate(size_type n); 
+    // 按 malloc 实际分配的大小 (size class) 报告可用的元素个数
+    static allocation_result<pointer, size_type> allocate_at_least(size_type n); 
 
     static void deallocate(pointer ptr); 
     static void deallocate(pointer ptr, size_type n); 
@@ -41,28 +101,47 @@ public:
 template <typename T> 
 T* allocator<T>::allocate()
 {
-    return static_cast<T*>(::operator new(sizeof(T))); 
+    return static_cast<T*>(mystl::aligned_new(sizeof(T), alignof(T))); 
 }
 
 template<typename T>   
 T* allocator<T>::allocate(size_type n)
 {
     if(0 == n ) return nullptr; 
-    return static_cast<T*>(::operator new(n * sizeof(T))); 
+    return static_cast<T*>(mystl::aligned_new(n * sizeof(T), alignof(T))); 
+}
+
+template <typename T> 
+allocation_result<T*, size_t> allocator<T>::allocate_at_least(size_type n)
+{
+    T* ptr = allocate(n); 
+    size_type count = n; 
+#if MYSTL_NEW_USES_MALLOC
+    // 超过默认对齐时 operator new 不一定直接来自 malloc
+    if(ptr != nullptr && alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__) 
+        count = ::malloc_usable_size(ptr) / sizeof(T); 
+#endif
+    return {ptr, count}; 
 }
 
 template <typename T>
 void allocator<T>::deallocate(T* ptr)
 {
     if(nullptr == ptr) return; 
-    ::operator delete(ptr); 
+    mystl::aligned_delete(ptr, alignof(T)); 
 }
 
 template <typename T> 
 void allocator<T>::deallocate(T* ptr, size_type)
 {
     if(ptr == nullptr) return; 
-    ::operator delete(ptr);
+    mystl::aligned_delete(ptr, alignof(T));
+}
+
+template <typename T>
+void allocator<T>::construct(T* ptr)
+{
+    mystl::_construct(ptr);
 }
 
 template <typename T> 
@@ -96,6 +175,349 @@ void allocator<T>:: destroy(T* first, T* last)
     mystl::destroy(first, last); 
 }
 
+template <typename T1, typename T2>
+bool operator== (const allocator<T1>&, const allocator<T2>&) noexcept
+{
+    return true;
+}
+
+template <typename T1, typename T2>
+bool operator!= (const allocator<T1>&, const allocator<T2>&) noexcept
+{
+    return false;
+}
+
+// allocator_traits
+// 容器只通过 allocator_traits 访问分配器，分配器未提供的成员由这里补上默认实现
+
+// 以下辅助模版探测分配器是否提供对应的成员
+template <typename Alloc, typename = void>
+struct alloc_pointer { typedef typename Alloc::value_type* type; };
+template <typename Alloc>
+struct alloc_pointer<Alloc, std::void_t<typename Alloc::pointer>>
+{ typedef typename Alloc::pointer type; };
+
+template <typename Alloc, typename = void>
+struct alloc_const_pointer { typedef const typename Alloc::value_type* type; };
+template <typename Alloc>
+struct alloc_const_pointer<Alloc, std::void_t<typename Alloc::const_pointer>>
+{ typedef typename Alloc::const_pointer type; };
+
+template <typename Alloc, typename = void>
+struct alloc_size_type { typedef size_t type; };
+template <typename Alloc>
+struct alloc_size_type<Alloc, std::void_t<typename Alloc::size_type>>
+{ typedef typename Alloc::size_type type; };
+
+template <typename Alloc, typename = void>
+struct alloc_difference_type { typedef ptrdiff_t type; };
+template <typename Alloc>
+struct alloc_difference_type<Alloc, std::void_t<typename Alloc::difference_type>>
+{ typedef typename Alloc::difference_type type; };
+
+template <typename Alloc, typename = void>
+struct alloc_pocca { typedef m_false_type type; };
+template <typename Alloc>
+struct alloc_pocca<Alloc, std::void_t<typename Alloc::propagate_on_container_copy_assignment>>
+{ typedef typename Alloc::propagate_on_container_copy_assignment type; };
+
+template <typename Alloc, typename = void>
+struct alloc_pocma { typedef m_false_type type; };
+template <typename Alloc>
+struct alloc_pocma<Alloc, std::void_t<typename Alloc::propagate_on_container_move_assignment>>
+{ typedef typename Alloc::propagate_on_container_move_assignment type; };
+
+template <typename Alloc, typename = void>
+struct alloc_pocs { typedef m_false_type type; };
+template <typename Alloc>
+struct alloc_pocs<Alloc, std::void_t<typename Alloc::propagate_on_container_swap>>
+{ typedef typename Alloc::propagate_on_container_swap type; };
+
+template <typename Alloc, typename = void>
+struct alloc_always_equal { typedef m_bool_constant<std::is_empty<Alloc>::value> type; };
+template <typename Alloc>
+struct alloc_always_equal<Alloc, std::void_t<typename Alloc::is_always_equal>>
+{ typedef typename Alloc::is_always_equal type; };
+
+// rebind: 优先使用 Alloc::rebind<U>::other，否则替换 Alloc<T, Args...> 的第一个模版参数
+template <typename Alloc, typename U>
+struct alloc_rebind_first;
+template <template <typename, typename...> class Alloc, typename T, typename... Args, typename U>
+struct alloc_rebind_first<Alloc<T, Args...>, U> { typedef Alloc<U, Args...> type; };
+
+template <typename Alloc, typename U, typename = void>
+struct alloc_rebind { typedef typename alloc_rebind_first<Alloc, U>::type type; };
+template <typename Alloc, typename U>
+struct alloc_rebind<Alloc, U, std::void_t<typename Alloc::template rebind<U>::other>>
+{ typedef typename Alloc::template rebind<U>::other type; };
+
+template <typename Alloc, typename Ptr, typename = void, typename... Args>
+struct alloc_has_construct: m_false_type {};
+template <typename Alloc, typename Ptr, typename... Args>
+struct alloc_has_construct<Alloc, Ptr, std::void_t<decltype(std::declval<Alloc&>().construct(
+    std::declval<Ptr>(), std::declval<Args>()...))>, Args...>: m_true_type {};
+
+template <typename Alloc, typename Ptr, typename = void>
+struct alloc_has_destroy: m_false_type {};
+template <typename Alloc, typename Ptr>
+struct alloc_has_destroy<Alloc, Ptr, std::void_t<decltype(
+    std::declval<Alloc&>().destroy(std::declval<Ptr>()))>>: m_true_type {};
+
+template <typename Alloc, typename = void>
+struct alloc_has_select: m_false_type {};
+template <typename Alloc>
+struct alloc_has_select<Alloc, std::void_t<decltype(
+    std::declval<const Alloc&>().select_on_container_copy_construction())>>: m_true_type {};
+
+template <typename Alloc, typename = void>
+struct alloc_has_allocate_at_least: m_false_type {};
+template <typename Alloc>
+struct alloc_has_allocate_at_least<Alloc, std::void_t<decltype(
+    std::declval<Alloc&>().allocate_at_least(size_t()))>>: m_true_type {};
+
+// mystl 扩展：分配器能否就地调整一块内存的大小 (a.reallocate(p, old_n, new_n))，如 mremap_allocator
+template <typename Alloc, typename = void>
+struct alloc_has_reallocate: m_false_type {};
+template <typename Alloc>
+struct alloc_has_reallocate<Alloc, std::void_t<decltype(std::declval<Alloc&>().reallocate(
+    std::declval<typename Alloc::value_type*>(), size_t(), size_t()))>>: m_true_type {};
+
+// mystl 扩展：分配器能否整体回收所有块 (a.live() / a.release())，如 slab_allocator
+template <typename Alloc, typename = void>
+struct alloc_has_release: m_false_type {};
+template <typename Alloc>
+struct alloc_has_release<Alloc, std::void_t<decltype(std::declval<const Alloc&>().live()),
+    decltype(std::declval<Alloc&>().release())>>: m_true_type {};
+
+template <typename Alloc>
+struct allocator_traits
+{
+    typedef Alloc                                           allocator_type;
+    typedef typename Alloc::value_type                      value_type;
+    typedef typename alloc_pointer<Alloc>::type             pointer;
+    typedef typename alloc_const_pointer<Alloc>::type       const_pointer;
+    typedef typename alloc_size_type<Alloc>::type           size_type;
+    typedef typename alloc_difference_type<Alloc>::type     difference_type;
+
+    typedef typename alloc_pocca<Alloc>::type   propagate_on_container_copy_assignment;
+    typedef typename alloc_pocma<Alloc>::type   propagate_on_container_move_assignment;
+    typedef typename alloc_pocs<Alloc>::type    propagate_on_container_swap;
+    typedef typename alloc_always_equal<Alloc>::type is_always_equal;
+
+    template <typename U>
+    using rebind_alloc = typename alloc_rebind<Alloc, U>::type;
+    template <typename U>
+    using rebind_traits = allocator_traits<rebind_alloc<U>>;
+
+    static pointer allocate(Alloc& a, size_type n)
+    {
+        return a.allocate(n);
+    }
+
+    // 至少分配 n 个元素，返回实际可用的个数，释放时应传入该个数
+    // 分配器未提供 allocate_at_least 时恰好分配 n 个
+    static allocation_result<pointer, size_type> allocate_at_least(Alloc& a, size_type n)
+    {
+        return allocate_at_least_aux(alloc_has_allocate_at_least<Alloc>{}, a, n);
+    }
+
+    static void deallocate(Alloc& a, pointer ptr, size_type n)
+    {
+        a.deallocate(ptr, n);
+    }
+
+    // mystl 扩展：把 old_n 个元素的空间调整为 new_n 个，按字节保留原有内容，只能用于可平凡重定位的元素
+    // 分配器未提供 reallocate 时分配新空间并复制；抛出异常时 ptr 保持不变
+    static pointer reallocate(Alloc& a, pointer ptr, size_type old_n, size_type new_n)
+    {
+        return reallocate_aux(alloc_has_reallocate<Alloc>{}, a, ptr, old_n, new_n);
+    }
+
+    template <typename U, typename... Args>
+    static void construct(Alloc& a, U* ptr, Args&& ...args)
+    {
+        construct_aux(alloc_has_construct<Alloc, U*, void, Args...>{},
+            a, ptr, mystl::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    static void destroy(Alloc& a, U* ptr)
+    {
+        destroy_aux(alloc_has_destroy<Alloc, U*>{}, a, ptr);
+    }
+
+    // 区间析构，mystl 扩展：分配器未自定义 destroy 时走 mystl::destroy 的平凡析构优化
+    template <typename U>
+    static void destroy(Alloc& a, U* first, U* last)
+    {
+        destroy_range_aux(alloc_has_destroy<Alloc, U*>{}, a, first, last);
+    }
+
+    static size_type max_size(const Alloc&) noexcept
+    {
+        return static_cast<size_type>(-1) / sizeof(value_type);
+    }
+
+    static Alloc select_on_container_copy_construction(const Alloc& a)
+    {
+        return select_aux(alloc_has_select<Alloc>{}, a);
+    }
+
+    // mystl 扩展：容器持有的 n 个块是否恰为该分配器尚未释放的全部块，
+    // 若是，容器可以在析构元素后调用 release 一次性回收，而不必逐个 deallocate
+    static bool releasable(const Alloc& a, size_type n)
+    {
+        return releasable_aux(alloc_has_release<Alloc>{}, a, n);
+    }
+
+    static void release(Alloc& a)
+    {
+        release_aux(alloc_has_release<Alloc>{}, a);
+    }
+
+private:
+    static allocation_result<pointer, size_type> allocate_at_least_aux(m_true_type, Alloc& a, size_type n)
+    {
+        auto r = a.allocate_at_least(n);
+        return {r.ptr, static_cast<size_type>(r.count)};
+    }
+    static allocation_result<pointer, size_type> allocate_at_least_aux(m_false_type, Alloc& a, size_type n)
+    { return {a.allocate(n), n}; }
+
+    static pointer reallocate_aux(m_true_type, Alloc& a, pointer ptr, size_type old_n, size_type new_n)
+    { return a.reallocate(ptr, old_n, new_n); }
+    static pointer reallocate_aux(m_false_type, Alloc& a, pointer ptr, size_type old_n, size_type new_n)
+    {
+        pointer result = a.allocate(new_n);
+        if(ptr != nullptr)
+        {
+            if(result != nullptr)
+                std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr),
+                            (old_n < new_n ? old_n : new_n) * sizeof(value_type));
+            a.deallocate(ptr, old_n);
+        }
+        return result;
+    }
+
+    template <typename U, typename... Args>
+    static void construct_aux(m_true_type, Alloc& a, U* ptr, Args&& ...args)
+    { a.construct(ptr, mystl::forward<Args>(args)...); }
+    template <typename U, typename... Args>
+    static void construct_aux(m_false_type, Alloc&, U* ptr, Args&& ...args)
+    { mystl::_construct(ptr, mystl::forward<Args>(args)...); }
+
+    template <typename U>
+    static void destroy_aux(m_true_type, Alloc& a, U* ptr)
+    { a.destroy(ptr); }
+    template <typename U>
+    static void destroy_aux(m_false_type, Alloc&, U* ptr)
+    { mystl::destroy(ptr); }
+
+    template <typename U>
+    static void destroy_range_aux(m_true_type, Alloc& a, U* first, U* last)
+    { for(; first != last; ++first) a.destroy(first); }
+    template <typename U>
+    static void destroy_range_aux(m_false_type, Alloc&, U* first, U* last)
+    { mystl::destroy(first, last); }
+
+    static Alloc select_aux(m_true_type, const Alloc& a)
+    { return a.select_on_container_copy_construction(); }
+    static Alloc select_aux(m_false_type, const Alloc& a)
+    { return a; }
+
+    static bool releasable_aux(m_true_type, const Alloc& a, size_type n)
+    { return a.live() == n; }
+    static bool releasable_aux(m_false_type, const Alloc&, size_type)
+    { return false; }
+
+    static void release_aux(m_true_type, Alloc& a)
+    { a.release(); }
+    static void release_aux(m_false_type, Alloc&) {}
+};
+
+// alloc_holder
+// 容器通过继承 alloc_holder 保存分配器实例，
+// 无状态分配器借助空基类优化(EBO)不占用任何空间
+template <typename Alloc, bool = std::is_empty<Alloc>::value && !std::is_final<Alloc>::value>
+class alloc_holder: private Alloc
+{
+public:
+    alloc_holder() = default;
+    explicit alloc_holder(const Alloc& a): Alloc(a) {}
+
+    Alloc&          get_alloc()         noexcept { return *this; }
+    const Alloc&    get_alloc()   const noexcept { return *this; }
+};
+
+template <typename Alloc>
+class alloc_holder<Alloc, false>
+{
+private:
+    Alloc   _alloc;
+
+public:
+    alloc_holder() = default;
+    explicit alloc_holder(const Alloc& a): _alloc(a) {}
+
+    Alloc&          get_alloc()         noexcept { return _alloc; }
+    const Alloc&    get_alloc()   const noexcept { return _alloc; }
+};
+
+// 容器赋值 / 交换时按 propagate_on_container_* 决定是否转移分配器
+template <typename Alloc>
+void alloc_on_copy_aux(Alloc& lhs, const Alloc& rhs, m_true_type) { lhs = rhs; }
+template <typename Alloc>
+void alloc_on_copy_aux(Alloc&, const Alloc&, m_false_type) {}
+
+template <typename Alloc>
+void alloc_on_copy(Alloc& lhs, const Alloc& rhs)
+{
+    mystl::alloc_on_copy_aux(lhs, rhs,
+        m_bool_constant<allocator_traits<Alloc>::propagate_on_container_copy_assignment::value>{});
+}
+
+template <typename Alloc>
+void alloc_on_move_aux(Alloc& lhs, Alloc& rhs, m_true_type) { lhs = mystl::move(rhs); }
+template <typename Alloc>
+void alloc_on_move_aux(Alloc&, Alloc&, m_false_type) {}
+
+template <typename Alloc>
+void alloc_on_move(Alloc& lhs, Alloc& rhs)
+{
+    mystl::alloc_on_move_aux(lhs, rhs,
+        m_bool_constant<allocator_traits<Alloc>::propagate_on_container_move_assignment::value>{});
+}
+
+template <typename Alloc>
+void alloc_on_swap_aux(Alloc& lhs, Alloc& rhs, m_true_type)
+{
+    Alloc temp(mystl::move(lhs));
+    lhs = mystl::move(rhs);
+    rhs = mystl::move(temp);
+}
+template <typename Alloc>
+void alloc_on_swap_aux(Alloc&, Alloc&, m_false_type) {}
+
+template <typename Alloc>
+void alloc_on_swap(Alloc& lhs, Alloc& rhs)
+{
+    mystl::alloc_on_swap_aux(lhs, rhs,
+        m_bool_constant<allocator_traits<Alloc>::propagate_on_container_swap::value>{});
+}
+
+// 两个分配器能否互相释放对方分配的内存
+template <typename Alloc>
+bool alloc_equal(const Alloc& lhs, const Alloc& rhs)
+{
+    return allocator_traits<Alloc>::is_always_equal::value || lhs == rhs;
+}
+
+namespace pmr
+{
+// 定义于 memory_resource.h，此处声明以便各容器头文件提供 pmr 别名
+template <typename T> class polymorphic_allocator;
+}
+
 } // end of namespace 
 #endif // !ALLOCATOR_HPP_  
 
@@ -0,0 +1,450 @@
+// -- concurrent_vector.h 模版类 concurrent_vector
+// 多个线程可以同时追加元素的 vector
+#ifndef CONCURRENT_VECTOR_H_
+#define CONCURRENT_VECTOR_H_
+
+// notes:
+// * 元素存放在大小按 2 的幂增长的段中: 第 0 段 64 个元素，第 k 段 (k >= 1) 存放 [2^(k+5), 2^(k+6))
+//   段表是固定大小的数组，段一旦分配就不再移动，扩容时已有元素的地址不变
+// * push_back / emplace_back / grow_by 用原子计数器 fetch_add 领取下标，再在各自的位置上构造，
+//   线程之间只在段首次分配时竞争一次 CAS，失败的一方释放自己分配的段
+// * 每个元素对应一个就绪位，构造完成后以 release 语义置位；
+//   ready(i) 为 true 之后其他线程才能读取第 i 个元素，push_back 返回的迭代器在本线程内立即可用
+// * size() 为已领取的下标数，可能包含正在构造的元素；构造时抛出异常的位置永远不会就绪，
+//   分配段失败时领取到的位置同样如此，析构时只析构已就绪的元素
+// * 可以与追加并发的操作: push_back、emplace_back、grow_by、reserve、ready、size、
+//   以及对已就绪元素的读取；clear、析构等其余操作要求没有其他线程在访问
+// * 分配器在多个线程中同时使用，需要是线程安全的
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <type_traits>
+#include "iterator.h"
+#include "memory.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 最高位 1 的位置，n > 0
+inline size_t concurrent_vector_log2(uint64_t n) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * 8 - 1 - static_cast<size_t>(__builtin_clzll(n));
+#else
+    size_t k = 0;
+    while(n >>= 1) ++k;
+    return k;
+#endif
+}
+
+// concurrent_vector iterator
+// 保存容器地址与下标；concurrent_vector 不可复制、移动与交换，容器地址在其生存期内不变
+template <typename Vec, typename Ref, typename Ptr>
+struct concurrent_vector_iterator: public iterator<random_access_iterator_tag, typename Vec::value_type>
+{
+    typedef concurrent_vector_iterator<Vec, typename Vec::reference, typename Vec::pointer>  iterator;
+    typedef concurrent_vector_iterator<Vec, typename Vec::const_reference,
+                                       typename Vec::const_pointer>                          const_iterator;
+    typedef concurrent_vector_iterator                  self;
+    typedef typename std::conditional<std::is_const<typename std::remove_reference<Ref>::type>::value,
+                                      const Vec*, Vec*>::type container_pointer;
+
+    typedef typename Vec::value_type    value_type;
+    typedef Ptr                         pointer;
+    typedef Ref                         reference;
+    typedef size_t                      size_type;
+    typedef ptrdiff_t                   difference_type;
+
+    container_pointer   vec;
+    size_type           index;
+
+    concurrent_vector_iterator() noexcept: vec(nullptr), index(0) {}
+    concurrent_vector_iterator(container_pointer v, size_type i) noexcept: vec(v), index(i) {}
+    concurrent_vector_iterator(const iterator& rhs) noexcept: vec(rhs.vec), index(rhs.index) {}
+    self& operator=(const iterator& rhs) noexcept
+    {
+        vec = rhs.vec;
+        index = rhs.index;
+        return *this;
+    }
+
+    reference operator*() const { return vec->element(index); }
+    pointer   operator->() const { return &vec->element(index); }
+    reference operator[](difference_type n) const { return vec->element(index + n); }
+
+    self& operator++() noexcept { ++index; return *this; }
+    self& operator--() noexcept { --index; return *this; }
+    self operator++(int) noexcept { self temp = *this; ++index; return temp; }
+    self operator--(int) noexcept { self temp = *this; --index; return temp; }
+
+    self& operator+=(difference_type n) noexcept { index += n; return *this; }
+    self& operator-=(difference_type n) noexcept { index -= n; return *this; }
+    self operator+(difference_type n) const noexcept { return self(vec, index + n); }
+    self operator-(difference_type n) const noexcept { return self(vec, index - n); }
+
+    difference_type operator-(const self& x) const noexcept
+    {
+        return static_cast<difference_type>(index) - static_cast<difference_type>(x.index);
+    }
+
+    bool operator==(const self& rhs) const noexcept { return index == rhs.index; }
+    bool operator!=(const self& rhs) const noexcept { return index != rhs.index; }
+    bool operator< (const self& rhs) const noexcept { return index < rhs.index; }
+    bool operator> (const self& rhs) const noexcept { return index > rhs.index; }
+    bool operator<=(const self& rhs) const noexcept { return index <= rhs.index; }
+    bool operator>=(const self& rhs) const noexcept { return index >= rhs.index; }
+};
+
+template <typename Vec, typename Ref, typename Ptr>
+concurrent_vector_iterator<Vec, Ref, Ptr>
+operator+(ptrdiff_t n, const concurrent_vector_iterator<Vec, Ref, Ptr>& it) noexcept
+{
+    return it + n;
+}
+
+template <typename T, typename Alloc = mystl::allocator<T>>
+class concurrent_vector: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+    template <typename V, typename R, typename P> friend struct concurrent_vector_iterator;
+
+public:
+    // traits
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type;
+    typedef allocator_type                              data_allocator;
+    typedef mystl::allocator_traits<data_allocator>     data_traits;
+
+    typedef typename data_traits::value_type            value_type;
+    typedef typename data_traits::pointer               pointer;
+    typedef typename data_traits::const_pointer         const_pointer;
+    typedef value_type&                                 reference;
+    typedef const value_type&                           const_reference;
+    typedef typename data_traits::size_type             size_type;
+    typedef typename data_traits::difference_type       difference_type;
+
+    typedef concurrent_vector_iterator<concurrent_vector, reference, pointer>             iterator;
+    typedef concurrent_vector_iterator<concurrent_vector, const_reference, const_pointer> const_iterator;
+    typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+    allocator_type get_allocator() const { return get_alloc(); }
+
+private:
+    typedef mystl::alloc_holder<data_allocator>         alloc_base;
+    typedef std::atomic<uint64_t>                       ready_word;
+    typedef typename data_traits::template rebind_alloc<ready_word> ready_allocator;
+    typedef mystl::allocator_traits<ready_allocator>    ready_traits;
+    using alloc_base::get_alloc;
+
+    static constexpr size_type first_shift = 6;     // 第 0 段 64 个元素，每段都是整数个就绪字
+    static constexpr size_type segment_count = sizeof(size_type) * 8 - first_shift + 1;
+
+    std::atomic<size_type>      _size;
+    std::atomic<pointer>        _data[segment_count];
+    std::atomic<ready_word*>    _ready[segment_count];
+
+public:
+    // ctors, 不可复制
+    concurrent_vector() noexcept(std::is_nothrow_default_constructible<allocator_type>::value)
+    : alloc_base(), _size(0)
+    { init_table(); }
+
+    explicit concurrent_vector(const allocator_type& alloc)
+    : alloc_base(alloc), _size(0)
+    { init_table(); }
+
+    concurrent_vector(const concurrent_vector&) = delete;
+    concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+    ~concurrent_vector()
+    {
+        clear();
+        release_segments();
+    }
+
+public:
+    // 迭代器相关，遍历时 [begin, end) 中的元素应当都已就绪
+    iterator        begin()         noexcept { return iterator(this, 0); }
+    const_iterator  begin()   const noexcept { return const_iterator(this, 0); }
+    iterator        end()           noexcept { return iterator(this, size()); }
+    const_iterator  end()     const noexcept { return const_iterator(this, size()); }
+
+    reverse_iterator        rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator        rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator          cbegin()  const noexcept { return begin(); }
+    const_iterator          cend()    const noexcept { return end(); }
+
+    // 容量相关
+    bool        empty()     const noexcept { return size() == 0; }
+    size_type   size()      const noexcept { return _size.load(std::memory_order_acquire); }
+    size_type   max_size()  const noexcept { return static_cast<size_type>(-1) / 2 / sizeof(T); }
+    size_type   capacity()  const noexcept;
+
+    // 预先分配能容纳 n 个元素的段，可以与追加并发
+    void reserve(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(),
+                              "n can not larger than max_size() in concurrent_vector<T>::reserve(n)");
+        if(n > 0) install_segments(0, n);
+    }
+
+    // 第 i 个元素是否已构造完成，为 true 时与构造它的线程建立 happens-before 关系
+    bool ready(size_type i) const noexcept
+    {
+        if(i >= size()) return false;
+        const ready_word* words = _ready[segment_of(i)].load(std::memory_order_acquire);
+        if(words == nullptr) return false;
+        const size_type off = i - segment_base(segment_of(i));
+        return (words[off >> 6].load(std::memory_order_acquire) >> (off & 63)) & 1;
+    }
+
+    // 访问元素相关
+    reference operator[](size_type n)
+    {
+        MYSTL_DEBUG(n < size());
+        return element(n);
+    }
+    const_reference operator[](size_type n) const
+    {
+        MYSTL_DEBUG(n < size());
+        return element(n);
+    }
+
+    reference at(size_type n)
+    {
+        THROW_OUT_OF_RANGE_IF(!ready(n), "concurrent_vector<T>::at() subscript out of range");
+        return element(n);
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_OF_RANGE_IF(!ready(n), "concurrent_vector<T>::at() subscript out of range");
+        return element(n);
+    }
+
+    reference       front()       { MYSTL_DEBUG(!empty()); return element(0); }
+    const_reference front() const { MYSTL_DEBUG(!empty()); return element(0); }
+    reference       back()        { MYSTL_DEBUG(!empty()); return element(size() - 1); }
+    const_reference back()  const { MYSTL_DEBUG(!empty()); return element(size() - 1); }
+
+    // 修改容器相关操作，返回指向新元素的迭代器
+    template <typename ...Args>
+    iterator emplace_back(Args&& ...args)
+    {
+        const size_type i = claim(1);
+        construct_at(i, mystl::forward<Args>(args)...);
+        return iterator(this, i);
+    }
+
+    iterator push_back(const value_type& value) { return emplace_back(value); }
+    iterator push_back(value_type&& value) { return emplace_back(mystl::move(value)); }
+
+    // 一次领取 n 个连续的位置，返回指向第一个新元素的迭代器
+    iterator grow_by(size_type n);
+    iterator grow_by(size_type n, const value_type& value);
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_forward_iterator<Iter>::value, int>::type = 0>
+    iterator grow_by(Iter first, Iter last);
+
+    iterator grow_by(std::initializer_list<value_type> initlist)
+    {
+        return grow_by(initlist.begin(), initlist.end());
+    }
+
+    // 析构所有元素，保留已分配的段，不可与其他操作并发
+    void clear() noexcept;
+
+private:
+    // helper functions
+
+    static size_type segment_of(size_type i) noexcept
+    {
+        return i < (size_type(1) << first_shift) ? 0 : concurrent_vector_log2(i) - first_shift + 1;
+    }
+    static size_type segment_base(size_type k) noexcept
+    {
+        return k == 0 ? 0 : size_type(1) << (k + first_shift - 1);
+    }
+    static size_type segment_size(size_type k) noexcept
+    {
+        return size_type(1) << (k == 0 ? first_shift : k + first_shift - 1);
+    }
+
+    reference element(size_type i) noexcept
+    {
+        const size_type k = segment_of(i);
+        return _data[k].load(std::memory_order_acquire)[i - segment_base(k)];
+    }
+    const_reference element(size_type i) const noexcept
+    {
+        const size_type k = segment_of(i);
+        return _data[k].load(std::memory_order_acquire)[i - segment_base(k)];
+    }
+
+    void init_table() noexcept
+    {
+        for(size_type k = 0; k < segment_count; ++k)
+        {
+            _data[k].store(nullptr, std::memory_order_relaxed);
+            _ready[k].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    // 领取 [i, i + n)，并保证所在的段都已分配
+    size_type claim(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(), "concurrent_vector<T>'s size too big");
+        if(n == 0) return _size.load(std::memory_order_acquire);
+        const size_type i = _size.fetch_add(n, std::memory_order_acq_rel);
+        install_segments(i, i + n);
+        return i;
+    }
+
+    template <typename ...Args>
+    void construct_at(size_type i, Args&& ...args)
+    {
+        const size_type k = segment_of(i);
+        const size_type off = i - segment_base(k);
+        pointer p = _data[k].load(std::memory_order_acquire) + off;
+        data_traits::construct(get_alloc(), p, mystl::forward<Args>(args)...);
+        _ready[k].load(std::memory_order_acquire)[off >> 6].fetch_or(
+            uint64_t(1) << (off & 63), std::memory_order_release);
+    }
+
+    void install_segments(size_type first, size_type last);
+    void install_segment(size_type k);
+    void release_segments() noexcept;
+};
+
+/*****************************************************************************************/
+
+template <typename T, typename Alloc>
+typename concurrent_vector<T, Alloc>::size_type
+concurrent_vector<T, Alloc>::capacity() const noexcept
+{
+    size_type k = 0;
+    while(k < segment_count && _data[k].load(std::memory_order_acquire) != nullptr)
+        ++k;
+    return k == 0 ? 0 : segment_base(k - 1) + segment_size(k - 1);
+}
+
+template <typename T, typename Alloc>
+typename concurrent_vector<T, Alloc>::iterator
+concurrent_vector<T, Alloc>::grow_by(size_type n)
+{
+    const size_type first = claim(n);
+    for(size_type i = first; i < first + n; ++i)
+        construct_at(i);
+    return iterator(this, first);
+}
+
+template <typename T, typename Alloc>
+typename concurrent_vector<T, Alloc>::iterator
+concurrent_vector<T, Alloc>::grow_by(size_type n, const value_type& value)
+{
+    const size_type first = claim(n);
+    for(size_type i = first; i < first + n; ++i)
+        construct_at(i, value);
+    return iterator(this, first);
+}
+
+template <typename T, typename Alloc>
+template <typename Iter, typename std::enable_if<
+    mystl::is_forward_iterator<Iter>::value, int>::type>
+typename concurrent_vector<T, Alloc>::iterator
+concurrent_vector<T, Alloc>::grow_by(Iter first, Iter last)
+{
+    const size_type n = static_cast<size_type>(mystl::distance(first, last));
+    const size_type start = claim(n);
+    for(size_type i = start; first != last; ++first, ++i)
+        construct_at(i, *first);
+    return iterator(this, start);
+}
+
+// clear: 按就绪位析构，构造失败的位置被跳过
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::clear() noexcept
+{
+    const size_type n = _size.load(std::memory_order_acquire);
+    for(size_type k = 0; k < segment_count && segment_base(k) < n; ++k)
+    {
+        pointer data = _data[k].load(std::memory_order_acquire);
+        ready_word* words = _ready[k].load(std::memory_order_acquire);
+        if(data == nullptr) continue;
+        for(size_type w = 0; w < (segment_size(k) >> 6); ++w)
+        {
+            uint64_t bits = words[w].load(std::memory_order_acquire);
+            if(!std::is_trivially_destructible<T>::value)
+            {
+                for(; bits != 0; bits &= bits - 1)
+                    data_traits::destroy(get_alloc(), data + (w << 6) + concurrent_vector_log2(bits & (~bits + 1)));
+            }
+            words[w].store(0, std::memory_order_relaxed);
+        }
+    }
+    _size.store(0, std::memory_order_release);
+}
+
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::install_segments(size_type first, size_type last)
+{
+    if(first >= last) return;
+    const size_type k_last = segment_of(last - 1);
+    for(size_type k = segment_of(first); k <= k_last; ++k)
+    {
+        if(_data[k].load(std::memory_order_acquire) == nullptr)
+            install_segment(k);
+    }
+}
+
+// install_segment: 先装就绪字再装数据段，数据段非空即说明两者都已就位
+// 两个线程同时分配同一段时 CAS 失败的一方释放自己的那份
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::install_segment(size_type k)
+{
+    const size_type n = segment_size(k);
+    if(_ready[k].load(std::memory_order_acquire) == nullptr)
+    {
+        ready_allocator ralloc(get_alloc());
+        ready_word* words = ready_traits::allocate(ralloc, n >> 6);
+        for(size_type w = 0; w < (n >> 6); ++w)
+            ready_traits::construct(ralloc, words + w, uint64_t(0));
+        ready_word* expected = nullptr;
+        if(!_ready[k].compare_exchange_strong(expected, words, std::memory_order_acq_rel))
+            ready_traits::deallocate(ralloc, words, n >> 6);
+    }
+    if(_data[k].load(std::memory_order_acquire) == nullptr)
+    {
+        pointer data = data_traits::allocate(get_alloc(), n);
+        pointer expected = nullptr;
+        if(!_data[k].compare_exchange_strong(expected, data, std::memory_order_acq_rel))
+            data_traits::deallocate(get_alloc(), data, n);
+    }
+}
+
+template <typename T, typename Alloc>
+void concurrent_vector<T, Alloc>::release_segments() noexcept
+{
+    ready_allocator ralloc(get_alloc());
+    for(size_type k = 0; k < segment_count; ++k)
+    {
+        const size_type n = segment_size(k);
+        if(pointer data = _data[k].exchange(nullptr))
+            data_traits::deallocate(get_alloc(), data, n);
+        if(ready_word* words = _ready[k].exchange(nullptr))
+        {
+            ready_traits::destroy(ralloc, words, words + (n >> 6));
+            ready_traits::deallocate(ralloc, words, n >> 6);
+        }
+    }
+}
+
+} // end of namespace mystl
+#endif // !CONCURRENT_VECTOR_H_
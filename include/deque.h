@@ -11,10 +11,19 @@
 // * push_front 
 // * push_back 
 // * insert
+// 缓冲区大小为模版参数 BufSize，必须是 2 的幂，默认取不超过 4096 字节的 2 的幂个元素 (元素不小于 256 字节时为 16)
+// 迭代器的跳转与 operator[] 由此只需移位与掩码
+// 缓冲区缓存
+// * pop_front / pop_back / erase 腾出的缓冲区先放入每个 deque 自己的空闲链表，两端扩张时优先取用，
+//   队列式使用 (push_back + pop_front) 在稳定状态下不再分配、释放缓冲区
+// * 链表的 next 指针存放在空闲缓冲区开头，不占用额外空间
+// * 缓存上限默认 DEQUE_BUFFER_CACHE 个，可由 set_buffer_cache_limit 逐个对象调整，0 表示不缓存
+// * shrink_to_fit 与 clear 释放全部缓存；复制构造沿用源对象的上限
 
 
 #include <initializer_list>
 #include <algorithm>
+#include <cstring>
 #include "iterator.h"
 #include "memory.h"
 #include "util.h" 
@@ -34,18 +43,27 @@ namespace mystl
 #define DEQUE_MAP_INIT_SIZE 8 
 #endif 
 
+    // 每个 deque 缓存的空闲缓冲区个数上限
+#ifndef DEQUE_BUFFER_CACHE 
+#define DEQUE_BUFFER_CACHE 4 
+#endif 
+
+// 缓冲区大小取不超过 4096 字节的 2 的幂个元素，下标换算为移位与掩码
 template <typename T> 
 struct deque_buf_size 
 {
-    static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16; 
+    static constexpr size_t value = sizeof(T) < 256 ? mystl::floor_pow2(4096 / sizeof(T)) : 16; 
 }; 
 
 // deque iterator 
-template <typename T, typename Ref, typename Ptr> 
+template <typename T, typename Ref, typename Ptr, size_t BufSize = deque_buf_size<T>::value> 
 struct deque_iterator: public iterator<random_access_iterator_tag, T> 
 {
-    typedef     deque_iterator<T, T&, T*>               iterator; 
-    typedef     deque_iterator<T, const T&, const T*>   const_iterator; 
+    static_assert(BufSize > 0 && (BufSize & (BufSize - 1)) == 0,
+                  "deque: buffer size must be a power of two");
+
+    typedef     deque_iterator<T, T&, T*, BufSize>              iterator; 
+    typedef     deque_iterator<T, const T&, const T*, BufSize>  const_iterator; 
     typedef     deque_iterator                          self; 
 
     typedef T               value_type; 
@@ -56,7 +74,9 @@ struct deque_iterator: public iterator<random_access_iterator_tag, T>
     typedef T*              value_pointer; 
     typedef T**             map_pointer; 
 
-    static const size_type buffer_size = deque_buf_size<T>:: value; 
+    static constexpr size_type buffer_size = BufSize; 
+    static constexpr size_type buffer_shift = mystl::floor_log2(BufSize); 
+    static constexpr size_type buffer_mask = BufSize - 1; 
 
 
     // 数据成员：四个指针
@@ -86,17 +106,8 @@ struct deque_iterator: public iterator<random_access_iterator_tag, T>
     : cur(rhs.cur), first(rhs.first), last(rhs.last), node(rhs.node) {} 
 
     // operator overloads 
-    self& operator=(const iterator& rhs) 
-    {
-        if(this != &rhs) 
-        {
-            cur = rhs.cur; 
-            first = rhs.first; 
-            last = rhs.last; 
-            node = rhs.node; 
-        }
-        return *this; 
-    }
+    // iterator 经由上面的转换构造赋给 const_iterator 
+    self& operator=(const self& rhs) = default; 
 
     void set_node(map_pointer new_node)
     {
@@ -163,8 +174,8 @@ struct deque_iterator: public iterator<random_access_iterator_tag, T>
         else  
         {
             const auto node_offset = offset >0 ? 
-            offset/static_cast<difference_type>(buffer_size):   
-            - static_cast<difference_type> ((-offset - 1) / buffer_size) - 1; 
+            static_cast<difference_type>(static_cast<size_type>(offset) >> buffer_shift):   
+            - static_cast<difference_type> (static_cast<size_type>(-offset - 1) >> buffer_shift) - 1; 
             set_node(node + node_offset); 
             cur = first + (offset - node_offset * static_cast<difference_type>(buffer_size)); 
         }
@@ -206,72 +217,99 @@ struct deque_iterator: public iterator<random_access_iterator_tag, T>
 
 
 // deque 
-template <typename T>   
-class deque 
+template <typename T, typename Alloc = mystl::allocator<T>, size_t BufSize = deque_buf_size<T>::value>   
+class deque: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
 {
 public: 
     // deque traits 
-    typedef mystl::allocator<T>             allocator_type; 
-    typedef mystl::allocator<T>             data_allocator; 
-    typedef mystl::allocator<T*>            map_allocator; 
-
-    typedef typename allocator_type::value_type         value_type; 
-    typedef typename allocator_type::pointer            pointer; 
-    typedef typename allocator_type::const_pointer      const_pointer; 
-    typedef typename allocator_type::reference          reference; 
-    typedef typename allocator_type::const_reference    const_reference;  
-    typedef typename allocator_type::size_type          size_type;
-    typedef typename allocator_type::difference_type    difference_type; 
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type; 
+    typedef allocator_type                  data_allocator; 
+    typedef mystl::allocator_traits<data_allocator>     data_traits; 
+    typedef typename data_traits::template rebind_alloc<T*>     map_allocator; 
+    typedef mystl::allocator_traits<map_allocator>      map_traits; 
+
+    typedef typename data_traits::value_type            value_type; 
+    typedef typename data_traits::pointer               pointer; 
+    typedef typename data_traits::const_pointer         const_pointer; 
+    typedef value_type&                                 reference; 
+    typedef const value_type&                           const_reference;  
+    typedef typename data_traits::size_type             size_type;
+    typedef typename data_traits::difference_type       difference_type; 
     typedef pointer*                                    map_pointer; 
     typedef const pointer*                              const_map_pointer; 
 
-    typedef deque_iterator<T, T&, T*>                   iterator; 
-    typedef deque_iterator<T, const T&, const T*>       const_iterator; 
+    typedef deque_iterator<T, T&, T*, BufSize>              iterator; 
+    typedef deque_iterator<T, const T&, const T*, BufSize>  const_iterator; 
     typedef mystl::reverse_iterator<iterator>           reverse_iterator; 
     typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator; 
 
-    allocator_type get_allocator() {return allocator_type(); }
+    allocator_type get_allocator() const {return get_alloc(); }
 
-    static const size_type buffer_size = deque_buf_size<T>::value; 
+    static constexpr size_type buffer_size = BufSize; 
+    static constexpr size_type buffer_shift = iterator::buffer_shift; 
+    static constexpr size_type buffer_mask = iterator::buffer_mask; 
 
 private:   
+    typedef mystl::alloc_holder<data_allocator>         alloc_base; 
+    using alloc_base::get_alloc; 
+
     // 
     iterator _begin;            // 第一个节点   
     iterator _end;              // 末尾节点（哨兵） 
     map_pointer _map;           // T* 数组map  
     size_type   _map_size;      // map 中元素个数 
 
+    // 空闲缓冲区链表，缓冲区放不下一个指针时不缓存
+    static constexpr bool cacheable = buffer_size * sizeof(T) >= sizeof(pointer); 
+    pointer     _spare = nullptr; 
+    size_type   _spare_count = 0; 
+    size_type   _spare_limit = cacheable ? DEQUE_BUFFER_CACHE : 0; 
+
 public:  
     // ctor 
     deque() 
     { fill_init(0, value_type()); }
 
-    explicit deque(size_type n)
+    explicit deque(const allocator_type& alloc): alloc_base(alloc) 
+    { fill_init(0, value_type()); }
+
+    explicit deque(size_type n, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc) 
     { fill_init(n, value_type()); }
 
-    deque(size_type n, const value_type& value)
+    deque(size_type n, const value_type& value, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc) 
     { fill_init(n, value);} 
 
     template <typename InputIter, typename std::enable_if < 
     mystl::is_input_iterator<InputIter>::value, int>::type = 0 >  
-    deque(InputIter first, InputIter last) 
+    deque(InputIter first, InputIter last, const allocator_type& alloc = allocator_type()) 
+    : alloc_base(alloc) 
     { copy_init(first, last, iterator_category(first)); } 
 
-    deque(std::initializer_list<T> initlist) 
+    deque(std::initializer_list<T> initlist, const allocator_type& alloc = allocator_type()) 
+    : alloc_base(alloc) 
     { 
         copy_init(initlist.begin(), initlist.end(), mystl::forward_iterator_tag());
     } 
 
     deque(const deque& rhs) 
+    : alloc_base(data_traits::select_on_container_copy_construction(rhs.get_alloc())), 
+      _spare_limit(rhs._spare_limit) 
     {
         copy_init(rhs.begin(), rhs.end(), mystl::forward_iterator_tag()); 
     }
 
     deque(deque&&rhs ) noexcept 
-    : _begin(rhs._begin), _end(rhs._end), _map(rhs._map), _map_size(rhs._map_size) 
+    : alloc_base(mystl::move(rhs.get_alloc())), 
+      _begin(rhs._begin), _end(rhs._end), _map(rhs._map), _map_size(rhs._map_size), 
+      _spare(rhs._spare), _spare_count(rhs._spare_count), _spare_limit(rhs._spare_limit) 
     {
         rhs._map = nullptr; 
         rhs._map_size = 0; 
+        rhs._spare = nullptr; 
+        rhs._spare_count = 0; 
     }
 
     // copy assign 
@@ -280,7 +318,7 @@ public:
 
     deque& operator=(std::initializer_list<value_type> initlist)
     {
-        deque temp(initlist);
+        deque temp(initlist, get_alloc());
         swap(temp); 
         return *this; 
     }
@@ -291,9 +329,9 @@ public:
         {
             clear(); 
             //clear 之后，只剩下一个buffer没有被释放
-            data_allocator::deallocate(*_begin.node, buffer_size);
+            data_traits::deallocate(get_alloc(), *_begin.node, buffer_size);
             *_begin.node = nullptr; 
-            map_allocator::deallocate(_map, _map_size); 
+            deallocate_map(_map, _map_size); 
             _map = nullptr; 
         }
     }
@@ -336,17 +374,37 @@ public:
     void resize(size_type new_size, const value_type& value); 
     void shrink_to_fit() noexcept; 
 
+    // 空闲缓冲区缓存
+    size_type buffer_cache_size()  const noexcept {return _spare_count; } 
+    size_type buffer_cache_limit() const noexcept {return _spare_limit; } 
+    void set_buffer_cache_limit(size_type n) noexcept; 
+
+    // 跳过值初始化的 resize / 追加，与 vector 相同: 新增的元素只做默认初始化
+    void resize_default_init(size_type new_size); 
+
+    // 在末尾追加 n 个默认初始化的元素，返回它们所在的区间 [first, last)，区间可能跨越多个缓冲区
+    mystl::pair<iterator, iterator> append_uninitialized(size_type n); 
+
+    // 大小调整为 n (新增元素默认初始化) 后按缓冲区分段调用 op(p, count): [p, p + count) 是
+    // [0, n) 中位于同一缓冲区的连续一段，op 返回本段保留的元素个数 r (r <= count)，
+    // r < count 时不再继续，最终大小为各段保留个数之和
+    template <typename Op> 
+    void resize_and_overwrite(size_type n, Op op); 
+
     // visitor 元素访问
+    // 下标从 _begin 所在缓冲区的起点算起，移位得到节点、掩码得到缓冲区内的位置
     reference   operator[](size_type n) 
     {
         MYSTL_DEBUG(n < size()); 
-        return _begin[n]; 
+        const size_type offset = n + (_begin.cur - _begin.first); 
+        return _begin.node[offset >> buffer_shift][offset & buffer_mask]; 
     }
 
     const_reference operator[] (size_type n) const 
     {
         MYSTL_DEBUG(n < size()); 
-        return _begin[n]; 
+        const size_type offset = n + (_begin.cur - _begin.first); 
+        return _begin.node[offset >> buffer_shift][offset & buffer_mask]; 
     }
 
     reference at(size_type n)
@@ -442,8 +500,12 @@ private:
 
     // create / destroy node 
     map_pointer create_map(size_type size); 
+    void deallocate_map(map_pointer mp, size_type size); 
     void create_buffer(map_pointer nstart, map_pointer nfinish); 
     void destroy_buffer(map_pointer nstart, map_pointer nfinish); 
+    pointer take_buffer(); 
+    void recycle_buffer(pointer buf) noexcept; 
+    void release_spare(size_type keep) noexcept; 
 
     // initialize  
     void map_init(size_type nelems); 
@@ -463,6 +525,10 @@ private:
     // insert 
     template <typename ... Args>
     iterator    insert_aux(iterator position, Args&& ...args);
+    template <typename ... Args>
+    iterator    insert_aux(m_true_type, iterator position, Args&& ...args);
+    template <typename ... Args>
+    iterator    insert_aux(m_false_type, iterator position, Args&& ...args);
     void        fill_insert(iterator position, size_type n, const value_type& x);
     template <typename FIter>
     void        copy_insert(iterator, FIter, FIter, size_type);
@@ -474,16 +540,31 @@ private:
 
     // reallocate  
     void require_capacity(size_type n, bool isFront); 
+    bool recenter_map(size_type need, bool at_front); 
     void reallocate_map_at_front(size_type need); 
     void reallocate_map_at_back(size_type need); 
+
+    // relocate 
+    void relocate_range(iterator first, iterator last, iterator result) noexcept; 
+    iterator erase_relocate(iterator first, iterator last); 
 }; 
 
 // copy assign 
-template <typename T> 
-deque<T>& deque<T>:: operator=(const deque& rhs) 
+template <typename T, typename Alloc, size_t BufSize> 
+deque<T, Alloc, BufSize>& deque<T, Alloc, BufSize>:: operator=(const deque& rhs) 
 {
     if(this != &rhs)
     {
+        // 需要传播分配器且两者不相等时，旧空间只能由旧分配器回收
+        if(data_traits::propagate_on_container_copy_assignment::value && 
+            !mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+        {
+            clear(); 
+            data_traits::deallocate(get_alloc(), *_begin.node, buffer_size); 
+            deallocate_map(_map, _map_size); 
+            mystl::alloc_on_copy(get_alloc(), rhs.get_alloc()); 
+            map_init(0); 
+        }
         const auto len = size(); 
         if(len >= rhs.size())
         {
@@ -501,26 +582,49 @@ deque<T>& deque<T>:: operator=(const deque& rhs)
 }
 
 // move assign 
-template <typename T>  
-deque<T>& deque<T>::operator=(deque&& rhs )
+template <typename T, typename Alloc, size_t BufSize>  
+deque<T, Alloc, BufSize>& deque<T, Alloc, BufSize>::operator=(deque&& rhs )
 {
-    clear(); 
-    // 保留的buffer回收了吗？
-    data_allocator::deallocate(*_begin.node, buffer_size);
-    // _map 对应的T* 数组空间回收了吗? 
-    map_allocator::deallocate(_map, _map_size);
+    if(!data_traits::propagate_on_container_move_assignment::value && 
+        !mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+    {
+        // 分配器不相等且不传播：无法接管 rhs 的 buffer，逐个移动元素
+        clear(); 
+        for(auto first = rhs.begin(); first != rhs.end(); ++first)
+        {
+            emplace_back(mystl::move(*first)); 
+        }
+        rhs.clear(); 
+        return *this; 
+    }
+    // 被移动过的 deque 没有 map，无需回收
+    if(_map != nullptr) 
+    {
+        clear(); 
+        // 保留的buffer回收了吗？
+        data_traits::deallocate(get_alloc(), *_begin.node, buffer_size);
+        // _map 对应的T* 数组空间回收了吗? 
+        deallocate_map(_map, _map_size);
+    }
+    mystl::alloc_on_move(get_alloc(), rhs.get_alloc()); 
     _begin = mystl::move(rhs._begin); 
     _end  = mystl::move(rhs._end); 
     _map = rhs._map; 
     _map_size = rhs._map_size; 
     rhs._map = nullptr; 
     rhs._map_size = 0; 
+    // 分配器已随之转移，rhs 的缓存可以接管，超出本对象上限的部分释放
+    _spare = rhs._spare; 
+    _spare_count = rhs._spare_count; 
+    rhs._spare = nullptr; 
+    rhs._spare_count = 0; 
+    release_spare(_spare_limit); 
     return *this;     
 }
 
 // resize container 
-template <typename T> 
-void deque<T>::resize(size_type new_size, const value_type& value)
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::resize(size_type new_size, const value_type& value)
 {
     const auto len = size(); 
     if(new_size < len)
@@ -533,51 +637,89 @@ void deque<T>::resize(size_type new_size, const value_type& value)
     }
 }
 
+// resize_default_init 
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::resize_default_init(size_type new_size)
+{
+    const auto len = size(); 
+    if(new_size < len)
+    {
+        erase(_begin + new_size, _end); 
+    }
+    else 
+    {
+        append_uninitialized(new_size - len); 
+    }
+}
+
+// append_uninitialized 
+template <typename T, typename Alloc, size_t BufSize> 
+mystl::pair<typename deque<T, Alloc, BufSize>::iterator, typename deque<T, Alloc, BufSize>::iterator> 
+deque<T, Alloc, BufSize>::append_uninitialized(size_type n)
+{
+    require_capacity(n, false); 
+    const auto first = _end; 
+    _end = mystl::uninitialized_default_construct_n(_end, n); 
+    return mystl::pair<iterator, iterator>(first, _end); 
+}
+
+// resize_and_overwrite 
+template <typename T, typename Alloc, size_t BufSize> 
+template <typename Op> 
+void deque<T, Alloc, BufSize>::resize_and_overwrite(size_type n, Op op)
+{
+    resize_default_init(n); 
+    size_type kept = 0; 
+    iterator cur = _begin; 
+    while(kept < n) 
+    {
+        const size_type count = std::min(static_cast<size_type>(cur.last - cur.cur), n - kept); 
+        const auto r = static_cast<size_type>(op(cur.cur, count)); 
+        MYSTL_DEBUG(r <= count); 
+        kept += r; 
+        if(r < count) break; 
+        cur += count; 
+    }
+    erase(_begin + kept, _end); 
+}
+
 // shrink_to_fit 
-template <typename T> 
-void deque<T>::shrink_to_fit() noexcept 
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::shrink_to_fit() noexcept 
 {
 
     // at least leave head buffer 
     for(auto cur = _map; cur < _begin.node; ++cur) 
     {
-        data_allocator::deallocate(*cur, buffer_size); 
- 
+        data_traits::deallocate(get_alloc(), *cur, buffer_size); 
+        *cur = nullptr; 
     }
 
-    if(_begin.node == _end.node)
-    {
-        for(auto cur = _end.node + 1; cur < _map + _map_size; ++cur)
-        {
-            data_allocator::deallocate(*cur, buffer_size);
-            *cur = nullptr; 
-        }
-    }
-    else  
+    // [_begin.node, _end.node] 中的 buffer 仍在使用
+    for(auto cur = _end.node + 1; cur < _map + _map_size; ++cur)
     {
-         for(auto cur = _end.node; cur < _map + _map_size; ++cur)
-        {
-            data_allocator::deallocate(*cur, buffer_size);
-            *cur = nullptr; 
-        }
-    }
-    return; 
-    // fixed bug 
-    for(auto cur = _end.node + 1; cur < _map + _map_size; ++cur) 
-    {
-        data_allocator::deallocate(*cur, buffer_size); 
+        data_traits::deallocate(get_alloc(), *cur, buffer_size);
         *cur = nullptr; 
     }
+    release_spare(0); 
+}
+
+// set_buffer_cache_limit: 超出新上限的缓存立即释放
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::set_buffer_cache_limit(size_type n) noexcept 
+{
+    _spare_limit = cacheable ? n : 0; 
+    release_spare(_spare_limit); 
 }
 
 // emplace_front 
-template <typename T> 
+template <typename T, typename Alloc, size_t BufSize> 
 template <typename ...Args>   
-void deque<T>::emplace_front(Args&&...args) 
+void deque<T, Alloc, BufSize>::emplace_front(Args&&...args) 
 {
     if(_begin.cur != _begin.first)
     {
-        data_allocator::construct(_begin.cur -1, mystl::forward<Args>(args)...); 
+        data_traits::construct(get_alloc(), _begin.cur -1, mystl::forward<Args>(args)...); 
         --_begin.cur; 
     }
     else  
@@ -587,7 +729,7 @@ void deque<T>::emplace_front(Args&&...args)
         try
         {
             --_begin; 
-            data_allocator::construct(_begin.cur, mystl::forward<Args>(args)...); 
+            data_traits::construct(get_alloc(), _begin.cur, mystl::forward<Args>(args)...); 
         }
         catch(...)
         {
@@ -598,27 +740,27 @@ void deque<T>::emplace_front(Args&&...args)
 }
 
 // emplace at back 
-template <typename T>  
+template <typename T, typename Alloc, size_t BufSize>  
 template <typename ...Args> 
-void deque<T>::emplace_back(Args&&...args) 
+void deque<T, Alloc, BufSize>::emplace_back(Args&&...args) 
 {
     if(_end.cur != _end.last - 1) 
     {
-        data_allocator::construct(_end.cur, mystl::forward<Args>(args)...); 
+        data_traits::construct(get_alloc(), _end.cur, mystl::forward<Args>(args)...); 
         ++_end.cur; 
     }
     else  
     {
         require_capacity(1, false); 
-        data_allocator::construct(_end.cur, mystl::forward<Args>(args)...); 
+        data_traits::construct(get_alloc(), _end.cur, mystl::forward<Args>(args)...); 
         ++_end; // 跨越了buffer 不连续 
     }
 }
 
 // pos 处就地构造元素 
-template<typename T> 
+template <typename T, typename Alloc, size_t BufSize> 
 template<typename ... Args>  
-typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&&... args) 
+typename deque<T, Alloc, BufSize>::iterator deque<T, Alloc, BufSize>::emplace(iterator pos, Args&&... args) 
 {
     if(pos.cur == _begin.cur)
     {
@@ -634,12 +776,12 @@ typename deque<T>::iterator deque<T>::emplace(iterator pos, Args&&... args)
 }
 
 // push_front 
-template <typename T> 
-void deque<T>::push_front(const value_type& value) 
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::push_front(const value_type& value) 
 {
     if(_begin.cur != _begin.first)
     {
-        data_allocator::construct(_begin.cur-1, value); 
+        data_traits::construct(get_alloc(), _begin.cur-1, value); 
         --_begin.cur; 
     }
     else 
@@ -648,7 +790,7 @@ void deque<T>::push_front(const value_type& value)
         try
         {
             --_begin; 
-            data_allocator::construct(_begin.cur, value); 
+            data_traits::construct(get_alloc(), _begin.cur, value); 
         }
         catch(...)
         {
@@ -659,62 +801,62 @@ void deque<T>::push_front(const value_type& value)
 }
 
 // push_back
-template <typename T> 
-void deque<T>::push_back(const value_type& value)
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::push_back(const value_type& value)
 {
     if(_end.cur != _end.last - 1)
     {
-        data_allocator::construct(_end.cur, value);  // Invalid write of size 4
+        data_traits::construct(get_alloc(), _end.cur, value);  // Invalid write of size 4
         ++_end.cur; 
     }
     else 
     {
         require_capacity(1, false); 
-        data_allocator::construct(_end.cur, value); 
+        data_traits::construct(get_alloc(), _end.cur, value); 
         ++_end; 
     }
 }
 
 // pop front 
-template <typename T>  
-void deque<T>::pop_front() 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::pop_front() 
 {
     MYSTL_DEBUG(!empty()); 
     if(_begin.cur != _begin.last - 1) 
     {
-        data_allocator::destroy(_begin.cur); 
+        data_traits::destroy(get_alloc(), _begin.cur); 
         ++_begin.cur; 
     }
     else   
     {
-        data_allocator::destroy(_begin.cur); 
+        data_traits::destroy(get_alloc(), _begin.cur); 
         ++_begin; 
         destroy_buffer(_begin.node - 1, _begin.node - 1); 
     }
 }
 
 // pop back  
-template <typename T>  
-void deque<T>::pop_back () 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::pop_back () 
 {
     MYSTL_DEBUG(!empty()); 
     if(_end.cur != _end.first)
     {
         --_end.cur; 
-        data_allocator::destroy(_end.cur); 
+        data_traits::destroy(get_alloc(), _end.cur); 
     }
     else  
     {
         --_end; 
-        data_allocator::destroy(_end.cur); 
+        data_traits::destroy(get_alloc(), _end.cur); 
         destroy_buffer(_end.node+1, _end.node + 1); 
     }
 }
 
 // insert at pos 
-template <typename T> 
-typename deque<T>::iterator  
-deque<T>:: insert(iterator pos, const value_type& value) 
+template <typename T, typename Alloc, size_t BufSize> 
+typename deque<T, Alloc, BufSize>::iterator  
+deque<T, Alloc, BufSize>:: insert(iterator pos, const value_type& value) 
 {
     if(pos.cur == _begin.cur)
     {
@@ -734,9 +876,9 @@ deque<T>:: insert(iterator pos, const value_type& value)
     }
 }
 
-template <typename T>  
-typename deque<T>::iterator  
-deque<T>::insert(iterator pos, value_type&& value) 
+template <typename T, typename Alloc, size_t BufSize>  
+typename deque<T, Alloc, BufSize>::iterator  
+deque<T, Alloc, BufSize>::insert(iterator pos, value_type&& value) 
 {
     if(pos.cur == _begin.cur)
     {
@@ -757,8 +899,8 @@ deque<T>::insert(iterator pos, value_type&& value)
 }
 
 // insert n elems at pos  
-template <typename T>  
-void deque<T>::insert(iterator pos, size_type n, const value_type& value) 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::insert(iterator pos, size_type n, const value_type& value) 
 {
     if(pos.cur == _begin.cur)
     {
@@ -781,52 +923,64 @@ void deque<T>::insert(iterator pos, size_type n, const value_type& value)
 }
 
 // erase elem at pos  
-template <typename T>  
-typename deque<T>::iterator  
-deque<T>::erase(iterator pos) 
+template <typename T, typename Alloc, size_t BufSize>  
+typename deque<T, Alloc, BufSize>::iterator  
+deque<T, Alloc, BufSize>::erase(iterator pos) 
 {
+    if(mystl::is_trivially_relocatable<value_type>::value) 
+    {
+        auto next = pos; 
+        ++next; 
+        return erase_relocate(pos, next); 
+    }
     auto next = pos; 
     ++next; 
     const size_type elems_before = pos - _begin; 
     if(elems_before < size() / 2) 
     {
-        std::copy_backward(_begin, pos, next); 
+        std::move_backward(_begin, pos, next); 
         pop_front(); 
     }
     else  
     {   
-        std::copy(next, _end, pos); 
+        std::move(next, _end, pos); 
         pop_back(); 
     }
     return next;
 }
 
 // erase [first, last)  
-template <typename T>  
-typename deque<T>::iterator 
-deque<T>::erase(iterator first, iterator last) 
+template <typename T, typename Alloc, size_t BufSize>  
+typename deque<T, Alloc, BufSize>::iterator 
+deque<T, Alloc, BufSize>::erase(iterator first, iterator last) 
 {
     if(first == _begin && last == _end)
     {
         clear(); 
         return _end; 
     }
+    else if(mystl::is_trivially_relocatable<value_type>::value) 
+    {
+        return erase_relocate(first, last); 
+    }
     else 
     {
         const size_type len = last - first; 
         const size_type elems_before = first - _begin; 
         if(elems_before < (size() - len)/ 2) 
         {
-            std::copy_backward(_begin, first, last); 
+            std::move_backward(_begin, first, last); 
             auto new_begin = _begin + len; 
-            data_allocator::destroy(_begin.cur, new_begin.cur); 
+            mystl::destroy(_begin, new_begin); 
+            destroy_buffer(_begin.node, new_begin.node - 1); 
             _begin = new_begin;  
         }
         else  
         { 
-            std::copy(last, _end, first); 
+            std::move(last, _end, first); 
             auto new_end = _end - len; 
-            data_allocator::destroy(new_end.cur, _end.cur); 
+            mystl::destroy(new_end, _end); 
+            destroy_buffer(new_end.node + 1, _end.node); 
             _end = new_end; 
         }
         return _begin + elems_before; 
@@ -834,13 +988,13 @@ deque<T>::erase(iterator first, iterator last)
 }
 
 // clear deque 
-template <typename T>  
-void deque<T>:: clear()  
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>:: clear()  
 {
     // clear keeps only head buffer objects(elements) alive  
     for(map_pointer cur = _begin.node + 1; cur < _end.node; ++cur)
     {
-        data_allocator::destroy(*cur, *cur + buffer_size); 
+        data_traits::destroy(get_alloc(), *cur, *cur + buffer_size); 
     }
 
     // more than one buffer 
@@ -853,13 +1007,13 @@ void deque<T>:: clear()
     {
         mystl::destroy(_begin.cur, _end.cur); 
     }
-    shrink_to_fit(); 
     _end = _begin; 
+    shrink_to_fit(); 
 }
 
 // swap two deques  
-template <typename T> 
-void deque<T>:: swap(deque& rhs) noexcept  
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>:: swap(deque& rhs) noexcept  
 {
     if(this != &rhs) 
     {
@@ -867,18 +1021,23 @@ void deque<T>:: swap(deque& rhs) noexcept
         std::swap(_end, rhs._end); 
         std::swap(_map, rhs._map); 
         std::swap(_map_size, rhs._map_size); 
+        std::swap(_spare, rhs._spare); 
+        std::swap(_spare_count, rhs._spare_count); 
+        std::swap(_spare_limit, rhs._spare_limit); 
+        mystl::alloc_on_swap(get_alloc(), rhs.get_alloc()); 
     }
 }
 
 // auxiliary methods 
 
 //  create_map; 
-template <typename T> 
-typename deque<T>::map_pointer  
-deque<T>::create_map(size_type size) 
+template <typename T, typename Alloc, size_t BufSize> 
+typename deque<T, Alloc, BufSize>::map_pointer  
+deque<T, Alloc, BufSize>::create_map(size_type size) 
 {
     map_pointer mp = nullptr; 
-    mp = map_allocator::allocate(size);  
+    map_allocator ma(get_alloc()); 
+    mp = map_traits::allocate(ma, size);  
     for(auto i = 0; i < size; ++i)   
     {
         mp[i] = nullptr; 
@@ -886,16 +1045,24 @@ deque<T>::create_map(size_type size)
     return mp; 
 }
 
+// deallocate_map 
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::deallocate_map(map_pointer mp, size_type size) 
+{
+    map_allocator ma(get_alloc()); 
+    map_traits::deallocate(ma, mp, size); 
+}
+
 // create buffer  
-template <typename T>  
-void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish) 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::create_buffer(map_pointer nstart, map_pointer nfinish) 
 {
     map_pointer cur; 
     try
     {
         for(cur = nstart; cur <= nfinish; ++cur) 
         {
-            *cur = data_allocator::allocate(buffer_size); 
+            *cur = take_buffer(); 
         }
     }
     catch(...)
@@ -903,7 +1070,7 @@ void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
         while(cur != nstart)
         {
             --cur; 
-            data_allocator::deallocate(*cur, buffer_size); 
+            recycle_buffer(*cur); 
             *cur = nullptr; 
         }
         throw; 
@@ -911,19 +1078,62 @@ void deque<T>::create_buffer(map_pointer nstart, map_pointer nfinish)
 }
 
 //destroy_buffer 
-template <typename T> 
-void deque<T>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::destroy_buffer(map_pointer nstart, map_pointer nfinish)
 {
     for(map_pointer n= nstart; n <= nfinish; ++n)
     {
-        data_allocator::deallocate(*n, buffer_size); 
+        recycle_buffer(*n); 
         *n = nullptr; 
     }
 }
 
+// take_buffer: 优先取用缓存中的缓冲区
+template <typename T, typename Alloc, size_t BufSize> 
+typename deque<T, Alloc, BufSize>::pointer 
+deque<T, Alloc, BufSize>::take_buffer() 
+{
+    if(_spare == nullptr) 
+    {
+        return data_traits::allocate(get_alloc(), buffer_size); 
+    }
+    pointer buf = _spare; 
+    std::memcpy(static_cast<void*>(&_spare), static_cast<const void*>(buf), sizeof(pointer)); 
+    --_spare_count; 
+    return buf; 
+}
+
+// recycle_buffer: 缓存未满时放入链表，否则释放
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::recycle_buffer(pointer buf) noexcept 
+{
+    if(buf == nullptr) return; 
+    if(!cacheable || _spare_count >= _spare_limit) 
+    {
+        data_traits::deallocate(get_alloc(), buf, buffer_size); 
+        return; 
+    }
+    std::memcpy(static_cast<void*>(buf), static_cast<const void*>(&_spare), sizeof(pointer)); 
+    _spare = buf; 
+    ++_spare_count; 
+}
+
+// release_spare: 释放缓存，只保留 keep 个
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>::release_spare(size_type keep) noexcept 
+{
+    while(_spare_count > keep) 
+    {
+        pointer buf = _spare; 
+        std::memcpy(static_cast<void*>(&_spare), static_cast<const void*>(buf), sizeof(pointer)); 
+        --_spare_count; 
+        data_traits::deallocate(get_alloc(), buf, buffer_size); 
+    }
+}
+
 // map init  
-template <typename T>  
-void deque<T>:: map_init(size_type nElems) 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>:: map_init(size_type nElems) 
 {
     const size_type nNodes = nElems / buffer_size + 1; 
     _map_size = std::max(static_cast<size_type>(DEQUE_MAP_INIT_SIZE), nNodes + 2); 
@@ -948,7 +1158,7 @@ void deque<T>:: map_init(size_type nElems)
     }
     catch(...)
     {
-        map_allocator::deallocate(_map, _map_size); 
+        deallocate_map(_map, _map_size); 
         _map = nullptr; 
         _map_size = 0; 
         throw; 
@@ -961,8 +1171,8 @@ void deque<T>:: map_init(size_type nElems)
 }
 
 // fill_init 
-template <typename T> 
-void deque<T>:: fill_init(size_type n, const value_type& value) 
+template <typename T, typename Alloc, size_t BufSize> 
+void deque<T, Alloc, BufSize>:: fill_init(size_type n, const value_type& value) 
 {
     map_init(n); 
     if(n != 0) 
@@ -976,9 +1186,9 @@ void deque<T>:: fill_init(size_type n, const value_type& value)
 }
 
 // copy_init 
-template <typename T> 
+template <typename T, typename Alloc, size_t BufSize> 
 template <typename InputIter>   
-void deque<T>:: copy_init(InputIter first, InputIter last, input_iterator_tag) 
+void deque<T, Alloc, BufSize>:: copy_init(InputIter first, InputIter last, input_iterator_tag) 
 {
     const size_type n = mystl::distance(first, last);  
     map_init(n); 
@@ -989,9 +1199,9 @@ void deque<T>:: copy_init(InputIter first, InputIter last, input_iterator_tag)
 }
 
 // copy_init: forward_iterator  
-template <typename T>  
+template <typename T, typename Alloc, size_t BufSize>  
 template <typename ForwardIter>  
-void deque<T>:: copy_init(ForwardIter first, ForwardIter last, forward_iterator_tag)
+void deque<T, Alloc, BufSize>:: copy_init(ForwardIter first, ForwardIter last, forward_iterator_tag)
 {
     const size_type n = mystl::distance(first, last); 
     map_init(n); 
@@ -1000,13 +1210,14 @@ void deque<T>:: copy_init(ForwardIter first, ForwardIter last, forward_iterator_
         auto next = first; 
         mystl::advance(next, buffer_size); 
         mystl::uninitialized_copy(first, next, *cur); 
+        first = next; 
     }
     mystl::uninitialized_copy(first, last, _end.first); 
 }
 
 // fill_assign 
-template<typename T>  
-void deque<T>::fill_assign(size_type n, const value_type& value) 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::fill_assign(size_type n, const value_type& value) 
 {
     if( size() < n) 
     {
@@ -1022,9 +1233,9 @@ void deque<T>::fill_assign(size_type n, const value_type& value)
 }
 
 // copy assign 
-template <typename T>  
+template <typename T, typename Alloc, size_t BufSize>  
 template <typename InputIter>  
-void deque<T>:: copy_assign(InputIter first, InputIter last, input_iterator_tag) 
+void deque<T, Alloc, BufSize>:: copy_assign(InputIter first, InputIter last, input_iterator_tag) 
 {
     auto first1 = begin(); 
     auto last1 = end(); 
@@ -1043,9 +1254,9 @@ void deque<T>:: copy_assign(InputIter first, InputIter last, input_iterator_tag)
     }
 }
 
-template <typename T> 
+template <typename T, typename Alloc, size_t BufSize> 
 template <typename ForwardIter>  
-void deque<T>:: copy_assign (ForwardIter first, ForwardIter last, forward_iterator_tag)
+void deque<T, Alloc, BufSize>:: copy_assign (ForwardIter first, ForwardIter last, forward_iterator_tag)
 {
     const size_type len1 = size(); 
     const size_type len2 = mystl::distance(first, last); 
@@ -1063,17 +1274,70 @@ void deque<T>:: copy_assign (ForwardIter first, ForwardIter last, forward_iterat
 }
 
 // insert_aux  
-template <typename T> 
+template <typename T, typename Alloc, size_t BufSize> 
+template <typename ...Args>  
+typename deque<T, Alloc, BufSize>::iterator  
+deque<T, Alloc, BufSize>::insert_aux(iterator pos, Args&& ... args) 
+{
+    return insert_aux(mystl::is_trivially_relocatable<value_type>{}, pos, mystl::forward<Args>(args)...); 
+}
+
+// 可平凡重定位: 在临时空间构造新元素，把较短的一侧按缓冲区整段搬移一位，再把新元素搬入
+template <typename T, typename Alloc, size_t BufSize> 
+template <typename ...Args>  
+typename deque<T, Alloc, BufSize>::iterator  
+deque<T, Alloc, BufSize>::insert_aux(m_true_type, iterator pos, Args&& ... args) 
+{
+    const size_type elems_before = pos - _begin; 
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf; 
+    auto tmp = reinterpret_cast<pointer>(&buf); 
+    data_traits::construct(get_alloc(), tmp, mystl::forward<Args>(args)...); 
+    if(elems_before < size() / 2) 
+    {
+        try
+        {
+            require_capacity(1, true); 
+        }
+        catch(...)
+        {
+            data_traits::destroy(get_alloc(), tmp); 
+            throw; 
+        }
+        auto new_begin = _begin - 1; 
+        relocate_range(_begin, _begin + elems_before, new_begin); 
+        _begin = new_begin; 
+    }
+    else  
+    {
+        try
+        {
+            require_capacity(1, false); 
+        }
+        catch(...)
+        {
+            data_traits::destroy(get_alloc(), tmp); 
+            throw; 
+        }
+        auto first = _begin + elems_before; 
+        relocate_range(first, _end, first + 1); 
+        ++_end; 
+    }
+    pos = _begin + elems_before; 
+    mystl::uninitialized_relocate(tmp, tmp + 1, pos.cur); 
+    return pos; 
+}
+
+template <typename T, typename Alloc, size_t BufSize> 
 template <typename ...Args>  
-typename deque<T>::iterator  
-deque<T>::insert_aux(iterator pos, Args&& ... args) 
+typename deque<T, Alloc, BufSize>::iterator  
+deque<T, Alloc, BufSize>::insert_aux(m_false_type, iterator pos, Args&& ... args) 
 {
     const size_type elems_before = pos - _begin; 
     value_type value_copy = value_type(mystl::forward<Args>(args)...); 
     if(elems_before < size()/ 2) 
     {
         // insert at first half 
-        emplace_front(front()); 
+        emplace_front(mystl::move_if_noexcept(front())); 
         auto front1 = _begin; 
         ++front1; 
         auto front2 = front1; 
@@ -1081,27 +1345,27 @@ deque<T>::insert_aux(iterator pos, Args&& ... args)
         pos = _begin + elems_before; 
         auto pos1 = pos; 
         ++pos1; 
-        std::copy(front2, pos1, front1); 
+        std::move(front2, pos1, front1); 
     }
 
     else  
     {
         // insert at second half 
-        emplace_back(back()); 
+        emplace_back(mystl::move_if_noexcept(back())); 
         auto back1 = end(); 
         --back1; 
         auto back2 = back1; 
         --back2; 
         pos = _begin + elems_before; 
-        std::copy_backward(pos, back2, back1); 
+        std::move_backward(pos, back2, back1); 
     }
     *pos = mystl::move(value_copy); 
     return pos; 
 } 
 
 // fill_insert 
-template<typename T>  
-void deque<T>::fill_insert(iterator pos, size_type n, const value_type& value) 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::fill_insert(iterator pos, size_type n, const value_type& value) 
 {
     const size_type elems_before = pos - _begin; 
     const size_type len = size(); 
@@ -1118,15 +1382,15 @@ void deque<T>::fill_insert(iterator pos, size_type n, const value_type& value)
             if(elems_before >= n) 
             {
                 auto _begin_n = _begin + n; 
-                std::uninitialized_copy(_begin, _begin_n, new_begin); 
+                mystl::uninitialized_move_if_noexcept(_begin, _begin_n, new_begin); 
                 _begin = new_begin; 
-                std::copy(_begin_n, pos, old_begin); 
+                std::move(_begin_n, pos, old_begin); 
                 std::fill(pos - n, pos, value_copy); 
              }
             else  
             {
                 std::uninitialized_fill(
-                    std::uninitialized_copy(_begin, pos, new_begin), _begin, value_copy); 
+                    mystl::uninitialized_move_if_noexcept(_begin, pos, new_begin), _begin, value_copy); 
                 _begin = new_begin; 
                 std::fill(old_begin, pos, value_copy); 
             }
@@ -1151,16 +1415,16 @@ void deque<T>::fill_insert(iterator pos, size_type n, const value_type& value)
             if(elems_after > n) 
             {
                 auto _end_n = _end - n; 
-                std::uninitialized_copy(_end_n, _end, _end); 
+                mystl::uninitialized_move_if_noexcept(_end_n, _end, _end); 
                 _end = new_end; 
-                std::copy_backward(pos, _end_n, old_end); 
+                std::move_backward(pos, _end_n, old_end); 
                 std::fill(pos, pos + n, value_copy); 
             }
             else  
             {
                 std::uninitialized_fill(_end, pos +n, value_copy); 
-                std::uninitialized_copy(pos, _end, pos + n); 
-                _end - new_end; 
+                mystl::uninitialized_move_if_noexcept(pos, _end, pos + n); 
+                _end = new_end; 
                 std::fill(pos, old_end, value_copy); 
             }
         }
@@ -1174,9 +1438,9 @@ void deque<T>::fill_insert(iterator pos, size_type n, const value_type& value)
 }
 
 // copy insert 
-template <typename T>  
+template <typename T, typename Alloc, size_t BufSize>  
 template <typename ForwardIter>  
-void deque<T>::copy_insert(iterator pos, ForwardIter first, ForwardIter last, size_type n) 
+void deque<T, Alloc, BufSize>::copy_insert(iterator pos, ForwardIter first, ForwardIter last, size_type n) 
 {
     const size_type elems_before = pos - _begin; 
     auto len = size(); 
@@ -1193,16 +1457,16 @@ void deque<T>::copy_insert(iterator pos, ForwardIter first, ForwardIter last, si
             if(elems_before >= n) 
             {
                 auto _begin_n = _begin + n; 
-                std::uninitialized_copy(_begin, _begin + n, new_begin); 
+                mystl::uninitialized_move_if_noexcept(_begin, _begin + n, new_begin); 
                 _begin = new_begin; 
-                std::copy(_begin_n, pos, old_begin); 
+                std::move(_begin_n, pos, old_begin); 
                 std::copy(first, last, pos - n); 
             }
             else  
             {
                 auto mid = first; 
                 mystl::advance(mid, n - elems_before); 
-                std::uninitialized_copy(first, mid, std::uninitialized_copy
+                std::uninitialized_copy(first, mid, mystl::uninitialized_move_if_noexcept
                 (_begin, pos, new_begin)); 
                 _begin = new_begin; 
                 std::copy(mid, last, old_begin); 
@@ -1230,16 +1494,16 @@ void deque<T>::copy_insert(iterator pos, ForwardIter first, ForwardIter last, si
             if(elems_after > n) 
             {
                 auto _end_n = _end - n; 
-                std::uninitialized_copy(_end_n, _end, _end); 
+                mystl::uninitialized_move_if_noexcept(_end_n, _end, _end); 
                 _end = new_end; 
-                std::copy_backward(pos, _end_n, old_end); 
+                std::move_backward(pos, _end_n, old_end); 
                 std::copy(first, last, pos); 
             }
             else  
             {
                 auto mid = first; 
                 mystl::advance(mid, elems_after); 
-                std::uninitialized_copy(pos, _end, 
+                mystl::uninitialized_move_if_noexcept(pos, _end, 
                 std::uninitialized_copy(mid, last, _end)); 
                 _end = new_end; 
                 std::copy(first, mid, pos); 
@@ -1255,9 +1519,9 @@ void deque<T>::copy_insert(iterator pos, ForwardIter first, ForwardIter last, si
 }
 
 // insert_dispatch 
-template <typename T>  
+template <typename T, typename Alloc, size_t BufSize>  
 template <typename Iter>  
-void deque<T>::  
+void deque<T, Alloc, BufSize>::  
 insert_dispatch(iterator pos, Iter first, Iter last, input_iterator_tag)
 {
     if(last <= first ) return; 
@@ -1281,9 +1545,9 @@ insert_dispatch(iterator pos, Iter first, Iter last, input_iterator_tag)
     }
 }
 
-template <typename T>  
+template <typename T, typename Alloc, size_t BufSize>  
 template <typename Iter>  
-void deque<T>::  
+void deque<T, Alloc, BufSize>::  
 insert_dispatch(iterator pos, Iter first, Iter last, forward_iterator_tag) 
 {
     if(last <= first) return; 
@@ -1327,8 +1591,8 @@ insert_dispatch(iterator pos, Iter first, Iter last, forward_iterator_tag)
 }
 
 // require_capacity 
-template <typename T>
-void deque<T>:: require_capacity (size_type n, bool isFront)  
+template <typename T, typename Alloc, size_t BufSize>
+void deque<T, Alloc, BufSize>:: require_capacity (size_type n, bool isFront)  
 {
     if(isFront && (static_cast<size_type>(_begin.cur - _begin.first) < n)) 
     {
@@ -1352,10 +1616,45 @@ void deque<T>:: require_capacity (size_type n, bool isFront)
     }
 }
 
+// recenter_map 
+// map 中空闲节点不少于一半时，把在用节点就地居中，不再重新分配 map
+// 队列式使用 (一端进一端出) 时在用节点会沿 map 漂移，否则 map 会无限翻倍
+template <typename T, typename Alloc, size_t BufSize>  
+bool deque<T, Alloc, BufSize>::recenter_map(size_type need_buffer, bool at_front) 
+{
+    const size_type old_buffer = _end.node - _begin.node + 1; 
+    const size_type new_buffer = old_buffer + need_buffer; 
+    if(_map_size < 2 * new_buffer) return false; 
+
+    // 在用区间之外的节点先归还缓冲区，之后整体清空
+    destroy_buffer(_map, _begin.node - 1); 
+    destroy_buffer(_end.node + 1, _map + _map_size - 1); 
+
+    auto begin = _map + (_map_size - new_buffer) / 2; 
+    auto mid = at_front ? begin + need_buffer : begin; 
+    const difference_type begin_off = _begin.cur - _begin.first; 
+    const difference_type end_off = _end.cur - _end.first; 
+    if(mid < _begin.node) 
+        std::copy(_begin.node, _end.node + 1, mid); 
+    else 
+        std::copy_backward(_begin.node, _end.node + 1, mid + old_buffer); 
+    std::fill(_map, mid, nullptr); 
+    std::fill(mid + old_buffer, _map + _map_size, nullptr); 
+    _begin = iterator(*mid + begin_off, mid); 
+    _end = iterator(*(mid + old_buffer - 1) + end_off, mid + old_buffer - 1); 
+
+    if(at_front) 
+        create_buffer(begin, mid - 1); 
+    else 
+        create_buffer(mid + old_buffer, mid + old_buffer + need_buffer - 1); 
+    return true; 
+}
+
 // reallocate_map_at_front 
-template <typename T>  
-void deque<T>::reallocate_map_at_front(size_type need_buffer)
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::reallocate_map_at_front(size_type need_buffer)
 {
+    if(recenter_map(need_buffer, true)) return; 
     const size_type new_map_size = std::max(_map_size * 2, 
         _map_size + need_buffer); 
 
@@ -1368,13 +1667,10 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer)
     auto mid = begin + need_buffer; 
     auto end = mid + old_buffer; 
     create_buffer(begin, mid - 1); 
-    for(auto begin1 = mid, begin2 = _begin.node; begin1 != end; ++begin1, ++begin2)
-    {
-        *begin1 = *begin2; 
-    }
+    mystl::uninitialized_relocate(_begin.node, _end.node + 1, mid); 
 
     // update data 
-    map_allocator::deallocate(_map, _map_size); 
+    deallocate_map(_map, _map_size); 
     _map = new_map;
     _map_size = new_map_size;
     _begin = iterator(*mid + (_begin.cur - _begin.first), mid); 
@@ -1387,9 +1683,10 @@ void deque<T>::reallocate_map_at_front(size_type need_buffer)
 
 
 // reallocate_map_at_back
-template<typename T>  
-void deque<T>::reallocate_map_at_back(size_type need_buffer) 
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::reallocate_map_at_back(size_type need_buffer) 
 {
+    if(recenter_map(need_buffer, false)) return; 
     const size_type new_map_size = 
         std::max(_map_size *2, _map_size + need_buffer + DEQUE_MAP_INIT_SIZE); 
     map_pointer new_map = create_map(new_map_size); 
@@ -1400,64 +1697,133 @@ void deque<T>::reallocate_map_at_back(size_type need_buffer)
     auto begin = new_map + ((new_map_size - new_buffer)/2); 
     auto mid = begin + old_buffer; 
     auto end = mid + need_buffer; 
-    for(auto begin1 = begin, begin2 = _begin.node; begin1 != mid; ++begin1, ++begin2) 
-    {
-        *begin1 = *begin2;  
-    }
+    mystl::uninitialized_relocate(_begin.node, _end.node + 1, begin); 
     create_buffer(mid, end - 1); 
 
     // update data  
-    map_allocator::deallocate(_map, _map_size); 
+    deallocate_map(_map, _map_size); 
     _map = new_map; 
     _map_size = new_map_size; 
     _begin = iterator(*begin +(_begin.cur - _begin.first), begin); 
     _end = iterator(*(mid - 1) + (_end.cur - _end.first), mid - 1); 
 }
 
+// relocate_range 
+// 把 [first, last) 重定位到 result 开始的位置，仅用于可平凡重定位的类型
+// 按缓冲区分段 memmove: 向前搬移时从头开始，向后搬移时从尾开始，因此允许区间重叠
+template <typename T, typename Alloc, size_t BufSize>  
+void deque<T, Alloc, BufSize>::relocate_range(iterator first, iterator last, iterator result) noexcept
+{
+    if(result < first) 
+    {
+        while(first != last) 
+        {
+            difference_type n = last - first; 
+            n = std::min(n, static_cast<difference_type>(first.last - first.cur)); 
+            n = std::min(n, static_cast<difference_type>(result.last - result.cur)); 
+            mystl::uninitialized_relocate_n(first.cur, n, result.cur); 
+            first += n; 
+            result += n; 
+        }
+    }
+    else if(first < result) 
+    {
+        auto result_last = result + (last - first); 
+        while(first != last) 
+        {
+            // 位于缓冲区开头的迭代器，其前一段是上一个缓冲区的全部
+            difference_type n = last - first; 
+            n = std::min(n, last.cur == last.first ? 
+                static_cast<difference_type>(buffer_size) : static_cast<difference_type>(last.cur - last.first)); 
+            n = std::min(n, result_last.cur == result_last.first ? 
+                static_cast<difference_type>(buffer_size) : static_cast<difference_type>(result_last.cur - result_last.first)); 
+            last -= n; 
+            result_last -= n; 
+            mystl::uninitialized_relocate_n(last.cur, n, result_last.cur); 
+        }
+    }
+}
+
+// erase_relocate 
+// 可平凡重定位时的区间删除: 析构 [first, last)，把较短的一侧整段搬移过来填补空位
+template <typename T, typename Alloc, size_t BufSize>  
+typename deque<T, Alloc, BufSize>::iterator 
+deque<T, Alloc, BufSize>::erase_relocate(iterator first, iterator last) 
+{
+    const size_type len = last - first; 
+    const size_type elems_before = first - _begin; 
+    mystl::destroy(first, last); 
+    if(elems_before < (size() - len) / 2) 
+    {
+        auto new_begin = _begin + len; 
+        relocate_range(_begin, first, new_begin); 
+        destroy_buffer(_begin.node, new_begin.node - 1); 
+        _begin = new_begin; 
+    }
+    else  
+    {
+        auto new_end = _end - len; 
+        relocate_range(last, _end, first); 
+        destroy_buffer(new_end.node + 1, _end.node); 
+        _end = new_end; 
+    }
+    return _begin + elems_before; 
+}
+
 // overloading relational operators  
-template <typename T> 
-bool operator== (const deque<T>& lhs, const deque<T>& rhs)
+template <typename T, typename Alloc, size_t BufSize> 
+bool operator== (const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs)
 {
     return lhs.size() == rhs.size() &&  
         std::equal(lhs.begin(), lhs.end(), rhs.begin()); 
 }
 
-template <typename T>  
-bool operator< (const deque<T>& lhs, const deque<T>& rhs) 
+template <typename T, typename Alloc, size_t BufSize>  
+bool operator< (const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs) 
 {
     return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); 
 }
 
-template<typename T>  
-bool operator!=(const deque<T>& lhs, const deque<T>& rhs) 
+template <typename T, typename Alloc, size_t BufSize>  
+bool operator!=(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs) 
 {
     return !(lhs == rhs); 
 }
 
-template<typename T>  
-bool operator>(const deque<T>& lhs, const deque<T>& rhs) 
+template <typename T, typename Alloc, size_t BufSize>  
+bool operator>(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs) 
 {
     return rhs < lhs; 
 }
 
-template <typename T> 
-bool operator<=(const deque<T>& lhs, const deque<T>&rhs)
+template <typename T, typename Alloc, size_t BufSize> 
+bool operator<=(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>&rhs)
 {
     return !(rhs < lhs); 
 }
 
-template <typename T>  
-bool operator>=(const deque<T>& lhs, const deque<T>& rhs) 
+template <typename T, typename Alloc, size_t BufSize>  
+bool operator>=(const deque<T, Alloc, BufSize>& lhs, const deque<T, Alloc, BufSize>& rhs) 
 {
     return !(lhs < rhs); 
 }
 
 // overloading generic swap  
-template <typename T> 
-void swap(deque<T>& lhs, deque<T>& rhs) 
+template <typename T, typename Alloc, size_t BufSize> 
+void swap(deque<T, Alloc, BufSize>& lhs, deque<T, Alloc, BufSize>& rhs) 
 {
     lhs.swap(rhs); 
 }
 
+// deque 的迭代器与 map 都指向堆空间，分配器可平凡重定位时 deque 也可以
+template <typename T, typename Alloc, size_t BufSize> 
+struct is_trivially_relocatable<mystl::deque<T, Alloc, BufSize>>: is_trivially_relocatable<Alloc> {}; 
+
+namespace pmr
+{
+template <typename T>
+using deque = mystl::deque<T, polymorphic_allocator<T>>;
+}
+
 } // end of mystl 
 #endif // !_DEQUE_H_
\ No newline at end of file
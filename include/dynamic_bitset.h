@@ -0,0 +1,642 @@
+// -- dynamic_bitset.h 长度可变的位集合 dynamic_bitset
+// vector<bool> 在 mystl 中被禁用，dynamic_bitset 以 64 位的字为单位存放位
+#ifndef DYNAMIC_BITSET_H_
+#define DYNAMIC_BITSET_H_
+
+// notes:
+// * 第 i 位存放在第 i / 64 个字的第 i % 64 位，最后一个字中超出 size() 的位始终为 0
+// * 整字运算 (&=, |=, ^=, -=, 取反) 与 count()、find_first / find_next 对空字的跳过
+//   由 bitset_kernels 完成，首次使用时按 CPU 选择实现:
+//   - generic: 逐字循环，交给编译器自动向量化
+//   - popcnt : count() 使用 popcnt 指令
+//   - avx2   : 每次处理 256 位，count() 使用 vpshufb 查表 (Mula 算法)
+//   只在 GCC / Clang 的 x86 上有后两者，定义 MYSTL_BITSET_SIMD 为 0 可以关闭
+// * 字内的查找使用 __builtin_ctzll，编译为 tzcnt (rep bsf)
+// * 两个 dynamic_bitset 之间的运算要求长度相同
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "vector.h"
+#include "exceptdef.h"
+
+#ifndef MYSTL_BITSET_SIMD
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MYSTL_BITSET_SIMD 1
+#else
+#define MYSTL_BITSET_SIMD 0
+#endif
+#endif
+
+#if MYSTL_BITSET_SIMD
+#include <immintrin.h>
+#endif
+
+namespace mystl
+{
+
+// 单个字的 popcount 与末尾 0 的个数，ctz 要求 w != 0
+inline size_t bitset_popcount(uint64_t w) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_popcountll(w));
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ULL);
+    w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return static_cast<size_t>((w * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+inline size_t bitset_ctz(uint64_t w) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctzll(w));
+#else
+    size_t n = 0;
+    for(; (w & 1) == 0; w >>= 1) ++n;
+    return n;
+#endif
+}
+
+// 整字运算的几组实现
+struct bitset_generic
+{
+    static void and_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i) dst[i] &= src[i];
+    }
+    static void or_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i) dst[i] |= src[i];
+    }
+    static void xor_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i) dst[i] ^= src[i];
+    }
+    static void andnot_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i) dst[i] &= ~src[i];
+    }
+    static void flip(uint64_t* dst, size_t n) noexcept
+    {
+        for(size_t i = 0; i < n; ++i) dst[i] = ~dst[i];
+    }
+    static size_t count(const uint64_t* src, size_t n) noexcept
+    {
+        size_t result = 0;
+        for(size_t i = 0; i < n; ++i) result += bitset_popcount(src[i]);
+        return result;
+    }
+    // [first, n) 中第一个非零字的下标，没有则返回 n
+    static size_t find_nonzero(const uint64_t* src, size_t first, size_t n) noexcept
+    {
+        for(; first < n && src[first] == 0; ++first) {}
+        return first;
+    }
+};
+
+#if MYSTL_BITSET_SIMD
+
+struct bitset_popcnt
+{
+    __attribute__((target("popcnt")))
+    static size_t count(const uint64_t* src, size_t n) noexcept
+    {
+        // 四个累加器打破 popcnt 之间的依赖
+        uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            c0 += __builtin_popcountll(src[i]);
+            c1 += __builtin_popcountll(src[i + 1]);
+            c2 += __builtin_popcountll(src[i + 2]);
+            c3 += __builtin_popcountll(src[i + 3]);
+        }
+        for(; i < n; ++i) c0 += __builtin_popcountll(src[i]);
+        return static_cast<size_t>(c0 + c1 + c2 + c3);
+    }
+};
+
+struct bitset_avx2
+{
+    __attribute__((target("avx2")))
+    static void and_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_and_si256(a, b));
+        }
+        for(; i < n; ++i) dst[i] &= src[i];
+    }
+
+    __attribute__((target("avx2")))
+    static void or_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_or_si256(a, b));
+        }
+        for(; i < n; ++i) dst[i] |= src[i];
+    }
+
+    __attribute__((target("avx2")))
+    static void xor_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, b));
+        }
+        for(; i < n; ++i) dst[i] ^= src[i];
+    }
+
+    // _mm256_andnot_si256(b, a) 计算 ~b & a
+    __attribute__((target("avx2")))
+    static void andnot_assign(uint64_t* dst, const uint64_t* src, size_t n) noexcept
+    {
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_andnot_si256(b, a));
+        }
+        for(; i < n; ++i) dst[i] &= ~src[i];
+    }
+
+    __attribute__((target("avx2")))
+    static void flip(uint64_t* dst, size_t n) noexcept
+    {
+        const __m256i ones = _mm256_set1_epi64x(-1);
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(a, ones));
+        }
+        for(; i < n; ++i) dst[i] = ~dst[i];
+    }
+
+    // 每个字节拆成高低两个 4 位，用 vpshufb 查表得到各自的位数，再以 vpsadbw 按 64 位横向求和
+    __attribute__((target("avx2,popcnt")))
+    static size_t count(const uint64_t* src, size_t n) noexcept
+    {
+        const __m256i lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i low_mask = _mm256_set1_epi8(0x0f);
+        const __m256i zero = _mm256_setzero_si256();
+        __m256i acc = zero;
+        size_t i = 0;
+        for(; i + 4 <= n; i += 4)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+            __m256i lo = _mm256_and_si256(v, low_mask);
+            __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+            __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                          _mm256_shuffle_epi8(lookup, hi));
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(cnt, zero));
+        }
+        uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        uint64_t result = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        for(; i < n; ++i) result += __builtin_popcountll(src[i]);
+        return static_cast<size_t>(result);
+    }
+
+    __attribute__((target("avx2")))
+    static size_t find_nonzero(const uint64_t* src, size_t first, size_t n) noexcept
+    {
+        for(; first + 4 <= n; first += 4)
+        {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + first));
+            if(!_mm256_testz_si256(v, v)) break;
+        }
+        for(; first < n && src[first] == 0; ++first) {}
+        return first;
+    }
+};
+
+#endif // MYSTL_BITSET_SIMD
+
+// bitset_kernels: 一组整字运算，get() 返回按当前 CPU 选定的一组
+struct bitset_kernels
+{
+    const char* name;
+    void   (*and_assign)(uint64_t*, const uint64_t*, size_t);
+    void   (*or_assign)(uint64_t*, const uint64_t*, size_t);
+    void   (*xor_assign)(uint64_t*, const uint64_t*, size_t);
+    void   (*andnot_assign)(uint64_t*, const uint64_t*, size_t);
+    void   (*flip)(uint64_t*, size_t);
+    size_t (*count)(const uint64_t*, size_t);
+    size_t (*find_nonzero)(const uint64_t*, size_t, size_t);
+
+    static bitset_kernels generic() noexcept
+    {
+        return bitset_kernels{"generic",
+            &bitset_generic::and_assign, &bitset_generic::or_assign,
+            &bitset_generic::xor_assign, &bitset_generic::andnot_assign,
+            &bitset_generic::flip, &bitset_generic::count, &bitset_generic::find_nonzero};
+    }
+
+#if MYSTL_BITSET_SIMD
+    static bool has_popcnt() noexcept
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("popcnt");
+    }
+
+    static bool has_avx2() noexcept
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+    }
+
+    static bitset_kernels popcnt() noexcept
+    {
+        bitset_kernels k = generic();
+        k.name = "popcnt";
+        k.count = &bitset_popcnt::count;
+        return k;
+    }
+
+    static bitset_kernels avx2() noexcept
+    {
+        return bitset_kernels{"avx2",
+            &bitset_avx2::and_assign, &bitset_avx2::or_assign,
+            &bitset_avx2::xor_assign, &bitset_avx2::andnot_assign,
+            &bitset_avx2::flip, &bitset_avx2::count, &bitset_avx2::find_nonzero};
+    }
+#else
+    static bool has_popcnt() noexcept { return false; }
+    static bool has_avx2() noexcept { return false; }
+#endif
+
+    static bitset_kernels select() noexcept
+    {
+#if MYSTL_BITSET_SIMD
+        if(has_avx2()) return avx2();
+        if(has_popcnt()) return popcnt();
+#endif
+        return generic();
+    }
+
+    static const bitset_kernels& get() noexcept
+    {
+        static const bitset_kernels kernels = select();
+        return kernels;
+    }
+};
+
+// dynamic_bitset
+template <typename Alloc = mystl::allocator<uint64_t>>
+class dynamic_bitset
+{
+public:
+    typedef uint64_t                                block_type;
+    typedef size_t                                  size_type;
+    typedef Alloc                                   allocator_type;
+
+    static constexpr size_type bits_per_block = 64;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // 单个位的代理
+    class reference
+    {
+        friend class dynamic_bitset;
+
+        block_type* _block;
+        block_type  _mask;
+
+        reference(block_type* block, size_type bit) noexcept
+        : _block(block), _mask(block_type(1) << bit) {}
+
+    public:
+        operator bool() const noexcept { return (*_block & _mask) != 0; }
+        bool operator~() const noexcept { return (*_block & _mask) == 0; }
+
+        reference& operator=(bool x) noexcept
+        {
+            if(x) *_block |= _mask;
+            else  *_block &= ~_mask;
+            return *this;
+        }
+        reference& operator=(const reference& rhs) noexcept { return *this = static_cast<bool>(rhs); }
+
+        reference& flip() noexcept
+        {
+            *_block ^= _mask;
+            return *this;
+        }
+    };
+
+private:
+    mystl::vector<block_type, allocator_type>   _blocks;
+    size_type                                   _size = 0;
+
+public:
+    // ctors
+    dynamic_bitset() = default;
+
+    explicit dynamic_bitset(const allocator_type& alloc): _blocks(alloc) {}
+
+    explicit dynamic_bitset(size_type n, bool value = false,
+                            const allocator_type& alloc = allocator_type())
+    : _blocks(blocks_for(n), value ? ~block_type(0) : block_type(0), alloc), _size(n)
+    {
+        zero_unused_bits();
+    }
+
+    // 由 '0' / '1' 组成的字符串，str[0] 为第 0 位
+    explicit dynamic_bitset(const std::string& str, const allocator_type& alloc = allocator_type())
+    : dynamic_bitset(str.size(), false, alloc)
+    {
+        for(size_type i = 0; i < str.size(); ++i)
+        {
+            THROW_RUNTIME_ERROR_IF(str[i] != '0' && str[i] != '1',
+                                   "dynamic_bitset: invalid character in string");
+            if(str[i] == '1') set(i);
+        }
+    }
+
+    allocator_type get_allocator() const { return _blocks.get_allocator(); }
+
+public:
+    // 容量相关
+    bool        empty()      const noexcept { return _size == 0; }
+    size_type   size()       const noexcept { return _size; }
+    size_type   num_blocks() const noexcept { return _blocks.size(); }
+    size_type   capacity()   const noexcept { return _blocks.capacity() * bits_per_block; }
+
+    void reserve(size_type n) { _blocks.reserve(blocks_for(n)); }
+    void shrink_to_fit() { _blocks.shrink_to_fit(); }
+
+    void resize(size_type n, bool value = false);
+    void clear() noexcept
+    {
+        _blocks.clear();
+        _size = 0;
+    }
+
+    void push_back(bool value)
+    {
+        if(_size % bits_per_block == 0) _blocks.push_back(block_type(0));
+        ++_size;
+        set(_size - 1, value);
+    }
+
+    void pop_back()
+    {
+        MYSTL_DEBUG(!empty());
+        reset(_size - 1);
+        --_size;
+        if(_size % bits_per_block == 0) _blocks.pop_back();
+    }
+
+    // 访问位
+    bool test(size_type pos) const
+    {
+        MYSTL_DEBUG(pos < _size);
+        return (_blocks[block_index(pos)] & bit_mask(pos)) != 0;
+    }
+
+    bool operator[](size_type pos) const { return test(pos); }
+
+    reference operator[](size_type pos)
+    {
+        MYSTL_DEBUG(pos < _size);
+        return reference(&_blocks[block_index(pos)], bit_index(pos));
+    }
+
+    bool at(size_type pos) const
+    {
+        THROW_OUT_OF_RANGE_IF(!(pos < _size), "dynamic_bitset::at() subscript out of range");
+        return test(pos);
+    }
+
+    // 底层的字，最后一个字中超出 size() 的位为 0
+    const block_type* data() const noexcept { return _blocks.data(); }
+
+    // 修改位
+    dynamic_bitset& set();
+    dynamic_bitset& set(size_type pos, bool value = true)
+    {
+        MYSTL_DEBUG(pos < _size);
+        if(value) _blocks[block_index(pos)] |= bit_mask(pos);
+        else      _blocks[block_index(pos)] &= ~bit_mask(pos);
+        return *this;
+    }
+
+    dynamic_bitset& reset()
+    {
+        std::fill(_blocks.begin(), _blocks.end(), block_type(0));
+        return *this;
+    }
+    dynamic_bitset& reset(size_type pos) { return set(pos, false); }
+
+    dynamic_bitset& flip();
+    dynamic_bitset& flip(size_type pos)
+    {
+        MYSTL_DEBUG(pos < _size);
+        _blocks[block_index(pos)] ^= bit_mask(pos);
+        return *this;
+    }
+
+    // 统计
+    size_type count() const noexcept
+    {
+        return bitset_kernels::get().count(_blocks.data(), _blocks.size());
+    }
+
+    bool any() const noexcept { return find_first() != npos; }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == _size; }
+
+    // 查找: 返回第一个 (pos 之后第一个) 为 1 的位，没有则返回 npos
+    size_type find_first() const noexcept { return find_from_block(0); }
+    size_type find_next(size_type pos) const noexcept;
+
+    // 整体运算
+    dynamic_bitset& operator&=(const dynamic_bitset& rhs);
+    dynamic_bitset& operator|=(const dynamic_bitset& rhs);
+    dynamic_bitset& operator^=(const dynamic_bitset& rhs);
+    dynamic_bitset& operator-=(const dynamic_bitset& rhs);  // *this & ~rhs
+
+    dynamic_bitset operator~() const
+    {
+        dynamic_bitset result(*this);
+        result.flip();
+        return result;
+    }
+
+    bool operator==(const dynamic_bitset& rhs) const
+    {
+        return _size == rhs._size && _blocks == rhs._blocks;
+    }
+    bool operator!=(const dynamic_bitset& rhs) const { return !(*this == rhs); }
+
+    // 第 0 位在最左边
+    std::string to_string() const
+    {
+        std::string result(_size, '0');
+        for(size_type i = find_first(); i != npos; i = find_next(i))
+            result[i] = '1';
+        return result;
+    }
+
+    void swap(dynamic_bitset& rhs) noexcept
+    {
+        _blocks.swap(rhs._blocks);
+        mystl::swap(_size, rhs._size);
+    }
+
+private:
+    // helper functions
+    static size_type blocks_for(size_type n) noexcept { return (n + bits_per_block - 1) / bits_per_block; }
+    static size_type block_index(size_type pos) noexcept { return pos / bits_per_block; }
+    static size_type bit_index(size_type pos) noexcept { return pos % bits_per_block; }
+    static block_type bit_mask(size_type pos) noexcept { return block_type(1) << bit_index(pos); }
+
+    // 维持不变式: 最后一个字中超出 size() 的位为 0
+    void zero_unused_bits() noexcept
+    {
+        const size_type extra = bit_index(_size);
+        if(extra != 0) _blocks.back() &= (block_type(1) << extra) - 1;
+    }
+
+    size_type find_from_block(size_type first) const noexcept
+    {
+        const size_type i = bitset_kernels::get().find_nonzero(_blocks.data(), first, _blocks.size());
+        if(i == _blocks.size()) return npos;
+        return i * bits_per_block + bitset_ctz(_blocks[i]);
+    }
+};
+
+/*****************************************************************************************/
+
+// resize: 新增的位为 value
+template <typename Alloc>
+void dynamic_bitset<Alloc>::resize(size_type n, bool value)
+{
+    const size_type old_size = _size;
+    const block_type fill = value ? ~block_type(0) : block_type(0);
+    if(value && n > old_size && bit_index(old_size) != 0)
+    {
+        // 旧的最后一个字中空闲的高位
+        _blocks.back() |= ~((block_type(1) << bit_index(old_size)) - 1);
+    }
+    _blocks.resize(blocks_for(n), fill);
+    _size = n;
+    zero_unused_bits();
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::set()
+{
+    std::fill(_blocks.begin(), _blocks.end(), ~block_type(0));
+    zero_unused_bits();
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::flip()
+{
+    bitset_kernels::get().flip(_blocks.data(), _blocks.size());
+    zero_unused_bits();
+    return *this;
+}
+
+// find_next: 先查 pos 所在字中更高的位，再跳过空字
+template <typename Alloc>
+typename dynamic_bitset<Alloc>::size_type
+dynamic_bitset<Alloc>::find_next(size_type pos) const noexcept
+{
+    if(pos >= _size || ++pos >= _size) return npos;
+    const block_type w = _blocks[block_index(pos)] >> bit_index(pos);
+    if(w != 0) return pos + bitset_ctz(w);
+    return find_from_block(block_index(pos) + 1);
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator&=(const dynamic_bitset& rhs)
+{
+    MYSTL_DEBUG(_size == rhs._size);
+    bitset_kernels::get().and_assign(_blocks.data(), rhs._blocks.data(), _blocks.size());
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator|=(const dynamic_bitset& rhs)
+{
+    MYSTL_DEBUG(_size == rhs._size);
+    bitset_kernels::get().or_assign(_blocks.data(), rhs._blocks.data(), _blocks.size());
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator^=(const dynamic_bitset& rhs)
+{
+    MYSTL_DEBUG(_size == rhs._size);
+    bitset_kernels::get().xor_assign(_blocks.data(), rhs._blocks.data(), _blocks.size());
+    return *this;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc>& dynamic_bitset<Alloc>::operator-=(const dynamic_bitset& rhs)
+{
+    MYSTL_DEBUG(_size == rhs._size);
+    bitset_kernels::get().andnot_assign(_blocks.data(), rhs._blocks.data(), _blocks.size());
+    return *this;
+}
+
+// 重载运算符
+template <typename Alloc>
+dynamic_bitset<Alloc> operator&(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+    dynamic_bitset<Alloc> result(lhs);
+    return result &= rhs;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> operator|(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+    dynamic_bitset<Alloc> result(lhs);
+    return result |= rhs;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> operator^(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+    dynamic_bitset<Alloc> result(lhs);
+    return result ^= rhs;
+}
+
+template <typename Alloc>
+dynamic_bitset<Alloc> operator-(const dynamic_bitset<Alloc>& lhs, const dynamic_bitset<Alloc>& rhs)
+{
+    dynamic_bitset<Alloc> result(lhs);
+    return result -= rhs;
+}
+
+// mystl::swap overload
+template <typename Alloc>
+void swap(dynamic_bitset<Alloc>& lhs, dynamic_bitset<Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+template <typename Alloc>
+struct is_trivially_relocatable<mystl::dynamic_bitset<Alloc>>:
+    is_trivially_relocatable<mystl::vector<uint64_t, Alloc>> {};
+
+} // end of namespace mystl
+#endif // !DYNAMIC_BITSET_H_
@@ -102,13 +102,13 @@ struct ht_value_traits
 };
 
 // forward declaration 
-template <typename T, typename HashFun, typename KeyEqual> 
+template <typename T, typename HashFun, typename KeyEqual, typename Alloc = mystl::allocator<T>> 
 class hashtable; 
 
-template <typename T, typename HashFun, typename KeyEqual> 
+template <typename T, typename HashFun, typename KeyEqual, typename Alloc> 
 struct ht_iterator; 
 
-template <typename T, typename HashFun, typename KeyEqual> 
+template <typename T, typename HashFun, typename KeyEqual, typename Alloc> 
 struct ht_const_iterator; 
 
 template <typename T> 
@@ -118,13 +118,13 @@ template <typename T>
 struct ht_const_local_iterator; 
 
 // hashtable iterator base 
-template <typename T, typename Hash, typename KeyEqual> 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
 struct ht_iterator_base: public mystl::iterator<mystl::forward_iterator_tag, T> 
 {
-    typedef mystl::hashtable<T, Hash, KeyEqual>         hashtable; 
-    typedef ht_iterator_base<T, Hash, KeyEqual>         base; 
-    typedef mystl::ht_iterator<T, Hash, KeyEqual>       iterator; 
-    typedef mystl::ht_const_iterator<T, Hash, KeyEqual> const_iterator; 
+    typedef mystl::hashtable<T, Hash, KeyEqual, Alloc>         hashtable; 
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc>         base; 
+    typedef mystl::ht_iterator<T, Hash, KeyEqual, Alloc>       iterator; 
+    typedef mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc> const_iterator; 
     typedef hashtable_node<T*>                          node_ptr; 
     typedef hashtable*                                  contain_ptr; 
     typedef const node_ptr                              const_node_ptr; 
@@ -142,11 +142,11 @@ struct ht_iterator_base: public mystl::iterator<mystl::forward_iterator_tag, T>
     bool operator != (const base& rhs) const { return node != rhs.node; }
 }; 
 
-template <typename T, typename Hash, typename KeyEqual> 
-struct ht_iterator: public ht_iterator_base<T, Hash, KeyEqual> 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+struct ht_iterator: public ht_iterator_base<T, Hash, KeyEqual, Alloc> 
 {
     // traits 
-    typedef ht_iterator_base<T, Hash, KeyEqual>             base;
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc>             base;
     typedef typename base::hashtable                        hashtable; 
     typedef typename base::iterator                         iterator; 
     typedef typename base::const_iterator                   const_iterator; 
@@ -228,10 +228,10 @@ struct ht_iterator: public ht_iterator_base<T, Hash, KeyEqual>
     }
 }; 
 
-template <typename T, typename Hash, typename KeyEqual> 
-struct ht_const_iterator: public ht_iterator_base<T, Hash, KeyEqual> 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+struct ht_const_iterator: public ht_iterator_base<T, Hash, KeyEqual, Alloc> 
 {
-    typedef ht_iterator_base<T, Hash, KeyEqual>             base; 
+    typedef ht_iterator_base<T, Hash, KeyEqual, Alloc>             base; 
     typedef typename base::hashtable                        hashtable; 
     typedef typename base::iterator                         iterator; 
     typedef typename base::const_iterator                   const_iterator; 
@@ -468,12 +468,13 @@ inline size_t ht_next_prime(size_t n)
 
 // hastable
 // T for type, Hash for hashing function, KeyEqual for comparing rules 
-template <typename T, typename Hash, typename KeyEqual> 
-class hashtable
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+class hashtable: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<hashtable_node<T>>>
 {
     // friend 
-    friend struct mystl::ht_iterator<T, Hash, KeyEqual>; 
-    friend struct mystl::ht_const_iterator<T, Hash, KeyEqual>; 
+    friend struct mystl::ht_iterator<T, Hash, KeyEqual, Alloc>; 
+    friend struct mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc>; 
 
 public: 
     // type traits; 
@@ -488,27 +489,31 @@ public:
     typedef node_type*                                  node_ptr; 
     typedef mystl::vector<node_ptr>                     bucket_type; 
 
-    typedef mystl::allocator<T>                         allocator_type; 
-    typedef mystl::allocator<T>                         data_allocator; 
-    typedef mystl::allocator<node_type>                 node_allocator; 
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type; 
+    typedef allocator_type                              data_allocator; 
+    typedef mystl::allocator_traits<data_allocator>     data_traits; 
+    typedef typename data_traits::template rebind_alloc<node_type>  node_allocator; 
+    typedef mystl::allocator_traits<node_allocator>     node_traits; 
 
-    typedef typename allocator_type::pointer            pointer; 
-    typedef typename allocator_type::const_pointer      const_pointer; 
-    typedef typename allocator_type::reference          reference; 
-    typedef typename allocator_type::const_reference    const_reference; 
-    typedef typename allocator_type::size_type          size_type; 
-    typedef typename allocator_type::difference_type    difference_type; 
+    typedef typename data_traits::pointer               pointer; 
+    typedef typename data_traits::const_pointer         const_pointer; 
+    typedef value_type&                                 reference; 
+    typedef const value_type&                           const_reference; 
+    typedef typename data_traits::size_type             size_type; 
+    typedef typename data_traits::difference_type       difference_type; 
 
 
-    typedef typename mystl::ht_iterator<T, Hash, KeyEqual>          iterator; 
-    typedef typename mystl::ht_const_iterator<T, Hash, KeyEqual>    const_iterator; 
+    typedef typename mystl::ht_iterator<T, Hash, KeyEqual, Alloc>          iterator; 
+    typedef typename mystl::ht_const_iterator<T, Hash, KeyEqual, Alloc>    const_iterator; 
     typedef typename mystl::ht_local_iterator<T>                    local_iterator; 
     typedef typename mystl::ht_const_local_iterator<T>              const_local_iterator; 
 
-    // ? 
-    allocator_type get_allocator() const { return allocator_type(); }        
+    allocator_type get_allocator() const { return allocator_type(get_alloc()); }        
 
 private:   
+    typedef mystl::alloc_holder<node_allocator>         alloc_base; 
+    using alloc_base::get_alloc; 
+
     // 维护 hashtable 
     bucket_type     buckets_; 
     size_type       bucket_size_; 
@@ -559,8 +564,8 @@ private:
 public: 
     // ctor 
     explicit hashtable(size_type bucket_count, const Hash&hash = Hash(), 
-        const KeyEqual& equal = KeyEqual()): 
-        size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
+        const KeyEqual& equal = KeyEqual(), const allocator_type& alloc = allocator_type()): 
+        alloc_base(node_allocator(alloc)), size_(0), mlf_(1.0f), hash_(hash), equal_(equal)
         {
             init(bucket_count); 
         }
@@ -576,13 +581,16 @@ hashtable(Iter first, Iter last,
                 init(std::max(bucket_count, static_cast<size_type>(mystl::distance(first, last))));
             }
 
-hashtable(const hashtable& rhs): hash_(rhs.hash_), equal_(rhs.euqal)
+hashtable(const hashtable& rhs)
+: alloc_base(node_traits::select_on_container_copy_construction(rhs.get_alloc())), 
+  hash_(rhs.hash_), equal_(rhs.equal_)
 {
     copy_init(rhs);
 }
 
-hashtable(hashtable&& rhs ) noexcept: bucket_size_(rhs.bucket_size_), 
-size_(rhs.size_), mlf_(rhs.mlf_), hash_(rhs.hash()), equal_(rhs.equal)
+hashtable(hashtable&& rhs ) noexcept: alloc_base(mystl::move(rhs.get_alloc())), 
+bucket_size_(rhs.bucket_size_), 
+size_(rhs.size_), mlf_(rhs.mlf_), hash_(rhs.hash_), equal_(rhs.equal_)
 {
     buckets_ =mystl::move(rhs.buckets_);
     rhs.bucket_size_ = 0; 
@@ -815,8 +823,8 @@ private:
 // method 实现 
 
 // copy assign 
-template <typename T, typename Hash, typename KeyEqual>  
-hashtable<T, Hash, KeyEqual>&  hashtable<T, Hash, KeyEqual>::
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+hashtable<T, Hash, KeyEqual, Alloc>&  hashtable<T, Hash, KeyEqual, Alloc>::
 operator= (const hashtable& rhs) 
 {
     if(this != &rhs)
@@ -828,8 +836,8 @@ operator= (const hashtable& rhs)
 }
 
 // move assign 
-template <typename T, typename Hash, typename KeyEqual>  
-hashtable<T, Hash, KeyEqual>&  hashtable<T, Hash, KeyEqual>::
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+hashtable<T, Hash, KeyEqual, Alloc>&  hashtable<T, Hash, KeyEqual, Alloc>::
 operator= (hashtable&& rhs) noexcept
 {
     hashtable temp(mystl::move(rhs)); 
@@ -839,10 +847,10 @@ operator= (hashtable&& rhs) noexcept
 
 // 就地构造元素，键值允许重复
 // 强异常安全保证
-template <typename T, typename Hash, typename KeyEqual> 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
 template <typename ...Args>  
-typename hashtable<T, Hash, KeyEqual>::iterator   
-hashtable<T, Hash, KeyEqual>::
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator   
+hashtable<T, Hash, KeyEqual, Alloc>::
 emplace_multi(Args&& ...args)
 {
     auto np = create_node(mystl::forward<Args>(args)...); 
@@ -861,10 +869,10 @@ emplace_multi(Args&& ...args)
 
 // 就地构造元素，键值不允许重复
 // 强异常安全保证 
-template <typename T, typename Hash, typename KeyEqual> 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
 template <typename ...Args>  
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>  
-hashtable<T, Hash, KeyEqual>::
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>  
+hashtable<T, Hash, KeyEqual, Alloc>::
 emplace_unique(Args&& ...args)
 {
     auto np = create_node(mystl::forward<Args>(args)...); 
@@ -883,9 +891,9 @@ emplace_unique(Args&& ...args)
 }
 
 // 在不需要重建表格的情况下插入新节点，键值不允许重复
-template <typename T, typename Hash, typename KeyEqual> 
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, bool>  
-hashtable<T, Hash, KeyEqual>::insert_unique_noresize(const value_type& value)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, bool>  
+hashtable<T, Hash, KeyEqual, Alloc>::insert_unique_noresize(const value_type& value)
 {
     const auto n = hash(value_traits::get_key(value)); 
     auto first = buckets_[n]; 
@@ -904,9 +912,9 @@ hashtable<T, Hash, KeyEqual>::insert_unique_noresize(const value_type& value)
 }
 
 // 在不需要重建表格的情况下插入新节点，键值允许重复
-template <typename T, typename Hash, typename KeyEqual> 
-typename hashtable<T, Hash, KeyEqual>::iterator
-hashtable<T, Hash, KeyEqual>::insert_multi_noresize(const value_type& value)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator
+hashtable<T, Hash, KeyEqual, Alloc>::insert_multi_noresize(const value_type& value)
 {
     const auto n = hash(value_traits::get_key(value)); 
     auto first = buckets_[n]; 
@@ -929,8 +937,8 @@ hashtable<T, Hash, KeyEqual>::insert_multi_noresize(const value_type& value)
 }
 
 // erase node 
-template <typename T, typename Hash, typename KeyEqual>  
-void hashtable<T, Hash, KeyEqual>:: erase(const_iterator  position)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+void hashtable<T, Hash, KeyEqual, Alloc>:: erase(const_iterator  position)
 {
     auto p = position.node; 
     if(p)
@@ -964,8 +972,8 @@ void hashtable<T, Hash, KeyEqual>:: erase(const_iterator  position)
 }
 
 // range erase first, last 
-template <typename T, typename Hash, typename KeyEqual>   
-void hashtable<T, Hash, KeyEqual>:: erase(const_iterator first, const_iterator last)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+void hashtable<T, Hash, KeyEqual, Alloc>:: erase(const_iterator first, const_iterator last)
 {
     if(first.node == last.node) return; 
 
@@ -996,9 +1004,9 @@ void hashtable<T, Hash, KeyEqual>:: erase(const_iterator first, const_iterator l
 }
 
 // 删除键值为key的节点
-template <typename T, typename Hash, typename KeyEqual> 
-typename hashtable<T, Hash, KeyEqual>:: size_type 
-hashtable <T, Hash, KeyEqual>::erase_multi(const key_type& key)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+typename hashtable<T, Hash, KeyEqual, Alloc>:: size_type 
+hashtable <T, Hash, KeyEqual, Alloc>::erase_multi(const key_type& key)
 {
     auto p = equal_range_multi(key); 
     if(p.first.node != nullptr)
@@ -1010,9 +1018,9 @@ hashtable <T, Hash, KeyEqual>::erase_multi(const key_type& key)
 }
 
 // 删除键值为key的节点 
-template <typename T, typename Hash, typename KeyEqual> 
-typename hashtable<T, Hash, KeyEqual>:: size_type  
-hashtable<T, Hash, KeyEqual>::
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+typename hashtable<T, Hash, KeyEqual, Alloc>:: size_type  
+hashtable<T, Hash, KeyEqual, Alloc>::
 erase_unique(const key_type& key)
 {
     const auto n = hash(key); 
@@ -1049,8 +1057,8 @@ erase_unique(const key_type& key)
 }
 
 // 清空 hashtable 
-template <typename T, typename Hash, typename KeyEqual>  
-void hashtable<T, Hash, KeyEqual>:: clear()  
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+void hashtable<T, Hash, KeyEqual, Alloc>:: clear()  
 {
     if(size_ == 0) return; 
 
@@ -1069,9 +1077,9 @@ void hashtable<T, Hash, KeyEqual>:: clear()
 }
 
 // 在 bucket 节点的个数
-template <typename T, typename Hash, typename KeyEqual>  
-typename hashtable<T, Hash, KeyEqual>::size_type  
-hashtable<T, Hash, KeyEqual>:: bucket_size(size_type n) const noexcept  
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type  
+hashtable<T, Hash, KeyEqual, Alloc>:: bucket_size(size_type n) const noexcept  
 {
     size_type result = 0; 
     for(auto cur = buckets_[n]; cur; cur = cur->next)
@@ -1083,8 +1091,8 @@ hashtable<T, Hash, KeyEqual>:: bucket_size(size_type n) const noexcept
 
 
 // 重新对元素 hash 找到新的bucket 并插入
-template <typename T, typename Hash, typename KeyEqual>  
-void hashtable<T, Hash, KeyEqual>:: rehash(size_type count)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+void hashtable<T, Hash, KeyEqual, Alloc>:: rehash(size_type count)
 {
     auto n = ht_next_prime(count); 
     if(n > bucket_size_)
@@ -1103,9 +1111,9 @@ void hashtable<T, Hash, KeyEqual>:: rehash(size_type count)
 }
 
 // find key 
-template <typename T, typename Hash, typename KeyEqual> 
-typename hashtable<T, Hash, KeyEqual>:: iterator  
-hashtable<T, Hash, KeyEqual>::find(const key_type& key)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+typename hashtable<T, Hash, KeyEqual, Alloc>:: iterator  
+hashtable<T, Hash, KeyEqual, Alloc>::find(const key_type& key)
 {
     const auto n = hash(key); 
     node_ptr first = buckets_[n]; 
@@ -1114,9 +1122,9 @@ hashtable<T, Hash, KeyEqual>::find(const key_type& key)
     return first; 
 }
 
-template <typename T, typename Hash, typename KeyEqual>  
-typename hashtable<T, Hash, KeyEqual>::const_iterator  
-hashtable<T, Hash, KeyEqual>::find(const key_type& key) const 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator  
+hashtable<T, Hash, KeyEqual, Alloc>::find(const key_type& key) const 
 {
     const auto n = hash(key); 
     node_ptr first = buckets_[n]; 
@@ -1126,9 +1134,9 @@ hashtable<T, Hash, KeyEqual>::find(const key_type& key) const
 }
 
 // count key 
-template <typename T, typename Hash, typename KeyEqual> 
-typename hashtable<T, Hash, KeyEqual>::size_type  
-hashtable<T, Hash, KeyEqual>:: count(const key_type& key) const 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type  
+hashtable<T, Hash, KeyEqual, Alloc>:: count(const key_type& key) const 
 {
     const auto n = hash(key); 
     size_type res = 0; 
@@ -1142,10 +1150,10 @@ hashtable<T, Hash, KeyEqual>:: count(const key_type& key) const
 
 
 // equal range 
-template <typename T, typename Hash, typename KeyEqual>  
-pair <typename hashtable<T, Hash, KeyEqual>::iterator, 
-      typename hashtable<T, Hash, KeyEqual>::iterator> 
-hashtable<T, Hash, KeyEqual>::   
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+pair <typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, 
+      typename hashtable<T, Hash, KeyEqual, Alloc>::iterator> 
+hashtable<T, Hash, KeyEqual, Alloc>::   
 equal_range_multi(const key_type& key)
 {
     const auto n = hash(key);
@@ -1172,10 +1180,10 @@ equal_range_multi(const key_type& key)
     return mystl::make_pair(end(), end()); 
 }
 
-template <typename T, typename Hash, typename KeyEqual>  
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator, 
-     typename hashtable<T, Hash, KeyEqual>::const_iterator>  
-hashtable<T, Hash, KeyEqual>::
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator, 
+     typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>  
+hashtable<T, Hash, KeyEqual, Alloc>::
 equal_range_multi(const key_type& key) const 
 {   
     const auto n = hash(key);
@@ -1202,10 +1210,10 @@ equal_range_multi(const key_type& key) const
     return mystl::make_pair(cend(), cend());     
 }
 
-template <typename T, typename Hash, typename KeyEqual>  
-pair<typename hashtable<T, Hash, KeyEqual>::iterator, 
-     typename hashtable<T, Hash, KeyEqual>::iterator>  
-hashtable<T, Hash, KeyEqual>:: 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::iterator, 
+     typename hashtable<T, Hash, KeyEqual, Alloc>::iterator>  
+hashtable<T, Hash, KeyEqual, Alloc>:: 
 equal_range_unique(const key_type& key)
 {
     const auto n = hash(key); 
@@ -1226,10 +1234,10 @@ equal_range_unique(const key_type& key)
     return mystl::make_pair(end(), end()); 
 }
 
-template <typename T, typename Hash, typename KeyEqual>  
-pair<typename hashtable<T, Hash, KeyEqual>::const_iterator, 
-     typename hashtable<T, Hash, KeyEqual>::const_iterator>  
-hashtable<T, Hash, KeyEqual>::  
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator, 
+     typename hashtable<T, Hash, KeyEqual, Alloc>::const_iterator>  
+hashtable<T, Hash, KeyEqual, Alloc>::  
 equal_range_unique(const key_type& key) const  
 {
     const auto n = hash(key); 
@@ -1251,8 +1259,8 @@ equal_range_unique(const key_type& key) const
 }
 
 // 交换 hashtable 
-template <typename T, typename Hash, typename KeyEqual> 
-void hashtable<T, Hash, KeyEqual>::   
+template <typename T, typename Hash, typename KeyEqual, typename Alloc> 
+void hashtable<T, Hash, KeyEqual, Alloc>::   
 swap(hashtable& rhs) noexcept  
 {
     if(this != &rhs)
@@ -1263,6 +1271,7 @@ swap(hashtable& rhs) noexcept
         mystl::swap(mlf_, rhs.mlf_); 
         mystl::swap(hash_, rhs.hash_); 
         mystl::swap(equal_, rhs.equal_);  
+        mystl::alloc_on_swap(get_alloc(), rhs.get_alloc()); 
     }
 }
 
@@ -1270,8 +1279,8 @@ swap(hashtable& rhs) noexcept
 
 
 // init 
-template <typename T, typename Hash, typename KeyEqual>  
-void hashtable<T, Hash, KeyEqual>::init(size_type n)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+void hashtable<T, Hash, KeyEqual, Alloc>::init(size_type n)
 {
     const auto buckets_nums = next_size(n); 
     try
@@ -1289,8 +1298,8 @@ void hashtable<T, Hash, KeyEqual>::init(size_type n)
 }
 
 // copy init; 
-template <typename T, typename Hash, typename KeyEqual>  
-void hashtable<T, Hash, KeyEqual>::   
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+void hashtable<T, Hash, KeyEqual, Alloc>::   
 copy_init(const hashtable& ht)
 {
     bucket_size_ = 0; 
@@ -1327,22 +1336,22 @@ copy_init(const hashtable& ht)
 }
 
 // create_node 
-template <typename T, typename Hash, typename KeyEqual>  
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
 template <typename ...Args>  
-typename hashtable<T, Hash, KeyEqual>:: node_ptr 
-hashtable<T, Hash, KeyEqual>::    
+typename hashtable<T, Hash, KeyEqual, Alloc>:: node_ptr 
+hashtable<T, Hash, KeyEqual, Alloc>::    
 create_node(Args&& ...args)
 {
-    node_ptr temp = node_allocator::allocate(1); 
+    node_ptr temp = node_traits::allocate(get_alloc(), 1); 
     
     try
     {
-        data_allocator::construct(mystl::address_of(temp->value), mystl::forward<Args>(args)...); 
+        node_traits::construct(get_alloc(), mystl::address_of(temp->value), mystl::forward<Args>(args)...); 
         temp -> next = nullptr; 
     }
     catch(...)
     {
-        node_allocator::deallocate(temp); 
+        node_traits::deallocate(get_alloc(), temp, 1); 
         throw; 
     }
     
@@ -1350,35 +1359,35 @@ create_node(Args&& ...args)
 }
 
 // destroy_node
-template<typename T, typename Hash, typename KeyEqual>   
-void hashtable<T, Hash, KeyEqual>::    
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+void hashtable<T, Hash, KeyEqual, Alloc>::    
 destroy_node(node_ptr node)
 {
-    data_allocator::destroy(mystl::address_of(node->value)); 
-    node_allocator::deallocate(node); 
+    node_traits::destroy(get_alloc(), mystl::address_of(node->value)); 
+    node_traits::deallocate(get_alloc(), node, 1); 
     node = nullptr; 
 }
 
 
 
-template <typename T, typename Hash, typename KeyEqual>  
-typename hashtable<T, Hash, KeyEqual> :: size_type 
-hashtable<T, Hash, KeyEqual>::next_size(size_type n ) const 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+typename hashtable<T, Hash, KeyEqual, Alloc> :: size_type 
+hashtable<T, Hash, KeyEqual, Alloc>::next_size(size_type n ) const 
 {
     return ht_next_prime(n); 
 }
 
 // hashing fuction  
-template<typename T, typename Hash, typename KeyEqual>
-typename hashtable<T, Hash, KeyEqual>::size_type   
-hashtable<T, Hash, KeyEqual>::hash(const key_type& key) const
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>
+typename hashtable<T, Hash, KeyEqual, Alloc>::size_type   
+hashtable<T, Hash, KeyEqual, Alloc>::hash(const key_type& key) const
 {
     return hash_(key) % bucket_size_;
 }
 
 //rehash if need 
-template<typename T, typename Hash, typename KeyEqual>
-void hashtable<T, Hash, KeyEqual>::    
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>
+void hashtable<T, Hash, KeyEqual, Alloc>::    
 rehash_if_need(size_type n)  
 {
     if(static_cast<float>(size_ + n) > (float)bucket_size_ * max_load_factor())
@@ -1386,9 +1395,9 @@ rehash_if_need(size_type n)
 }
 
 // copy insert 
-template <typename T, typename Hash, typename KeyEqual>   
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
 template <typename InputIter>   
-void hashtable<T, Hash, KeyEqual>::   
+void hashtable<T, Hash, KeyEqual, Alloc>::   
 copy_insert_multi(InputIter first, InputIter last, mystl::input_iterator_tag)
 {
     size_type n = mystl::distance(first, last); 
@@ -1399,9 +1408,9 @@ copy_insert_multi(InputIter first, InputIter last, mystl::input_iterator_tag)
     }
 }
 
-template <typename T, typename Hash, typename KeyEqual>  
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
 template <typename InputIter>  
-void hashtable<T, Hash, KeyEqual>::    
+void hashtable<T, Hash, KeyEqual, Alloc>::    
 copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag)
 {
     rehash_if_need(mystl::distance(first, last)); 
@@ -1412,9 +1421,9 @@ copy_insert_unique(InputIter first, InputIter last, mystl::input_iterator_tag)
 }
 
 // insert_node 
-template <typename T, typename Hash, typename KeyEqual>   
-typename hashtable<T, Hash, KeyEqual>::iterator    
-hashtable<T, Hash, KeyEqual>::   
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+typename hashtable<T, Hash, KeyEqual, Alloc>::iterator    
+hashtable<T, Hash, KeyEqual, Alloc>::   
 insert_node_multi(node_ptr np)
 {
     const auto n = hash(value_traits::get_key(np -> value)); 
@@ -1446,9 +1455,9 @@ insert_node_multi(node_ptr np)
 }
 
 // insert_node_unique() 
-template <typename T, typename Hash, typename KeyEqual>   
-pair<typename hashtable<T, Hash, KeyEqual>:: iterator, bool>  
-hashtable<T, Hash, KeyEqual>::    
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+pair<typename hashtable<T, Hash, KeyEqual, Alloc>:: iterator, bool>  
+hashtable<T, Hash, KeyEqual, Alloc>::    
 insert_node_unique(node_ptr np)
 {
     const auto n = hash(value_traits::get_key(np->value)); 
@@ -1477,8 +1486,8 @@ insert_node_unique(node_ptr np)
 }
 
 // replace_bucket 
-template <typename T, typename Hash, typename KeyEqual>   
-void hashtable<T, Hash, KeyEqual>::   
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+void hashtable<T, Hash, KeyEqual, Alloc>::   
 replace_bucket(size_type bucket_count)
 {
     bucket_type bucket(bucket_count);  // ????? 
@@ -1518,8 +1527,8 @@ replace_bucket(size_type bucket_count)
 }
 
 // erase_bucket 
-template <typename T, typename Hash, typename KeyEqual>   
-void hashtable<T, Hash, KeyEqual>::   
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+void hashtable<T, Hash, KeyEqual, Alloc>::   
 erase_bucket(size_type n, node_ptr first, node_ptr last)
 {
     auto cur = buckets_[n]; 
@@ -1542,8 +1551,8 @@ erase_bucket(size_type n, node_ptr first, node_ptr last)
 }
 
 // erase bucket n, last   
-template <typename T, typename Hash, typename KeyEqual>   
-void hashtable<T, Hash, KeyEqual>::    
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+void hashtable<T, Hash, KeyEqual, Alloc>::    
 erase_bucket(size_type n, node_ptr last)
 {
     auto cur = buckets_[n]; 
@@ -1557,8 +1566,8 @@ erase_bucket(size_type n, node_ptr last)
     buckets_[n] = last;
 }
 
-template <typename T, typename Hash, typename KeyEqual>   
-bool hashtable<T, Hash, KeyEqual>::equal_to_multi (const hashtable& other)  
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>   
+bool hashtable<T, Hash, KeyEqual, Alloc>::equal_to_multi (const hashtable& other)  
 {
     if(size_ != other.size_)  return false; 
 
@@ -1575,8 +1584,8 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_multi (const hashtable& other)
     return true; 
 }
 
-template <typename T, typename Hash, typename KeyEqual>  
-bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+bool hashtable<T, Hash, KeyEqual, Alloc>::equal_to_unique(const hashtable& other)
 {
     if(size_ != other.size_) return false; 
 
@@ -1593,9 +1602,9 @@ bool hashtable<T, Hash, KeyEqual>::equal_to_unique(const hashtable& other)
 }
 
 // generic swap  
-template <typename T, typename Hash, typename KeyEqual>  
-void swap(hashtable<T, Hash, KeyEqual>& lhs, 
-          hashtable<T, Hash, KeyEqual>& rhs) noexcept 
+template <typename T, typename Hash, typename KeyEqual, typename Alloc>  
+void swap(hashtable<T, Hash, KeyEqual, Alloc>& lhs, 
+          hashtable<T, Hash, KeyEqual, Alloc>& rhs) noexcept 
 {
     lhs.swap(rhs);
 }
@@ -107,7 +107,7 @@ void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result,
 template <typename RandomIter> 
 void pop_heap(RandomIter first, RandomIter last) 
 {
-    mystl::pop_heap_aux(first, last - 1, *(last -1), distance_type(first)); 
+    mystl::pop_heap_aux(first, last - 1, last - 1, *(last -1), distance_type(first)); 
 }
 
 // overload: functional object 
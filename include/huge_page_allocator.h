@@ -0,0 +1,156 @@
+// -- huge_page_allocator.h 大页分配器
+// 面向大块连续缓冲区 (vector / deque 的 map 等)：
+// * 不小于 HUGE_PAGE_THRESHOLD 字节的请求以 mmap 申请，起始地址与长度按 2MB 对齐，
+//   并通过 madvise(MADV_HUGEPAGE) 提示内核使用透明大页，减少 TLB miss
+// * 较小的请求仍使用 ::operator new
+// 非 Linux 平台上全部请求退化为 ::operator new
+#ifndef HUGE_PAGE_ALLOCATOR_H_
+#define HUGE_PAGE_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include "allocator.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace mystl
+{
+
+#ifndef HUGE_PAGE_SIZE
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#endif
+
+#ifndef HUGE_PAGE_THRESHOLD
+#define HUGE_PAGE_THRESHOLD (1024 * 1024)
+#endif
+
+// 与类型无关的映射与解除映射
+struct huge_page_base
+{
+    static constexpr size_t round_up(size_t bytes) noexcept
+    {
+        return (bytes + HUGE_PAGE_SIZE - 1) & ~(static_cast<size_t>(HUGE_PAGE_SIZE) - 1);
+    }
+
+    static bool use_mmap(size_t bytes) noexcept
+    {
+#if defined(__linux__)
+        return bytes >= static_cast<size_t>(HUGE_PAGE_THRESHOLD);
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static void* map(size_t bytes);
+    static void  unmap(void* ptr, size_t bytes) noexcept;
+};
+
+// 多映射一个大页的长度，再裁掉首尾未对齐的部分，得到 2MB 对齐的区域
+inline void* huge_page_base::map(size_t bytes)
+{
+#if defined(__linux__)
+    const size_t len = round_up(bytes);
+    const size_t map_len = len + HUGE_PAGE_SIZE;
+    void* raw = ::mmap(nullptr, map_len, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(raw == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    const uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    const uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) & ~(static_cast<uintptr_t>(HUGE_PAGE_SIZE) - 1);
+    const size_t head = aligned - start;
+    const size_t tail = map_len - head - len;
+    if(head != 0) ::munmap(raw, head);
+    if(tail != 0) ::munmap(reinterpret_cast<void*>(aligned + len), tail);
+#ifdef MADV_HUGEPAGE
+    ::madvise(reinterpret_cast<void*>(aligned), len, MADV_HUGEPAGE);
+#endif
+    return reinterpret_cast<void*>(aligned);
+#else
+    return ::operator new(bytes);
+#endif
+}
+
+inline void huge_page_base::unmap(void* ptr, size_t bytes) noexcept
+{
+#if defined(__linux__)
+    ::munmap(ptr, round_up(bytes));
+#else
+    (void)bytes;
+    ::operator delete(ptr);
+#endif
+}
+
+// huge_page_allocator
+template <typename T>
+class huge_page_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    typedef m_true_type propagate_on_container_move_assignment;
+    typedef m_true_type is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef huge_page_allocator<U> other;
+    };
+
+    huge_page_allocator() noexcept = default;
+    template <typename U>
+    huge_page_allocator(const huge_page_allocator<U>&) noexcept {}
+
+    static T* allocate(size_type n)
+    {
+        if(n == 0) return nullptr;
+        THROW_LENGTH_ERROR_IF(n > static_cast<size_type>(-1) / sizeof(T),
+                              "huge_page_allocator<T>'s allocate size too big");
+        const size_t bytes = n * sizeof(T);
+        if(huge_page_base::use_mmap(bytes))
+        {
+            return static_cast<T*>(huge_page_base::map(bytes));
+        }
+        return static_cast<T*>(mystl::aligned_new(bytes, alignof(T)));
+    }
+
+    static void deallocate(T* ptr, size_type n) noexcept
+    {
+        if(ptr == nullptr) return;
+        const size_t bytes = n * sizeof(T);
+        if(huge_page_base::use_mmap(bytes))
+        {
+            huge_page_base::unmap(ptr, bytes);
+            return;
+        }
+        mystl::aligned_delete(ptr, alignof(T));
+    }
+};
+
+template <typename T1, typename T2>
+bool operator== (const huge_page_allocator<T1>&, const huge_page_allocator<T2>&) noexcept
+{
+    return true;
+}
+
+template <typename T1, typename T2>
+bool operator!= (const huge_page_allocator<T1>&, const huge_page_allocator<T2>&) noexcept
+{
+    return false;
+}
+
+} // end of namespace mystl
+#endif // !HUGE_PAGE_ALLOCATOR_H_
@@ -0,0 +1,331 @@
+// -- inplace_vector_base.h 模版类 inplace_vector_base
+// 元素从不搬到新空间的 vector (static_vector、vm_vector) 共用的插入、删除、赋值与比较
+#ifndef INPLACE_VECTOR_BASE_H_
+#define INPLACE_VECTOR_BASE_H_
+
+// notes:
+// * 以 CRTP 方式使用: class C: public inplace_vector_base<C, T>，C 需要将基类声明为友元
+// * C 提供 begin() / end() / size() / clear() / emplace_back() / pop_back()，以及以下私有接口:
+//   - require_size(n):  保证能容纳 n 个元素，不能时抛出异常 (或按溢出策略处理)，容器不变
+//   - require_room(n):  保证还能再容纳 n 个元素，同上
+//   - set_size(n):      记录新的元素个数
+//   - destroy_elements(first, last): 析构 [first, last) 上的元素
+// * 保证容量不会移动已有元素，因此 pos 与参数中引用容器元素的指针在保证容量后仍然有效
+// * 区间的插入、删除、赋值经由 uninitialized.h，可平凡重定位的元素以 memmove 腾出位置
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+template <typename Derived, typename T>
+class inplace_vector_base
+{
+public:
+    // traits
+    typedef T                   value_type;
+    typedef T*                  pointer;
+    typedef const T*            const_pointer;
+    typedef T*                  iterator;
+    typedef const T*            const_iterator;
+    typedef size_t              size_type;
+
+public:
+    // assign
+    void assign(size_type n, const value_type& value);
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last)
+    {
+        copy_assign(first, last, iterator_category(first));
+    }
+
+    void assign(std::initializer_list<value_type> initlist)
+    {
+        copy_assign(initlist.begin(), initlist.end(), mystl::forward_iterator_tag{});
+    }
+
+    // emplace
+    template <typename ...Args>
+    iterator emplace(const_iterator pos, Args&& ...args);
+
+    // insert
+    iterator insert(const_iterator pos, const value_type& value) { return emplace(pos, value); }
+    iterator insert(const_iterator pos, value_type&& value) { return emplace(pos, mystl::move(value)); }
+    iterator insert(const_iterator pos, size_type n, const value_type& value);
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_input_iterator<Iter>::value, int>::type = 0>
+    iterator insert(const_iterator pos, Iter first, Iter last)
+    {
+        MYSTL_DEBUG(pos >= begin() && pos <= end());
+        return copy_insert(begin() + (pos - begin()), first, last, iterator_category(first));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<value_type> initlist)
+    {
+        return insert(pos, initlist.begin(), initlist.end());
+    }
+
+    // erase
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    // resize
+    void resize(size_type new_size, const value_type& value);
+
+    // 新增的元素默认初始化，可平凡默认构造的元素不写入任何内容
+    void resize_default_init(size_type new_size);
+
+    void reverse() { std::reverse(begin(), end()); }
+
+    // 重载比较运算符
+    friend bool operator==(const Derived& lhs, const Derived& rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+    friend bool operator<(const Derived& lhs, const Derived& rhs)
+    {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+    friend bool operator!=(const Derived& lhs, const Derived& rhs) { return !(lhs == rhs); }
+    friend bool operator> (const Derived& lhs, const Derived& rhs) { return rhs < lhs; }
+    friend bool operator<=(const Derived& lhs, const Derived& rhs) { return !(rhs < lhs); }
+    friend bool operator>=(const Derived& lhs, const Derived& rhs) { return !(lhs < rhs); }
+
+private:
+    // helper functions
+
+    Derived&       derived()       noexcept { return static_cast<Derived&>(*this); }
+    const Derived& derived() const noexcept { return static_cast<const Derived&>(*this); }
+
+    iterator  begin() noexcept { return derived().begin(); }
+    iterator  end()   noexcept { return derived().end(); }
+    size_type size()  const noexcept { return derived().size(); }
+
+    // assign
+    template <typename InputIter>
+    void copy_assign(InputIter first, InputIter last, input_iterator_tag);
+
+    template <typename ForwardIter>
+    void copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag);
+
+    // insert
+    template <typename InputIter>
+    iterator copy_insert(iterator pos, InputIter first, InputIter last, input_iterator_tag);
+
+    template <typename ForwardIter>
+    iterator copy_insert(iterator pos, ForwardIter first, ForwardIter last, forward_iterator_tag);
+
+    template <typename Construct>
+    void open_gap(iterator pos, size_type n, Construct construct);
+};
+
+/*****************************************************************************************/
+
+// assign: 先保证容量，失败时容器保持不变
+template <typename Derived, typename T>
+void inplace_vector_base<Derived, T>::assign(size_type n, const value_type& value)
+{
+    derived().require_size(n);
+    if(n > size())
+    {
+        std::fill(begin(), end(), value);
+        mystl::uninitialized_fill_n(end(), n - size(), value);
+        derived().set_size(n);
+    }
+    else
+    {
+        erase(std::fill_n(begin(), n, value), end());
+    }
+}
+
+// 输入迭代器只能遍历一次，逐个追加
+template <typename Derived, typename T>
+template <typename InputIter>
+void inplace_vector_base<Derived, T>::copy_assign(InputIter first, InputIter last, input_iterator_tag)
+{
+    derived().clear();
+    for(; first != last; ++first)
+        derived().emplace_back(*first);
+}
+
+template <typename Derived, typename T>
+template <typename ForwardIter>
+void inplace_vector_base<Derived, T>::copy_assign(ForwardIter first, ForwardIter last,
+                                                  forward_iterator_tag)
+{
+    const size_type len = mystl::distance(first, last);
+    derived().require_size(len);
+    if(len > size())
+    {
+        auto mid = first;
+        mystl::advance(mid, size());
+        std::copy(first, mid, begin());
+        mystl::uninitialized_copy(mid, last, end());
+        derived().set_size(len);
+    }
+    else
+    {
+        erase(std::copy(first, last, begin()), end());
+    }
+}
+
+// emplace: 保证容量不移动元素，因此可以先保证容量，再构造可能引用容器元素的参数
+template <typename Derived, typename T>
+template <typename ...Args>
+typename inplace_vector_base<Derived, T>::iterator
+inplace_vector_base<Derived, T>::emplace(const_iterator pos, Args&& ...args)
+{
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    const size_type offset = pos - begin();
+    derived().require_room(1);
+    if(offset == size())
+    {
+        derived().emplace_back(mystl::forward<Args>(args)...);
+        return begin() + offset;
+    }
+    value_type value_copy(mystl::forward<Args>(args)...);
+    open_gap(begin() + offset, 1, [&](iterator gap) {
+        mystl::_construct(gap, mystl::move(value_copy));
+    });
+    return begin() + offset;
+}
+
+// insert n 个 value
+template <typename Derived, typename T>
+typename inplace_vector_base<Derived, T>::iterator
+inplace_vector_base<Derived, T>::insert(const_iterator pos, size_type n, const value_type& value)
+{
+    MYSTL_DEBUG(pos >= begin() && pos <= end());
+    const size_type offset = pos - begin();
+    if(n == 0) return begin() + offset;
+    derived().require_room(n);
+    const value_type value_copy = value;
+    open_gap(begin() + offset, n, [&](iterator gap) {
+        mystl::uninitialized_fill_n(gap, n, value_copy);
+    });
+    return begin() + offset;
+}
+
+// 输入迭代器: 追加到末尾后旋转到 pos
+template <typename Derived, typename T>
+template <typename InputIter>
+typename inplace_vector_base<Derived, T>::iterator
+inplace_vector_base<Derived, T>::copy_insert(iterator pos, InputIter first, InputIter last,
+                                             input_iterator_tag)
+{
+    const size_type offset = pos - begin();
+    const size_type old_size = size();
+    for(; first != last; ++first)
+        derived().emplace_back(*first);
+    std::rotate(begin() + offset, begin() + old_size, end());
+    return begin() + offset;
+}
+
+template <typename Derived, typename T>
+template <typename ForwardIter>
+typename inplace_vector_base<Derived, T>::iterator
+inplace_vector_base<Derived, T>::copy_insert(iterator pos, ForwardIter first, ForwardIter last,
+                                             forward_iterator_tag)
+{
+    const size_type offset = pos - begin();
+    const size_type n = mystl::distance(first, last);
+    if(n == 0) return pos;
+    derived().require_room(n);
+    open_gap(begin() + offset, n, [&](iterator gap) {
+        mystl::uninitialized_copy(first, last, gap);
+    });
+    return begin() + offset;
+}
+
+// open_gap: 把 [pos, end()) 后移 n 位，由 construct 在 [pos, pos + n) 上构造新元素，调用前已保证容量
+// 可平凡重定位的元素整体 memmove，构造失败时移回；否则在末尾之后构造，再旋转到 pos
+template <typename Derived, typename T>
+template <typename Construct>
+void inplace_vector_base<Derived, T>::open_gap(iterator pos, size_type n, Construct construct)
+{
+    const iterator old_end = end();
+    if(mystl::is_trivially_relocatable<value_type>::value)
+    {
+        mystl::uninitialized_relocate(pos, old_end, pos + n);
+        try
+        {
+            construct(pos);
+        }
+        catch(...)
+        {
+            mystl::uninitialized_relocate(pos + n, old_end + n, pos);
+            throw;
+        }
+        derived().set_size(size() + n);
+        return;
+    }
+
+    // 新元素先构造在末尾之后，再旋转到 pos
+    construct(old_end);
+    derived().set_size(size() + n);
+    std::rotate(pos, old_end, old_end + n);
+}
+
+// erase
+template <typename Derived, typename T>
+typename inplace_vector_base<Derived, T>::iterator
+inplace_vector_base<Derived, T>::erase(const_iterator pos)
+{
+    MYSTL_DEBUG(pos >= begin() && pos < end());
+    iterator xpos = begin() + (pos - begin());
+    std::move(xpos + 1, end(), xpos);
+    derived().pop_back();
+    return xpos;
+}
+
+template <typename Derived, typename T>
+typename inplace_vector_base<Derived, T>::iterator
+inplace_vector_base<Derived, T>::erase(const_iterator first, const_iterator last)
+{
+    MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+    iterator xfirst = begin() + (first - begin());
+    iterator new_end = std::move(begin() + (last - begin()), end(), xfirst);
+    derived().destroy_elements(new_end, end());
+    derived().set_size(new_end - begin());
+    return xfirst;
+}
+
+// resize
+template <typename Derived, typename T>
+void inplace_vector_base<Derived, T>::resize(size_type new_size, const value_type& value)
+{
+    if(new_size < size())
+    {
+        erase(begin() + new_size, end());
+        return;
+    }
+    derived().require_size(new_size);
+    mystl::uninitialized_fill_n(end(), new_size - size(), value);
+    derived().set_size(new_size);
+}
+
+template <typename Derived, typename T>
+void inplace_vector_base<Derived, T>::resize_default_init(size_type new_size)
+{
+    if(new_size < size())
+    {
+        erase(begin() + new_size, end());
+        return;
+    }
+    derived().require_size(new_size);
+    mystl::uninitialized_default_construct_n(end(), new_size - size());
+    derived().set_size(new_size);
+}
+
+} // end of namespace mystl
+#endif // !INPLACE_VECTOR_BASE_H_
@@ -210,7 +210,7 @@ void advance_dispatch(BidirectionalIterator & ite, Distance n, bidirectional_ite
 
 // random iterator 
 template<typename RandomIterator, typename Distance> 
-void advance_dispatch(RandomIterator ite, Distance n, random_access_iterator_tag)
+void advance_dispatch(RandomIterator& ite, Distance n, random_access_iterator_tag)
 {
     ite +=n; 
 }
@@ -219,22 +219,26 @@ struct list_const_iterator: public mystl::iterator<mystl::bidirectional_iterator
 };
 
 // list 
-template <typename T> 
-class list 
+template <typename T, typename Alloc = mystl::allocator<T>> 
+class list: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<list_node<T>>>
 {
 public: 
-    typedef mystl::allocator<T>                         allocator_type; 
-    typedef mystl::allocator<T>                         data_allocator;  
-    typedef mystl::allocator<list_node_base<T>>         base_allocator; 
-    typedef mystl::allocator<list_node<T>>              node_allocator; 
-
-    typedef typename allocator_type::value_type         value_type; 
-    typedef typename allocator_type::pointer            pointer; 
-    typedef typename allocator_type::const_pointer      const_pointer; 
-    typedef typename allocator_type::reference          reference; 
-    typedef typename allocator_type::const_reference    const_reference; 
-    typedef typename allocator_type::size_type          size_type; 
-    typedef typename allocator_type::difference_type    difference_type; 
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type; 
+    typedef allocator_type                              data_allocator;  
+    typedef mystl::allocator_traits<data_allocator>     data_traits; 
+    typedef typename data_traits::template rebind_alloc<list_node_base<T>>  base_allocator; 
+    typedef typename data_traits::template rebind_alloc<list_node<T>>       node_allocator; 
+    typedef mystl::allocator_traits<base_allocator>     base_traits; 
+    typedef mystl::allocator_traits<node_allocator>     node_traits; 
+
+    typedef typename data_traits::value_type            value_type; 
+    typedef typename data_traits::pointer               pointer; 
+    typedef typename data_traits::const_pointer         const_pointer; 
+    typedef value_type&                                 reference; 
+    typedef const value_type&                           const_reference; 
+    typedef typename data_traits::size_type             size_type; 
+    typedef typename data_traits::difference_type       difference_type; 
 
     typedef list_iterator<T>                            iterator; 
     typedef list_const_iterator<T>                      const_iterator; 
@@ -244,10 +248,12 @@ public:
     typedef typename node_triats<T>::base_ptr           base_ptr; 
     typedef typename node_triats<T>::node_ptr           node_ptr; 
 
-    // should be return data_allocator(); 
-    allocator_type  get_allocator() {return data_allocator(); }
+    allocator_type  get_allocator() const {return allocator_type(get_alloc()); }
 
 private:   
+    typedef mystl::alloc_holder<node_allocator>         alloc_base; 
+    using alloc_base::get_alloc; 
+
     base_ptr    _node;      // 指向末尾节点 
     size_type   _size;      // 大小
 
@@ -259,13 +265,20 @@ public:
     {
         fill_init(0, value_type()); 
     }
+
+    explicit list(const allocator_type& alloc): alloc_base(node_allocator(alloc))
+    {
+        fill_init(0, value_type()); 
+    }
     
-    explicit list(size_type n)
+    explicit list(size_type n, const allocator_type& alloc = allocator_type())
+    : alloc_base(node_allocator(alloc))
     {
         fill_init(n, value_type()); 
     }
 
-    list(size_type n, const T& value)
+    list(size_type n, const T& value, const allocator_type& alloc = allocator_type())
+    : alloc_base(node_allocator(alloc))
     {
         fill_init(n, value); 
     }
@@ -273,24 +286,28 @@ public:
     // range 
     template <typename Iter, 
         typename std::enable_if<mystl::is_input_iterator<Iter>::value,int>::type = 0>
-    list(Iter first, Iter last)
+    list(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    : alloc_base(node_allocator(alloc))
     {
         copy_init(first, last); 
     }   
 
-    list(std::initializer_list<T> initlist)
+    list(std::initializer_list<T> initlist, const allocator_type& alloc = allocator_type())
+    : alloc_base(node_allocator(alloc))
     {
         copy_init(initlist.begin(), initlist.end()); 
     }
 
     // copy ctor 
     list(const list& rhs)
+    : alloc_base(node_traits::select_on_container_copy_construction(rhs.get_alloc()))
     {
         copy_init(rhs.cbegin(), rhs.cend()); 
     }
 
     // move ctor 
-    list(list&& rhs) noexcept: _node(rhs._node), _size(rhs._size)
+    list(list&& rhs) noexcept
+    : alloc_base(mystl::move(rhs.get_alloc())), _node(rhs._node), _size(rhs._size)
     {
         rhs._node = nullptr; 
         rhs._size = 0; 
@@ -301,25 +318,51 @@ public:
     {
         if(this != &rhs )  
         {
+            // 需要传播分配器且两者不相等时，旧节点只能由旧分配器回收
+            if(node_traits::propagate_on_container_copy_assignment::value && 
+                !mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+            {
+                clear(); 
+                destroy_sentinel(_node); 
+                mystl::alloc_on_copy(get_alloc(), rhs.get_alloc()); 
+                fill_init(0, value_type()); 
+            }
             assign(rhs.begin(), rhs.end()); 
         }
         return *this; 
     }
 
     // move assign 
-    list& operator= (list &&rhs) noexcept 
+    // 分配器不相等且不传播时需要逐个移动元素，可能抛出异常
+    list& operator= (list &&rhs) noexcept(
+        node_traits::propagate_on_container_move_assignment::value || 
+        node_traits::is_always_equal::value) 
     {
         // 清空自身节点
         clear(); 
-        // 将rhs 接在end之前
-        splice(end(), rhs); 
+        if(node_traits::propagate_on_container_move_assignment::value || 
+            mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+        {
+            mystl::alloc_on_move(get_alloc(), rhs.get_alloc()); 
+            // 将rhs 接在end之前
+            splice(end(), rhs); 
+        }
+        else 
+        {
+            // 分配器不相等：节点不能跨分配器转移，逐个移动元素
+            for(auto first = rhs.begin(); first != rhs.end(); ++first)
+            {
+                emplace_back(mystl::move(*first)); 
+            }
+            rhs.clear(); 
+        }
         return *this; 
     }
 
     // range copy assign 
     list& operator= (std::initializer_list<T> initlist)
     {
-        list temp (initlist.begin(), initlist.end()); 
+        list temp (initlist.begin(), initlist.end(), get_allocator()); 
         swap(temp);
         return *this; 
     }
@@ -330,7 +373,7 @@ public:
         if(_node)
         {
             clear(); 
-            base_allocator::deallocate(_node); 
+            destroy_sentinel(_node); 
             _node = nullptr; 
             _size = 0; 
         }
@@ -553,6 +596,7 @@ public:
         {
             mystl::swap(_node, rhs._node); 
             mystl::swap(_size, rhs._size); 
+            mystl::alloc_on_swap(get_alloc(), rhs.get_alloc()); 
         }
     }
 
@@ -601,6 +645,10 @@ private:
 
     void destroy_node(node_ptr p); 
 
+    // sentinel node 
+    base_ptr create_sentinel(); 
+    void destroy_sentinel(base_ptr p); 
+
     // initialize 
     void fill_init(size_type n, const value_type& value); 
     template <typename Iter>   
@@ -629,9 +677,9 @@ private:
 };  // end of class list<T> 
 
 // erase pos bug: what if erase first element? 
-template <typename T> 
-typename list<T>::iterator 
-list<T>::erase(const_iterator pos) 
+template <typename T, typename Alloc> 
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::erase(const_iterator pos) 
 {
     MYSTL_DEBUG(pos != cend()); 
     auto n = pos._node; 
@@ -644,9 +692,9 @@ list<T>::erase(const_iterator pos)
 }
 
 // erase [first, last) 
-template<typename T> 
-typename list<T>::iterator 
-list<T>::erase(const_iterator first, const_iterator last)
+template <typename T, typename Alloc> 
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::erase(const_iterator first, const_iterator last)
 {
     if(first != last) 
     {
@@ -663,15 +711,30 @@ list<T>::erase(const_iterator first, const_iterator last)
 }
 
 // clear list 
-template <typename T> 
-void list<T>::clear() 
+template <typename T, typename Alloc> 
+void list<T, Alloc>::clear() 
 {
     if(_size != 0)
     {
         auto cur = _node->next; 
-        for(base_ptr next = cur->next; cur != _node; cur = next, next = cur->next)
+        if(node_traits::releasable(get_alloc(), _size))
         {
-            destroy_node(cur->as_node()); 
+            // 分配器中的节点全部属于本容器：只析构元素，节点所在的 slab 整体回收
+            if(!std::is_trivially_destructible<T>::value)
+            {
+                for(; cur != _node; cur = cur->next)
+                {
+                    node_traits::destroy(get_alloc(), mystl::address_of(cur->as_node()->value)); 
+                }
+            }
+            node_traits::release(get_alloc()); 
+        }
+        else
+        {
+            for(base_ptr next = cur->next; cur != _node; cur = next, next = cur->next)
+            {
+                destroy_node(cur->as_node()); 
+            }
         }
         _node->unlink(); 
         _size = 0; 
@@ -679,8 +742,8 @@ void list<T>::clear()
 }
 
 // resize 
-template <typename T> 
-void list<T>::resize(size_type new_size, const value_type& value)
+template <typename T, typename Alloc> 
+void list<T, Alloc>::resize(size_type new_size, const value_type& value)
 {
     auto ite = begin(); 
     size_type len = 0; 
@@ -701,8 +764,8 @@ void list<T>::resize(size_type new_size, const value_type& value)
 }
 
 // splice: 将list x 接在pos之前
-template <typename T> 
-void list<T>::splice(const_iterator pos, list& x) 
+template <typename T, typename Alloc> 
+void list<T, Alloc>::splice(const_iterator pos, list& x) 
 {
     MYSTL_DEBUG(this != &x); 
     if(!x.empty())
@@ -721,8 +784,8 @@ void list<T>::splice(const_iterator pos, list& x)
 }
 
 // splice: 将it 指向节点接在pos之前
-template <typename T>   
-void list<T>::splice(const_iterator pos, list& x, const_iterator it) 
+template <typename T, typename Alloc>   
+void list<T, Alloc>::splice(const_iterator pos, list& x, const_iterator it) 
 {
     if(pos._node != it._node && pos._node != it._node->next)
     {
@@ -738,8 +801,8 @@ void list<T>::splice(const_iterator pos, list& x, const_iterator it)
 }
 
 // splice: 将list x 的[first, last) 节点接在pos之前
-template <typename T> 
-void list<T>:: splice(const_iterator pos, list& x, const_iterator first, const_iterator last) 
+template <typename T, typename Alloc> 
+void list<T, Alloc>:: splice(const_iterator pos, list& x, const_iterator first, const_iterator last) 
 {
     if(first != last ) 
     {
@@ -767,9 +830,9 @@ void list<T>:: splice(const_iterator pos, list& x, const_iterator first, const_i
 }
 
 // remove_if: 删除满足条件的元素
-template<typename T> 
+template <typename T, typename Alloc> 
 template<typename UnaryPrdicate> 
-void list<T>::remove_if(UnaryPrdicate pred)
+void list<T, Alloc>::remove_if(UnaryPrdicate pred)
 {
     auto first = begin(); 
     auto last = end(); 
@@ -781,9 +844,9 @@ void list<T>::remove_if(UnaryPrdicate pred)
 }
 
 // remove_if:
-template <typename T> 
+template <typename T, typename Alloc> 
 template <typename BinaryPredicate> 
-void list<T>::unique(BinaryPredicate pred) 
+void list<T, Alloc>::unique(BinaryPredicate pred) 
 {
     auto first = begin(); 
     auto last = end(); 
@@ -799,9 +862,9 @@ void list<T>::unique(BinaryPredicate pred)
 } 
 
 // merge with another list 按照comp 为true 的顺序
-template <typename T>   
+template <typename T, typename Alloc>   
 template <typename Compare>  
-void list<T>:: merge(list& x, Compare comp)
+void list<T, Alloc>:: merge(list& x, Compare comp)
 {
     if(this != &x) 
     {
@@ -851,8 +914,8 @@ void list<T>:: merge(list& x, Compare comp)
 }
 
 // reverse list 
-template <typename T> 
-void list<T>::reverse()
+template <typename T, typename Alloc> 
+void list<T, Alloc>::reverse()
 {
     if(_size < 1) return; 
 
@@ -871,39 +934,56 @@ void list<T>::reverse()
 // helper function 
 
 // create nodes 
-template <typename T> 
+template <typename T, typename Alloc> 
 template <typename...Args>   
-typename list<T>::node_ptr 
-list<T>::create_node(Args&&...args) 
+typename list<T, Alloc>::node_ptr 
+list<T, Alloc>::create_node(Args&&...args) 
 {
-    node_ptr p = node_allocator::allocate(1); 
+    node_ptr p = node_traits::allocate(get_alloc(), 1); 
     try
     {
-        data_allocator::construct(mystl::address_of(p->value), mystl::forward<Args>(args)...);
+        node_traits::construct(get_alloc(), mystl::address_of(p->value), mystl::forward<Args>(args)...);
         p->prev = nullptr;
         p->next = nullptr; 
     }
     catch(...)
     {
-        node_allocator::deallocate(p);
+        node_traits::deallocate(get_alloc(), p, 1);
         throw; 
     }
     return p; 
 }
 
 // destroy node 
-template <typename T> 
-void list<T>::destroy_node(node_ptr p) 
+template <typename T, typename Alloc> 
+void list<T, Alloc>::destroy_node(node_ptr p) 
+{
+    node_traits::destroy(get_alloc(), mystl::address_of(p->value)); 
+    node_traits::deallocate(get_alloc(), p, 1); 
+}
+
+// create sentinel node: 哨兵节点不含 value，只分配 list_node_base 
+template <typename T, typename Alloc> 
+typename list<T, Alloc>::base_ptr 
+list<T, Alloc>::create_sentinel() 
+{
+    base_allocator ba(get_alloc()); 
+    return base_traits::allocate(ba, 1); 
+}
+
+// destroy sentinel node 
+template <typename T, typename Alloc> 
+void list<T, Alloc>::destroy_sentinel(base_ptr p) 
 {
-    data_allocator::destroy(mystl::address_of(p->value)); 
-    node_allocator::deallocate(p); 
+    base_allocator ba(get_alloc()); 
+    base_traits::deallocate(ba, p, 1); 
 }
 
 // fill_init 
-template <typename T> 
-void list<T>::fill_init(size_type n, const value_type& value)
+template <typename T, typename Alloc> 
+void list<T, Alloc>::fill_init(size_type n, const value_type& value)
 {
-    _node = base_allocator::allocate(1); 
+    _node = create_sentinel(); 
     _node->unlink(); 
 
     _size = n; 
@@ -919,7 +999,7 @@ void list<T>::fill_init(size_type n, const value_type& value)
     catch(...)
     {
         clear(); 
-        base_allocator::deallocate(_node); 
+        destroy_sentinel(_node); 
         _node = nullptr; 
         _size = 0; 
         throw; 
@@ -927,11 +1007,11 @@ void list<T>::fill_init(size_type n, const value_type& value)
 }
 
 // copy_init [first, last) 
-template <typename T> 
+template <typename T, typename Alloc> 
 template <typename Iter>  
-void list<T>::copy_init(Iter first, Iter last) 
+void list<T, Alloc>::copy_init(Iter first, Iter last) 
 {
-    _node = base_allocator::allocate(1);
+    _node = create_sentinel();
     _node->unlink(); 
 
     size_type n = mystl::distance(first, last); 
@@ -948,7 +1028,7 @@ void list<T>::copy_init(Iter first, Iter last)
     catch(...)
     {
         clear();
-        base_allocator::deallocate(_node); 
+        destroy_sentinel(_node); 
         _node = nullptr; 
         _size = 0; 
         throw;  
@@ -956,9 +1036,9 @@ void list<T>::copy_init(Iter first, Iter last)
 }
 
 // pos 连接一个节点(pos -> link_node)
-template<typename T> 
-typename list<T>::iterator 
-list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
+template <typename T, typename Alloc> 
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::link_iter_node(const_iterator pos, base_ptr link_node)
 {
     if(pos == _node->next)
     {
@@ -977,8 +1057,8 @@ list<T>::link_iter_node(const_iterator pos, base_ptr link_node)
 }
 
 // pos 处连接[first, last) [first, last]->pos
-template <typename T> 
-void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) 
+template <typename T, typename Alloc> 
+void list<T, Alloc>::link_nodes(base_ptr pos, base_ptr first, base_ptr last) 
 {
     pos->prev->next = first; 
     first->prev = pos->prev; 
@@ -987,8 +1067,8 @@ void list<T>::link_nodes(base_ptr pos, base_ptr first, base_ptr last)
 }
 
 // 头部连接 [first, last] 
-template<typename T> 
-void list<T>:: link_nodes_at_front(base_ptr first, base_ptr last) 
+template <typename T, typename Alloc> 
+void list<T, Alloc>:: link_nodes_at_front(base_ptr first, base_ptr last) 
 {
     first->prev =_node; 
     last->next = _node->next; 
@@ -997,8 +1077,8 @@ void list<T>:: link_nodes_at_front(base_ptr first, base_ptr last)
 }
 
 // 尾部连接 [first, last] 
-template<typename T>   
-void list<T>::link_nodes_at_back(base_ptr first, base_ptr last) 
+template <typename T, typename Alloc>   
+void list<T, Alloc>::link_nodes_at_back(base_ptr first, base_ptr last) 
 {
     last->next = _node; 
     first->prev = _node->prev; 
@@ -1007,16 +1087,16 @@ void list<T>::link_nodes_at_back(base_ptr first, base_ptr last)
 }
 
 // list 与其中的一段[first, last] 断开连接
-template <typename T> 
-void list<T>::unlink_nodes(base_ptr first, base_ptr last)
+template <typename T, typename Alloc> 
+void list<T, Alloc>::unlink_nodes(base_ptr first, base_ptr last)
 {
     first->prev->next = last->next; 
     last->next->prev = first->prev; 
 }
 
 // fill_assign n 
-template<typename T> 
-void list<T>::fill_assign(size_type n, const value_type& value) 
+template <typename T, typename Alloc> 
+void list<T, Alloc>::fill_assign(size_type n, const value_type& value) 
 {
     auto first = begin(); 
     auto last = end(); 
@@ -1036,9 +1116,9 @@ void list<T>::fill_assign(size_type n, const value_type& value)
 }
 
 // copy_assign[f2, l2)  
-template <typename T> 
+template <typename T, typename Alloc> 
 template <typename Iter> 
-void list<T>::copy_assign(Iter f2, Iter l2) 
+void list<T, Alloc>::copy_assign(Iter f2, Iter l2) 
 {
     auto f1 = begin(); 
     auto l1 = end(); 
@@ -1058,9 +1138,9 @@ void list<T>::copy_assign(Iter f2, Iter l2)
 }
 
 // pos fill_assign n 
-template <typename T> 
-typename list<T>::iterator 
-list<T>::fill_insert(const_iterator pos, size_type n, const value_type& value) 
+template <typename T, typename Alloc> 
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::fill_insert(const_iterator pos, size_type n, const value_type& value) 
 {
     iterator r(pos._node); 
     if(n != 0)
@@ -1102,10 +1182,10 @@ list<T>::fill_insert(const_iterator pos, size_type n, const value_type& value)
 }
 
 // pos 处插入[first, last) 
-template<typename T> 
+template <typename T, typename Alloc> 
 template <typename Iter >  
-typename list<T>::iterator 
-list<T>::copy_insert(const_iterator pos, size_type n, Iter first) 
+typename list<T, Alloc>::iterator 
+list<T, Alloc>::copy_insert(const_iterator pos, size_type n, Iter first) 
 {
     iterator r(pos._node); 
     if(n != 0)
@@ -1149,10 +1229,10 @@ list<T>::copy_insert(const_iterator pos, size_type n, Iter first)
 }
 
 // list merge sort  
-template <typename T> 
+template <typename T, typename Alloc> 
 template <typename Compare>   
-typename list<T>::iterator 
-list<T>:: list_sort(iterator f1, iterator l2, size_type n, Compare cmp)
+typename list<T, Alloc>::iterator 
+list<T, Alloc>:: list_sort(iterator f1, iterator l2, size_type n, Compare cmp)
 {
     if(n < 2) return f1; 
 
@@ -1230,8 +1310,8 @@ list<T>:: list_sort(iterator f1, iterator l2, size_type n, Compare cmp)
 }
 
 // overloads relational opeartors 
-template <typename T> 
-bool operator==(const list<T>& lhs, const list<T>& rhs)
+template <typename T, typename Alloc> 
+bool operator==(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
     auto f1 = lhs.begin(); 
     auto l1 = lhs.end(); 
@@ -1244,42 +1324,52 @@ bool operator==(const list<T>& lhs, const list<T>& rhs)
     return f1 == l1 && f2 == l2; 
 }
 
-template <typename T> 
-bool operator< (const list<T>& lhs, const list<T>& rhs)
+template <typename T, typename Alloc> 
+bool operator< (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
     return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend());
 }
 
-template <typename T> 
-bool operator != (const list<T>& lhs, const list<T>& rhs)
+template <typename T, typename Alloc> 
+bool operator != (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
     return !(lhs == rhs); 
 }
 
-template <typename T> 
-bool operator >(const list<T>& lhs, const list<T>& rhs)
+template <typename T, typename Alloc> 
+bool operator >(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
     return (rhs < lhs); 
 }
 
-template<typename T> 
-bool operator <=(const list<T>& lhs, const list<T>& rhs)
+template <typename T, typename Alloc> 
+bool operator <=(const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
     return !(rhs < lhs);
 }
 
-template <typename T>   
-bool operator>= (const list<T>& lhs, const list<T>& rhs)
+template <typename T, typename Alloc>   
+bool operator>= (const list<T, Alloc>& lhs, const list<T, Alloc>& rhs)
 {
     return !(lhs < rhs); 
 }
 
 // generic swap 
-template<typename T> 
-void swap(list<T>& lhs, list<T>& rhs)
+template <typename T, typename Alloc> 
+void swap(list<T, Alloc>& lhs, list<T, Alloc>& rhs)
 {
     lhs.swap(rhs);
 }
 
+// 哨兵节点在堆上，list 自身不含指向自身的指针，分配器可平凡重定位时 list 也可以
+template <typename T, typename Alloc> 
+struct is_trivially_relocatable<mystl::list<T, Alloc>>: is_trivially_relocatable<Alloc> {}; 
+
+namespace pmr
+{
+template <typename T>
+using list = mystl::list<T, polymorphic_allocator<T>>;
+}
+
 } // end of namespace mystl 
 #endif // !_LIST_H_
\ No newline at end of file
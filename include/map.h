@@ -12,7 +12,8 @@
 
 namespace mystl
 {
-template<typename Key, typename T, typename Compar = mystl::less<Key>> 
+template<typename Key, typename T, typename Compar = mystl::less<Key>, 
+    typename Alloc = mystl::allocator<mystl::pair<const Key, T>>> 
 class map  
 {
 public: 
@@ -24,7 +25,7 @@ public:
     // functor for comparing 
     class value_compare:public mystl::binary_function<value_type, value_type, bool> 
     {
-        friend class map<Key, T, Compar> ; 
+        friend class map<Key, T, Compar, Alloc> ; 
     private:  
         Compar   comp; 
         value_compare(Compar c): comp(c) {}  
@@ -37,7 +38,7 @@ public:
 
 private: 
     // base on rbtree
-    typedef mystl::rb_tree<value_type, key_compare>         base_type; 
+    typedef mystl::rb_tree<value_type, key_compare, Alloc>         base_type; 
     base_type                                               _tree;
 
 public: 
@@ -59,6 +60,8 @@ public:
     // ctors 
     map() = default; 
 
+    explicit map(const allocator_type& alloc): _tree(alloc) {} 
+
     template <typename InputIter>  
     map(InputIter first, InputIter last): _tree()
     {
@@ -77,7 +80,7 @@ public:
     }
 
     // move ctor 
-    map(map&& rhs):_tree(mystl::move(rhs.tree))
+    map(map&& rhs):_tree(mystl::move(rhs._tree))
     {
 
     }   
@@ -255,45 +258,46 @@ public:
 }; 
 
 // overload operator 
-template <typename Key, typename T, typename Compar>  
-bool operator== (const map<Key, T, Compar>& lhs, const map<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator== (const map<Key, T, Compar, Alloc>& lhs, const map<Key, T, Compar, Alloc>& rhs)
 {
     return lhs == rhs; 
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator < (const map<Key, T, Compar>& lhs, const map<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator < (const map<Key, T, Compar, Alloc>& lhs, const map<Key, T, Compar, Alloc>& rhs)
 {
     return lhs < rhs; 
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator!= (const map<Key, T, Compar>& lhs, const map<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator!= (const map<Key, T, Compar, Alloc>& lhs, const map<Key, T, Compar, Alloc>& rhs)
 {
     return !(rhs == lhs); 
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator> (const map<Key, T, Compar>& lhs, const map<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator> (const map<Key, T, Compar, Alloc>& lhs, const map<Key, T, Compar, Alloc>& rhs)
 {
     return rhs < lhs; 
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator <= (const map<Key, T, Compar>& lhs, const map<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator <= (const map<Key, T, Compar, Alloc>& lhs, const map<Key, T, Compar, Alloc>& rhs)
 {
     return !(rhs < lhs); 
 }
 
 // overload generic swap 
-template <typename Key, typename T, typename Compar> 
-void swap(map<Key, T, Compar>& lhs, map<Key, T, Compar>& rhs) noexcept
+template <typename Key, typename T, typename Compar, typename Alloc> 
+void swap(map<Key, T, Compar, Alloc>& lhs, map<Key, T, Compar, Alloc>& rhs) noexcept
 {
     lhs.swap(rhs);
 }
 
 // multimap 
-template <typename Key, typename T, typename Compar = mystl::less<Key>> 
+template <typename Key, typename T, typename Compar = mystl::less<Key>, 
+    typename Alloc = mystl::allocator<mystl::pair<const Key, T>>> 
 class multimap  
 {
 public: 
@@ -306,7 +310,7 @@ public:
     // functor for comparision 
     struct value_compare: public binary_function<value_type, value_type, bool> 
     {
-        friend class multimap<Key, T, Compar>; 
+        friend class multimap<Key, T, Compar, Alloc>; 
     private:   
         Compar      comp; 
         value_compare(Compar c): comp(c) {} 
@@ -318,7 +322,7 @@ public:
     }; 
 
 private:  
-    typedef mystl::rb_tree<value_type, key_compare>         base_type; 
+    typedef mystl::rb_tree<value_type, key_compare, Alloc>         base_type; 
     base_type   _tree; 
 
 public:  
@@ -340,6 +344,8 @@ public:
     // ctors 
     multimap() = default; 
 
+    explicit multimap(const allocator_type& alloc): _tree(alloc) {} 
+
     template <typename InputIter>  
     multimap(InputIter first, InputIter last): _tree() 
     {
@@ -531,47 +537,64 @@ public:
  }; 
 
 // relational operator oveloading 
-template <typename Key, typename T, typename Compar>  
-bool operator == (const multimap<Key, T, Compar>& lhs, const multimap<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator == (const multimap<Key, T, Compar, Alloc>& lhs, const multimap<Key, T, Compar, Alloc>& rhs)
 {
     return lhs == rhs; 
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator< (const multimap<Key, T, Compar>& lhs, const multimap<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator< (const multimap<Key, T, Compar, Alloc>& lhs, const multimap<Key, T, Compar, Alloc>& rhs)
 {
     return lhs < rhs; 
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator!= (const multimap<Key, T, Compar>& lhs, const multimap<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator!= (const multimap<Key, T, Compar, Alloc>& lhs, const multimap<Key, T, Compar, Alloc>& rhs)
 {
     return !(lhs == rhs); 
 }
 
-template <typename Key, typename T, typename Compar>   
-bool operator> (const multimap<Key, T, Compar>& lhs, const multimap<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>   
+bool operator> (const multimap<Key, T, Compar, Alloc>& lhs, const multimap<Key, T, Compar, Alloc>& rhs)
 {
     return rhs < lhs; 
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator<= (const multimap<Key, T, Compar>& lhs, const multimap<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator<= (const multimap<Key, T, Compar, Alloc>& lhs, const multimap<Key, T, Compar, Alloc>& rhs)
 {
     return !(rhs < lhs);
 }
 
-template <typename Key, typename T, typename Compar>  
-bool operator>= (const multimap<Key, T, Compar>& lhs, const multimap<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+bool operator>= (const multimap<Key, T, Compar, Alloc>& lhs, const multimap<Key, T, Compar, Alloc>& rhs)
 {
     return !(lhs < rhs); 
 }
 
 // overloading generic swap 
-template <typename Key, typename T, typename Compar>  
-void swap(multimap<Key, T, Compar>& lhs, multimap<Key, T, Compar>& rhs)
+template <typename Key, typename T, typename Compar, typename Alloc>  
+void swap(multimap<Key, T, Compar, Alloc>& lhs, multimap<Key, T, Compar, Alloc>& rhs)
 {
     lhs.swap(rhs); 
 }
+
+// map / multimap 与底层 rb_tree 相同
+template <typename Key, typename T, typename Compar, typename Alloc> 
+struct is_trivially_relocatable<mystl::map<Key, T, Compar, Alloc>>: 
+    is_trivially_relocatable<mystl::rb_tree<mystl::pair<const Key, T>, Compar, Alloc>> {}; 
+
+template <typename Key, typename T, typename Compar, typename Alloc> 
+struct is_trivially_relocatable<mystl::multimap<Key, T, Compar, Alloc>>: 
+    is_trivially_relocatable<mystl::rb_tree<mystl::pair<const Key, T>, Compar, Alloc>> {}; 
+
+namespace pmr
+{
+template <typename Key, typename T, typename Compar = mystl::less<Key>>
+using map = mystl::map<Key, T, Compar, polymorphic_allocator<mystl::pair<const Key, T>>>;
+template <typename Key, typename T, typename Compar = mystl::less<Key>>
+using multimap = mystl::multimap<Key, T, Compar, polymorphic_allocator<mystl::pair<const Key, T>>>;
+}
 }   // end of mystl 
 #endif // !MAP_H_
\ No newline at end of file
@@ -1,6 +1,6 @@
 // -- memory.h undone
 // 负责更高级的动态内存管理
-// 基本函数 空间配置器 未初始化的空间管理，模版类 auto_ptr 
+// 基本函数 空间配置器 未初始化的空间管理，模版类 auto_ptr, unique_ptr, shared_ptr, weak_ptr, intrusive_ptr 
 #ifndef MEMORY_H_
 #define MEMORY_H_ 
 #include "construct.h"
@@ -11,7 +11,23 @@
 #include <cstddef> 
 #include <cstdlib>
 #include <climits> 
+#include <cstdint> 
+#include <atomic> 
+#include <functional> 
+#include <memory> 
+#include <new> 
 #include <type_traits> 
+#include <utility> 
+
+#if defined(__has_include)
+#if __has_include(<sys/single_threaded.h>)
+#include <sys/single_threaded.h>
+#define MYSTL_HAS_SINGLE_THREADED 1
+#endif
+#endif
+#ifndef MYSTL_HAS_SINGLE_THREADED
+#define MYSTL_HAS_SINGLE_THREADED 0
+#endif
 
 namespace mystl
 {
@@ -23,8 +39,145 @@ constexpr Tp* address_of(Tp& value) noexcept
     return &value; 
 }
 
-// temp use std::pair, should use mystl::pair 
+#ifndef SCRATCH_ARENA_INIT_SIZE
+#define SCRATCH_ARENA_INIT_SIZE (64 * 1024)                 // 首次分配的块大小
+#endif
+
+#ifndef SCRATCH_ARENA_DEFAULT_CAP
+#define SCRATCH_ARENA_DEFAULT_CAP (64 * 1024 * 1024)        // 默认保留的块大小上限
+#endif
+
+// scratch_arena 
+// 每个线程一块可复用的临时空间，供 get_temporary_buffer / temporary_buffer 使用，
+// 避免每次 stable_sort / merge 都要 malloc 与 free 一大块内存
+// * 块内按栈的方式分配，释放栈顶时回退；乱序释放的先做标记，等到上面的都释放后一起回退
+// * 块空闲时若请求放不下，按 2 倍几何增长重新分配，但不超过 cap()
+// * 块正在使用或请求超过 cap() 时直接 malloc，释放时 free
+// * 只能在申请的线程释放；线程退出时释放块
+class scratch_arena
+{
+    struct alignas(alignof(std::max_align_t)) header
+    {
+        size_t  prev_top;       // 块内: 分配前的栈顶；malloc: 用户指针到 malloc 起始处的偏移
+        header* prev;           // 块内上一个分配
+        bool    from_heap; 
+        bool    freed; 
+    }; 
+
+public:
+    static scratch_arena& local() noexcept
+    {
+        static thread_local scratch_arena arena; 
+        return arena; 
+    }
+
+    scratch_arena() = default; 
+    scratch_arena(const scratch_arena&) = delete; 
+    scratch_arena& operator=(const scratch_arena&) = delete; 
+    ~scratch_arena() { free(_block); }
+
+    // 申请至少 bytes 字节、按 align 对齐的空间，内存不足时返回 nullptr
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) noexcept; 
+    void  deallocate(void* p) noexcept; 
+
+    // 保留的块大小上限，调小时若块空闲立即释放
+    void set_cap(size_t bytes) noexcept
+    {
+        _cap = bytes; 
+        if(_size > _cap) trim(); 
+    }
+    size_t cap() const noexcept { return _cap; }
+
+    // 块空闲时归还给系统
+    void trim() noexcept
+    {
+        if(_top != 0) return; 
+        free(_block); 
+        _block = nullptr; 
+        _size = 0; 
+    }
+
+    size_t capacity() const noexcept { return _size; }  // 当前块大小
+    size_t in_use()   const noexcept { return _top; }   // 块内已用字节数
+
+private:
+    static char* align_up(char* p, size_t align) noexcept
+    {
+        const uintptr_t v = reinterpret_cast<uintptr_t>(p); 
+        return reinterpret_cast<char*>((v + align - 1) & ~static_cast<uintptr_t>(align - 1)); 
+    }
+
+    void grow(size_t need) noexcept; 
 
+private:
+    char*   _block = nullptr; 
+    size_t  _size = 0; 
+    size_t  _top = 0; 
+    header* _last = nullptr; 
+    size_t  _cap = SCRATCH_ARENA_DEFAULT_CAP; 
+}; 
+
+inline void* scratch_arena::allocate(size_t bytes, size_t align) noexcept
+{
+    if(align < alignof(header)) align = alignof(header); 
+    const size_t need = bytes + sizeof(header) + align; 
+    if(need < bytes) return nullptr; 
+
+    if(_top == 0 && need > _size && need <= _cap) 
+    {
+        grow(need); 
+    }
+    if(_block != nullptr && need <= _size - _top) 
+    {
+        char* user = align_up(_block + _top + sizeof(header), align); 
+        header* h = reinterpret_cast<header*>(user) - 1; 
+        h->prev_top = _top; 
+        h->prev = _last; 
+        h->from_heap = false; 
+        h->freed = false; 
+        _top = static_cast<size_t>(user + bytes - _block); 
+        _last = h; 
+        return user; 
+    }
+
+    char* raw = static_cast<char*>(malloc(need)); 
+    if(raw == nullptr) return nullptr; 
+    char* user = align_up(raw + sizeof(header), align); 
+    header* h = reinterpret_cast<header*>(user) - 1; 
+    h->prev_top = static_cast<size_t>(user - raw); 
+    h->prev = nullptr; 
+    h->from_heap = true; 
+    h->freed = false; 
+    return user; 
+}
+
+inline void scratch_arena::deallocate(void* p) noexcept
+{
+    if(p == nullptr) return; 
+    header* h = static_cast<header*>(p) - 1; 
+    if(h->from_heap) 
+    {
+        free(static_cast<char*>(p) - h->prev_top); 
+        return; 
+    }
+    h->freed = true; 
+    while(_last != nullptr && _last->freed) 
+    {
+        _top = _last->prev_top; 
+        _last = _last->prev; 
+    }
+}
+
+// 块空闲时重新分配，至少为原来的 2 倍
+inline void scratch_arena::grow(size_t need) noexcept
+{
+    size_t new_size = _size < SCRATCH_ARENA_INIT_SIZE ? SCRATCH_ARENA_INIT_SIZE : _size * 2; 
+    if(new_size < need) new_size = need; 
+    if(new_size > _cap) new_size = _cap; 
+    free(_block); 
+    _block = static_cast<char*>(malloc(new_size)); 
+    _size = _block == nullptr ? 0 : new_size; 
+}
 
 // 获取/释放临时缓冲区 辅助函数
 template <typename T>  
@@ -34,7 +187,8 @@ std::pair<T*, ptrdiff_t> _get_buffer(ptrdiff_t len, T*)
         len = INT_MAX/sizeof(T); 
     while(len > 0)
     {
-        T* tmp = static_cast<T*>(malloc(static_cast<size_t>(len)*sizeof(T)));
+        T* tmp = static_cast<T*>(scratch_arena::local().allocate(
+            static_cast<size_t>(len) * sizeof(T), alignof(T)));
         if(tmp)
             return std::pair<T*, ptrdiff_t>(tmp, len); 
         len /=2; // 申请失败时将len减半
@@ -61,11 +215,11 @@ std::pair<T*, ptrdiff_t> get_temporary_buffer(ptrdiff_t len, T*)
     return _get_buffer(len, static_cast<T*>(0)); 
 }
 
-// 释放临时缓冲区
+// 释放临时缓冲区，必须在申请的线程中调用
 template<typename T>  
 void release_temporary_buffer(T* ptr)
 {
-    free(ptr); 
+    scratch_arena::local().deallocate(ptr); 
 }
 
 
@@ -84,7 +238,7 @@ public:
     ~temporary_buffer()
     {
         mystl::destroy(buffer, buffer + len);
-        free(buffer); 
+        scratch_arena::local().deallocate(buffer); 
     }
 
 
@@ -123,7 +277,7 @@ temporary_buffer(ForwardIterator first, ForwardIterator last)
     }
     catch(...)
     {
-        free(buffer);
+        scratch_arena::local().deallocate(buffer);
         buffer = nullptr; 
         len = 0; 
     }
@@ -135,11 +289,13 @@ void temporary_buffer<ForwardIterator, T>::
 allocate_buffer()
 {
     original_len = len; 
+    buffer = nullptr; 
     if(len > static_cast<ptrdiff_t>(INT_MAX/sizeof(T)))
         len = INT_MAX/sizeof(T);
     while(len > 0)
     {
-        buffer = static_cast<T*>(malloc(len * sizeof(T)));
+        buffer = static_cast<T*>(scratch_arena::local().allocate(
+            static_cast<size_t>(len) * sizeof(T), alignof(T)));
         if(buffer) break; 
         len /= 2; // 空间不足时尝试折半
     }
@@ -218,6 +374,1014 @@ public:
 };
 
 
+// default_delete 
+// unique_ptr / shared_ptr 的默认删除器
+template <typename T> 
+struct default_delete
+{
+    constexpr default_delete() noexcept = default; 
+
+    template <typename U, typename std::enable_if< 
+        std::is_convertible<U*, T*>::value, int>::type = 0> 
+    default_delete(const default_delete<U>&) noexcept {}
+
+    void operator()(T* ptr) const
+    {
+        static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type"); 
+        delete ptr; 
+    }
+}; 
+
+template <typename T> 
+struct default_delete<T[]>
+{
+    constexpr default_delete() noexcept = default; 
+
+    void operator()(T* ptr) const
+    {
+        static_assert(sizeof(T) > 0, "can't delete pointer to incomplete type"); 
+        delete[] ptr; 
+    }
+}; 
+
+// deleter_holder 
+// 与 alloc_holder 相同，无状态的删除器借助空基类优化不占用空间
+template <typename D, bool = std::is_empty<D>::value && !std::is_final<D>::value> 
+class deleter_holder: private D
+{
+public:
+    deleter_holder() = default; 
+    template <typename E> 
+    explicit deleter_holder(E&& d): D(mystl::forward<E>(d)) {}
+
+    D&          get_deleter()       noexcept { return *this; }
+    const D&    get_deleter() const noexcept { return *this; }
+}; 
+
+template <typename D> 
+class deleter_holder<D, false>
+{
+private:
+    D   _deleter; 
+
+public:
+    deleter_holder() = default; 
+    template <typename E> 
+    explicit deleter_holder(E&& d): _deleter(mystl::forward<E>(d)) {}
+
+    D&          get_deleter()       noexcept { return _deleter; }
+    const D&    get_deleter() const noexcept { return _deleter; }
+}; 
+
+// unique_ptr 
+// 独占所有权的智能指针，默认删除器不占用空间: sizeof(unique_ptr<T>) == sizeof(T*)
+template <typename T, typename D = mystl::default_delete<T>> 
+class unique_ptr: private mystl::deleter_holder<D>
+{
+    typedef mystl::deleter_holder<D>    deleter_base; 
+
+public:
+    typedef T*  pointer; 
+    typedef T   element_type; 
+    typedef D   deleter_type; 
+
+private:
+    pointer _ptr; 
+
+public:
+    // ctor 
+    constexpr unique_ptr() noexcept: _ptr(nullptr) {}
+    constexpr unique_ptr(std::nullptr_t) noexcept: _ptr(nullptr) {}
+    explicit unique_ptr(pointer p) noexcept: _ptr(p) {}
+    unique_ptr(pointer p, const D& d) noexcept: deleter_base(d), _ptr(p) {}
+    template <typename E = D, typename std::enable_if< 
+        !std::is_reference<E>::value, int>::type = 0> 
+    unique_ptr(pointer p, E&& d) noexcept: deleter_base(mystl::move(d)), _ptr(p) {}
+
+    unique_ptr(unique_ptr&& rhs) noexcept
+    : deleter_base(mystl::forward<D>(rhs.get_deleter())), _ptr(rhs.release()) {}
+
+    template <typename U, typename E, typename std::enable_if< 
+        std::is_convertible<U*, T*>::value && !std::is_array<U>::value, int>::type = 0> 
+    unique_ptr(unique_ptr<U, E>&& rhs) noexcept
+    : deleter_base(mystl::forward<E>(rhs.get_deleter())), _ptr(rhs.release()) {}
+
+    unique_ptr(const unique_ptr&) = delete; 
+    unique_ptr& operator=(const unique_ptr&) = delete; 
+
+    ~unique_ptr()
+    {
+        if(_ptr != nullptr) get_deleter()(_ptr); 
+    }
+
+    // assign 
+    unique_ptr& operator=(unique_ptr&& rhs) noexcept
+    {
+        reset(rhs.release()); 
+        get_deleter() = mystl::forward<D>(rhs.get_deleter()); 
+        return *this; 
+    }
+
+    template <typename U, typename E, typename std::enable_if< 
+        std::is_convertible<U*, T*>::value && !std::is_array<U>::value, int>::type = 0> 
+    unique_ptr& operator=(unique_ptr<U, E>&& rhs) noexcept
+    {
+        reset(rhs.release()); 
+        get_deleter() = mystl::forward<E>(rhs.get_deleter()); 
+        return *this; 
+    }
+
+    unique_ptr& operator=(std::nullptr_t) noexcept
+    {
+        reset(); 
+        return *this; 
+    }
+
+    // observers 
+    T& operator*() const { return *_ptr; }
+    pointer operator->() const noexcept { return _ptr; }
+    pointer get() const noexcept { return _ptr; }
+    explicit operator bool() const noexcept { return _ptr != nullptr; }
+    using deleter_base::get_deleter; 
+
+    // modifiers 
+    pointer release() noexcept
+    {
+        pointer p = _ptr; 
+        _ptr = nullptr; 
+        return p; 
+    }
+
+    void reset(pointer p = pointer()) noexcept
+    {
+        pointer old = _ptr; 
+        _ptr = p; 
+        if(old != nullptr) get_deleter()(old); 
+    }
+
+    void swap(unique_ptr& rhs) noexcept
+    {
+        mystl::swap(_ptr, rhs._ptr); 
+        mystl::swap(get_deleter(), rhs.get_deleter()); 
+    }
+}; 
+
+// unique_ptr<T[]> 
+template <typename T, typename D> 
+class unique_ptr<T[], D>: private mystl::deleter_holder<D>
+{
+    typedef mystl::deleter_holder<D>    deleter_base; 
+
+public:
+    typedef T*  pointer; 
+    typedef T   element_type; 
+    typedef D   deleter_type; 
+
+private:
+    pointer _ptr; 
+
+public:
+    constexpr unique_ptr() noexcept: _ptr(nullptr) {}
+    constexpr unique_ptr(std::nullptr_t) noexcept: _ptr(nullptr) {}
+    explicit unique_ptr(pointer p) noexcept: _ptr(p) {}
+    unique_ptr(pointer p, const D& d) noexcept: deleter_base(d), _ptr(p) {}
+
+    unique_ptr(unique_ptr&& rhs) noexcept
+    : deleter_base(mystl::forward<D>(rhs.get_deleter())), _ptr(rhs.release()) {}
+
+    unique_ptr(const unique_ptr&) = delete; 
+    unique_ptr& operator=(const unique_ptr&) = delete; 
+
+    ~unique_ptr()
+    {
+        if(_ptr != nullptr) get_deleter()(_ptr); 
+    }
+
+    unique_ptr& operator=(unique_ptr&& rhs) noexcept
+    {
+        reset(rhs.release()); 
+        get_deleter() = mystl::forward<D>(rhs.get_deleter()); 
+        return *this; 
+    }
+
+    unique_ptr& operator=(std::nullptr_t) noexcept
+    {
+        reset(); 
+        return *this; 
+    }
+
+    T& operator[](size_t i) const { return _ptr[i]; }
+    pointer get() const noexcept { return _ptr; }
+    explicit operator bool() const noexcept { return _ptr != nullptr; }
+    using deleter_base::get_deleter; 
+
+    pointer release() noexcept
+    {
+        pointer p = _ptr; 
+        _ptr = nullptr; 
+        return p; 
+    }
+
+    void reset(pointer p = pointer()) noexcept
+    {
+        pointer old = _ptr; 
+        _ptr = p; 
+        if(old != nullptr) get_deleter()(old); 
+    }
+
+    void swap(unique_ptr& rhs) noexcept
+    {
+        mystl::swap(_ptr, rhs._ptr); 
+        mystl::swap(get_deleter(), rhs.get_deleter()); 
+    }
+}; 
+
+// make_unique 
+template <typename T, typename... Args, typename std::enable_if< 
+    !std::is_array<T>::value, int>::type = 0> 
+unique_ptr<T> make_unique(Args&& ...args)
+{
+    return unique_ptr<T>(new T(mystl::forward<Args>(args)...)); 
+}
+
+template <typename T, typename std::enable_if< 
+    std::is_array<T>::value && std::extent<T>::value == 0, int>::type = 0> 
+unique_ptr<T> make_unique(size_t n)
+{
+    return unique_ptr<T>(new typename std::remove_extent<T>::type[n]()); 
+}
+
+template <typename T1, typename D1, typename T2, typename D2> 
+bool operator==(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs) noexcept
+{ return lhs.get() == rhs.get(); }
+
+template <typename T1, typename D1, typename T2, typename D2> 
+bool operator!=(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs) noexcept
+{ return lhs.get() != rhs.get(); }
+
+template <typename T1, typename D1, typename T2, typename D2> 
+bool operator<(const unique_ptr<T1, D1>& lhs, const unique_ptr<T2, D2>& rhs) noexcept
+{ return lhs.get() < rhs.get(); }
+
+template <typename T, typename D> 
+bool operator==(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept { return !lhs; }
+
+template <typename T, typename D> 
+bool operator==(std::nullptr_t, const unique_ptr<T, D>& rhs) noexcept { return !rhs; }
+
+template <typename T, typename D> 
+bool operator!=(const unique_ptr<T, D>& lhs, std::nullptr_t) noexcept { return static_cast<bool>(lhs); }
+
+template <typename T, typename D> 
+bool operator!=(std::nullptr_t, const unique_ptr<T, D>& rhs) noexcept { return static_cast<bool>(rhs); }
+
+template <typename T, typename D> 
+void swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept
+{
+    lhs.swap(rhs); 
+}
+
+// shared_ptr 的引用计数
+// 进程中只有一个线程时 (glibc 的 __libc_single_threaded) 用普通的读写代替原子的读-改-写，
+// 第二个线程创建之后该标志不会恢复，之后一律使用原子操作
+inline bool sp_single_threaded() noexcept
+{
+#if MYSTL_HAS_SINGLE_THREADED
+    return __libc_single_threaded; 
+#else
+    return false; 
+#endif
+}
+
+// 返回修改前的值
+inline long sp_count_add(std::atomic<long>& count, long n) noexcept
+{
+    if(sp_single_threaded()) 
+    {
+        const long old = count.load(std::memory_order_relaxed); 
+        count.store(old + n, std::memory_order_relaxed); 
+        return old; 
+    }
+    return count.fetch_add(n, std::memory_order_acq_rel); 
+}
+
+// 控制块基类
+// _use 为 shared_ptr 的个数；_weak 为 weak_ptr 的个数，所有 shared_ptr 共同算作一个
+class sp_counted_base
+{
+public:
+    sp_counted_base() noexcept: _use(1), _weak(1) {}
+    virtual ~sp_counted_base() = default; 
+
+    sp_counted_base(const sp_counted_base&) = delete; 
+    sp_counted_base& operator=(const sp_counted_base&) = delete; 
+
+    // 析构所管理的对象
+    virtual void dispose() noexcept = 0; 
+    // 释放控制块自身
+    virtual void destroy() noexcept = 0; 
+
+    void add_ref() noexcept { sp_count_add(_use, 1); }
+
+    // weak_ptr::lock: 计数不为 0 时才增加
+    bool add_ref_lock() noexcept
+    {
+        long count = _use.load(std::memory_order_relaxed); 
+        if(sp_single_threaded()) 
+        {
+            if(count == 0) return false; 
+            _use.store(count + 1, std::memory_order_relaxed); 
+            return true; 
+        }
+        while(count != 0) 
+        {
+            if(_use.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel, 
+                                          std::memory_order_relaxed)) 
+                return true; 
+        }
+        return false; 
+    }
+
+    void release() noexcept
+    {
+        if(sp_count_add(_use, -1) == 1) 
+        {
+            dispose(); 
+            weak_release(); 
+        }
+    }
+
+    void weak_add_ref() noexcept { sp_count_add(_weak, 1); }
+
+    void weak_release() noexcept
+    {
+        if(sp_count_add(_weak, -1) == 1) 
+        {
+            destroy(); 
+        }
+    }
+
+    long use_count() const noexcept { return _use.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<long>   _use; 
+    std::atomic<long>   _weak; 
+}; 
+
+// 由指针与删除器构造的控制块，与对象分开分配
+template <typename Ptr, typename D, typename Alloc> 
+class sp_counted_deleter final: public sp_counted_base, private mystl::alloc_holder<Alloc>
+{
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<sp_counted_deleter> block_allocator; 
+    typedef mystl::allocator_traits<block_allocator>                                            block_traits; 
+
+public:
+    sp_counted_deleter(Ptr p, D d, const Alloc& a) noexcept
+    : mystl::alloc_holder<Alloc>(a), _ptr(p), _deleter(mystl::move(d)) {}
+
+    void dispose() noexcept override { _deleter(_ptr); }
+
+    void destroy() noexcept override
+    {
+        block_allocator a(this->get_alloc()); 
+        this->~sp_counted_deleter(); 
+        block_traits::deallocate(a, this, 1); 
+    }
+
+    static sp_counted_deleter* create(Ptr p, D d, const Alloc& alloc)
+    {
+        block_allocator a(alloc); 
+        sp_counted_deleter* block = block_traits::allocate(a, 1); 
+        ::new (static_cast<void*>(block)) sp_counted_deleter(p, mystl::move(d), alloc); 
+        return block; 
+    }
+
+private:
+    Ptr     _ptr; 
+    D       _deleter; 
+}; 
+
+// make_shared / allocate_shared 的控制块，对象就地存放在控制块中，只需一次分配
+template <typename T, typename Alloc> 
+class sp_counted_inplace final: public sp_counted_base, private mystl::alloc_holder<Alloc>
+{
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<sp_counted_inplace> block_allocator; 
+    typedef mystl::allocator_traits<block_allocator>                                            block_traits; 
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>                   value_allocator; 
+    typedef mystl::allocator_traits<value_allocator>                                            value_traits; 
+
+public:
+    template <typename... Args> 
+    explicit sp_counted_inplace(const Alloc& a, Args&& ...args): mystl::alloc_holder<Alloc>(a)
+    {
+        value_allocator va(this->get_alloc()); 
+        value_traits::construct(va, ptr(), mystl::forward<Args>(args)...); 
+    }
+
+    T* ptr() noexcept { return reinterpret_cast<T*>(&_storage); }
+
+    void dispose() noexcept override
+    {
+        value_allocator va(this->get_alloc()); 
+        value_traits::destroy(va, ptr()); 
+    }
+
+    void destroy() noexcept override
+    {
+        block_allocator a(this->get_alloc()); 
+        this->~sp_counted_inplace(); 
+        block_traits::deallocate(a, this, 1); 
+    }
+
+    template <typename... Args> 
+    static sp_counted_inplace* create(const Alloc& alloc, Args&& ...args)
+    {
+        block_allocator a(alloc); 
+        sp_counted_inplace* block = block_traits::allocate(a, 1); 
+        try
+        {
+            ::new (static_cast<void*>(block)) sp_counted_inplace(alloc, mystl::forward<Args>(args)...); 
+        }
+        catch(...)
+        {
+            block_traits::deallocate(a, block, 1); 
+            throw; 
+        }
+        return block; 
+    }
+
+private:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _storage; 
+}; 
+
+template <typename T> class shared_ptr; 
+template <typename T> class weak_ptr; 
+
+// shared_ptr 
+// 共享所有权的智能指针，make_shared / allocate_shared 把控制块与对象放在同一次分配中
+template <typename T> 
+class shared_ptr
+{
+    template <typename U> friend class shared_ptr; 
+    template <typename U> friend class weak_ptr; 
+    template <typename U, typename Alloc, typename... Args> 
+    friend shared_ptr<U> allocate_shared(const Alloc& alloc, Args&& ...args); 
+
+public:
+    typedef T           element_type; 
+    typedef weak_ptr<T> weak_type; 
+
+private:
+    T*                  _ptr; 
+    sp_counted_base*    _ctrl; 
+
+    // 接管已经建立好的控制块
+    struct adopt_tag {}; 
+    shared_ptr(adopt_tag, T* p, sp_counted_base* ctrl) noexcept: _ptr(p), _ctrl(ctrl) {}
+
+public:
+    // ctor 
+    constexpr shared_ptr() noexcept: _ptr(nullptr), _ctrl(nullptr) {}
+    constexpr shared_ptr(std::nullptr_t) noexcept: _ptr(nullptr), _ctrl(nullptr) {}
+
+    template <typename Y, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    explicit shared_ptr(Y* p): shared_ptr(p, mystl::default_delete<Y>()) {}
+
+    template <typename Y, typename D, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    shared_ptr(Y* p, D d): shared_ptr(p, mystl::move(d), mystl::allocator<char>()) {}
+
+    // 控制块分配失败时用 d 删除 p
+    template <typename Y, typename D, typename Alloc, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    shared_ptr(Y* p, D d, const Alloc& alloc): _ptr(p), _ctrl(nullptr)
+    {
+        try
+        {
+            _ctrl = sp_counted_deleter<Y*, D, Alloc>::create(p, d, alloc); 
+        }
+        catch(...)
+        {
+            d(p); 
+            throw; 
+        }
+    }
+
+    // aliasing ctor: 与 rhs 共享所有权，但指向 p
+    template <typename Y> 
+    shared_ptr(const shared_ptr<Y>& rhs, T* p) noexcept: _ptr(p), _ctrl(rhs._ctrl)
+    {
+        if(_ctrl != nullptr) _ctrl->add_ref(); 
+    }
+
+    shared_ptr(const shared_ptr& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        if(_ctrl != nullptr) _ctrl->add_ref(); 
+    }
+
+    template <typename Y, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    shared_ptr(const shared_ptr<Y>& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        if(_ctrl != nullptr) _ctrl->add_ref(); 
+    }
+
+    shared_ptr(shared_ptr&& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        rhs._ptr = nullptr; 
+        rhs._ctrl = nullptr; 
+    }
+
+    template <typename Y, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    shared_ptr(shared_ptr<Y>&& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        rhs._ptr = nullptr; 
+        rhs._ctrl = nullptr; 
+    }
+
+    // weak_ptr 已过期时抛出 std::bad_weak_ptr
+    template <typename Y, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    explicit shared_ptr(const weak_ptr<Y>& rhs): _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        if(_ctrl == nullptr || !_ctrl->add_ref_lock()) 
+            throw std::bad_weak_ptr(); 
+    }
+
+    template <typename Y, typename D, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value && !std::is_array<Y>::value, int>::type = 0> 
+    shared_ptr(unique_ptr<Y, D>&& rhs): _ptr(rhs.get()), _ctrl(nullptr)
+    {
+        if(_ptr != nullptr) 
+        {
+            typedef typename std::conditional<std::is_reference<D>::value, 
+                std::reference_wrapper<typename std::remove_reference<D>::type>, D>::type deleter; 
+            _ctrl = sp_counted_deleter<Y*, deleter, mystl::allocator<char>>::create( 
+                rhs.get(), deleter(rhs.get_deleter()), mystl::allocator<char>()); 
+            rhs.release(); 
+        }
+    }
+
+    ~shared_ptr()
+    {
+        if(_ctrl != nullptr) _ctrl->release(); 
+    }
+
+    // assign 
+    shared_ptr& operator=(const shared_ptr& rhs) noexcept
+    {
+        shared_ptr(rhs).swap(*this); 
+        return *this; 
+    }
+
+    template <typename Y> 
+    shared_ptr& operator=(const shared_ptr<Y>& rhs) noexcept
+    {
+        shared_ptr(rhs).swap(*this); 
+        return *this; 
+    }
+
+    shared_ptr& operator=(shared_ptr&& rhs) noexcept
+    {
+        shared_ptr(mystl::move(rhs)).swap(*this); 
+        return *this; 
+    }
+
+    template <typename Y> 
+    shared_ptr& operator=(shared_ptr<Y>&& rhs) noexcept
+    {
+        shared_ptr(mystl::move(rhs)).swap(*this); 
+        return *this; 
+    }
+
+    template <typename Y, typename D> 
+    shared_ptr& operator=(unique_ptr<Y, D>&& rhs)
+    {
+        shared_ptr(mystl::move(rhs)).swap(*this); 
+        return *this; 
+    }
+
+    // modifiers 
+    void reset() noexcept { shared_ptr().swap(*this); }
+
+    template <typename Y> 
+    void reset(Y* p) { shared_ptr(p).swap(*this); }
+
+    template <typename Y, typename D> 
+    void reset(Y* p, D d) { shared_ptr(p, mystl::move(d)).swap(*this); }
+
+    void swap(shared_ptr& rhs) noexcept
+    {
+        mystl::swap(_ptr, rhs._ptr); 
+        mystl::swap(_ctrl, rhs._ctrl); 
+    }
+
+    // observers 
+    T* get() const noexcept { return _ptr; }
+    typename std::add_lvalue_reference<T>::type operator*() const noexcept { return *_ptr; }
+    T* operator->() const noexcept { return _ptr; }
+    long use_count() const noexcept { return _ctrl != nullptr ? _ctrl->use_count() : 0; }
+    explicit operator bool() const noexcept { return _ptr != nullptr; }
+
+    template <typename Y> 
+    bool owner_before(const shared_ptr<Y>& rhs) const noexcept { return _ctrl < rhs._ctrl; }
+    template <typename Y> 
+    bool owner_before(const weak_ptr<Y>& rhs) const noexcept { return _ctrl < rhs._ctrl; }
+}; 
+
+// weak_ptr 
+template <typename T> 
+class weak_ptr
+{
+    template <typename U> friend class shared_ptr; 
+    template <typename U> friend class weak_ptr; 
+
+public:
+    typedef T   element_type; 
+
+private:
+    T*                  _ptr; 
+    sp_counted_base*    _ctrl; 
+
+public:
+    constexpr weak_ptr() noexcept: _ptr(nullptr), _ctrl(nullptr) {}
+
+    weak_ptr(const weak_ptr& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        if(_ctrl != nullptr) _ctrl->weak_add_ref(); 
+    }
+
+    template <typename Y, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    weak_ptr(const weak_ptr<Y>& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        if(_ctrl != nullptr) _ctrl->weak_add_ref(); 
+    }
+
+    template <typename Y, typename std::enable_if< 
+        std::is_convertible<Y*, T*>::value, int>::type = 0> 
+    weak_ptr(const shared_ptr<Y>& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        if(_ctrl != nullptr) _ctrl->weak_add_ref(); 
+    }
+
+    weak_ptr(weak_ptr&& rhs) noexcept: _ptr(rhs._ptr), _ctrl(rhs._ctrl)
+    {
+        rhs._ptr = nullptr; 
+        rhs._ctrl = nullptr; 
+    }
+
+    ~weak_ptr()
+    {
+        if(_ctrl != nullptr) _ctrl->weak_release(); 
+    }
+
+    weak_ptr& operator=(const weak_ptr& rhs) noexcept
+    {
+        weak_ptr(rhs).swap(*this); 
+        return *this; 
+    }
+
+    template <typename Y> 
+    weak_ptr& operator=(const shared_ptr<Y>& rhs) noexcept
+    {
+        weak_ptr(rhs).swap(*this); 
+        return *this; 
+    }
+
+    weak_ptr& operator=(weak_ptr&& rhs) noexcept
+    {
+        weak_ptr(mystl::move(rhs)).swap(*this); 
+        return *this; 
+    }
+
+    void reset() noexcept { weak_ptr().swap(*this); }
+
+    void swap(weak_ptr& rhs) noexcept
+    {
+        mystl::swap(_ptr, rhs._ptr); 
+        mystl::swap(_ctrl, rhs._ctrl); 
+    }
+
+    long use_count() const noexcept { return _ctrl != nullptr ? _ctrl->use_count() : 0; }
+    bool expired() const noexcept { return use_count() == 0; }
+
+    // 对象仍然存活时返回共享所有权的 shared_ptr，否则返回空
+    shared_ptr<T> lock() const noexcept
+    {
+        if(_ctrl != nullptr && _ctrl->add_ref_lock()) 
+            return shared_ptr<T>(typename shared_ptr<T>::adopt_tag(), _ptr, _ctrl); 
+        return shared_ptr<T>(); 
+    }
+
+    template <typename Y> 
+    bool owner_before(const shared_ptr<Y>& rhs) const noexcept { return _ctrl < rhs._ctrl; }
+    template <typename Y> 
+    bool owner_before(const weak_ptr<Y>& rhs) const noexcept { return _ctrl < rhs._ctrl; }
+}; 
+
+// allocate_shared: 用 alloc 一次分配控制块与对象
+template <typename T, typename Alloc, typename... Args> 
+shared_ptr<T> allocate_shared(const Alloc& alloc, Args&& ...args)
+{
+    typedef typename std::remove_cv<T>::type value_type; 
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<value_type> value_allocator; 
+    auto block = sp_counted_inplace<value_type, value_allocator>::create( 
+        value_allocator(alloc), mystl::forward<Args>(args)...); 
+    return shared_ptr<T>(typename shared_ptr<T>::adopt_tag(), block->ptr(), block); 
+}
+
+template <typename T, typename... Args> 
+shared_ptr<T> make_shared(Args&& ...args)
+{
+    return mystl::allocate_shared<T>(mystl::allocator<T>(), mystl::forward<Args>(args)...); 
+}
+
+template <typename T, typename U> 
+shared_ptr<T> static_pointer_cast(const shared_ptr<U>& rhs) noexcept
+{
+    return shared_ptr<T>(rhs, static_cast<T*>(rhs.get())); 
+}
+
+template <typename T, typename U> 
+shared_ptr<T> const_pointer_cast(const shared_ptr<U>& rhs) noexcept
+{
+    return shared_ptr<T>(rhs, const_cast<T*>(rhs.get())); 
+}
+
+template <typename T, typename U> 
+shared_ptr<T> dynamic_pointer_cast(const shared_ptr<U>& rhs) noexcept
+{
+    T* p = dynamic_cast<T*>(rhs.get()); 
+    return p != nullptr ? shared_ptr<T>(rhs, p) : shared_ptr<T>(); 
+}
+
+template <typename T, typename U> 
+bool operator==(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
+{ return lhs.get() == rhs.get(); }
+
+template <typename T, typename U> 
+bool operator!=(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
+{ return lhs.get() != rhs.get(); }
+
+template <typename T, typename U> 
+bool operator<(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
+{ return lhs.get() < rhs.get(); }
+
+template <typename T> 
+bool operator==(const shared_ptr<T>& lhs, std::nullptr_t) noexcept { return !lhs; }
+
+template <typename T> 
+bool operator==(std::nullptr_t, const shared_ptr<T>& rhs) noexcept { return !rhs; }
+
+template <typename T> 
+bool operator!=(const shared_ptr<T>& lhs, std::nullptr_t) noexcept { return static_cast<bool>(lhs); }
+
+template <typename T> 
+bool operator!=(std::nullptr_t, const shared_ptr<T>& rhs) noexcept { return static_cast<bool>(rhs); }
+
+template <typename T> 
+void swap(shared_ptr<T>& lhs, shared_ptr<T>& rhs) noexcept
+{
+    lhs.swap(rhs); 
+}
+
+template <typename T> 
+void swap(weak_ptr<T>& lhs, weak_ptr<T>& rhs) noexcept
+{
+    lhs.swap(rhs); 
+}
+
+// ref_counted 
+// 侵入式引用计数的混入基类，用法: class node: public mystl::ref_counted<node> {...}; 
+// 计数与对象在同一块内存中，没有单独的控制块，解引用不会多一次缓存未命中
+// Atomic 为 true 时计数可在线程间共享；为 false 时使用普通整数，只能在单个线程内使用
+// 复制对象不复制计数，新对象的计数总是从 0 开始
+template <typename Atomic> struct ref_count_policy; 
+
+template <> 
+struct ref_count_policy<m_true_type>
+{
+    typedef std::atomic<long> count_type; 
+
+    static void add(count_type& c) noexcept { c.fetch_add(1, std::memory_order_relaxed); }
+    // 返回减少后的值；最后一次释放需要看到其他线程之前对对象的所有写入
+    static long sub(count_type& c) noexcept { return c.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+    static long get(const count_type& c) noexcept { return c.load(std::memory_order_relaxed); }
+}; 
+
+template <> 
+struct ref_count_policy<m_false_type>
+{
+    typedef long count_type; 
+
+    static void add(count_type& c) noexcept { ++c; }
+    static long sub(count_type& c) noexcept { return --c; }
+    static long get(const count_type& c) noexcept { return c; }
+}; 
+
+template <typename T, bool Atomic = true> 
+class ref_counted
+{
+    typedef ref_count_policy<m_bool_constant<Atomic>>   policy; 
+
+private:
+    mutable typename policy::count_type _count; 
+
+protected:
+    ref_counted() noexcept: _count(0) {}
+    ref_counted(const ref_counted&) noexcept: _count(0) {}
+    ref_counted& operator=(const ref_counted&) noexcept { return *this; }
+    ~ref_counted() = default; 
+
+public:
+    long use_count() const noexcept { return policy::get(_count); }
+
+    // 由 intrusive_ptr 通过实参依赖查找调用
+    friend void intrusive_ptr_add_ref(const ref_counted* p) noexcept
+    {
+        policy::add(p->_count); 
+    }
+
+    friend void intrusive_ptr_release(const ref_counted* p) noexcept
+    {
+        if(policy::sub(p->_count) == 0) 
+            delete static_cast<const T*>(p); 
+    }
+}; 
+
+// intrusive_ptr 
+// 指向自带引用计数的对象，大小与裸指针相同
+// T 需要提供可由实参依赖查找找到的 intrusive_ptr_add_ref(T*) 与 intrusive_ptr_release(T*)，
+// 继承 ref_counted<T> 即可得到
+template <typename T> 
+class intrusive_ptr
+{
+    template <typename U> friend class intrusive_ptr; 
+
+public:
+    typedef T   element_type; 
+
+private:
+    T*  _ptr; 
+
+public:
+    // ctor 
+    constexpr intrusive_ptr() noexcept: _ptr(nullptr) {}
+    constexpr intrusive_ptr(std::nullptr_t) noexcept: _ptr(nullptr) {}
+
+    // add_ref 为 false 时接管 p 上已有的一个计数
+    intrusive_ptr(T* p, bool add_ref = true): _ptr(p)
+    {
+        if(_ptr != nullptr && add_ref) intrusive_ptr_add_ref(_ptr); 
+    }
+
+    intrusive_ptr(const intrusive_ptr& rhs): _ptr(rhs._ptr)
+    {
+        if(_ptr != nullptr) intrusive_ptr_add_ref(_ptr); 
+    }
+
+    template <typename U, typename std::enable_if< 
+        std::is_convertible<U*, T*>::value, int>::type = 0> 
+    intrusive_ptr(const intrusive_ptr<U>& rhs): _ptr(rhs._ptr)
+    {
+        if(_ptr != nullptr) intrusive_ptr_add_ref(_ptr); 
+    }
+
+    intrusive_ptr(intrusive_ptr&& rhs) noexcept: _ptr(rhs._ptr)
+    {
+        rhs._ptr = nullptr; 
+    }
+
+    template <typename U, typename std::enable_if< 
+        std::is_convertible<U*, T*>::value, int>::type = 0> 
+    intrusive_ptr(intrusive_ptr<U>&& rhs) noexcept: _ptr(rhs._ptr)
+    {
+        rhs._ptr = nullptr; 
+    }
+
+    ~intrusive_ptr()
+    {
+        if(_ptr != nullptr) intrusive_ptr_release(_ptr); 
+    }
+
+    // assign 
+    intrusive_ptr& operator=(const intrusive_ptr& rhs)
+    {
+        intrusive_ptr(rhs).swap(*this); 
+        return *this; 
+    }
+
+    template <typename U> 
+    intrusive_ptr& operator=(const intrusive_ptr<U>& rhs)
+    {
+        intrusive_ptr(rhs).swap(*this); 
+        return *this; 
+    }
+
+    intrusive_ptr& operator=(intrusive_ptr&& rhs) noexcept
+    {
+        intrusive_ptr(mystl::move(rhs)).swap(*this); 
+        return *this; 
+    }
+
+    template <typename U> 
+    intrusive_ptr& operator=(intrusive_ptr<U>&& rhs) noexcept
+    {
+        intrusive_ptr(mystl::move(rhs)).swap(*this); 
+        return *this; 
+    }
+
+    intrusive_ptr& operator=(T* p)
+    {
+        intrusive_ptr(p).swap(*this); 
+        return *this; 
+    }
+
+    // modifiers 
+    void reset() noexcept { intrusive_ptr().swap(*this); }
+    void reset(T* p, bool add_ref = true) { intrusive_ptr(p, add_ref).swap(*this); }
+
+    // 放弃所有权但不减少计数
+    T* detach() noexcept
+    {
+        T* p = _ptr; 
+        _ptr = nullptr; 
+        return p; 
+    }
+
+    void swap(intrusive_ptr& rhs) noexcept { mystl::swap(_ptr, rhs._ptr); }
+
+    // observers 
+    T* get() const noexcept { return _ptr; }
+    T& operator*() const noexcept { return *_ptr; }
+    T* operator->() const noexcept { return _ptr; }
+    explicit operator bool() const noexcept { return _ptr != nullptr; }
+}; 
+
+template <typename T, typename... Args> 
+intrusive_ptr<T> make_intrusive(Args&& ...args)
+{
+    return intrusive_ptr<T>(new T(mystl::forward<Args>(args)...)); 
+}
+
+template <typename T, typename U> 
+bool operator==(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+{ return lhs.get() == rhs.get(); }
+
+template <typename T, typename U> 
+bool operator!=(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+{ return lhs.get() != rhs.get(); }
+
+template <typename T, typename U> 
+bool operator<(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+{ return std::less<const void*>()(lhs.get(), rhs.get()); }
+
+template <typename T> 
+bool operator==(const intrusive_ptr<T>& lhs, std::nullptr_t) noexcept { return !lhs; }
+
+template <typename T> 
+bool operator==(std::nullptr_t, const intrusive_ptr<T>& rhs) noexcept { return !rhs; }
+
+template <typename T> 
+bool operator!=(const intrusive_ptr<T>& lhs, std::nullptr_t) noexcept { return static_cast<bool>(lhs); }
+
+template <typename T> 
+bool operator!=(std::nullptr_t, const intrusive_ptr<T>& rhs) noexcept { return static_cast<bool>(rhs); }
+
+template <typename T> 
+void swap(intrusive_ptr<T>& lhs, intrusive_ptr<T>& rhs) noexcept
+{
+    lhs.swap(rhs); 
+}
+
+template <typename T, typename U> 
+intrusive_ptr<T> static_pointer_cast(const intrusive_ptr<U>& rhs)
+{
+    return intrusive_ptr<T>(static_cast<T*>(rhs.get())); 
+}
+
+template <typename T, typename U> 
+intrusive_ptr<T> dynamic_pointer_cast(const intrusive_ptr<U>& rhs)
+{
+    return intrusive_ptr<T>(dynamic_cast<T*>(rhs.get())); 
+}
+
+// 智能指针只持有指针 (与无状态的删除器)，按字节搬移后旧对象无需析构
+template <typename T, typename D> 
+struct is_trivially_relocatable<mystl::unique_ptr<T, D>>: is_trivially_relocatable<D> {}; 
+
+template <typename T> 
+struct is_trivially_relocatable<mystl::shared_ptr<T>>: m_true_type {}; 
+
+template <typename T> 
+struct is_trivially_relocatable<mystl::weak_ptr<T>>: m_true_type {}; 
+
+template <typename T> 
+struct is_trivially_relocatable<mystl::intrusive_ptr<T>>: m_true_type {}; 
+
 } // endof namespace mystl 
 
 
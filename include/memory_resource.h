@@ -0,0 +1,586 @@
+// -- memory_resource.h 多态内存资源
+// 与 std::pmr 对应：
+// * memory_resource                 抽象内存资源
+// * new_delete_resource / null_memory_resource / get_default_resource / set_default_resource
+// * monotonic_buffer_resource       单调增长的缓冲区，deallocate 为空操作，release 或析构时一次性释放
+// * unsynchronized_pool_resource    按 2 的幂分级的内存池，单线程使用
+// * synchronized_pool_resource      带互斥锁的内存池，可跨线程使用
+// * polymorphic_allocator<T>        通过 memory_resource* 分配的分配器
+// 容器别名 mystl::pmr::vector 等在各自的容器头文件中定义
+#ifndef MEMORY_RESOURCE_H_
+#define MEMORY_RESOURCE_H_
+
+#include <cstddef>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include "allocator.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+namespace pmr
+{
+
+// memory_resource
+class memory_resource
+{
+public:
+    static constexpr size_t max_align = alignof(std::max_align_t);
+
+    virtual ~memory_resource() = default;
+
+    void* allocate(size_t bytes, size_t alignment = max_align)
+    {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate(void* ptr, size_t bytes, size_t alignment = max_align)
+    {
+        do_deallocate(ptr, bytes, alignment);
+    }
+
+    bool is_equal(const memory_resource& other) const noexcept
+    {
+        return do_is_equal(other);
+    }
+
+private:
+    virtual void* do_allocate(size_t bytes, size_t alignment) = 0;
+    virtual void  do_deallocate(void* ptr, size_t bytes, size_t alignment) = 0;
+    virtual bool  do_is_equal(const memory_resource& other) const noexcept = 0;
+};
+
+inline bool operator==(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{
+    return &lhs == &rhs || lhs.is_equal(rhs);
+}
+
+inline bool operator!=(const memory_resource& lhs, const memory_resource& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+// new_delete_resource: 使用带对齐参数的 ::operator new / ::operator delete
+class new_delete_memory_resource: public memory_resource
+{
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        if(alignment > max_align)
+            return ::operator new(bytes, std::align_val_t(alignment));
+        return ::operator new(bytes);
+    }
+
+    void do_deallocate(void* ptr, size_t, size_t alignment) override
+    {
+        if(alignment > max_align)
+            ::operator delete(ptr, std::align_val_t(alignment));
+        else
+            ::operator delete(ptr);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+// null_memory_resource: 任何分配都抛出 std::bad_alloc，用于禁止缓冲区耗尽后回退到堆
+class null_memory_resource_impl: public memory_resource
+{
+private:
+    void* do_allocate(size_t, size_t) override
+    {
+        throw std::bad_alloc();
+    }
+
+    void do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+inline memory_resource* new_delete_resource() noexcept
+{
+    static new_delete_memory_resource resource;
+    return &resource;
+}
+
+inline memory_resource* null_memory_resource() noexcept
+{
+    static null_memory_resource_impl resource;
+    return &resource;
+}
+
+inline std::atomic<memory_resource*>& default_resource_aux() noexcept
+{
+    static std::atomic<memory_resource*> resource(new_delete_resource());
+    return resource;
+}
+
+inline memory_resource* get_default_resource() noexcept
+{
+    return default_resource_aux().load(std::memory_order_acquire);
+}
+
+// 设置默认资源，传入 nullptr 时恢复为 new_delete_resource，返回之前的默认资源
+inline memory_resource* set_default_resource(memory_resource* r) noexcept
+{
+    if(r == nullptr) r = new_delete_resource();
+    return default_resource_aux().exchange(r, std::memory_order_acq_rel);
+}
+
+// 向上对齐 n 至 alignment (2 的幂)
+inline size_t align_up(size_t n, size_t alignment) noexcept
+{
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+// monotonic_buffer_resource
+// 从初始缓冲区与向上游申请的 chunk 中顺序切分内存，deallocate 不做任何事，
+// release() 或析构时把所有 chunk 一次性还给上游
+class monotonic_buffer_resource: public memory_resource
+{
+public:
+    static constexpr size_t default_chunk = 1024;
+
+    monotonic_buffer_resource() noexcept
+        :monotonic_buffer_resource(default_chunk, get_default_resource()) {}
+
+    explicit monotonic_buffer_resource(memory_resource* upstream) noexcept
+        :monotonic_buffer_resource(default_chunk, upstream) {}
+
+    explicit monotonic_buffer_resource(size_t initial_size,
+                                       memory_resource* upstream = get_default_resource()) noexcept
+        :_upstream(upstream), _next_size(initial_size < 64 ? 64 : initial_size) {}
+
+    monotonic_buffer_resource(void* buffer, size_t buffer_size,
+                              memory_resource* upstream = get_default_resource()) noexcept
+        :_upstream(upstream), _initial_buffer(buffer), _initial_size(buffer_size),
+        _cur(static_cast<char*>(buffer)), _end(static_cast<char*>(buffer) + buffer_size),
+        _next_size(buffer_size < 64 ? 64 : buffer_size * 2) {}
+
+    monotonic_buffer_resource(const monotonic_buffer_resource&) = delete;
+    monotonic_buffer_resource& operator=(const monotonic_buffer_resource&) = delete;
+
+    ~monotonic_buffer_resource() override { release(); }
+
+    void release() noexcept;
+
+    memory_resource* upstream_resource() const noexcept { return _upstream; }
+
+private:
+    // 每个 chunk 尾部的链表结点
+    struct chunk_footer
+    {
+        chunk_footer*   next;
+        char*           start;
+        size_t          bytes;
+        size_t          alignment;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void  do_deallocate(void*, size_t, size_t) override {}
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    void new_chunk(size_t bytes, size_t alignment);
+
+private:
+    memory_resource*    _upstream;
+    void*               _initial_buffer = nullptr;
+    size_t              _initial_size = 0;
+    char*               _cur = nullptr;
+    char*               _end = nullptr;
+    size_t              _next_size;
+    chunk_footer*       _chunks = nullptr;
+};
+
+inline void* monotonic_buffer_resource::do_allocate(size_t bytes, size_t alignment)
+{
+    if(bytes == 0) bytes = 1;
+    size_t space = static_cast<size_t>(_end - _cur);
+    size_t pad = align_up(reinterpret_cast<size_t>(_cur), alignment) - reinterpret_cast<size_t>(_cur);
+    if(_cur == nullptr || pad + bytes > space)
+    {
+        new_chunk(bytes, alignment);
+        pad = align_up(reinterpret_cast<size_t>(_cur), alignment) - reinterpret_cast<size_t>(_cur);
+    }
+    char* result = _cur + pad;
+    _cur = result + bytes;
+    return result;
+}
+
+inline void monotonic_buffer_resource::new_chunk(size_t bytes, size_t alignment)
+{
+    const size_t chunk_align = alignment > alignof(chunk_footer) ? alignment : alignof(chunk_footer);
+    size_t size = _next_size;
+    while(size < bytes + alignment)
+    {
+        size *= 2;
+    }
+    size = align_up(size, alignof(chunk_footer));
+    char* start = static_cast<char*>(_upstream->allocate(size + sizeof(chunk_footer), chunk_align));
+    chunk_footer* footer = reinterpret_cast<chunk_footer*>(start + size);
+    footer->next = _chunks;
+    footer->start = start;
+    footer->bytes = size + sizeof(chunk_footer);
+    footer->alignment = chunk_align;
+    _chunks = footer;
+    _cur = start;
+    _end = start + size;
+    // 几何增长，减少向上游申请的次数
+    _next_size = size * 2;
+}
+
+inline void monotonic_buffer_resource::release() noexcept
+{
+    while(_chunks != nullptr)
+    {
+        chunk_footer* next = _chunks->next;
+        _upstream->deallocate(_chunks->start, _chunks->bytes, _chunks->alignment);
+        _chunks = next;
+    }
+    _cur = static_cast<char*>(_initial_buffer);
+    _end = _cur + _initial_size;
+}
+
+// pool_options
+struct pool_options
+{
+    size_t max_blocks_per_chunk = 0;            // 0 表示使用默认值
+    size_t largest_required_pool_block = 0;     // 超过该大小的请求直接交给上游
+};
+
+// unsynchronized_pool_resource
+// 区块大小为 8, 16, 32 ... largest_required_pool_block 的若干个池，
+// 每个池维护一条空闲链表，链表为空时向上游申请一个 chunk，chunk 中的区块数逐次翻倍
+// 大于最大区块的请求直接向上游申请，并记录在链表中以便 release() 统一释放
+class unsynchronized_pool_resource: public memory_resource
+{
+public:
+    static constexpr size_t min_block = 8;
+    static constexpr size_t default_max_blocks = 1024;
+    static constexpr size_t default_largest_block = 4096;
+    static constexpr size_t max_pools = 16;
+
+    unsynchronized_pool_resource()
+        :unsynchronized_pool_resource(pool_options(), get_default_resource()) {}
+
+    explicit unsynchronized_pool_resource(memory_resource* upstream)
+        :unsynchronized_pool_resource(pool_options(), upstream) {}
+
+    explicit unsynchronized_pool_resource(const pool_options& opts)
+        :unsynchronized_pool_resource(opts, get_default_resource()) {}
+
+    unsynchronized_pool_resource(const pool_options& opts, memory_resource* upstream);
+
+    unsynchronized_pool_resource(const unsynchronized_pool_resource&) = delete;
+    unsynchronized_pool_resource& operator=(const unsynchronized_pool_resource&) = delete;
+
+    ~unsynchronized_pool_resource() override { release(); }
+
+    void release() noexcept;
+
+    memory_resource* upstream_resource() const noexcept { return _upstream; }
+    pool_options     options()           const noexcept { return _options; }
+
+private:
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct chunk_footer
+    {
+        chunk_footer*   next;
+        char*           start;
+        size_t          bytes;
+        size_t          alignment;
+    };
+
+    struct pool
+    {
+        free_block*     free_list = nullptr;
+        chunk_footer*   chunks = nullptr;
+        size_t          next_blocks = 1;
+    };
+
+    // 直接向上游申请的大块，尾部带双向链表结点
+    struct large_footer
+    {
+        large_footer*   prev;
+        large_footer*   next;
+        char*           start;
+        size_t          bytes;
+        size_t          alignment;
+    };
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void  do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+    size_t pool_index(size_t bytes, size_t alignment) const noexcept;
+    size_t block_size(size_t index) const noexcept { return min_block << index; }
+    void   refill(size_t index);
+
+private:
+    memory_resource*    _upstream;
+    pool_options        _options;
+    size_t              _npools = 0;
+    pool                _pools[max_pools];
+    large_footer*       _large = nullptr;
+};
+
+inline unsynchronized_pool_resource::unsynchronized_pool_resource(
+    const pool_options& opts, memory_resource* upstream)
+    :_upstream(upstream), _options(opts)
+{
+    if(_options.max_blocks_per_chunk == 0)
+        _options.max_blocks_per_chunk = default_max_blocks;
+    if(_options.largest_required_pool_block == 0)
+        _options.largest_required_pool_block = default_largest_block;
+    if(_options.largest_required_pool_block > (min_block << (max_pools - 1)))
+        _options.largest_required_pool_block = min_block << (max_pools - 1);
+
+    _npools = 1;
+    while(block_size(_npools - 1) < _options.largest_required_pool_block)
+    {
+        ++_npools;
+    }
+    _options.largest_required_pool_block = block_size(_npools - 1);
+}
+
+// 同时满足大小与对齐要求的最小池，不存在时返回 _npools
+inline size_t unsynchronized_pool_resource::pool_index(size_t bytes, size_t alignment) const noexcept
+{
+    size_t need = bytes > alignment ? bytes : alignment;
+    size_t index = 0;
+    while(index < _npools && block_size(index) < need)
+    {
+        ++index;
+    }
+    return index;
+}
+
+inline void unsynchronized_pool_resource::refill(size_t index)
+{
+    pool& p = _pools[index];
+    const size_t bsize = block_size(index);
+    const size_t nblocks = p.next_blocks;
+    const size_t bytes = bsize * nblocks;
+    // chunk 按区块大小对齐，保证每个区块都按自身大小对齐
+    const size_t alignment = bsize > alignof(chunk_footer) ? bsize : alignof(chunk_footer);
+    char* start = static_cast<char*>(_upstream->allocate(bytes + sizeof(chunk_footer), alignment));
+
+    chunk_footer* footer = reinterpret_cast<chunk_footer*>(start + bytes);
+    footer->next = p.chunks;
+    footer->start = start;
+    footer->bytes = bytes + sizeof(chunk_footer);
+    footer->alignment = alignment;
+    p.chunks = footer;
+
+    for(size_t i = nblocks; i > 0; --i)
+    {
+        free_block* b = reinterpret_cast<free_block*>(start + (i - 1) * bsize);
+        b->next = p.free_list;
+        p.free_list = b;
+    }
+    if(p.next_blocks < _options.max_blocks_per_chunk)
+    {
+        p.next_blocks *= 2;
+    }
+}
+
+inline void* unsynchronized_pool_resource::do_allocate(size_t bytes, size_t alignment)
+{
+    const size_t index = pool_index(bytes, alignment);
+    if(index < _npools)
+    {
+        pool& p = _pools[index];
+        if(p.free_list == nullptr)
+        {
+            refill(index);
+        }
+        free_block* result = p.free_list;
+        p.free_list = result->next;
+        return result;
+    }
+
+    const size_t size = align_up(bytes, alignof(large_footer));
+    const size_t align = alignment > alignof(large_footer) ? alignment : alignof(large_footer);
+    char* ptr = static_cast<char*>(_upstream->allocate(size + sizeof(large_footer), align));
+    large_footer* footer = reinterpret_cast<large_footer*>(ptr + size);
+    footer->prev = nullptr;
+    footer->next = _large;
+    footer->start = ptr;
+    footer->bytes = size + sizeof(large_footer);
+    footer->alignment = align;
+    if(_large != nullptr) _large->prev = footer;
+    _large = footer;
+    return ptr;
+}
+
+inline void unsynchronized_pool_resource::do_deallocate(void* ptr, size_t bytes, size_t alignment)
+{
+    if(ptr == nullptr) return;
+    const size_t index = pool_index(bytes, alignment);
+    if(index < _npools)
+    {
+        free_block* b = static_cast<free_block*>(ptr);
+        b->next = _pools[index].free_list;
+        _pools[index].free_list = b;
+        return;
+    }
+
+    const size_t size = align_up(bytes, alignof(large_footer));
+    large_footer* footer = reinterpret_cast<large_footer*>(static_cast<char*>(ptr) + size);
+    if(footer->prev != nullptr) footer->prev->next = footer->next;
+    else _large = footer->next;
+    if(footer->next != nullptr) footer->next->prev = footer->prev;
+    _upstream->deallocate(footer->start, footer->bytes, footer->alignment);
+}
+
+// 把所有 chunk 与大块还给上游，即使其中仍有未释放的区块
+inline void unsynchronized_pool_resource::release() noexcept
+{
+    for(size_t i = 0; i < _npools; ++i)
+    {
+        pool& p = _pools[i];
+        while(p.chunks != nullptr)
+        {
+            chunk_footer* next = p.chunks->next;
+            _upstream->deallocate(p.chunks->start, p.chunks->bytes, p.chunks->alignment);
+            p.chunks = next;
+        }
+        p.free_list = nullptr;
+        p.next_blocks = 1;
+    }
+    while(_large != nullptr)
+    {
+        large_footer* next = _large->next;
+        _upstream->deallocate(_large->start, _large->bytes, _large->alignment);
+        _large = next;
+    }
+}
+
+// synchronized_pool_resource
+// 以互斥锁保护的 unsynchronized_pool_resource
+class synchronized_pool_resource: public memory_resource
+{
+public:
+    synchronized_pool_resource()
+        :_pool(pool_options(), get_default_resource()) {}
+
+    explicit synchronized_pool_resource(memory_resource* upstream)
+        :_pool(pool_options(), upstream) {}
+
+    explicit synchronized_pool_resource(const pool_options& opts)
+        :_pool(opts, get_default_resource()) {}
+
+    synchronized_pool_resource(const pool_options& opts, memory_resource* upstream)
+        :_pool(opts, upstream) {}
+
+    synchronized_pool_resource(const synchronized_pool_resource&) = delete;
+    synchronized_pool_resource& operator=(const synchronized_pool_resource&) = delete;
+
+    void release()
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pool.release();
+    }
+
+    memory_resource* upstream_resource() const noexcept { return _pool.upstream_resource(); }
+    pool_options     options()           const noexcept { return _pool.options(); }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _pool.allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _pool.deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    std::mutex                      _mutex;
+    unsynchronized_pool_resource    _pool;
+};
+
+// polymorphic_allocator
+// 有状态分配器，保存一个 memory_resource*，拷贝构造容器时不传播 (使用默认资源)
+template <typename T>
+class polymorphic_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    polymorphic_allocator() noexcept: _resource(get_default_resource()) {}
+    polymorphic_allocator(memory_resource* r) noexcept: _resource(r)
+    {
+        MYSTL_DEBUG(r != nullptr);
+    }
+    template <typename U>
+    polymorphic_allocator(const polymorphic_allocator<U>& rhs) noexcept: _resource(rhs.resource()) {}
+
+    T* allocate(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > static_cast<size_type>(-1) / sizeof(T),
+                              "polymorphic_allocator<T>'s allocate size too big");
+        return static_cast<T*>(_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_type n)
+    {
+        _resource->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    polymorphic_allocator select_on_container_copy_construction() const
+    {
+        return polymorphic_allocator();
+    }
+
+    memory_resource* resource() const noexcept { return _resource; }
+
+private:
+    memory_resource*    _resource;
+};
+
+template <typename T1, typename T2>
+bool operator==(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+    return *lhs.resource() == *rhs.resource();
+}
+
+template <typename T1, typename T2>
+bool operator!=(const polymorphic_allocator<T1>& lhs, const polymorphic_allocator<T2>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+} // end of namespace pmr
+} // end of namespace mystl
+#endif // !MEMORY_RESOURCE_H_
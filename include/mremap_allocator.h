@@ -0,0 +1,200 @@
+// -- mremap_allocator.h 可原地扩大大块内存的分配器
+// 面向持续增长的大型 vector：
+// * 不小于 MREMAP_THRESHOLD 字节的请求以 mmap 申请，长度按页对齐
+// * reallocate (mystl 扩展) 在新旧大小都使用 mmap 时调用 mremap(MREMAP_MAYMOVE)，
+//   内核只需移动页表项，不复制数据；其余情况分配新空间并按字节复制
+// * 较小的请求仍使用 ::operator new
+// reallocate 按字节搬移内容，只能用于可平凡重定位的元素，vector 只在此时使用它
+// 非 Linux 平台上全部请求退化为 ::operator new
+#ifndef MREMAP_ALLOCATOR_H_
+#define MREMAP_ALLOCATOR_H_
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include "allocator.h"
+#include "type_traits.h"
+#include "exceptdef.h"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace mystl
+{
+
+#ifndef MREMAP_THRESHOLD
+#define MREMAP_THRESHOLD (1024 * 1024)
+#endif
+
+// 与类型无关的映射、重新映射与解除映射
+struct mremap_base
+{
+    static size_t page_size() noexcept
+    {
+#if defined(__linux__)
+        static const size_t size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return size;
+#else
+        return 4096;
+#endif
+    }
+
+    static size_t round_up(size_t bytes) noexcept
+    {
+        return (bytes + page_size() - 1) & ~(page_size() - 1);
+    }
+
+    static bool use_mmap(size_t bytes) noexcept
+    {
+#if defined(__linux__)
+        return bytes >= static_cast<size_t>(MREMAP_THRESHOLD);
+#else
+        (void)bytes;
+        return false;
+#endif
+    }
+
+    static void* map(size_t bytes);
+    static void* remap(void* ptr, size_t old_bytes, size_t new_bytes);
+    static void  unmap(void* ptr, size_t bytes) noexcept;
+};
+
+inline void* mremap_base::map(size_t bytes)
+{
+#if defined(__linux__)
+    void* ptr = ::mmap(nullptr, round_up(bytes), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(ptr == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+#else
+    return ::operator new(bytes);
+#endif
+}
+
+// 失败时抛出 std::bad_alloc，原映射保持不变
+inline void* mremap_base::remap(void* ptr, size_t old_bytes, size_t new_bytes)
+{
+#if defined(__linux__)
+    const size_t old_len = round_up(old_bytes);
+    const size_t new_len = round_up(new_bytes);
+    if(old_len == new_len) return ptr;
+    void* result = ::mremap(ptr, old_len, new_len, MREMAP_MAYMOVE);
+    if(result == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    return result;
+#else
+    void* result = ::operator new(new_bytes);
+    std::memcpy(result, ptr, old_bytes < new_bytes ? old_bytes : new_bytes);
+    ::operator delete(ptr);
+    return result;
+#endif
+}
+
+inline void mremap_base::unmap(void* ptr, size_t bytes) noexcept
+{
+#if defined(__linux__)
+    ::munmap(ptr, round_up(bytes));
+#else
+    (void)bytes;
+    ::operator delete(ptr);
+#endif
+}
+
+// mremap_allocator
+template <typename T>
+class mremap_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    typedef m_true_type propagate_on_container_move_assignment;
+    typedef m_true_type is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef mremap_allocator<U> other;
+    };
+
+    mremap_allocator() noexcept = default;
+    template <typename U>
+    mremap_allocator(const mremap_allocator<U>&) noexcept {}
+
+    static T* allocate(size_type n)
+    {
+        if(n == 0) return nullptr;
+        THROW_LENGTH_ERROR_IF(n > static_cast<size_type>(-1) / sizeof(T),
+                              "mremap_allocator<T>'s allocate size too big");
+        const size_t bytes = n * sizeof(T);
+        if(mremap_base::use_mmap(bytes))
+        {
+            return static_cast<T*>(mremap_base::map(bytes));
+        }
+        return static_cast<T*>(mystl::aligned_new(bytes, alignof(T)));
+    }
+
+    static void deallocate(T* ptr, size_type n) noexcept
+    {
+        if(ptr == nullptr) return;
+        const size_t bytes = n * sizeof(T);
+        if(mremap_base::use_mmap(bytes))
+        {
+            mremap_base::unmap(ptr, bytes);
+            return;
+        }
+        mystl::aligned_delete(ptr, alignof(T));
+    }
+
+    // 把 ptr 处 old_n 个元素的空间调整为 new_n 个，前 min(old_n, new_n) 个元素按字节保留
+    // 抛出异常时 ptr 保持不变
+    static T* reallocate(T* ptr, size_type old_n, size_type new_n)
+    {
+        if(ptr == nullptr) return allocate(new_n);
+        if(new_n == 0)
+        {
+            deallocate(ptr, old_n);
+            return nullptr;
+        }
+        THROW_LENGTH_ERROR_IF(new_n > static_cast<size_type>(-1) / sizeof(T),
+                              "mremap_allocator<T>'s allocate size too big");
+        const size_t old_bytes = old_n * sizeof(T);
+        const size_t new_bytes = new_n * sizeof(T);
+        if(mremap_base::use_mmap(old_bytes) && mremap_base::use_mmap(new_bytes))
+        {
+            return static_cast<T*>(mremap_base::remap(ptr, old_bytes, new_bytes));
+        }
+        T* result = allocate(new_n);
+        std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr),
+                    old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(ptr, old_n);
+        return result;
+    }
+};
+
+template <typename T1, typename T2>
+bool operator== (const mremap_allocator<T1>&, const mremap_allocator<T2>&) noexcept
+{
+    return true;
+}
+
+template <typename T1, typename T2>
+bool operator!= (const mremap_allocator<T1>&, const mremap_allocator<T2>&) noexcept
+{
+    return false;
+}
+
+} // end of namespace mystl
+#endif // !MREMAP_ALLOCATOR_H_
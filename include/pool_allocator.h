@@ -0,0 +1,237 @@
+// -- pool_allocator.h 小对象内存池分配器
+// SGI 风格的二级配置器：
+// * 不超过 POOL_MAX_BYTES 的请求按 POOL_ALIGN 字节对齐到 POOL_NFREELISTS 个大小类别，
+//   每个类别维护一条空闲链表，链表为空时一次从内存池切出一批区块 (refill)
+// * 内存池本身以大块 (chunk) 的方式向 ::operator new 申请，不会归还给系统
+// * 超过 POOL_MAX_BYTES 的请求直接交给 ::operator new / ::operator delete
+#ifndef POOL_ALLOCATOR_H_
+#define POOL_ALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include "allocator.h"
+#include "type_traits.h"
+
+namespace mystl
+{
+
+#ifndef POOL_ALIGN
+#define POOL_ALIGN 8
+#endif
+
+#ifndef POOL_MAX_BYTES
+#define POOL_MAX_BYTES 256
+#endif
+
+#ifndef POOL_NFREELISTS
+#define POOL_NFREELISTS (POOL_MAX_BYTES / POOL_ALIGN)
+#endif
+
+#ifndef POOL_REFILL_NOBJS
+#define POOL_REFILL_NOBJS 20
+#endif
+
+// 与类型无关的内存池，所有 pool_allocator<T> 共享
+class pool_alloc_base
+{
+public:
+    // 空闲区块：未被使用时前 sizeof(void*) 字节存放下一个空闲区块的地址
+    union free_obj
+    {
+        union free_obj* next;
+        char            data[1];
+    };
+
+    // 上调至 POOL_ALIGN 的倍数
+    static constexpr size_t round_up(size_t bytes) noexcept
+    {
+        return (bytes + POOL_ALIGN - 1) & ~(static_cast<size_t>(POOL_ALIGN) - 1);
+    }
+
+    // bytes 所在的空闲链表下标
+    static constexpr size_t freelist_index(size_t bytes) noexcept
+    {
+        return (bytes + POOL_ALIGN - 1) / POOL_ALIGN - 1;
+    }
+
+    static void* allocate(size_t bytes);
+    static void  deallocate(void* ptr, size_t bytes) noexcept;
+
+    // 内存池向系统申请的总字节数，用于观察内存占用
+    static size_t heap_size() noexcept
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _heap_size;
+    }
+
+private:
+    static void* refill(size_t bytes);
+    static char* chunk_alloc(size_t bytes, size_t& nobjs);
+
+private:
+    static inline free_obj*     _free_list[POOL_NFREELISTS] = {};
+    static inline char*         _start_free = nullptr;     // 内存池起始位置
+    static inline char*         _end_free = nullptr;       // 内存池结束位置
+    static inline size_t        _heap_size = 0;
+    static inline std::mutex    _mutex;
+};
+
+inline void* pool_alloc_base::allocate(size_t bytes)
+{
+    if(bytes > static_cast<size_t>(POOL_MAX_BYTES))
+    {
+        return ::operator new(bytes);
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    free_obj*& head = _free_list[freelist_index(bytes)];
+    free_obj* result = head;
+    if(result == nullptr)
+    {
+        return refill(round_up(bytes));
+    }
+    head = result->next;
+    return result;
+}
+
+inline void pool_alloc_base::deallocate(void* ptr, size_t bytes) noexcept
+{
+    if(ptr == nullptr) return;
+    if(bytes > static_cast<size_t>(POOL_MAX_BYTES))
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    free_obj* obj = static_cast<free_obj*>(ptr);
+    free_obj*& head = _free_list[freelist_index(bytes)];
+    obj->next = head;
+    head = obj;
+}
+
+// refill: 空闲链表为空时，从内存池取出至多 POOL_REFILL_NOBJS 个区块，
+// 返回第一个给调用者，其余挂到空闲链表上。调用者已持有锁
+inline void* pool_alloc_base::refill(size_t bytes)
+{
+    size_t nobjs = POOL_REFILL_NOBJS;
+    char* chunk = chunk_alloc(bytes, nobjs);
+    if(nobjs == 1)
+    {
+        return chunk;
+    }
+
+    free_obj* result = reinterpret_cast<free_obj*>(chunk);
+    free_obj* cur = reinterpret_cast<free_obj*>(chunk + bytes);
+    _free_list[freelist_index(bytes)] = cur;
+    for(size_t i = 2; i < nobjs; ++i)
+    {
+        free_obj* next = reinterpret_cast<free_obj*>(reinterpret_cast<char*>(cur) + bytes);
+        cur->next = next;
+        cur = next;
+    }
+    cur->next = nullptr;
+    return result;
+}
+
+// chunk_alloc: 从内存池取出 nobjs 个大小为 bytes 的区块，
+// 内存池不足一个区块时向系统申请新的 chunk，nobjs 返回实际取得的个数
+inline char* pool_alloc_base::chunk_alloc(size_t bytes, size_t& nobjs)
+{
+    const size_t need = bytes * nobjs;
+    const size_t left = static_cast<size_t>(_end_free - _start_free);
+    char* result = _start_free;
+
+    if(left >= need)
+    {
+        _start_free += need;
+        return result;
+    }
+    if(left >= bytes)
+    {
+        nobjs = left / bytes;
+        _start_free += bytes * nobjs;
+        return result;
+    }
+
+    // 内存池剩余的零头挂到对应的空闲链表，避免浪费
+    if(left > 0)
+    {
+        free_obj*& head = _free_list[freelist_index(left)];
+        reinterpret_cast<free_obj*>(_start_free)->next = head;
+        head = reinterpret_cast<free_obj*>(_start_free);
+    }
+
+    // 新 chunk 大小随已申请总量增长
+    const size_t get_bytes = 2 * need + round_up(_heap_size >> 4);
+    _start_free = static_cast<char*>(::operator new(get_bytes));
+    _end_free = _start_free + get_bytes;
+    _heap_size += get_bytes;
+    return chunk_alloc(bytes, nobjs);
+}
+
+// pool_allocator
+// 满足 allocator_traits 要求的无状态分配器，小对象经由 pool_alloc_base 分配
+template <typename T>
+class pool_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    typedef m_true_type propagate_on_container_move_assignment;
+    typedef m_true_type is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef pool_allocator<U> other;
+    };
+
+    pool_allocator() noexcept = default;
+    template <typename U>
+    pool_allocator(const pool_allocator<U>&) noexcept {}
+
+    // 超过 POOL_ALIGN 对齐要求的类型不能放进内存池
+    static constexpr bool use_pool = alignof(T) <= POOL_ALIGN;
+
+    static T* allocate(size_type n)
+    {
+        if(n == 0) return nullptr;
+        if(!use_pool)
+        {
+            return static_cast<T*>(mystl::aligned_new(n * sizeof(T), alignof(T)));
+        }
+        return static_cast<T*>(pool_alloc_base::allocate(n * sizeof(T)));
+    }
+
+    static void deallocate(T* ptr, size_type n) noexcept
+    {
+        if(ptr == nullptr) return;
+        if(!use_pool)
+        {
+            mystl::aligned_delete(ptr, alignof(T));
+            return;
+        }
+        pool_alloc_base::deallocate(ptr, n * sizeof(T));
+    }
+};
+
+template <typename T1, typename T2>
+bool operator== (const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept
+{
+    return true;
+}
+
+template <typename T1, typename T2>
+bool operator!= (const pool_allocator<T1>&, const pool_allocator<T2>&) noexcept
+{
+    return false;
+}
+
+} // end of namespace mystl
+#endif // !POOL_ALLOCATOR_H_
@@ -760,8 +760,9 @@ NodePtr rb_tree_erase_rebalance(NodePtr z, NodePtr& root,  NodePtr& leftmost, No
 
 
 // rb_tree 
-template <typename T, typename Compar>  
-class rb_tree  
+template <typename T, typename Compar, typename Alloc = mystl::allocator<T>>  
+class rb_tree: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<rb_tree_node<T>>>
 {
 public:
     typedef rb_tree_traits<T>                           tree_traits; 
@@ -776,27 +777,32 @@ public:
     typedef typename tree_traits::value_type            value_type; 
     typedef Compar                                      key_compare; 
 
-    typedef mystl::allocator<T>                         allocator_type; 
-    typedef mystl::allocator<T>                         data_allocator; 
-    typedef mystl::allocator<base_type>                 base_allocator; 
-    typedef mystl::allocator<node_type>                 node_allocator; 
-
-    typedef typename allocator_type::pointer            pointer; 
-    typedef typename allocator_type::const_pointer      const_pointer; 
-    typedef typename allocator_type::reference          reference; 
-    typedef typename allocator_type::const_reference    const_reference; 
-    typedef typename allocator_type::size_type          size_type; 
-    typedef typename allocator_type::difference_type    difference_type; 
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type; 
+    typedef allocator_type                              data_allocator; 
+    typedef mystl::allocator_traits<data_allocator>     data_traits; 
+    typedef typename data_traits::template rebind_alloc<base_type>  base_allocator; 
+    typedef typename data_traits::template rebind_alloc<node_type>  node_allocator; 
+    typedef mystl::allocator_traits<base_allocator>     base_traits; 
+    typedef mystl::allocator_traits<node_allocator>     node_traits; 
+
+    typedef typename data_traits::pointer               pointer; 
+    typedef typename data_traits::const_pointer         const_pointer; 
+    typedef value_type&                                 reference; 
+    typedef const value_type&                           const_reference; 
+    typedef typename data_traits::size_type             size_type; 
+    typedef typename data_traits::difference_type       difference_type; 
 
     typedef rb_tree_iterator<T>                         iterator; 
     typedef rb_tree_const_iterator<T>                   const_iterator; 
     typedef mystl::reverse_iterator<iterator>           reverse_iterator; 
     typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator; 
 
-    allocator_type get_allocator() const {return data_allocator();  } 
+    allocator_type get_allocator() const {return allocator_type(get_alloc());  } 
     key_compare     key_comp()     const {return _key_comp; }
 
 private:  
+    typedef mystl::alloc_holder<node_allocator>         alloc_base; 
+    using alloc_base::get_alloc; 
     
     base_ptr        _header;            // 与root 互为父节点 
     size_type       _node_count;        // 节点规模
@@ -811,6 +817,8 @@ private:
 public:  
     // ctors 
     rb_tree() {rb_tree_init();  } 
+    explicit rb_tree(const allocator_type& alloc) 
+    : alloc_base(node_allocator(alloc)) {rb_tree_init(); } 
     rb_tree(const rb_tree& rhs); 
     rb_tree(rb_tree&& rhs) noexcept; 
 
@@ -820,7 +828,7 @@ public:
     ~rb_tree() 
     { 
         clear(); 
-        base_allocator::deallocate(_header); // remember to deallocated _header 
+        destroy_header(); // remember to deallocated _header 
     }
 
 public:  
@@ -998,6 +1006,10 @@ private:
     node_ptr    clone_node(base_ptr x); 
     void        destroy_node(node_ptr p); 
 
+    // header node 
+    base_ptr    create_header(); 
+    void        destroy_header(); 
+
     // init / reset 
     void    rb_tree_init(); 
     void    reset();    
@@ -1020,12 +1032,14 @@ private:
     // copy tree / erase tree 
     base_ptr    copy_from(base_ptr x, base_ptr p); 
     void        erase_since(base_ptr x); 
+    void        destroy_value_since(base_ptr x); 
 }; 
 
 // implementation 
 // ctors 
-template <typename T, typename Compar>  
-rb_tree<T, Compar> ::  rb_tree(const rb_tree& rhs) 
+template <typename T, typename Compar, typename Alloc>  
+rb_tree<T, Compar, Alloc> ::  rb_tree(const rb_tree& rhs) 
+: alloc_base(node_traits::select_on_container_copy_construction(rhs.get_alloc())) 
 {
     rb_tree_init(); 
     if(rhs._node_count != 0)
@@ -1040,9 +1054,10 @@ rb_tree<T, Compar> ::  rb_tree(const rb_tree& rhs)
 }
 
 // move ctor 
-template <typename T, typename Compar>  
-rb_tree<T, Compar> :: rb_tree(rb_tree&& rhs) noexcept: 
-    _header(mystl::move(rhs.header)), 
+template <typename T, typename Compar, typename Alloc>  
+rb_tree<T, Compar, Alloc> :: rb_tree(rb_tree&& rhs) noexcept: 
+    alloc_base(mystl::move(rhs.get_alloc())), 
+    _header(mystl::move(rhs._header)), 
     _node_count(rhs._node_count), 
     _key_comp(rhs._key_comp)
 {
@@ -1050,13 +1065,21 @@ rb_tree<T, Compar> :: rb_tree(rb_tree&& rhs) noexcept:
 }
 
 // copy assign 
-template <typename T, typename Compar>  
-rb_tree<T, Compar>& rb_tree<T, Compar>::   
+template <typename T, typename Compar, typename Alloc>  
+rb_tree<T, Compar, Alloc>& rb_tree<T, Compar, Alloc>::   
 operator= (const rb_tree& rhs)
 {
     if(this != &rhs)
     {
         clear(); 
+        // 需要传播分配器且两者不相等时，header 只能由旧分配器回收
+        if(node_traits::propagate_on_container_copy_assignment::value && 
+            !mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+        {
+            destroy_header(); 
+            mystl::alloc_on_copy(get_alloc(), rhs.get_alloc()); 
+            rb_tree_init(); 
+        }
 
         if(rhs._node_count  != 0) 
         {
@@ -1072,11 +1095,24 @@ operator= (const rb_tree& rhs)
 }
 
 // move assign 
-template <typename T, typename Compar>  
-rb_tree<T, Compar>& rb_tree<T, Compar>:: operator=(rb_tree&& rhs)
+template <typename T, typename Compar, typename Alloc>  
+rb_tree<T, Compar, Alloc>& rb_tree<T, Compar, Alloc>:: operator=(rb_tree&& rhs)
 {
     clear(); 
-    base_allocator::deallocate(_header);    // don't forget free _header 
+    if(!node_traits::propagate_on_container_move_assignment::value && 
+        !mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+    {
+        // 分配器不相等且不传播：节点不能跨分配器转移，逐个移动元素
+        for(auto first = rhs.begin(); first != rhs.end(); ++first)
+        {
+            emplace_multi(mystl::move(*first)); 
+        }
+        _key_comp = rhs._key_comp; 
+        rhs.clear(); 
+        return *this; 
+    }
+    destroy_header();    // don't forget free _header 
+    mystl::alloc_on_move(get_alloc(), rhs.get_alloc()); 
     _header = mystl::move(rhs._header); 
     _node_count = rhs._node_count; 
     _key_comp = rhs._key_comp; 
@@ -1085,10 +1121,10 @@ rb_tree<T, Compar>& rb_tree<T, Compar>:: operator=(rb_tree&& rhs)
 }
 
 // inplace insert element with multi elems 
-template <typename T, typename Compar>  
+template <typename T, typename Compar, typename Alloc>  
 template <typename...Args>  
-typename rb_tree<T,Compar>::iterator 
-rb_tree<T, Compar>:: emplace_multi(Args&& ...args)
+typename rb_tree<T, Compar, Alloc>::iterator 
+rb_tree<T, Compar, Alloc>:: emplace_multi(Args&& ...args)
 {
     THROW_LENGTH_ERROR_IF(_node_count > max_size() - 1,     
             "rb_tree<T, Comp>'s size too big!"); 
@@ -1099,10 +1135,10 @@ rb_tree<T, Compar>:: emplace_multi(Args&& ...args)
 }
 
 // inplace insert element unique elems 
-template <typename T, typename Compar>  
+template <typename T, typename Compar, typename Alloc>  
 template <typename ...Args>  
-mystl::pair<typename rb_tree<T, Compar>::iterator, bool>  
-rb_tree<T, Compar>:: emplace_unique(Args&& ...args)
+mystl::pair<typename rb_tree<T, Compar, Alloc>::iterator, bool>  
+rb_tree<T, Compar, Alloc>:: emplace_unique(Args&& ...args)
 {
     THROW_LENGTH_ERROR_IF(_node_count > max_size() -1, 
                 "rb_tree<T, Comp>'s size too big"); 
@@ -1121,10 +1157,10 @@ rb_tree<T, Compar>:: emplace_unique(Args&& ...args)
 
 // inplace insert allow multi keys, use hint is more effictive when hint is close to
 // insert position 
-template <typename T, typename Compar>  
+template <typename T, typename Compar, typename Alloc>  
 template <typename ... Args>  
-typename rb_tree<T, Compar>::iterator 
-rb_tree<T, Compar>:: emplace_multi_use_hint(iterator hint, Args&& ...args)
+typename rb_tree<T, Compar, Alloc>::iterator 
+rb_tree<T, Compar, Alloc>:: emplace_multi_use_hint(iterator hint, Args&& ...args)
 {
     THROW_LENGTH_ERROR_IF(_node_count > max_size() - 1,  
                             "rb_tree<T, Comp>'s size too big"); 
@@ -1163,10 +1199,10 @@ rb_tree<T, Compar>:: emplace_multi_use_hint(iterator hint, Args&& ...args)
 }
 
 // inplace insert unique key, it's move effective when hit is close to insert position
-template <typename T, typename Compar>  
+template <typename T, typename Compar, typename Alloc>  
 template <typename... Args>  
-typename rb_tree<T, Compar>::iterator  
-rb_tree<T, Compar>:: emplace_unique_use_hint(iterator hint, Args&&...args)
+typename rb_tree<T, Compar, Alloc>::iterator  
+rb_tree<T, Compar, Alloc>:: emplace_unique_use_hint(iterator hint, Args&&...args)
 {
     THROW_LENGTH_ERROR_IF(_node_count > max_size() - 1, 
                         "rb_tree<T, Comp>'s size too big"); 
@@ -1215,9 +1251,9 @@ rb_tree<T, Compar>:: emplace_unique_use_hint(iterator hint, Args&&...args)
 }
 
 // insert allows multi keys 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::iterator 
-rb_tree<T, Compar>:: insert_multi(const value_type& value)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::iterator 
+rb_tree<T, Compar, Alloc>:: insert_multi(const value_type& value)
 {
     THROW_LENGTH_ERROR_IF(_node_count > max_size() - 1, 
                     "rb_tree<T, Comp>'s size too big"); 
@@ -1226,9 +1262,9 @@ rb_tree<T, Compar>:: insert_multi(const value_type& value)
 }
 
 // insert unique keys 
-template <typename T, typename Compar>  
-mystl::pair<typename rb_tree<T, Compar>::iterator, bool>  
-rb_tree<T, Compar>::  
+template <typename T, typename Compar, typename Alloc>  
+mystl::pair<typename rb_tree<T, Compar, Alloc>::iterator, bool>  
+rb_tree<T, Compar, Alloc>::  
 insert_unique(const value_type& value)
 {
     THROW_LENGTH_ERROR_IF(_node_count > max_size() - 1, 
@@ -1243,9 +1279,9 @@ insert_unique(const value_type& value)
 }
 
 // remove node at hint 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::iterator   
-rb_tree<T, Compar>::erase(iterator hint)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::iterator   
+rb_tree<T, Compar, Alloc>::erase(iterator hint)
 {
     auto node = hint.node->get_node_ptr(); 
     iterator next(node); 
@@ -1258,9 +1294,9 @@ rb_tree<T, Compar>::erase(iterator hint)
 }
 
 // remove elems which equals to key and return num of elems 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>:: size_type  
-rb_tree<T, Compar>:: erase_multi(const key_type& key)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>:: size_type  
+rb_tree<T, Compar, Alloc>:: erase_multi(const key_type& key)
 {
     auto p = equal_range_multi(key); 
     size_type n = mystl::distance(p.first, p.second); 
@@ -1270,9 +1306,9 @@ rb_tree<T, Compar>:: erase_multi(const key_type& key)
 
 
 // remove elem which equals to key and return num of elem 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>:: size_type  
-rb_tree<T, Compar>:: erase_unique(const key_type& key)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>:: size_type  
+rb_tree<T, Compar, Alloc>:: erase_unique(const key_type& key)
 {
     auto it = find(key); 
     if(it != end()) 
@@ -1284,8 +1320,8 @@ rb_tree<T, Compar>:: erase_unique(const key_type& key)
 }
 
 // erase [first, last) 
-template <typename T, typename Compar>  
-void rb_tree<T, Compar>::  
+template <typename T, typename Compar, typename Alloc>  
+void rb_tree<T, Compar, Alloc>::  
 erase(iterator first, iterator last)
 {   
     if(first == begin() && last == end())
@@ -1302,12 +1338,24 @@ erase(iterator first, iterator last)
 }
 
 // clear 
-template <typename T, typename Compar>  
-void rb_tree<T, Compar>:: clear()  
+template <typename T, typename Compar, typename Alloc>  
+void rb_tree<T, Compar, Alloc>:: clear()  
 {
     if(_node_count != 0)
     {
-        erase_since(root()); 
+        if(node_traits::releasable(get_alloc(), _node_count))
+        {
+            // 分配器中的节点全部属于本容器：只析构元素，节点所在的 slab 整体回收
+            if(!std::is_trivially_destructible<T>::value)
+            {
+                destroy_value_since(root()); 
+            }
+            node_traits::release(get_alloc()); 
+        }
+        else
+        {
+            erase_since(root()); 
+        }
         leftmost() = _header; 
         root() = nullptr; 
         rightmost() = _header; 
@@ -1316,9 +1364,9 @@ void rb_tree<T, Compar>:: clear()
 }
 
 // find key and return its iterator 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::iterator
-rb_tree<T, Compar>::find (const key_type& key)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::iterator
+rb_tree<T, Compar, Alloc>::find (const key_type& key)
 {
     auto y = _header; 
     auto x = root(); 
@@ -1337,9 +1385,9 @@ rb_tree<T, Compar>::find (const key_type& key)
     return (ite == end() || _key_comp(key, value_traits::get_key(*ite))) ? end() : ite; 
 }
 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::const_iterator 
-rb_tree<T, Compar> :: find (const key_type& key) const  
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::const_iterator 
+rb_tree<T, Compar, Alloc> :: find (const key_type& key) const  
 {
     auto y = _header; 
     auto x = root(); 
@@ -1360,9 +1408,9 @@ rb_tree<T, Compar> :: find (const key_type& key) const
 
 
 // lower_bound 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::iterator 
-rb_tree<T, Compar>:: lower_bound(const key_type& key)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::iterator 
+rb_tree<T, Compar, Alloc>:: lower_bound(const key_type& key)
 {
     auto y = _header; 
     auto x = root(); 
@@ -1381,9 +1429,9 @@ rb_tree<T, Compar>:: lower_bound(const key_type& key)
     return iterator(y); 
 }
 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::const_iterator  
-rb_tree<T, Compar>:: lower_bound(const key_type& key) const  
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::const_iterator  
+rb_tree<T, Compar, Alloc>:: lower_bound(const key_type& key) const  
 {
     auto y = _header; 
     auto x = root();
@@ -1402,9 +1450,9 @@ rb_tree<T, Compar>:: lower_bound(const key_type& key) const
 }
 
 // upper_bound 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>:: iterator   
-rb_tree<T, Compar>:: upper_bound(const key_type& key) 
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>:: iterator   
+rb_tree<T, Compar, Alloc>:: upper_bound(const key_type& key) 
 {
     auto y = _header; 
     auto x = root(); 
@@ -1423,9 +1471,9 @@ rb_tree<T, Compar>:: upper_bound(const key_type& key)
     return iterator(y); 
 }
 
-template <typename T, typename Compar> 
-typename rb_tree<T, Compar>:: const_iterator  
-rb_tree<T, Compar>:: upper_bound(const key_type& key) const 
+template <typename T, typename Compar, typename Alloc> 
+typename rb_tree<T, Compar, Alloc>:: const_iterator  
+rb_tree<T, Compar, Alloc>:: upper_bound(const key_type& key) const 
 {
     auto y = _header; 
     auto x = root(); 
@@ -1445,45 +1493,46 @@ rb_tree<T, Compar>:: upper_bound(const key_type& key) const
 }
 
 // swap rbtree with another 
-template <typename T, typename Compar>  
-void rb_tree<T, Compar>:: swap(rb_tree& rhs)  noexcept 
+template <typename T, typename Compar, typename Alloc>  
+void rb_tree<T, Compar, Alloc>:: swap(rb_tree& rhs)  noexcept 
 {
     if(this != &rhs)
     {
         mystl::swap(_header, rhs._header); 
         mystl::swap(_node_count, rhs._node_count); 
         mystl::swap(_key_comp, rhs._key_comp); 
+        mystl::alloc_on_swap(get_alloc(), rhs.get_alloc()); 
     }
 }
 
 // auxiliary methods  
 
 // create node  
-template <typename T, typename Compar>  
+template <typename T, typename Compar, typename Alloc>  
 template <typename... Args>  
-typename rb_tree<T, Compar>:: node_ptr   
-rb_tree<T, Compar>:: create_node (Args&&... args)
+typename rb_tree<T, Compar, Alloc>:: node_ptr   
+rb_tree<T, Compar, Alloc>:: create_node (Args&&... args)
 {
-    auto temp = node_allocator::allocate(1);
+    auto temp = node_traits::allocate(get_alloc(), 1);
     try
     {
-        data_allocator::construct(mystl::address_of(temp->value), mystl::forward<Args>(args)...); 
+        node_traits::construct(get_alloc(), mystl::address_of(temp->value), mystl::forward<Args>(args)...); 
         temp->left = nullptr; 
         temp->right = nullptr; 
         temp->parent = nullptr; 
     }
     catch(...)
     {
-        node_allocator::deallocate(temp); 
+        node_traits::deallocate(get_alloc(), temp, 1); 
         throw; 
     }
     return temp;  
 }
 
 // copy a node 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::node_ptr 
-rb_tree<T, Compar>:: clone_node(base_ptr x)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::node_ptr 
+rb_tree<T, Compar, Alloc>:: clone_node(base_ptr x)
 {
     node_ptr temp = create_node(x->get_node_ptr()->value); 
     temp->color = x->color; 
@@ -1493,18 +1542,36 @@ rb_tree<T, Compar>:: clone_node(base_ptr x)
 }
 
 // destroy node 
-template <typename T, typename Compar> 
-void rb_tree<T, Compar>:: destroy_node (node_ptr p)
+template <typename T, typename Compar, typename Alloc> 
+void rb_tree<T, Compar, Alloc>:: destroy_node (node_ptr p)
 {
-    data_allocator::destroy(&p->value); 
-    node_allocator::deallocate(p); 
+    node_traits::destroy(get_alloc(), &p->value); 
+    node_traits::deallocate(get_alloc(), p, 1); 
 } 
 
+// create header: header 只分配 rb_tree_node_base 
+template <typename T, typename Compar, typename Alloc> 
+typename rb_tree<T, Compar, Alloc>::base_ptr 
+rb_tree<T, Compar, Alloc>:: create_header ()
+{
+    base_allocator ba(get_alloc()); 
+    return base_traits::allocate(ba, 1); 
+}
+
+// destroy header 
+template <typename T, typename Compar, typename Alloc> 
+void rb_tree<T, Compar, Alloc>:: destroy_header ()
+{
+    if(_header == nullptr) return; 
+    base_allocator ba(get_alloc()); 
+    base_traits::deallocate(ba, _header, 1); 
+}
+
 // initialize container 
-template <typename T, typename Compar> 
-void rb_tree<T, Compar>:: rb_tree_init ()
+template <typename T, typename Compar, typename Alloc> 
+void rb_tree<T, Compar, Alloc>:: rb_tree_init ()
 {
-    _header = base_allocator::allocate(1); 
+    _header = create_header(); 
     _header->color = rb_tree_red; 
     root() = nullptr; 
     leftmost() = _header; 
@@ -1513,17 +1580,17 @@ void rb_tree<T, Compar>:: rb_tree_init ()
 }
 
 // reset 
-template <typename T, typename Compar>  
-void rb_tree<T, Compar>:: reset ()
+template <typename T, typename Compar, typename Alloc>  
+void rb_tree<T, Compar, Alloc>:: reset ()
 {
     _header = nullptr; 
     _node_count = 0; 
 }
 
 // get_insert_multi_pos 
-template <typename T, typename Compar>  
-mystl::pair<typename rb_tree<T, Compar>::base_ptr, bool>  
-rb_tree<T, Compar>::get_insert_multi_pos(const key_type& key)
+template <typename T, typename Compar, typename Alloc>  
+mystl::pair<typename rb_tree<T, Compar, Alloc>::base_ptr, bool>  
+rb_tree<T, Compar, Alloc>::get_insert_multi_pos(const key_type& key)
 {
     auto x = root(); 
     auto y = _header; 
@@ -1539,9 +1606,9 @@ rb_tree<T, Compar>::get_insert_multi_pos(const key_type& key)
 }
 
 // get_insert_unique_pos 
-template <typename T, typename Compar>  
-mystl::pair<mystl::pair<typename rb_tree<T, Compar>::base_ptr, bool>, bool> 
-rb_tree<T, Compar>::get_insert_unique_pos(const key_type& key)
+template <typename T, typename Compar, typename Alloc>  
+mystl::pair<mystl::pair<typename rb_tree<T, Compar, Alloc>::base_ptr, bool>, bool> 
+rb_tree<T, Compar, Alloc>::get_insert_unique_pos(const key_type& key)
 {
     auto x = root(); 
     auto y = _header; 
@@ -1561,7 +1628,7 @@ rb_tree<T, Compar>::get_insert_unique_pos(const key_type& key)
     {
         if(y == _header || ite == begin())
         {
-            return mystl::make_pair(mystl::make_pair(rb_tree<T, Compar>::base_ptr(y), true), true); 
+            return mystl::make_pair(mystl::make_pair(rb_tree<T, Compar, Alloc>::base_ptr(y), true), true); 
         }
         else  
         {
@@ -1571,18 +1638,18 @@ rb_tree<T, Compar>::get_insert_unique_pos(const key_type& key)
     
     if(_key_comp(value_traits::get_key(*ite), key))
     {
-        return mystl::make_pair(mystl::make_pair(rb_tree<T, Compar>::base_ptr(y), mystl::move(add_to_left)), true); 
+        return mystl::make_pair(mystl::make_pair(rb_tree<T, Compar, Alloc>::base_ptr(y), mystl::move(add_to_left)), true); 
     }
 
-    return mystl::make_pair(mystl::make_pair(rb_tree<T, Compar>::base_ptr(y), mystl::move(add_to_left)), false); 
+    return mystl::make_pair(mystl::make_pair(rb_tree<T, Compar, Alloc>::base_ptr(y), mystl::move(add_to_left)), false); 
     #endif 
 }
 
 // insert_value_at  
 // x is the parent of the insert node 
- template <typename T, typename Compar>  
-typename rb_tree<T, Compar>:: iterator 
-rb_tree<T, Compar>:: insert_value_at(base_ptr x, const value_type& value, bool add_to_left)
+ template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>:: iterator 
+rb_tree<T, Compar, Alloc>:: insert_value_at(base_ptr x, const value_type& value, bool add_to_left)
 {
     node_ptr node = create_node(value); 
     node->parent = x; 
@@ -1616,9 +1683,9 @@ rb_tree<T, Compar>:: insert_value_at(base_ptr x, const value_type& value, bool a
 }
 
 // insert new node at x 
-template<typename T, typename Compar>  
-typename rb_tree<T, Compar>::iterator 
-rb_tree<T, Compar> :: insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::iterator 
+rb_tree<T, Compar, Alloc> :: insert_node_at(base_ptr x, node_ptr node, bool add_to_left)
 {
     node->parent = x; 
     auto base_node = node->get_base_ptr(); 
@@ -1650,9 +1717,9 @@ rb_tree<T, Compar> :: insert_node_at(base_ptr x, node_ptr node, bool add_to_left
 }
 
 // insert mutli elems use hint 
-template <typename T, typename Compar> 
-typename rb_tree<T, Compar>::iterator   
-rb_tree<T, Compar>::
+template <typename T, typename Compar, typename Alloc> 
+typename rb_tree<T, Compar, Alloc>::iterator   
+rb_tree<T, Compar, Alloc>::
 insert_multi_use_hint(iterator hint, key_type key,  node_ptr node)
 {
     // hint 
@@ -1677,9 +1744,9 @@ insert_multi_use_hint(iterator hint, key_type key,  node_ptr node)
 }
 
 // insert unique elems use hint 
-template <typename T, typename Compar> 
-typename rb_tree<T, Compar>::iterator  
-rb_tree<T, Compar>:: 
+template <typename T, typename Compar, typename Alloc> 
+typename rb_tree<T, Compar, Alloc>::iterator  
+rb_tree<T, Compar, Alloc>:: 
 insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
 {
     auto np = hint.node; 
@@ -1711,9 +1778,9 @@ insert_unique_use_hint(iterator hint, key_type key, node_ptr node)
 
 // copy_from 
 // copy a rb_tree recursively start from x, p is the parent of x 
-template <typename T, typename Compar>  
-typename rb_tree<T, Compar>::base_ptr
-rb_tree<T, Compar>::copy_from(base_ptr x, base_ptr p)
+template <typename T, typename Compar, typename Alloc>  
+typename rb_tree<T, Compar, Alloc>::base_ptr
+rb_tree<T, Compar, Alloc>::copy_from(base_ptr x, base_ptr p)
 {
     auto top = clone_node(x); 
     top->parent = p; 
@@ -1750,8 +1817,8 @@ rb_tree<T, Compar>::copy_from(base_ptr x, base_ptr p)
 
 // erase_since 
 // delete node x and its subtree
-template <typename T, typename Compar>  
-void rb_tree<T, Compar>::erase_since(base_ptr x)
+template <typename T, typename Compar, typename Alloc>  
+void rb_tree<T, Compar, Alloc>::erase_since(base_ptr x)
 {
     while(x != nullptr)
     {
@@ -1762,50 +1829,67 @@ void rb_tree<T, Compar>::erase_since(base_ptr x)
     }
 }
 
+// destroy_value_since: 只析构以 x 为根的子树中的元素，不释放节点
+template <typename T, typename Compar, typename Alloc>  
+void rb_tree<T, Compar, Alloc>::destroy_value_since(base_ptr x)
+{
+    while(x != nullptr)
+    {
+        destroy_value_since(x->left); 
+        node_traits::destroy(get_alloc(), mystl::address_of(x->get_node_ptr()->value)); 
+        x = x->right; 
+    }
+}
+
 // relational operator overloads 
-template <typename T, typename Compar>  
-bool operator== (const rb_tree<T, Compar>& lhs, const rb_tree<T, Compar>& rhs)
+template <typename T, typename Compar, typename Alloc>  
+bool operator== (const rb_tree<T, Compar, Alloc>& lhs, const rb_tree<T, Compar, Alloc>& rhs)
 {
     return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin()); 
 }
 
-template <typename T, typename Compar>  
-bool operator< (const rb_tree<T, Compar>& lhs, const rb_tree<T, Compar>& rhs)
+template <typename T, typename Compar, typename Alloc>  
+bool operator< (const rb_tree<T, Compar, Alloc>& lhs, const rb_tree<T, Compar, Alloc>& rhs)
 {
     return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end()); 
 }
 
-template <typename T, typename Compar>  
-bool operator!= (const rb_tree<T, Compar>& lhs, const rb_tree<T, Compar>& rhs)
+template <typename T, typename Compar, typename Alloc>  
+bool operator!= (const rb_tree<T, Compar, Alloc>& lhs, const rb_tree<T, Compar, Alloc>& rhs)
 {
     return !(rhs == lhs); 
 }
 
-template <typename T, typename Compar>  
-bool operator >(const rb_tree<T, Compar>& lhs, const rb_tree<T, Compar>& rhs)
+template <typename T, typename Compar, typename Alloc>  
+bool operator >(const rb_tree<T, Compar, Alloc>& lhs, const rb_tree<T, Compar, Alloc>& rhs)
 {
     return rhs < lhs; 
 }
 
-template <typename T, typename Compar> 
-bool operator <=(const rb_tree<T, Compar>& lhs, const rb_tree<T, Compar>& rhs)
+template <typename T, typename Compar, typename Alloc> 
+bool operator <=(const rb_tree<T, Compar, Alloc>& lhs, const rb_tree<T, Compar, Alloc>& rhs)
 {
     return !(rhs < lhs);  
 }
 
-template <typename T, typename Compar>  
-bool operator >=(const rb_tree<T, Compar>& lhs, const rb_tree<T, Compar>& rhs)
+template <typename T, typename Compar, typename Alloc>  
+bool operator >=(const rb_tree<T, Compar, Alloc>& lhs, const rb_tree<T, Compar, Alloc>& rhs)
 {
     return !(lhs < rhs);
 }
 
 // overloading generic swap 
-template <typename T, typename Compar>  
-void swap(rb_tree<T, Compar>& lhs, rb_tree<T, Compar>& rhs)
+template <typename T, typename Compar, typename Alloc>  
+void swap(rb_tree<T, Compar, Alloc>& lhs, rb_tree<T, Compar, Alloc>& rhs)
 {
     lhs.swap(rhs); 
 }
 
+// header 节点在堆上，比较函数与分配器都可平凡重定位时 rb_tree 也可以
+template <typename T, typename Compar, typename Alloc> 
+struct is_trivially_relocatable<mystl::rb_tree<T, Compar, Alloc>>: m_bool_constant<
+    is_trivially_relocatable<Compar>::value && is_trivially_relocatable<Alloc>::value> {}; 
+
 } // end of namespace mystl 
 
 
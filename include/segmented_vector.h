@@ -0,0 +1,570 @@
+// -- segmented_vector.h 模版类 segmented_vector
+// 由固定大小的块组成的 vector: 扩容只追加新块，元素从不移动
+#ifndef SEGMENTED_VECTOR_H_
+#define SEGMENTED_VECTOR_H_
+
+// notes:
+// * 每块 BlockSize 个元素，BlockSize 为 2 的幂，第 i 个元素位于第 i >> shift 块的第 i & mask 个位置
+// * 块表 (指向各块的指针) 存放在 vector 中，扩容时只有块表重新分配
+// * push_back / emplace_back / resize / reserve 不使任何元素的指针、引用失效；
+//   迭代器保存块表地址与下标，块表重新分配时失效 (与 deque 相同)，swap 与移动后仍指向原来的元素
+// * 只支持在末尾增删，不提供会移动元素的 insert / erase
+// * 迭代器为随机访问迭代器，可用于 heap_algo.h、numeric.h 等算法
+// * clear / pop_back 保留已分配的块，shrink_to_fit 释放多余的块
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include "iterator.h"
+#include "memory.h"
+#include "vector.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 默认块大小: 约 4KB 的 2 的幂
+template <typename T>
+struct segmented_block_size
+{
+    static constexpr size_t value = sizeof(T) < 256 ? mystl::floor_pow2(4096 / sizeof(T)) : 16;
+};
+
+// segmented_vector iterator
+// 保存块表地址与下标，第 index 个元素为 table[index >> shift][index & mask]
+template <typename Vec, typename Ref, typename Ptr>
+struct segmented_vector_iterator: public iterator<random_access_iterator_tag, typename Vec::value_type>
+{
+    typedef segmented_vector_iterator<Vec, typename Vec::reference, typename Vec::pointer>  iterator;
+    typedef segmented_vector_iterator<Vec, typename Vec::const_reference,
+                                      typename Vec::const_pointer>                          const_iterator;
+    typedef segmented_vector_iterator                   self;
+    typedef const typename Vec::pointer*                table_pointer;
+
+    typedef typename Vec::value_type    value_type;
+    typedef Ptr                         pointer;
+    typedef Ref                         reference;
+    typedef size_t                      size_type;
+    typedef ptrdiff_t                   difference_type;
+
+    table_pointer   table;
+    size_type       index;
+
+    segmented_vector_iterator() noexcept: table(nullptr), index(0) {}
+    segmented_vector_iterator(table_pointer t, size_type i) noexcept: table(t), index(i) {}
+    segmented_vector_iterator(const iterator& rhs) noexcept: table(rhs.table), index(rhs.index) {}
+    self& operator=(const iterator& rhs) noexcept
+    {
+        table = rhs.table;
+        index = rhs.index;
+        return *this;
+    }
+
+    reference operator*() const { return at_index(index); }
+    pointer   operator->() const { return &at_index(index); }
+    reference operator[](difference_type n) const { return at_index(index + n); }
+
+    self& operator++() noexcept { ++index; return *this; }
+    self& operator--() noexcept { --index; return *this; }
+    self operator++(int) noexcept { self temp = *this; ++index; return temp; }
+    self operator--(int) noexcept { self temp = *this; --index; return temp; }
+
+    self& operator+=(difference_type n) noexcept { index += n; return *this; }
+    self& operator-=(difference_type n) noexcept { index -= n; return *this; }
+    self operator+(difference_type n) const noexcept { return self(table, index + n); }
+    self operator-(difference_type n) const noexcept { return self(table, index - n); }
+
+    difference_type operator-(const self& x) const noexcept
+    {
+        return static_cast<difference_type>(index) - static_cast<difference_type>(x.index);
+    }
+
+    bool operator==(const self& rhs) const noexcept { return index == rhs.index; }
+    bool operator!=(const self& rhs) const noexcept { return index != rhs.index; }
+    bool operator< (const self& rhs) const noexcept { return index < rhs.index; }
+    bool operator> (const self& rhs) const noexcept { return index > rhs.index; }
+    bool operator<=(const self& rhs) const noexcept { return index <= rhs.index; }
+    bool operator>=(const self& rhs) const noexcept { return index >= rhs.index; }
+
+private:
+    reference at_index(size_type i) const noexcept
+    {
+        return table[i >> Vec::block_shift][i & Vec::block_mask];
+    }
+};
+
+template <typename Vec, typename Ref, typename Ptr>
+segmented_vector_iterator<Vec, Ref, Ptr>
+operator+(ptrdiff_t n, const segmented_vector_iterator<Vec, Ref, Ptr>& it) noexcept
+{
+    return it + n;
+}
+
+// segmented_vector
+template <typename T, size_t BlockSize = segmented_block_size<T>::value,
+          typename Alloc = mystl::allocator<T>>
+class segmented_vector: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+    static_assert(BlockSize > 0 && (BlockSize & (BlockSize - 1)) == 0,
+                  "segmented_vector: BlockSize must be a power of two");
+
+public:
+    // traits
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type;
+    typedef allocator_type                              data_allocator;
+    typedef mystl::allocator_traits<data_allocator>     data_traits;
+
+    typedef typename data_traits::value_type            value_type;
+    typedef typename data_traits::pointer               pointer;
+    typedef typename data_traits::const_pointer         const_pointer;
+    typedef value_type&                                 reference;
+    typedef const value_type&                           const_reference;
+    typedef typename data_traits::size_type             size_type;
+    typedef typename data_traits::difference_type       difference_type;
+
+    typedef segmented_vector_iterator<segmented_vector, reference, pointer>             iterator;
+    typedef segmented_vector_iterator<segmented_vector, const_reference, const_pointer> const_iterator;
+    typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+    static constexpr size_type block_size = BlockSize;
+    static constexpr size_type block_shift = mystl::floor_log2(BlockSize);
+    static constexpr size_type block_mask = BlockSize - 1;
+
+    allocator_type get_allocator() const { return get_alloc(); }
+
+private:
+    typedef mystl::alloc_holder<data_allocator>         alloc_base;
+    typedef typename data_traits::template rebind_alloc<pointer>    table_allocator;
+    using alloc_base::get_alloc;
+
+    mystl::vector<pointer, table_allocator> _blocks;    // 块表
+    size_type                               _size;
+
+public:
+    // ctors
+    segmented_vector() noexcept(std::is_nothrow_default_constructible<allocator_type>::value)
+    : alloc_base(), _blocks(table_allocator(get_alloc())), _size(0) {}
+
+    explicit segmented_vector(const allocator_type& alloc)
+    : alloc_base(alloc), _blocks(table_allocator(alloc)), _size(0) {}
+
+    explicit segmented_vector(size_type n, const allocator_type& alloc = allocator_type())
+    : segmented_vector(alloc)
+    {
+        guarded([&] { resize(n); });
+    }
+
+    segmented_vector(size_type n, const value_type& value,
+                     const allocator_type& alloc = allocator_type())
+    : segmented_vector(alloc)
+    {
+        guarded([&] { resize(n, value); });
+    }
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_input_iterator<Iter>::value, int>::type = 0>
+    segmented_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    : segmented_vector(alloc)
+    {
+        guarded([&] { append(first, last); });
+    }
+
+    segmented_vector(std::initializer_list<value_type> initlist,
+                     const allocator_type& alloc = allocator_type())
+    : segmented_vector(initlist.begin(), initlist.end(), alloc) {}
+
+    segmented_vector(const segmented_vector& rhs)
+    : segmented_vector(data_traits::select_on_container_copy_construction(rhs.get_alloc()))
+    {
+        guarded([&] { copy_from(rhs); });
+    }
+
+    segmented_vector(segmented_vector&& rhs) noexcept
+    : alloc_base(mystl::move(rhs.get_alloc())), _blocks(mystl::move(rhs._blocks)), _size(rhs._size)
+    {
+        rhs._size = 0;
+    }
+
+    segmented_vector& operator=(const segmented_vector& rhs);
+    segmented_vector& operator=(segmented_vector&& rhs);
+
+    segmented_vector& operator=(std::initializer_list<value_type> initlist)
+    {
+        clear();
+        append(initlist.begin(), initlist.end());
+        return *this;
+    }
+
+    ~segmented_vector()
+    {
+        clear();
+        release_blocks(0);
+    }
+
+public:
+    // 迭代器相关
+    iterator        begin()         noexcept { return iterator(_blocks.data(), 0); }
+    const_iterator  begin()   const noexcept { return const_iterator(_blocks.data(), 0); }
+    iterator        end()           noexcept { return iterator(_blocks.data(), _size); }
+    const_iterator  end()     const noexcept { return const_iterator(_blocks.data(), _size); }
+
+    reverse_iterator        rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator        rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator          cbegin()  const noexcept { return begin(); }
+    const_iterator          cend()    const noexcept { return end(); }
+    const_reverse_iterator  crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator  crend()   const noexcept { return rend(); }
+
+    // 容量相关
+    bool        empty()       const noexcept { return _size == 0; }
+    size_type   size()        const noexcept { return _size; }
+    size_type   max_size()    const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+    size_type   capacity()    const noexcept { return _blocks.size() * BlockSize; }
+    size_type   block_count() const noexcept { return _blocks.size(); }
+
+    void reserve(size_type n);
+    void shrink_to_fit();
+
+    // 访问元素相关
+    reference operator[](size_type n)
+    {
+        MYSTL_DEBUG(n < _size);
+        return element(n);
+    }
+    const_reference operator[](size_type n) const
+    {
+        MYSTL_DEBUG(n < _size);
+        return element(n);
+    }
+
+    reference at(size_type n)
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < _size), "segmented_vector<T>::at() subscript out of range");
+        return element(n);
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < _size), "segmented_vector<T>::at() subscript out of range");
+        return element(n);
+    }
+
+    reference       front()       { MYSTL_DEBUG(!empty()); return element(0); }
+    const_reference front() const { MYSTL_DEBUG(!empty()); return element(0); }
+    reference       back()        { MYSTL_DEBUG(!empty()); return element(_size - 1); }
+    const_reference back()  const { MYSTL_DEBUG(!empty()); return element(_size - 1); }
+
+    // 第 i 块的起始地址，块内元素连续，可以逐块处理
+    pointer       block_data(size_type i)       noexcept { return _blocks[i]; }
+    const_pointer block_data(size_type i) const noexcept { return _blocks[i]; }
+
+    // 修改容器相关操作
+    void assign(size_type n, const value_type& value)
+    {
+        clear();
+        resize(n, value);
+    }
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_input_iterator<Iter>::value, int>::type = 0>
+    void assign(Iter first, Iter last)
+    {
+        clear();
+        append(first, last);
+    }
+
+    void assign(std::initializer_list<value_type> initlist)
+    {
+        assign(initlist.begin(), initlist.end());
+    }
+
+    template <typename ...Args>
+    reference emplace_back(Args&& ...args);
+
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(mystl::move(value)); }
+
+    void pop_back()
+    {
+        MYSTL_DEBUG(!empty());
+        --_size;
+        data_traits::destroy(get_alloc(), &element(_size));
+    }
+
+    void clear() noexcept { destroy_from(0); }
+
+    void resize(size_type new_size) { resize(new_size, value_type()); }
+    void resize(size_type new_size, const value_type& value);
+
+    void swap(segmented_vector& rhs) noexcept
+    {
+        mystl::alloc_on_swap(get_alloc(), rhs.get_alloc());
+        _blocks.swap(rhs._blocks);
+        mystl::swap(_size, rhs._size);
+    }
+
+private:
+    // helper functions
+
+    reference element(size_type n) noexcept
+    {
+        return _blocks[n >> block_shift][n & block_mask];
+    }
+    const_reference element(size_type n) const noexcept
+    {
+        return _blocks[n >> block_shift][n & block_mask];
+    }
+
+    static size_type blocks_for(size_type n) noexcept { return (n + BlockSize - 1) >> block_shift; }
+
+    // 构造函数中的操作失败时，析构函数不会被调用，需要自行释放
+    template <typename F>
+    void guarded(F f)
+    {
+        try
+        {
+            f();
+        }
+        catch(...)
+        {
+            clear();
+            release_blocks(0);
+            throw;
+        }
+    }
+
+    void add_block();
+    void release_blocks(size_type keep) noexcept;
+    void destroy_from(size_type n) noexcept;
+    void copy_from(const segmented_vector& rhs);
+
+    template <typename Iter>
+    void append(Iter first, Iter last)
+    {
+        for(; first != last; ++first)
+            emplace_back(*first);
+    }
+};
+
+/*****************************************************************************************/
+
+// 复制赋值: 需要传播分配器且两者不相等时，旧的块只能由旧分配器回收
+template <typename T, size_t BlockSize, typename Alloc>
+segmented_vector<T, BlockSize, Alloc>&
+segmented_vector<T, BlockSize, Alloc>::operator=(const segmented_vector& rhs)
+{
+    if(this != &rhs)
+    {
+        clear();
+        if(data_traits::propagate_on_container_copy_assignment::value &&
+           !mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+        {
+            release_blocks(0);
+            mystl::alloc_on_copy(get_alloc(), rhs.get_alloc());
+            // 块表也换成新分配器: 以空表复制赋值，由 vector 按同样的规则传播
+            const table_allocator table_alloc(get_alloc());
+            const mystl::vector<pointer, table_allocator> table(table_alloc);
+            _blocks = table;
+        }
+        copy_from(rhs);
+    }
+    return *this;
+}
+
+// 移动赋值: 分配器相等时接管块表，否则逐个移动
+template <typename T, size_t BlockSize, typename Alloc>
+segmented_vector<T, BlockSize, Alloc>&
+segmented_vector<T, BlockSize, Alloc>::operator=(segmented_vector&& rhs)
+{
+    if(this != &rhs)
+    {
+        clear();
+        if(data_traits::propagate_on_container_move_assignment::value ||
+           mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+        {
+            release_blocks(0);
+            mystl::alloc_on_move(get_alloc(), rhs.get_alloc());
+            _blocks.swap(rhs._blocks);
+            mystl::swap(_size, rhs._size);
+        }
+        else
+        {
+            for(auto& x : rhs)
+                emplace_back(mystl::move(x));
+            rhs.clear();
+        }
+    }
+    return *this;
+}
+
+// emplace_back: 末块已满时追加一块，已有元素不移动
+template <typename T, size_t BlockSize, typename Alloc>
+template <typename ...Args>
+typename segmented_vector<T, BlockSize, Alloc>::reference
+segmented_vector<T, BlockSize, Alloc>::emplace_back(Args&& ...args)
+{
+    if(_size == capacity())
+    {
+        THROW_LENGTH_ERROR_IF(_size == max_size(), "segmented_vector<T>'s size too big");
+        add_block();
+    }
+    pointer p = &element(_size);
+    data_traits::construct(get_alloc(), p, mystl::forward<Args>(args)...);
+    ++_size;
+    return *p;
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
+void segmented_vector<T, BlockSize, Alloc>::reserve(size_type n)
+{
+    THROW_LENGTH_ERROR_IF(n > max_size(),
+                          "n can not larger than max_size() in segmented_vector<T>::reserve(n)");
+    const size_type need = blocks_for(n);
+    if(need <= _blocks.size()) return;
+    _blocks.reserve(need);
+    while(_blocks.size() < need)
+        add_block();
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
+void segmented_vector<T, BlockSize, Alloc>::shrink_to_fit()
+{
+    release_blocks(blocks_for(_size));
+    _blocks.shrink_to_fit();
+}
+
+// resize: 逐块填充
+template <typename T, size_t BlockSize, typename Alloc>
+void segmented_vector<T, BlockSize, Alloc>::resize(size_type new_size, const value_type& value)
+{
+    if(new_size <= _size)
+    {
+        destroy_from(new_size);
+        return;
+    }
+    reserve(new_size);
+    const value_type value_copy = value;
+    while(_size < new_size)
+    {
+        const size_type offset = _size & block_mask;
+        const size_type n = std::min(BlockSize - offset, new_size - _size);
+        mystl::uninitialized_fill_n(&element(_size), n, value_copy);
+        _size += n;
+    }
+}
+
+// 追加一个空块，块表的扩容失败时释放该块
+template <typename T, size_t BlockSize, typename Alloc>
+void segmented_vector<T, BlockSize, Alloc>::add_block()
+{
+    pointer block = data_traits::allocate(get_alloc(), BlockSize);
+    try
+    {
+        _blocks.push_back(block);
+    }
+    catch(...)
+    {
+        data_traits::deallocate(get_alloc(), block, BlockSize);
+        throw;
+    }
+}
+
+// 释放第 keep 块之后的块，调用前其中的元素已经析构
+template <typename T, size_t BlockSize, typename Alloc>
+void segmented_vector<T, BlockSize, Alloc>::release_blocks(size_type keep) noexcept
+{
+    while(_blocks.size() > keep)
+    {
+        data_traits::deallocate(get_alloc(), _blocks.back(), BlockSize);
+        _blocks.pop_back();
+    }
+}
+
+// 析构 [n, size()) 上的元素，保留块
+template <typename T, size_t BlockSize, typename Alloc>
+void segmented_vector<T, BlockSize, Alloc>::destroy_from(size_type n) noexcept
+{
+    while(_size > n)
+    {
+        const size_type block_first = (_size - 1) & ~block_mask;
+        const size_type first = std::max(block_first, n);
+        data_traits::destroy(get_alloc(), &element(first), &element(_size - 1) + 1);
+        _size = first;
+    }
+}
+
+// copy_from: *this 为空，逐块复制，可平凡复制的元素为 memmove
+template <typename T, size_t BlockSize, typename Alloc>
+void segmented_vector<T, BlockSize, Alloc>::copy_from(const segmented_vector& rhs)
+{
+    reserve(rhs._size);
+    for(size_type b = 0; _size < rhs._size; ++b)
+    {
+        const size_type n = std::min(BlockSize, rhs._size - _size);
+        mystl::uninitialized_copy(rhs._blocks[b], rhs._blocks[b] + n, _blocks[b]);
+        _size += n;
+    }
+}
+
+// 重载比较运算符
+template <typename T, size_t BlockSize, typename Alloc>
+bool operator==(const segmented_vector<T, BlockSize, Alloc>& lhs,
+                const segmented_vector<T, BlockSize, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
+bool operator<(const segmented_vector<T, BlockSize, Alloc>& lhs,
+               const segmented_vector<T, BlockSize, Alloc>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
+bool operator!=(const segmented_vector<T, BlockSize, Alloc>& lhs,
+                const segmented_vector<T, BlockSize, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
+bool operator>(const segmented_vector<T, BlockSize, Alloc>& lhs,
+               const segmented_vector<T, BlockSize, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
+bool operator<=(const segmented_vector<T, BlockSize, Alloc>& lhs,
+                const segmented_vector<T, BlockSize, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <typename T, size_t BlockSize, typename Alloc>
+bool operator>=(const segmented_vector<T, BlockSize, Alloc>& lhs,
+                const segmented_vector<T, BlockSize, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// mystl::swap overload
+template <typename T, size_t BlockSize, typename Alloc>
+void swap(segmented_vector<T, BlockSize, Alloc>& lhs, segmented_vector<T, BlockSize, Alloc>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// 块表是 vector，分配器可平凡重定位时 segmented_vector 也可以；迭代器只引用块表，重定位后仍然有效
+template <typename T, size_t BlockSize, typename Alloc>
+struct is_trivially_relocatable<mystl::segmented_vector<T, BlockSize, Alloc>>:
+    is_trivially_relocatable<Alloc> {};
+
+} // end of namespace mystl
+#endif // !SEGMENTED_VECTOR_H_
@@ -17,7 +17,8 @@ namespace mystl
 {
 
 // template class set 
-template <typename Key, typename Compar = mystl::less<Key>>  
+template <typename Key, typename Compar = mystl::less<Key>, 
+    typename Alloc = mystl::allocator<Key>>  
 class set  
 {   
 public: 
@@ -27,7 +28,7 @@ public:
     typedef Compar                  value_compare; 
 
 private: 
-    typedef mystl::rb_tree<value_type, key_compare>      base_type; 
+    typedef mystl::rb_tree<value_type, key_compare, Alloc>      base_type; 
     base_type                                            _tree; 
 
 public: 
@@ -48,6 +49,8 @@ public:
     // ctors 
     set() = default; 
 
+    explicit set(const allocator_type& alloc): _tree(alloc) {} 
+
     // range init 
     template <typename InputIter>  
     set(InputIter first, InputIter last): _tree() 
@@ -214,50 +217,51 @@ public:
 }; 
 
 // relational operator oveloading 
-template <typename Key, typename Compar>  
-bool operator== (const set<Key, Compar>& lhs, const set<Key, Compar>& rhs) 
+template <typename Key, typename Compar, typename Alloc>  
+bool operator== (const set<Key, Compar, Alloc>& lhs, const set<Key, Compar, Alloc>& rhs) 
 {
     return lhs == rhs; 
 }
 
-template <typename Key, typename Compar> 
-bool operator!= (const set<Key, Compar>& lhs, const set<Key, Compar>& rhs) 
+template <typename Key, typename Compar, typename Alloc> 
+bool operator!= (const set<Key, Compar, Alloc>& lhs, const set<Key, Compar, Alloc>& rhs) 
 {
     return !(lhs == rhs);
 }
-template <typename Key, typename Compar>  
-bool operator< (const set<Key, Compar>& lhs, const set<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator< (const set<Key, Compar, Alloc>& lhs, const set<Key, Compar, Alloc>& rhs)
 {
     return lhs < rhs; 
 }
 
-template <typename Key, typename Compar>  
-bool operator> (const set<Key, Compar>& lhs, const set<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator> (const set<Key, Compar, Alloc>& lhs, const set<Key, Compar, Alloc>& rhs)
 {
     return rhs < lhs; 
 }
 
-template <typename Key, typename Compar>  
-bool operator <= (const set<Key, Compar>& lhs, const set<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator <= (const set<Key, Compar, Alloc>& lhs, const set<Key, Compar, Alloc>& rhs)
 {
     return !(rhs < lhs); 
 }
 
-template <typename Key, typename Compar>  
-bool operator >= (const set<Key, Compar>& lhs, const set<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator >= (const set<Key, Compar, Alloc>& lhs, const set<Key, Compar, Alloc>& rhs)
 {
     return !(lhs < rhs); 
 }
 
 // overloading generic swap 
-template <typename Key, typename Compar>  
-void swap(set<Key, Compar>& lhs, set<Key, Compar>& rhs) noexcept 
+template <typename Key, typename Compar, typename Alloc>  
+void swap(set<Key, Compar, Alloc>& lhs, set<Key, Compar, Alloc>& rhs) noexcept 
 {
     lhs.swap(rhs); 
 }
 
 // multiset 
-template <typename Key, typename Compar = mystl::less<Key>>  
+template <typename Key, typename Compar = mystl::less<Key>, 
+    typename Alloc = mystl::allocator<Key>>  
 class multiset 
 {
 public: 
@@ -267,7 +271,7 @@ public:
     typedef Compar          value_compare; 
 
 private:  
-    typedef mystl::rb_tree<value_type, key_compare>         base_type; 
+    typedef mystl::rb_tree<value_type, key_compare, Alloc>         base_type; 
     base_type                                               _tree; 
 
 public:  
@@ -288,6 +292,8 @@ public:
 public:  
     // ctors 
     multiset() = default; 
+
+    explicit multiset(const allocator_type& alloc): _tree(alloc) {} 
     // range ctor 
     template <typename InputIter>  
     multiset(InputIter first, InputIter last): _tree() 
@@ -462,48 +468,65 @@ public:
 }; 
 
 // relational operators 
-template <typename Key, typename Compar>  
-bool operator == (const multiset<Key, Compar>& lhs, const multiset<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator == (const multiset<Key, Compar, Alloc>& lhs, const multiset<Key, Compar, Alloc>& rhs)
 {
     return lhs == rhs; 
 }
 
-template <typename Key, typename Compar> 
-bool operator != (const multiset<Key, Compar>& lhs, const multiset<Key, Compar>& rhs) 
+template <typename Key, typename Compar, typename Alloc> 
+bool operator != (const multiset<Key, Compar, Alloc>& lhs, const multiset<Key, Compar, Alloc>& rhs) 
 {
     return !(lhs == rhs); 
 }
 
-template <typename Key, typename Compar>  
-bool operator < (const multiset<Key, Compar>& lhs, const multiset<Key, Compar>& rhs) 
+template <typename Key, typename Compar, typename Alloc>  
+bool operator < (const multiset<Key, Compar, Alloc>& lhs, const multiset<Key, Compar, Alloc>& rhs) 
 {
     return lhs < rhs; 
 }
 
-template <typename Key, typename Compar>  
-bool operator > ( const multiset<Key, Compar>& lhs, const multiset<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator > ( const multiset<Key, Compar, Alloc>& lhs, const multiset<Key, Compar, Alloc>& rhs)
 {
     return rhs < lhs; 
 }
 
-template <typename Key, typename Compar>  
-bool operator <=(const multiset<Key, Compar>& lhs, const multiset<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator <=(const multiset<Key, Compar, Alloc>& lhs, const multiset<Key, Compar, Alloc>& rhs)
 {
     return !(rhs < lhs); 
 }
 
-template <typename Key, typename Compar>  
-bool operator >= (const multiset<Key, Compar>& lhs, const multiset<Key, Compar>& rhs)
+template <typename Key, typename Compar, typename Alloc>  
+bool operator >= (const multiset<Key, Compar, Alloc>& lhs, const multiset<Key, Compar, Alloc>& rhs)
 {
     return !(lhs < rhs); 
 }
 
 
 // overloading generic swap 
-template <typename Key, typename Compar>  
-void swap(multiset <Key, Compar>& lhs, multiset<Key, Compar>& rhs) noexcept 
+template <typename Key, typename Compar, typename Alloc>  
+void swap(multiset <Key, Compar, Alloc>& lhs, multiset<Key, Compar, Alloc>& rhs) noexcept 
 {
     lhs.swap(rhs); 
 }
+
+// set / multiset 与底层 rb_tree 相同
+template <typename Key, typename Compar, typename Alloc> 
+struct is_trivially_relocatable<mystl::set<Key, Compar, Alloc>>: 
+    is_trivially_relocatable<mystl::rb_tree<Key, Compar, Alloc>> {}; 
+
+template <typename Key, typename Compar, typename Alloc> 
+struct is_trivially_relocatable<mystl::multiset<Key, Compar, Alloc>>: 
+    is_trivially_relocatable<mystl::rb_tree<Key, Compar, Alloc>> {}; 
+
+namespace pmr
+{
+template <typename Key, typename Compar = mystl::less<Key>>
+using set = mystl::set<Key, Compar, polymorphic_allocator<Key>>;
+template <typename Key, typename Compar = mystl::less<Key>>
+using multiset = mystl::multiset<Key, Compar, polymorphic_allocator<Key>>;
+}
 }   // end of namespace mystl 
 #endif // !SET_H_
\ No newline at end of file
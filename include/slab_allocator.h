@@ -0,0 +1,303 @@
+// -- slab_allocator.h 节点容器专用的 slab 分配器
+// 每个容器拥有独立的 slab_arena：
+// * 节点从按缓存行对齐的连续 slab 中顺序切出，同一容器的节点在内存中相邻
+// * 释放的节点挂到侵入式空闲链表，供下次分配复用
+// * 容器 clear() / 析构时，若自身持有该大小类别的全部节点，直接整块释放 slab，不再逐个释放节点
+// slab_arena 以非原子引用计数在分配器副本之间共享，与容器一样不是线程安全的
+#ifndef SLAB_ALLOCATOR_H_
+#define SLAB_ALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+#include "allocator.h"
+#include "type_traits.h"
+
+namespace mystl
+{
+
+#ifndef SLAB_CACHE_LINE
+#define SLAB_CACHE_LINE 64
+#endif
+
+#ifndef SLAB_SIZE
+#define SLAB_SIZE (16 * 1024)
+#endif
+
+#ifndef SLAB_MAX_POOLS
+#define SLAB_MAX_POOLS 4
+#endif
+
+class slab_arena
+{
+public:
+    slab_arena() = default;
+    slab_arena(const slab_arena&) = delete;
+    slab_arena& operator=(const slab_arena&) = delete;
+
+    ~slab_arena()
+    {
+        for(size_t i = 0; i < _npools; ++i)
+        {
+            release_pool(_pools[i]);
+        }
+    }
+
+    // 块大小上调至 alignment 的倍数，无法放入 slab 时返回 nullptr，由调用者回退到 ::operator new
+    void* allocate(size_t bytes, size_t alignment);
+    void  deallocate(void* ptr, size_t bytes, size_t alignment) noexcept;
+
+    // 该大小类别是否由 slab 提供：大小类别数已满或对齐过大的请求回退到 ::operator new，
+    // 大小类别一旦建立便不会移除，因此可以据此判断一个块的来源
+    bool has_pool(size_t bytes, size_t alignment) const noexcept
+    {
+        return alignment <= SLAB_CACHE_LINE && find_pool(block_size(bytes, alignment)) != nullptr;
+    }
+
+    // 该大小类别尚未释放的块数
+    size_t live(size_t bytes, size_t alignment) const noexcept
+    {
+        const slab_pool* p = find_pool(block_size(bytes, alignment));
+        return p == nullptr ? 0 : p->live;
+    }
+
+    // 整体释放该大小类别的全部 slab，调用者保证其中的块已不再使用
+    void release(size_t bytes, size_t alignment) noexcept
+    {
+        slab_pool* p = find_pool(block_size(bytes, alignment));
+        if(p != nullptr) release_pool(*p);
+    }
+
+    void   add_ref()  noexcept { ++_refs; }
+    size_t drop_ref() noexcept { return --_refs; }
+
+private:
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    // slab 头部占据一整条缓存行，其后的第一个块按缓存行对齐
+    struct slab_header
+    {
+        slab_header*    next;
+    };
+
+    struct slab_pool
+    {
+        size_t          block = 0;
+        free_block*     free_list = nullptr;
+        slab_header*    slabs = nullptr;
+        char*           cur = nullptr;
+        char*           end = nullptr;
+        size_t          live = 0;
+    };
+
+    static size_t block_size(size_t bytes, size_t alignment) noexcept
+    {
+        if(alignment < sizeof(free_block)) alignment = sizeof(free_block);
+        if(bytes < sizeof(free_block)) bytes = sizeof(free_block);
+        return (bytes + alignment - 1) & ~(alignment - 1);
+    }
+
+    slab_pool* find_pool(size_t block) noexcept
+    {
+        for(size_t i = 0; i < _npools; ++i)
+        {
+            if(_pools[i].block == block) return &_pools[i];
+        }
+        return nullptr;
+    }
+
+    const slab_pool* find_pool(size_t block) const noexcept
+    {
+        return const_cast<slab_arena*>(this)->find_pool(block);
+    }
+
+    void new_slab(slab_pool& p);
+    void release_pool(slab_pool& p) noexcept;
+
+private:
+    slab_pool   _pools[SLAB_MAX_POOLS];
+    size_t      _npools = 0;
+    size_t      _refs = 1;
+};
+
+inline void* slab_arena::allocate(size_t bytes, size_t alignment)
+{
+    if(alignment > SLAB_CACHE_LINE) return nullptr;
+    const size_t block = block_size(bytes, alignment);
+    slab_pool* p = find_pool(block);
+    if(p == nullptr)
+    {
+        if(_npools == SLAB_MAX_POOLS) return nullptr;
+        p = &_pools[_npools++];
+        p->block = block;
+    }
+
+    void* result;
+    if(p->free_list != nullptr)
+    {
+        result = p->free_list;
+        p->free_list = p->free_list->next;
+    }
+    else
+    {
+        if(static_cast<size_t>(p->end - p->cur) < block)
+        {
+            new_slab(*p);
+        }
+        result = p->cur;
+        p->cur += block;
+    }
+    ++p->live;
+    return result;
+}
+
+inline void slab_arena::deallocate(void* ptr, size_t bytes, size_t alignment) noexcept
+{
+    slab_pool* p = find_pool(block_size(bytes, alignment));
+    free_block* b = static_cast<free_block*>(ptr);
+    b->next = p->free_list;
+    p->free_list = b;
+    --p->live;
+}
+
+inline void slab_arena::new_slab(slab_pool& p)
+{
+    size_t bytes = SLAB_SIZE;
+    if(bytes < SLAB_CACHE_LINE + 8 * p.block)
+    {
+        bytes = SLAB_CACHE_LINE + 8 * p.block;
+    }
+    bytes = (bytes + SLAB_CACHE_LINE - 1) & ~(static_cast<size_t>(SLAB_CACHE_LINE) - 1);
+    char* mem = static_cast<char*>(::operator new(bytes, std::align_val_t(SLAB_CACHE_LINE)));
+    slab_header* slab = reinterpret_cast<slab_header*>(mem);
+    slab->next = p.slabs;
+    p.slabs = slab;
+    p.cur = mem + SLAB_CACHE_LINE;
+    p.end = mem + bytes;
+}
+
+inline void slab_arena::release_pool(slab_pool& p) noexcept
+{
+    while(p.slabs != nullptr)
+    {
+        slab_header* next = p.slabs->next;
+        ::operator delete(p.slabs, std::align_val_t(SLAB_CACHE_LINE));
+        p.slabs = next;
+    }
+    p.free_list = nullptr;
+    p.cur = nullptr;
+    p.end = nullptr;
+    p.live = 0;
+}
+
+// slab_allocator
+// 默认构造时创建新的 slab_arena；拷贝、rebind 得到的分配器共享同一个 arena
+// 拷贝构造容器时 (select_on_container_copy_construction) 新容器获得独立的 arena
+// 移动赋值不传播分配器：arena 不同时元素被逐个移动到目标容器自己的 arena 中
+template <typename T>
+class slab_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    typedef m_false_type propagate_on_container_copy_assignment;
+    typedef m_false_type propagate_on_container_move_assignment;
+    typedef m_true_type  propagate_on_container_swap;
+    typedef m_false_type is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef slab_allocator<U> other;
+    };
+
+    template <typename U> friend class slab_allocator;
+
+    slab_allocator(): _arena(new slab_arena) {}
+
+    slab_allocator(const slab_allocator& rhs) noexcept: _arena(rhs._arena)
+    {
+        _arena->add_ref();
+    }
+
+    template <typename U>
+    slab_allocator(const slab_allocator<U>& rhs) noexcept: _arena(rhs._arena)
+    {
+        _arena->add_ref();
+    }
+
+    slab_allocator& operator=(const slab_allocator& rhs) noexcept
+    {
+        rhs._arena->add_ref();
+        drop();
+        _arena = rhs._arena;
+        return *this;
+    }
+
+    ~slab_allocator() { drop(); }
+
+    T* allocate(size_type n)
+    {
+        if(n == 0) return nullptr;
+        if(n == 1)
+        {
+            void* p = _arena->allocate(sizeof(T), alignof(T));
+            if(p != nullptr) return static_cast<T*>(p);
+        }
+        return static_cast<T*>(mystl::aligned_new(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, size_type n) noexcept
+    {
+        if(ptr == nullptr) return;
+        if(n == 1 && _arena->has_pool(sizeof(T), alignof(T)))
+        {
+            _arena->deallocate(ptr, sizeof(T), alignof(T));
+            return;
+        }
+        mystl::aligned_delete(ptr, alignof(T));
+    }
+
+    // mystl 扩展：当前尚未释放的 T 大小的块数，以及整体释放这些块
+    size_type live() const noexcept { return _arena->live(sizeof(T), alignof(T)); }
+    void      release() noexcept { _arena->release(sizeof(T), alignof(T)); }
+
+    slab_allocator select_on_container_copy_construction() const
+    {
+        return slab_allocator();
+    }
+
+    const slab_arena* arena() const noexcept { return _arena; }
+
+private:
+    void drop() noexcept
+    {
+        if(_arena->drop_ref() == 0) delete _arena;
+    }
+
+private:
+    slab_arena* _arena;
+};
+
+template <typename T1, typename T2>
+bool operator== (const slab_allocator<T1>& lhs, const slab_allocator<T2>& rhs) noexcept
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template <typename T1, typename T2>
+bool operator!= (const slab_allocator<T1>& lhs, const slab_allocator<T2>& rhs) noexcept
+{
+    return !(lhs == rhs);
+}
+
+} // end of namespace mystl
+#endif // !SLAB_ALLOCATOR_H_
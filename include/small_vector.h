@@ -0,0 +1,366 @@
+// -- small_vector.h 模版类 small_vector
+// 前 N 个元素存放在对象内部的缓冲区中，超出后转移到堆上，接口与 vector 相同
+#ifndef SMALL_VECTOR_H_
+#define SMALL_VECTOR_H_
+
+// notes:
+// small_vector 私有继承 vector，扩容、插入、删除等逻辑与 vector 完全相同:
+// vector 的所有分配与释放都经由 small_buffer_allocator，它在请求不超过 N 个元素且内联缓冲区
+// 空闲时返回内联缓冲区，否则转交给 Alloc；释放内联缓冲区时只标记为空闲
+// vector 的移动与交换直接交换指针，对内联缓冲区不成立，small_vector 自行实现这几个函数:
+// * 堆上的空间仍然直接接管
+// * 内联的元素逐个移动
+// 因此 small_vector 不可平凡重定位，移动后原对象的迭代器全部失效
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include "vector.h"
+
+namespace mystl
+{
+
+// 内联缓冲区
+template <typename T, size_t N>
+class small_buffer
+{
+    static_assert(N > 0, "small_vector: N must be positive");
+
+    template <typename U, size_t M, typename A> friend class small_buffer_allocator;
+
+protected:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type  _inline[N];
+    bool    _inline_used = true;
+
+    small_buffer() noexcept = default;
+    small_buffer(const small_buffer&) = delete;
+    small_buffer& operator=(const small_buffer&) = delete;
+
+    T* inline_data() noexcept { return reinterpret_cast<T*>(_inline); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>(_inline); }
+};
+
+// small_buffer_allocator
+// 持有所属 small_vector 的内联缓冲区，只在同一个 small_vector 内部复制，不随容器传播
+template <typename T, size_t N, typename Alloc>
+class small_buffer_allocator: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>   upstream_allocator;
+    typedef mystl::allocator_traits<upstream_allocator>                         upstream_traits;
+    typedef mystl::alloc_holder<upstream_allocator>                             alloc_base;
+
+public:
+    typedef T                                       value_type;
+    typedef T*                                      pointer;
+    typedef const T*                                const_pointer;
+    typedef T&                                      reference;
+    typedef const T&                                const_reference;
+    typedef typename upstream_traits::size_type         size_type;
+    typedef typename upstream_traits::difference_type   difference_type;
+
+    typedef m_false_type    propagate_on_container_copy_assignment;
+    typedef m_false_type    propagate_on_container_move_assignment;
+    typedef m_false_type    propagate_on_container_swap;
+    typedef m_false_type    is_always_equal;
+
+    // 其他类型没有内联缓冲区，退化为 Alloc
+    template <typename U>
+    struct rebind
+    {
+        typedef typename std::conditional<std::is_same<U, T>::value, small_buffer_allocator,
+            typename upstream_traits::template rebind_alloc<U>>::type other;
+    };
+
+    small_buffer_allocator(small_buffer<T, N>* buf, const upstream_allocator& a) noexcept
+    : alloc_base(a), _buf(buf) {}
+
+    T* allocate(size_type n)
+    {
+        if(n <= N && !_buf->_inline_used)
+        {
+            _buf->_inline_used = true;
+            return _buf->inline_data();
+        }
+        return upstream_traits::allocate(this->get_alloc(), n);
+    }
+
+    void deallocate(T* ptr, size_type n)
+    {
+        if(ptr == _buf->inline_data())
+        {
+            _buf->_inline_used = false;
+            return;
+        }
+        if(ptr != nullptr) upstream_traits::deallocate(this->get_alloc(), ptr, n);
+    }
+
+    const upstream_allocator& upstream() const noexcept { return this->get_alloc(); }
+
+    bool operator==(const small_buffer_allocator& rhs) const noexcept { return _buf == rhs._buf; }
+    bool operator!=(const small_buffer_allocator& rhs) const noexcept { return _buf != rhs._buf; }
+
+private:
+    small_buffer<T, N>*     _buf;
+};
+
+// small_vector
+// 基类顺序保证内联缓冲区先于 vector 构造、晚于 vector 析构
+template <typename T, size_t N, typename Alloc = mystl::allocator<T>>
+class small_vector: private mystl::small_buffer<T, N>,
+                    private mystl::vector<T, mystl::small_buffer_allocator<T, N, Alloc>>
+{
+    typedef mystl::small_buffer<T, N>                                   buffer_base;
+    typedef mystl::small_buffer_allocator<T, N, Alloc>                  buffer_allocator;
+    typedef mystl::vector<T, buffer_allocator>                          vector_base;
+
+public:
+    // traits
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type;
+
+    using typename vector_base::value_type;
+    using typename vector_base::pointer;
+    using typename vector_base::const_pointer;
+    using typename vector_base::reference;
+    using typename vector_base::const_reference;
+    using typename vector_base::size_type;
+    using typename vector_base::difference_type;
+    using typename vector_base::iterator;
+    using typename vector_base::const_iterator;
+    using typename vector_base::reverse_iterator;
+    using typename vector_base::const_reverse_iterator;
+
+    static constexpr size_t inline_capacity = N;
+
+    allocator_type get_allocator() const { return allocator_type(this->get_alloc().upstream()); }
+
+public:
+    // ctors
+    small_vector() noexcept: small_vector(allocator_type()) {}
+
+    explicit small_vector(const allocator_type& alloc) noexcept
+    : vector_base(typename vector_base::adopt_storage_tag(), buffer_base::inline_data(), N,
+                  buffer_allocator(this, alloc))
+    {
+    }
+
+    explicit small_vector(size_type n, const allocator_type& alloc = allocator_type())
+    : small_vector(alloc)
+    {
+        this->resize(n);
+    }
+
+    small_vector(size_type n, const value_type& value,
+                 const allocator_type& alloc = allocator_type())
+    : small_vector(alloc)
+    {
+        this->assign(n, value);
+    }
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_input_iterator<Iter>::value, int>::type = 0>
+    small_vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    : small_vector(alloc)
+    {
+        this->assign(first, last);
+    }
+
+    small_vector(std::initializer_list<value_type> initlist,
+                 const allocator_type& alloc = allocator_type())
+    : small_vector(alloc)
+    {
+        this->assign(initlist);
+    }
+
+    small_vector(const small_vector& rhs)
+    : small_vector(mystl::allocator_traits<allocator_type>::select_on_container_copy_construction(
+                   rhs.get_allocator()))
+    {
+        this->assign(rhs.begin(), rhs.end());
+    }
+
+    // 分配器可能不相等时需要重新分配空间
+    small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value &&
+        mystl::allocator_traits<allocator_type>::is_always_equal::value)
+    : small_vector(rhs.get_allocator())
+    {
+        move_from(rhs);
+    }
+
+    // assign
+    small_vector& operator=(const small_vector& rhs)
+    {
+        if(this != &rhs) this->assign(rhs.begin(), rhs.end());
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& rhs)
+    {
+        if(this != &rhs)
+        {
+            this->clear();
+            release_heap();
+            move_from(rhs);
+        }
+        return *this;
+    }
+
+    small_vector& operator=(std::initializer_list<value_type> initlist)
+    {
+        this->assign(initlist);
+        return *this;
+    }
+
+    // 析构由 vector 完成，内联缓冲区的释放只是标记
+
+public:
+    // 与 vector 相同的接口
+    using vector_base::begin;
+    using vector_base::end;
+    using vector_base::rbegin;
+    using vector_base::rend;
+    using vector_base::cbegin;
+    using vector_base::cend;
+    using vector_base::crbegin;
+    using vector_base::crend;
+
+    using vector_base::empty;
+    using vector_base::size;
+    using vector_base::max_size;
+    using vector_base::capacity;
+    using vector_base::reserve;
+    using vector_base::shrink_to_fit;
+
+    using vector_base::operator[];
+    using vector_base::at;
+    using vector_base::front;
+    using vector_base::back;
+    using vector_base::data;
+
+    using vector_base::assign;
+    using vector_base::emplace;
+    using vector_base::emplace_back;
+    using vector_base::push_back;
+    using vector_base::pop_back;
+    using vector_base::insert;
+    using vector_base::erase;
+    using vector_base::clear;
+    using vector_base::resize;
+    using vector_base::reverse;
+
+    // 元素是否存放在内联缓冲区中
+    bool is_inline() const noexcept { return this->_begin == buffer_base::inline_data(); }
+
+    void swap(small_vector& rhs);
+
+private:
+    // 回到空的内联状态，调用前元素已经析构
+    void reset_inline() noexcept
+    {
+        this->_begin = buffer_base::inline_data();
+        this->_end = this->_begin;
+        this->_cap = this->_begin + N;
+        this->_inline_used = true;
+    }
+
+    // 释放堆上的空间，调用前元素已经析构
+    void release_heap() noexcept
+    {
+        if(!is_inline())
+        {
+            this->get_alloc().deallocate(this->_begin, this->capacity());
+            reset_inline();
+        }
+    }
+
+    void move_from(small_vector& rhs);
+};
+
+// move_from: *this 为空且处于内联状态
+// rhs 在堆上且分配器相等时直接接管空间，否则逐个移动元素
+template <typename T, size_t N, typename Alloc>
+void small_vector<T, N, Alloc>::move_from(small_vector& rhs)
+{
+    if(!rhs.is_inline() && mystl::alloc_equal(get_allocator(), rhs.get_allocator()))
+    {
+        this->_begin = rhs._begin;
+        this->_end = rhs._end;
+        this->_cap = rhs._cap;
+        this->_inline_used = false;
+        rhs.reset_inline();
+    }
+    else
+    {
+        this->reserve(rhs.size());
+        this->_end = mystl::uninitialized_move(rhs.begin(), rhs.end(), this->_begin);
+        rhs.clear();
+    }
+}
+
+// swap: 两者都在堆上时交换指针，否则经由临时对象移动
+template <typename T, size_t N, typename Alloc>
+void small_vector<T, N, Alloc>::swap(small_vector& rhs)
+{
+    if(this == &rhs) return;
+    if(!is_inline() && !rhs.is_inline() && mystl::alloc_equal(get_allocator(), rhs.get_allocator()))
+    {
+        mystl::swap(this->_begin, rhs._begin);
+        mystl::swap(this->_end, rhs._end);
+        mystl::swap(this->_cap, rhs._cap);
+    }
+    else
+    {
+        small_vector temp(mystl::move(rhs));
+        rhs = mystl::move(*this);
+        *this = mystl::move(temp);
+    }
+}
+
+// 重载比较运算符
+template <typename T, size_t N, typename Alloc>
+bool operator== (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return lhs.size() == rhs.size() &&
+        std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename T, size_t N, typename Alloc>
+bool operator< (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return std::lexicographical_compare(lhs.begin(), lhs.end(),
+                        rhs.begin(), rhs.end());
+}
+
+template <typename T, size_t N, typename Alloc>
+bool operator!= (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, size_t N, typename Alloc>
+bool operator> (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return rhs < lhs;
+}
+
+template <typename T, size_t N, typename Alloc>
+bool operator<= (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return !(rhs < lhs);
+}
+
+template <typename T, size_t N, typename Alloc>
+bool operator>= (const small_vector<T, N, Alloc>& lhs, const small_vector<T, N, Alloc>& rhs)
+{
+    return !(lhs < rhs);
+}
+
+// mystl::swap overload
+template <typename T, size_t N, typename Alloc>
+void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+} // end of namespace mystl
+#endif // !SMALL_VECTOR_H_
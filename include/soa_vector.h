@@ -0,0 +1,735 @@
+// -- soa_vector.h 模版类 soa_vector
+// 按列存放的 vector: soa_vector<Ts...> 的每一行由 Ts... 各一个字段组成，每个字段单独占用一段连续空间
+#ifndef SOA_VECTOR_H_
+#define SOA_VECTOR_H_
+
+// notes:
+// * 所有列共用 size 与 capacity，扩容时按 vector 的 growth_1_5x 一起重新分配
+// * 行以代理引用访问: reference 为 std::tuple<Ts&...>，可以整体赋值，也可以结构化绑定
+// * column<I>() 返回第 I 列的 soa_span，只扫描少数字段的循环直接在列上进行
+// * 异常保证与 vector 相同: emplace_back / push_back / reserve 满足强异常安全保证，
+//   某一列构造失败时已构造的列被析构
+// * 迭代器以 (容器, 行号) 表示，解引用得到代理引用，因此不能用于要求真实引用的算法
+// * 分配器写在列类型之前: basic_soa_vector<Alloc, Ts...>，每一列使用 rebind 到该列类型的分配器；
+//   soa_vector<Ts...> 为使用 mystl::allocator 的别名
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "allocator.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "vector.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// soa_span: 一列的视图
+template <typename T>
+class soa_span
+{
+public:
+    typedef T               value_type;
+    typedef T*              pointer;
+    typedef T&              reference;
+    typedef T*              iterator;
+    typedef size_t          size_type;
+
+    soa_span(T* data, size_type size) noexcept: _data(data), _size(size) {}
+
+    pointer     data()  const noexcept { return _data; }
+    size_type   size()  const noexcept { return _size; }
+    bool        empty() const noexcept { return _size == 0; }
+    iterator    begin() const noexcept { return _data; }
+    iterator    end()   const noexcept { return _data + _size; }
+
+    reference operator[](size_type n) const
+    {
+        MYSTL_DEBUG(n < _size);
+        return _data[n];
+    }
+
+private:
+    T*          _data;
+    size_type   _size;
+};
+
+// soa_iterator: 行迭代器
+template <typename Vec, typename Ref>
+class soa_iterator
+{
+public:
+    typedef mystl::random_access_iterator_tag       iterator_category;
+    typedef typename Vec::value_type                value_type;
+    typedef void                                    pointer;
+    typedef Ref                                     reference;
+    typedef ptrdiff_t                               difference_type;
+    typedef size_t                                  size_type;
+
+    soa_iterator() noexcept: _vec(nullptr), _row(0) {}
+    soa_iterator(Vec* vec, size_type row) noexcept: _vec(vec), _row(row) {}
+
+    // iterator 可以转换为 const_iterator
+    template <typename V, typename R, typename std::enable_if<
+        std::is_convertible<V*, Vec*>::value, int>::type = 0>
+    soa_iterator(const soa_iterator<V, R>& rhs) noexcept: _vec(rhs.container()), _row(rhs.row()) {}
+
+    Vec*        container() const noexcept { return _vec; }
+    size_type   row()       const noexcept { return _row; }
+
+    reference operator*() const { return (*_vec)[_row]; }
+    reference operator[](difference_type n) const { return (*_vec)[_row + n]; }
+
+    soa_iterator& operator++() noexcept { ++_row; return *this; }
+    soa_iterator& operator--() noexcept { --_row; return *this; }
+    soa_iterator operator++(int) noexcept { soa_iterator tmp = *this; ++_row; return tmp; }
+    soa_iterator operator--(int) noexcept { soa_iterator tmp = *this; --_row; return tmp; }
+
+    soa_iterator& operator+=(difference_type n) noexcept { _row += n; return *this; }
+    soa_iterator& operator-=(difference_type n) noexcept { _row -= n; return *this; }
+    soa_iterator operator+(difference_type n) const noexcept { return soa_iterator(_vec, _row + n); }
+    soa_iterator operator-(difference_type n) const noexcept { return soa_iterator(_vec, _row - n); }
+
+    template <typename V, typename R>
+    difference_type operator-(const soa_iterator<V, R>& rhs) const noexcept
+    {
+        return static_cast<difference_type>(_row) - static_cast<difference_type>(rhs.row());
+    }
+
+    template <typename V, typename R>
+    bool operator==(const soa_iterator<V, R>& rhs) const noexcept { return _row == rhs.row(); }
+    template <typename V, typename R>
+    bool operator!=(const soa_iterator<V, R>& rhs) const noexcept { return _row != rhs.row(); }
+    template <typename V, typename R>
+    bool operator<(const soa_iterator<V, R>& rhs) const noexcept { return _row < rhs.row(); }
+    template <typename V, typename R>
+    bool operator>(const soa_iterator<V, R>& rhs) const noexcept { return _row > rhs.row(); }
+    template <typename V, typename R>
+    bool operator<=(const soa_iterator<V, R>& rhs) const noexcept { return _row <= rhs.row(); }
+    template <typename V, typename R>
+    bool operator>=(const soa_iterator<V, R>& rhs) const noexcept { return _row >= rhs.row(); }
+
+private:
+    Vec*        _vec;
+    size_type   _row;
+};
+
+// basic_soa_vector
+template <typename Alloc, typename ...Ts>
+class basic_soa_vector: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<std::tuple<Ts...>>>
+{
+    static_assert(sizeof...(Ts) > 0, "soa_vector: at least one column is required");
+
+public:
+    // traits
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<std::tuple<Ts...>> allocator_type;
+    typedef mystl::allocator_traits<allocator_type>         data_traits;
+
+    typedef std::tuple<Ts...>                               value_type;
+    typedef std::tuple<Ts&...>                              reference;
+    typedef std::tuple<const Ts&...>                        const_reference;
+    typedef size_t                                          size_type;
+    typedef ptrdiff_t                                       difference_type;
+
+    typedef soa_iterator<basic_soa_vector, reference>             iterator;
+    typedef soa_iterator<const basic_soa_vector, const_reference> const_iterator;
+
+    template <size_t I>
+    using column_type = typename std::tuple_element<I, value_type>::type;
+
+    static constexpr size_t column_count = sizeof...(Ts);
+
+    allocator_type get_allocator() const { return get_alloc(); }
+
+private:
+    typedef mystl::alloc_holder<allocator_type>             alloc_base;
+    typedef std::index_sequence_for<Ts...>                  columns;
+    using alloc_base::get_alloc;
+
+    template <size_t I>
+    using column_index = std::integral_constant<size_t, I>;
+
+    // 第 I 列的分配器
+    template <size_t I>
+    using column_allocator = typename data_traits::template rebind_alloc<column_type<I>>;
+    template <size_t I>
+    using column_traits = mystl::allocator_traits<column_allocator<I>>;
+
+    std::tuple<Ts*...>  _columns;
+    size_type           _size = 0;
+    size_type           _cap = 0;
+
+public:
+    // ctors
+    basic_soa_vector() noexcept(std::is_nothrow_default_constructible<allocator_type>::value)
+    : alloc_base(), _columns() {}
+
+    explicit basic_soa_vector(const allocator_type& alloc): alloc_base(alloc), _columns() {}
+
+    explicit basic_soa_vector(size_type n, const allocator_type& alloc = allocator_type())
+    : basic_soa_vector(alloc)
+    {
+        resize(n);
+    }
+
+    basic_soa_vector(const basic_soa_vector& rhs)
+    : basic_soa_vector(rhs, data_traits::select_on_container_copy_construction(rhs.get_alloc())) {}
+
+    basic_soa_vector(const basic_soa_vector& rhs, const allocator_type& alloc);
+
+    basic_soa_vector(basic_soa_vector&& rhs) noexcept
+    : alloc_base(mystl::move(rhs.get_alloc())), _columns(rhs._columns), _size(rhs._size), _cap(rhs._cap)
+    {
+        rhs._columns = std::tuple<Ts*...>();
+        rhs._size = 0;
+        rhs._cap = 0;
+    }
+
+    // 分配器不相等时无法接管 rhs 的列，只能逐列移动元素
+    basic_soa_vector(basic_soa_vector&& rhs, const allocator_type& alloc);
+
+    basic_soa_vector& operator=(const basic_soa_vector& rhs);
+
+    basic_soa_vector& operator=(basic_soa_vector&& rhs) noexcept(
+        data_traits::propagate_on_container_move_assignment::value ||
+        data_traits::is_always_equal::value);
+
+    ~basic_soa_vector()
+    {
+        release();
+    }
+
+public:
+    // 迭代器相关
+    iterator        begin()         noexcept { return iterator(this, 0); }
+    const_iterator  begin()   const noexcept { return const_iterator(this, 0); }
+    iterator        end()           noexcept { return iterator(this, _size); }
+    const_iterator  end()     const noexcept { return const_iterator(this, _size); }
+    const_iterator  cbegin()  const noexcept { return begin(); }
+    const_iterator  cend()    const noexcept { return end(); }
+
+    // 容量相关
+    bool        empty()     const noexcept { return _size == 0; }
+    size_type   size()      const noexcept { return _size; }
+    size_type   capacity()  const noexcept { return _cap; }
+    size_type   max_size()  const noexcept
+    {
+        return static_cast<size_type>(-1) / row_bytes();
+    }
+
+    void reserve(size_type new_cap)
+    {
+        if(new_cap > _cap)
+        {
+            THROW_LENGTH_ERROR_IF(new_cap > max_size(),
+                                  "n can not larger than max_size() in soa_vector<Ts...>::reserve(n)");
+            reallocate(new_cap);
+        }
+    }
+
+    void shrink_to_fit()
+    {
+        if(_size < _cap) reallocate(_size);
+    }
+
+    // 访问行
+    reference operator[](size_type n)
+    {
+        MYSTL_DEBUG(n < _size);
+        return row(n, columns{});
+    }
+    const_reference operator[](size_type n) const
+    {
+        MYSTL_DEBUG(n < _size);
+        return row(n, columns{});
+    }
+
+    reference at(size_type n)
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < _size), "soa_vector<Ts...>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < _size), "soa_vector<Ts...>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference       front()       { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+    const_reference front() const { MYSTL_DEBUG(!empty()); return (*this)[0]; }
+    reference       back()        { MYSTL_DEBUG(!empty()); return (*this)[_size - 1]; }
+    const_reference back()  const { MYSTL_DEBUG(!empty()); return (*this)[_size - 1]; }
+
+    // 访问列
+    template <size_t I>
+    column_type<I>* data() noexcept { return std::get<I>(_columns); }
+    template <size_t I>
+    const column_type<I>* data() const noexcept { return std::get<I>(_columns); }
+
+    template <size_t I>
+    soa_span<column_type<I>> column() noexcept
+    {
+        return soa_span<column_type<I>>(data<I>(), _size);
+    }
+    template <size_t I>
+    soa_span<const column_type<I>> column() const noexcept
+    {
+        return soa_span<const column_type<I>>(data<I>(), _size);
+    }
+
+    // 修改容器相关操作
+
+    // 每个参数构造一列
+    template <typename ...Args>
+    reference emplace_back(Args&& ...args);
+
+    void push_back(const value_type& value)
+    {
+        push_back_tuple(value, columns{});
+    }
+    void push_back(value_type&& value)
+    {
+        push_back_tuple(mystl::move(value), columns{});
+    }
+
+    void pop_back();
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    void clear() noexcept
+    {
+        destroy_rows(0, _size, columns{});
+        _size = 0;
+    }
+
+    // 新增的行值初始化
+    void resize(size_type new_size);
+
+    void swap(basic_soa_vector& rhs) noexcept
+    {
+        swap_storage(rhs);
+        mystl::alloc_on_swap(get_alloc(), rhs.get_alloc());
+    }
+
+private:
+    // helper functions
+
+    static constexpr size_type row_bytes() noexcept
+    {
+        size_type bytes = 0;
+        for(size_type s : {sizeof(Ts)...}) bytes += s;
+        return bytes;
+    }
+
+    template <size_t ...I>
+    reference row(size_type n, std::index_sequence<I...>)
+    {
+        return reference(std::get<I>(_columns)[n]...);
+    }
+    template <size_t ...I>
+    const_reference row(size_type n, std::index_sequence<I...>) const
+    {
+        return const_reference(std::get<I>(_columns)[n]...);
+    }
+
+    template <typename Tuple, size_t ...I>
+    void push_back_tuple(Tuple&& value, std::index_sequence<I...>)
+    {
+        emplace_back(std::get<I>(mystl::forward<Tuple>(value))...);
+    }
+
+    // 对各列依次调用 op(column_index<I>)；某一列抛出异常时，
+    // 对此前已完成的列依次调用 undo(column_index<I>) 后重新抛出
+    template <typename Op, typename Undo>
+    static void for_columns(Op&, Undo&, column_index<sizeof...(Ts)>) {}
+
+    template <size_t I, typename Op, typename Undo>
+    static void for_columns(Op& op, Undo& undo, column_index<I>)
+    {
+        op(column_index<I>{});
+        try
+        {
+            for_columns(op, undo, column_index<I + 1>{});
+        }
+        catch(...)
+        {
+            undo(column_index<I>{});
+            throw;
+        }
+    }
+
+    // 对各列调用不抛出异常的 f(column_index<I>)
+    template <typename F, size_t ...I>
+    static void each_column(F&& f, std::index_sequence<I...>)
+    {
+        (f(column_index<I>{}), ...);
+    }
+
+    template <size_t I>
+    column_type<I>* allocate_column(size_type n)
+    {
+        column_allocator<I> a(get_alloc());
+        return column_traits<I>::allocate(a, n);
+    }
+
+    template <size_t I>
+    void deallocate_column(column_type<I>* p, size_type n) noexcept
+    {
+        if(p == nullptr) return;
+        column_allocator<I> a(get_alloc());
+        column_traits<I>::deallocate(a, p, n);
+    }
+
+    template <size_t I, typename ...Args>
+    void construct_at(column_type<I>* p, Args&& ...args)
+    {
+        column_allocator<I> a(get_alloc());
+        column_traits<I>::construct(a, p, mystl::forward<Args>(args)...);
+    }
+
+    template <size_t I>
+    void destroy_range(column_type<I>* first, column_type<I>* last) noexcept
+    {
+        column_allocator<I> a(get_alloc());
+        column_traits<I>::destroy(a, first, last);
+    }
+
+    template <size_t ...I>
+    void deallocate_columns(std::tuple<Ts*...>& cols, size_type cap, std::index_sequence<I...>) noexcept
+    {
+        (deallocate_column<I>(std::get<I>(cols), cap), ...);
+    }
+
+    template <size_t ...I>
+    void destroy_rows(size_type first, size_type last, std::index_sequence<I...>) noexcept
+    {
+        (destroy_range<I>(std::get<I>(_columns) + first, std::get<I>(_columns) + last), ...);
+    }
+
+    // 析构全部元素并释放各列
+    void release() noexcept
+    {
+        clear();
+        deallocate_columns(_columns, _cap, columns{});
+        _columns = std::tuple<Ts*...>();
+        _cap = 0;
+    }
+
+    void swap_storage(basic_soa_vector& rhs) noexcept
+    {
+        _columns.swap(rhs._columns);
+        mystl::swap(_size, rhs._size);
+        mystl::swap(_cap, rhs._cap);
+    }
+
+    size_type get_new_capacity(size_type add_size) const;
+    void reallocate(size_type new_cap);
+
+    template <typename Tuple>
+    void construct_row(Tuple&& args);
+};
+
+/*****************************************************************************************/
+
+// 复制构造: 逐列复制，可平凡复制的列为 memmove
+template <typename Alloc, typename ...Ts>
+basic_soa_vector<Alloc, Ts...>::basic_soa_vector(const basic_soa_vector& rhs, const allocator_type& alloc)
+: basic_soa_vector(alloc)
+{
+    if(rhs.empty()) return;
+    reserve(rhs._size);
+    auto copy = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        mystl::uninitialized_copy(rhs.data<I>(), rhs.data<I>() + rhs._size, data<I>());
+    };
+    auto undo = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        destroy_range<I>(data<I>(), data<I>() + rhs._size);
+    };
+    for_columns(copy, undo, column_index<0>{});
+    _size = rhs._size;
+}
+
+template <typename Alloc, typename ...Ts>
+basic_soa_vector<Alloc, Ts...>::basic_soa_vector(basic_soa_vector&& rhs, const allocator_type& alloc)
+: basic_soa_vector(alloc)
+{
+    if(mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+    {
+        swap_storage(rhs);
+        return;
+    }
+    if(rhs.empty()) return;
+    reserve(rhs._size);
+    auto move_column = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        mystl::uninitialized_move(rhs.data<I>(), rhs.data<I>() + rhs._size, data<I>());
+    };
+    auto undo = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        destroy_range<I>(data<I>(), data<I>() + rhs._size);
+    };
+    for_columns(move_column, undo, column_index<0>{});
+    _size = rhs._size;
+}
+
+// 复制赋值: 先完整复制一份，成功后再替换，满足强异常安全保证
+template <typename Alloc, typename ...Ts>
+basic_soa_vector<Alloc, Ts...>&
+basic_soa_vector<Alloc, Ts...>::operator=(const basic_soa_vector& rhs)
+{
+    if(this != &rhs)
+    {
+        basic_soa_vector tmp(rhs, data_traits::propagate_on_container_copy_assignment::value
+                                  ? rhs.get_alloc() : get_alloc());
+        release();
+        mystl::alloc_on_copy(get_alloc(), rhs.get_alloc());
+        swap_storage(tmp);
+    }
+    return *this;
+}
+
+// 移动赋值: 分配器相等或传播时接管各列，否则逐列移动
+template <typename Alloc, typename ...Ts>
+basic_soa_vector<Alloc, Ts...>&
+basic_soa_vector<Alloc, Ts...>::operator=(basic_soa_vector&& rhs) noexcept(
+    data_traits::propagate_on_container_move_assignment::value ||
+    data_traits::is_always_equal::value)
+{
+    if(this == &rhs) return *this;
+    if(data_traits::propagate_on_container_move_assignment::value ||
+       mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+    {
+        release();
+        mystl::alloc_on_move(get_alloc(), rhs.get_alloc());
+        swap_storage(rhs);
+    }
+    else
+    {
+        basic_soa_vector tmp(mystl::move(rhs), get_alloc());
+        release();
+        swap_storage(tmp);
+        rhs.clear();
+    }
+    return *this;
+}
+
+// emplace_back
+// 需要扩容时先把参数构造为一行，参数可能引用容器中的元素
+template <typename Alloc, typename ...Ts>
+template <typename ...Args>
+typename basic_soa_vector<Alloc, Ts...>::reference
+basic_soa_vector<Alloc, Ts...>::emplace_back(Args&& ...args)
+{
+    static_assert(sizeof...(Args) == sizeof...(Ts), "soa_vector: one argument per column");
+    if(_size == _cap)
+    {
+        value_type value(mystl::forward<Args>(args)...);
+        reallocate(get_new_capacity(1));
+        construct_row(mystl::move(value));
+    }
+    else
+    {
+        construct_row(std::forward_as_tuple(mystl::forward<Args>(args)...));
+    }
+    return (*this)[_size - 1];
+}
+
+// 在 _size 处逐列构造一行
+template <typename Alloc, typename ...Ts>
+template <typename Tuple>
+void basic_soa_vector<Alloc, Ts...>::construct_row(Tuple&& args)
+{
+    auto construct = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        construct_at<I>(data<I>() + _size, std::get<I>(mystl::forward<Tuple>(args)));
+    };
+    auto undo = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        destroy_range<I>(data<I>() + _size, data<I>() + _size + 1);
+    };
+    for_columns(construct, undo, column_index<0>{});
+    ++_size;
+}
+
+template <typename Alloc, typename ...Ts>
+void basic_soa_vector<Alloc, Ts...>::pop_back()
+{
+    MYSTL_DEBUG(!empty());
+    --_size;
+    destroy_rows(_size, _size + 1, columns{});
+}
+
+// erase: 每一列各自前移
+template <typename Alloc, typename ...Ts>
+typename basic_soa_vector<Alloc, Ts...>::iterator
+basic_soa_vector<Alloc, Ts...>::erase(const_iterator pos)
+{
+    MYSTL_DEBUG(pos >= begin() && pos < end());
+    return erase(pos, pos + 1);
+}
+
+template <typename Alloc, typename ...Ts>
+typename basic_soa_vector<Alloc, Ts...>::iterator
+basic_soa_vector<Alloc, Ts...>::erase(const_iterator first, const_iterator last)
+{
+    MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first));
+    const size_type f = first.row();
+    const size_type l = last.row();
+    if(f == l) return iterator(this, f);
+    each_column([&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        std::move(data<I>() + l, data<I>() + _size, data<I>() + f);
+    }, columns{});
+    const size_type new_size = _size - (l - f);
+    destroy_rows(new_size, _size, columns{});
+    _size = new_size;
+    return iterator(this, f);
+}
+
+// resize
+template <typename Alloc, typename ...Ts>
+void basic_soa_vector<Alloc, Ts...>::resize(size_type new_size)
+{
+    if(new_size < _size)
+    {
+        destroy_rows(new_size, _size, columns{});
+        _size = new_size;
+        return;
+    }
+    reserve(new_size);
+    auto init = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        auto first = data<I>() + _size;
+        auto curr = first;
+        try
+        {
+            for(; curr != data<I>() + new_size; ++curr)
+                construct_at<I>(curr);
+        }
+        catch(...)
+        {
+            destroy_range<I>(first, curr);
+            throw;
+        }
+    };
+    auto undo = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        destroy_range<I>(data<I>() + _size, data<I>() + new_size);
+    };
+    for_columns(init, undo, column_index<0>{});
+    _size = new_size;
+}
+
+template <typename Alloc, typename ...Ts>
+typename basic_soa_vector<Alloc, Ts...>::size_type
+basic_soa_vector<Alloc, Ts...>::get_new_capacity(size_type add_size) const
+{
+    THROW_LENGTH_ERROR_IF(max_size() - _cap < add_size, "soa_vector<Ts...>'s size too big");
+    const size_type new_cap = mystl::growth_1_5x()(_cap, add_size, max_size());
+    return std::min(std::max(new_cap, _cap + add_size), max_size());
+}
+
+// reallocate: 所有列一起换到容量为 new_cap 的新空间
+// 先分配全部新列，再搬移元素。移动可能抛出异常的列以复制代替 (move_if_noexcept)，这些列先搬移，
+// 不会失败的移动放在最后，因此任何一步失败时原有的列都保持不变 (只能移动且移动可能抛出异常的列除外)
+template <typename Alloc, typename ...Ts>
+void basic_soa_vector<Alloc, Ts...>::reallocate(size_type new_cap)
+{
+    MYSTL_DEBUG(new_cap >= _size);
+    std::tuple<Ts*...> new_columns;
+    auto allocate = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        std::get<I>(new_columns) = allocate_column<I>(new_cap);
+    };
+    auto deallocate = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        deallocate_column<I>(std::get<I>(new_columns), new_cap);
+    };
+    for_columns(allocate, deallocate, column_index<0>{});
+
+    // 第 I 列是否以复制搬移
+    auto copies = [](auto i) {
+        typedef column_type<decltype(i)::value> T;
+        return !std::is_nothrow_move_constructible<T>::value && std::is_copy_constructible<T>::value;
+    };
+    auto copy_pass = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        if(copies(i))
+            mystl::uninitialized_copy(data<I>(), data<I>() + _size, std::get<I>(new_columns));
+    };
+    auto move_pass = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        if(!copies(i))
+            mystl::uninitialized_move(data<I>(), data<I>() + _size, std::get<I>(new_columns));
+    };
+    auto undo_copy = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        if(copies(i))
+            destroy_range<I>(std::get<I>(new_columns), std::get<I>(new_columns) + _size);
+    };
+    auto undo_move = [&](auto i) {
+        constexpr size_t I = decltype(i)::value;
+        if(!copies(i))
+            destroy_range<I>(std::get<I>(new_columns), std::get<I>(new_columns) + _size);
+    };
+    try
+    {
+        for_columns(copy_pass, undo_copy, column_index<0>{});
+        try
+        {
+            for_columns(move_pass, undo_move, column_index<0>{});
+        }
+        catch(...)
+        {
+            each_column(undo_copy, columns{});
+            throw;
+        }
+    }
+    catch(...)
+    {
+        deallocate_columns(new_columns, new_cap, columns{});
+        throw;
+    }
+
+    destroy_rows(0, _size, columns{});
+    deallocate_columns(_columns, _cap, columns{});
+    _columns = new_columns;
+    _cap = new_cap;
+}
+
+// 重载比较运算符
+template <typename Alloc, typename ...Ts>
+bool operator==(const basic_soa_vector<Alloc, Ts...>& lhs, const basic_soa_vector<Alloc, Ts...>& rhs)
+{
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+}
+
+template <typename Alloc, typename ...Ts>
+bool operator!=(const basic_soa_vector<Alloc, Ts...>& lhs, const basic_soa_vector<Alloc, Ts...>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+// mystl::swap overload
+template <typename Alloc, typename ...Ts>
+void swap(basic_soa_vector<Alloc, Ts...>& lhs, basic_soa_vector<Alloc, Ts...>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// 只保存各列的指针，分配器可平凡重定位时 soa_vector 也可以
+template <typename Alloc, typename ...Ts>
+struct is_trivially_relocatable<mystl::basic_soa_vector<Alloc, Ts...>>: is_trivially_relocatable<Alloc> {};
+
+// 使用 mystl::allocator 的 soa_vector
+template <typename ...Ts>
+using soa_vector = basic_soa_vector<mystl::allocator<std::tuple<Ts...>>, Ts...>;
+
+} // end of namespace mystl
+#endif // !SOA_VECTOR_H_
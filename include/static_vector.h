@@ -0,0 +1,421 @@
+// -- static_vector.h 模版类 static_vector
+// 容量固定为 N、元素存放在对象内部的 vector，从不分配堆内存
+#ifndef STATIC_VECTOR_H_
+#define STATIC_VECTOR_H_
+
+// notes:
+// 接口与 vector 相同，容量固定为 N，没有 reserve / shrink_to_fit
+// 超出容量的处理由模版参数 Overflow 决定:
+// * static_vector_throw (默认): 抛出 std::length_error，容器保持不变
+// * static_vector_checked: 视为程序错误，MYSTL_DEBUG 断言后终止程序，不抛出 length_error
+// 两种策略下 try_push_back / try_emplace_back 在容器已满时都返回 nullptr，不触发溢出处理
+// 元素为平凡类型时:
+// * 存储就是 T[N]，static_vector 本身可平凡复制，复制即整体 memcpy
+// * C++17 的常量表达式要求成员全部初始化，因此构造时存储清零
+// * 构造、元素访问、push_back / emplace_back / try_push_back / try_emplace_back / pop_back /
+//   resize(n) / clear 可用于常量表达式
+// 插入、删除、赋值与比较由 inplace_vector_base 提供，平凡类型走 memmove / memset
+// 移动构造与移动赋值逐个移动元素，原对象的元素个数不变
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <initializer_list>
+#include <type_traits>
+#include "inplace_vector_base.h"
+#include "iterator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+// 溢出策略
+struct static_vector_throw
+{
+    [[noreturn]] static void overflow(const char* what)
+    {
+        throw std::length_error(what);
+    }
+};
+
+struct static_vector_checked
+{
+    [[noreturn]] static void overflow(const char*) noexcept
+    {
+        MYSTL_DEBUG(!"static_vector overflow");
+        std::abort();
+    }
+};
+
+// 存储
+// 平凡类型: T[N]，复制、移动、析构全部平凡
+template <typename T, size_t N,
+          bool = std::is_trivial<T>::value && std::is_copy_assignable<T>::value>
+class static_vector_storage
+{
+    static_assert(N > 0, "static_vector: N must be positive");
+
+protected:
+    T       _data[N] = {};
+    size_t  _size = 0;
+
+    constexpr T* data_ptr() noexcept { return _data; }
+    constexpr const T* data_ptr() const noexcept { return _data; }
+};
+
+// 其他类型: 未初始化的缓冲区，前 _size 个位置上有存活的对象
+template <typename T, size_t N>
+class static_vector_storage<T, N, false>
+{
+    static_assert(N > 0, "static_vector: N must be positive");
+
+protected:
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type  _buf[N];
+    size_t  _size = 0;
+
+    T* data_ptr() noexcept { return reinterpret_cast<T*>(_buf); }
+    const T* data_ptr() const noexcept { return reinterpret_cast<const T*>(_buf); }
+
+    static_vector_storage() noexcept {}
+
+    static_vector_storage(const static_vector_storage& rhs)
+    {
+        mystl::uninitialized_copy(rhs.data_ptr(), rhs.data_ptr() + rhs._size, data_ptr());
+        _size = rhs._size;
+    }
+
+    static_vector_storage(static_vector_storage&& rhs)
+        noexcept(std::is_nothrow_move_constructible<T>::value)
+    {
+        mystl::uninitialized_move(rhs.data_ptr(), rhs.data_ptr() + rhs._size, data_ptr());
+        _size = rhs._size;
+    }
+
+    static_vector_storage& operator=(const static_vector_storage& rhs)
+    {
+        if(this != &rhs)
+        {
+            const size_t n = rhs._size;
+            if(n <= _size)
+            {
+                std::copy(rhs.data_ptr(), rhs.data_ptr() + n, data_ptr());
+                mystl::destroy(data_ptr() + n, data_ptr() + _size);
+            }
+            else
+            {
+                std::copy(rhs.data_ptr(), rhs.data_ptr() + _size, data_ptr());
+                mystl::uninitialized_copy(rhs.data_ptr() + _size, rhs.data_ptr() + n,
+                                          data_ptr() + _size);
+            }
+            _size = n;
+        }
+        return *this;
+    }
+
+    static_vector_storage& operator=(static_vector_storage&& rhs)
+        noexcept(std::is_nothrow_move_constructible<T>::value &&
+                 std::is_nothrow_move_assignable<T>::value)
+    {
+        if(this != &rhs)
+        {
+            const size_t n = rhs._size;
+            if(n <= _size)
+            {
+                std::move(rhs.data_ptr(), rhs.data_ptr() + n, data_ptr());
+                mystl::destroy(data_ptr() + n, data_ptr() + _size);
+            }
+            else
+            {
+                std::move(rhs.data_ptr(), rhs.data_ptr() + _size, data_ptr());
+                mystl::uninitialized_move(rhs.data_ptr() + _size, rhs.data_ptr() + n,
+                                          data_ptr() + _size);
+            }
+            _size = n;
+        }
+        return *this;
+    }
+
+    ~static_vector_storage()
+    {
+        mystl::destroy(data_ptr(), data_ptr() + _size);
+    }
+};
+
+// static_vector
+template <typename T, size_t N, typename Overflow = mystl::static_vector_throw>
+class static_vector: private mystl::static_vector_storage<T, N>,
+                     public mystl::inplace_vector_base<static_vector<T, N, Overflow>, T>
+{
+    typedef mystl::static_vector_storage<T, N>                              storage_base;
+    typedef mystl::inplace_vector_base<static_vector<T, N, Overflow>, T>    base;
+    friend base;
+
+public:
+    // traits
+    typedef T                                           value_type;
+    typedef T*                                          pointer;
+    typedef const T*                                    const_pointer;
+    typedef T&                                          reference;
+    typedef const T&                                    const_reference;
+    typedef size_t                                      size_type;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef value_type*                                 iterator;
+    typedef const value_type*                           const_iterator;
+    typedef mystl::reverse_iterator<iterator>           reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator;
+
+    static constexpr size_type static_capacity = N;
+
+private:
+    // 存储是否为 T[N]
+    typedef m_bool_constant<std::is_trivial<T>::value &&
+                            std::is_copy_assignable<T>::value>  trivial_storage;
+
+public:
+    // ctors
+    constexpr static_vector() noexcept = default;
+
+    explicit static_vector(size_type n)
+    {
+        resize(n);
+    }
+
+    static_vector(size_type n, const value_type& value)
+    {
+        this->assign(n, value);
+    }
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_input_iterator<Iter>::value, int>::type = 0>
+    static_vector(Iter first, Iter last)
+    {
+        this->assign(first, last);
+    }
+
+    static_vector(std::initializer_list<value_type> initlist)
+    {
+        this->assign(initlist.begin(), initlist.end());
+    }
+
+    // 复制、移动与析构由 static_vector_storage 完成
+
+    static_vector& operator=(std::initializer_list<value_type> initlist)
+    {
+        this->assign(initlist.begin(), initlist.end());
+        return *this;
+    }
+
+public:
+    // 迭代器相关
+    constexpr iterator begin()                  noexcept { return this->data_ptr(); }
+    constexpr const_iterator begin()      const noexcept { return this->data_ptr(); }
+    constexpr iterator end()                    noexcept { return this->data_ptr() + this->_size; }
+    constexpr const_iterator end()        const noexcept { return this->data_ptr() + this->_size; }
+
+    reverse_iterator rbegin()                   noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin()       const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend()                     noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend()         const noexcept { return const_reverse_iterator(begin()); }
+
+    constexpr const_iterator cbegin()     const noexcept { return begin(); }
+    constexpr const_iterator cend()       const noexcept { return end(); }
+    const_reverse_iterator crbegin()      const noexcept { return rbegin(); }
+    const_reverse_iterator crend()        const noexcept { return rend(); }
+
+    // 容量相关
+    constexpr bool      empty()     const noexcept { return this->_size == 0; }
+    constexpr bool      full()      const noexcept { return this->_size == N; }
+    constexpr size_type size()      const noexcept { return this->_size; }
+    constexpr size_type max_size()  const noexcept { return N; }
+    constexpr size_type capacity()  const noexcept { return N; }
+
+    // 访问元素相关
+    constexpr reference operator[](size_type n)
+    {
+        MYSTL_DEBUG(n < size());
+        return this->data_ptr()[n];
+    }
+    constexpr const_reference operator[](size_type n) const
+    {
+        MYSTL_DEBUG(n < size());
+        return this->data_ptr()[n];
+    }
+
+    constexpr reference at(size_type n)
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+    constexpr const_reference at(size_type n) const
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < size()), "static_vector<T, N>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    constexpr reference front()
+    {
+        MYSTL_DEBUG(!empty());
+        return *begin();
+    }
+    constexpr const_reference front() const
+    {
+        MYSTL_DEBUG(!empty());
+        return *begin();
+    }
+
+    constexpr reference back()
+    {
+        MYSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+    constexpr const_reference back() const
+    {
+        MYSTL_DEBUG(!empty());
+        return *(end() - 1);
+    }
+
+    constexpr pointer       data()       noexcept { return this->data_ptr(); }
+    constexpr const_pointer data() const noexcept { return this->data_ptr(); }
+
+    // 修改容器相关操作
+
+    // emplace_back
+    template <typename ...Args>
+    constexpr reference emplace_back(Args&& ...args)
+    {
+        check_room(1);
+        return unchecked_emplace_back(mystl::forward<Args>(args)...);
+    }
+
+    // push_back
+    constexpr void push_back(const value_type& value) { emplace_back(value); }
+    constexpr void push_back(value_type&& value) { emplace_back(mystl::move(value)); }
+
+    // 容器已满时返回 nullptr，否则返回新元素的地址
+    template <typename ...Args>
+    constexpr pointer try_emplace_back(Args&& ...args)
+    {
+        if(full()) return nullptr;
+        return &unchecked_emplace_back(mystl::forward<Args>(args)...);
+    }
+
+    constexpr pointer try_push_back(const value_type& value) { return try_emplace_back(value); }
+    constexpr pointer try_push_back(value_type&& value) { return try_emplace_back(mystl::move(value)); }
+
+    // pop_back
+    constexpr void pop_back()
+    {
+        MYSTL_DEBUG(!empty());
+        --this->_size;
+        destroy_one(end(), trivial_storage{});
+    }
+
+    // clear
+    constexpr void clear() noexcept
+    {
+        destroy_range(begin(), end(), trivial_storage{});
+        this->_size = 0;
+    }
+
+    // resize
+    using base::resize;
+    constexpr void resize(size_type new_size)
+    {
+        if(new_size < size())
+        {
+            destroy_range(begin() + new_size, end(), trivial_storage{});
+            this->_size = new_size;
+            return;
+        }
+        check_size(new_size);
+        while(size() < new_size)
+            unchecked_emplace_back();
+    }
+
+    void swap(static_vector& rhs);
+
+private:
+    // helper functions
+
+    // 溢出检查
+    constexpr void check_size(size_type n) const
+    {
+        if(n > N) Overflow::overflow("static_vector<T, N>'s size too big");
+    }
+    constexpr void check_room(size_type n) const
+    {
+        if(n > N - size()) Overflow::overflow("static_vector<T, N>'s size too big");
+    }
+
+    // inplace_vector_base 所需的接口
+    void require_size(size_type n) const { check_size(n); }
+    void require_room(size_type n) const { check_room(n); }
+    void set_size(size_type n) noexcept { this->_size = n; }
+    static void destroy_elements(pointer first, pointer last) noexcept
+    {
+        destroy_range(first, last, trivial_storage{});
+    }
+
+    // 单个元素的构造与析构，T[N] 存储上以赋值代替构造，以便用于常量表达式
+    template <typename ...Args>
+    static constexpr void construct_one(pointer p, m_true_type, Args&& ...args)
+    {
+        *p = value_type(mystl::forward<Args>(args)...);
+    }
+    template <typename ...Args>
+    static void construct_one(pointer p, m_false_type, Args&& ...args)
+    {
+        mystl::_construct(p, mystl::forward<Args>(args)...);
+    }
+
+    static constexpr void destroy_one(pointer, m_true_type) noexcept {}
+    static void destroy_one(pointer p, m_false_type) noexcept { mystl::destroy(p); }
+
+    static constexpr void destroy_range(pointer, pointer, m_true_type) noexcept {}
+    static void destroy_range(pointer first, pointer last, m_false_type) noexcept
+    {
+        mystl::destroy(first, last);
+    }
+
+    template <typename ...Args>
+    constexpr reference unchecked_emplace_back(Args&& ...args)
+    {
+        pointer p = end();
+        construct_one(p, trivial_storage{}, mystl::forward<Args>(args)...);
+        ++this->_size;
+        return *p;
+    }
+};
+
+/*****************************************************************************************/
+
+// swap: 交换公共部分，较长一方多出的元素移动到较短一方
+template <typename T, size_t N, typename Overflow>
+void static_vector<T, N, Overflow>::swap(static_vector& rhs)
+{
+    if(this == &rhs) return;
+    static_vector& shorter = size() < rhs.size() ? *this : rhs;
+    static_vector& longer = size() < rhs.size() ? rhs : *this;
+    const size_type n = shorter.size();
+    std::swap_ranges(shorter.begin(), shorter.end(), longer.begin());
+    mystl::uninitialized_move(longer.begin() + n, longer.end(), shorter.end());
+    shorter._size = longer._size;
+    longer.erase(longer.begin() + n, longer.end());
+}
+
+// mystl::swap overload
+template <typename T, size_t N, typename Overflow>
+void swap(static_vector<T, N, Overflow>& lhs, static_vector<T, N, Overflow>& rhs)
+{
+    lhs.swap(rhs);
+}
+
+// 元素存放在对象内部，可平凡重定位与否取决于元素
+template <typename T, size_t N, typename Overflow>
+struct is_trivially_relocatable<mystl::static_vector<T, N, Overflow>>: is_trivially_relocatable<T> {};
+
+} // end of namespace mystl
+#endif // !STATIC_VECTOR_H_
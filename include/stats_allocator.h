@@ -0,0 +1,236 @@
+// -- stats_allocator.h 统计分配器
+// stats_allocator<T, Tag, Alloc> 包装任意分配器 Alloc，按 Tag 记录：
+// * 分配 / 释放次数与字节数
+// * 当前存活字节数与峰值
+// * 按 2 的幂分桶的请求大小直方图
+// 计数器使用 relaxed 原子操作，只保证各计数自身准确，不保证快照中各项之间的一致性
+// 查询：alloc_stats<Tag>::snapshot() / reset() / to_json()
+#ifndef STATS_ALLOCATOR_H_
+#define STATS_ALLOCATOR_H_
+
+#include <cstddef>
+#include <atomic>
+#include <string>
+#include "allocator.h"
+#include "type_traits.h"
+
+namespace mystl
+{
+
+#ifndef STATS_HISTOGRAM_BUCKETS
+#define STATS_HISTOGRAM_BUCKETS 32
+#endif
+
+// 某一时刻的统计快照
+struct alloc_stats_snapshot
+{
+    size_t  allocations = 0;
+    size_t  deallocations = 0;
+    size_t  bytes_allocated = 0;
+    size_t  bytes_deallocated = 0;
+    size_t  live_bytes = 0;
+    size_t  peak_bytes = 0;
+    // histogram[i] 为请求大小落在 [2^i, 2^(i+1)) 的分配次数，最后一个桶收纳更大的请求
+    size_t  histogram[STATS_HISTOGRAM_BUCKETS] = {};
+
+    size_t live_allocations() const noexcept { return allocations - deallocations; }
+
+    std::string to_json() const;
+};
+
+inline std::string alloc_stats_snapshot::to_json() const
+{
+    std::string s = "{";
+    s += "\"allocations\":" + std::to_string(allocations);
+    s += ",\"deallocations\":" + std::to_string(deallocations);
+    s += ",\"bytes_allocated\":" + std::to_string(bytes_allocated);
+    s += ",\"bytes_deallocated\":" + std::to_string(bytes_deallocated);
+    s += ",\"live_bytes\":" + std::to_string(live_bytes);
+    s += ",\"peak_bytes\":" + std::to_string(peak_bytes);
+    s += ",\"histogram\":{";
+    bool first = true;
+    for(size_t i = 0; i < STATS_HISTOGRAM_BUCKETS; ++i)
+    {
+        if(histogram[i] == 0) continue;
+        if(!first) s += ",";
+        first = false;
+        s += "\"" + std::to_string(static_cast<size_t>(1) << i) + "\":" + std::to_string(histogram[i]);
+    }
+    s += "}}";
+    return s;
+}
+
+// 一组计数器
+class alloc_stats_counters
+{
+public:
+    void record_allocate(size_t bytes) noexcept
+    {
+        _allocations.fetch_add(1, std::memory_order_relaxed);
+        _bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        _histogram[bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+        const size_t live = _live_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        size_t peak = _peak_bytes.load(std::memory_order_relaxed);
+        while(live > peak &&
+              !_peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void record_deallocate(size_t bytes) noexcept
+    {
+        _deallocations.fetch_add(1, std::memory_order_relaxed);
+        _bytes_deallocated.fetch_add(bytes, std::memory_order_relaxed);
+        _live_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    alloc_stats_snapshot snapshot() const noexcept
+    {
+        alloc_stats_snapshot s;
+        s.allocations = _allocations.load(std::memory_order_relaxed);
+        s.deallocations = _deallocations.load(std::memory_order_relaxed);
+        s.bytes_allocated = _bytes_allocated.load(std::memory_order_relaxed);
+        s.bytes_deallocated = _bytes_deallocated.load(std::memory_order_relaxed);
+        s.live_bytes = _live_bytes.load(std::memory_order_relaxed);
+        s.peak_bytes = _peak_bytes.load(std::memory_order_relaxed);
+        for(size_t i = 0; i < STATS_HISTOGRAM_BUCKETS; ++i)
+        {
+            s.histogram[i] = _histogram[i].load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    // 清零计数，峰值重置为当前存活字节数
+    void reset() noexcept
+    {
+        _allocations.store(0, std::memory_order_relaxed);
+        _deallocations.store(0, std::memory_order_relaxed);
+        _bytes_allocated.store(0, std::memory_order_relaxed);
+        _bytes_deallocated.store(0, std::memory_order_relaxed);
+        _peak_bytes.store(_live_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        for(size_t i = 0; i < STATS_HISTOGRAM_BUCKETS; ++i)
+        {
+            _histogram[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    static size_t bucket(size_t bytes) noexcept
+    {
+        size_t i = 0;
+        while(bytes > 1 && i + 1 < STATS_HISTOGRAM_BUCKETS)
+        {
+            bytes >>= 1;
+            ++i;
+        }
+        return i;
+    }
+
+private:
+    std::atomic<size_t> _allocations{0};
+    std::atomic<size_t> _deallocations{0};
+    std::atomic<size_t> _bytes_allocated{0};
+    std::atomic<size_t> _bytes_deallocated{0};
+    std::atomic<size_t> _live_bytes{0};
+    std::atomic<size_t> _peak_bytes{0};
+    std::atomic<size_t> _histogram[STATS_HISTOGRAM_BUCKETS] = {};
+};
+
+// 每个 Tag 一组计数器，同一 Tag 的所有 stats_allocator (包括 rebind 后的) 共享
+template <typename Tag>
+struct alloc_stats
+{
+    static alloc_stats_counters& counters() noexcept
+    {
+        static alloc_stats_counters c;
+        return c;
+    }
+
+    static alloc_stats_snapshot snapshot() noexcept { return counters().snapshot(); }
+    static void                 reset()    noexcept { counters().reset(); }
+    static std::string          to_json()           { return snapshot().to_json(); }
+};
+
+// 默认 Tag
+struct default_stats_tag {};
+
+// stats_allocator
+// 分配与释放转发给 Alloc，传播属性与相等性也沿用 Alloc
+template <typename T, typename Tag = default_stats_tag, typename Alloc = mystl::allocator<T>>
+class stats_allocator: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
+{
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>   base_allocator;
+    typedef mystl::allocator_traits<base_allocator>                             base_traits;
+    typedef mystl::alloc_holder<base_allocator>                                 alloc_base;
+
+public:
+    typedef T                                   value_type;
+    typedef T*                                  pointer;
+    typedef const T*                            const_pointer;
+    typedef T&                                  reference;
+    typedef const T&                            const_reference;
+    typedef typename base_traits::size_type         size_type;
+    typedef typename base_traits::difference_type   difference_type;
+
+    typedef typename base_traits::propagate_on_container_copy_assignment propagate_on_container_copy_assignment;
+    typedef typename base_traits::propagate_on_container_move_assignment propagate_on_container_move_assignment;
+    typedef typename base_traits::propagate_on_container_swap            propagate_on_container_swap;
+    typedef typename base_traits::is_always_equal                        is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef stats_allocator<U, Tag, typename base_traits::template rebind_alloc<U>> other;
+    };
+
+    stats_allocator() = default;
+    explicit stats_allocator(const base_allocator& a): alloc_base(a) {}
+    template <typename U, typename A>
+    stats_allocator(const stats_allocator<U, Tag, A>& rhs): alloc_base(base_allocator(rhs.base())) {}
+
+    T* allocate(size_type n)
+    {
+        T* p = base_traits::allocate(this->get_alloc(), n);
+        if(p != nullptr) alloc_stats<Tag>::counters().record_allocate(n * sizeof(T));
+        return p;
+    }
+
+    // 按实际得到的个数计数，与之后 deallocate 传入的个数一致
+    mystl::allocation_result<T*, size_type> allocate_at_least(size_type n)
+    {
+        auto r = base_traits::allocate_at_least(this->get_alloc(), n);
+        if(r.ptr != nullptr) alloc_stats<Tag>::counters().record_allocate(r.count * sizeof(T));
+        return {r.ptr, r.count};
+    }
+
+    void deallocate(T* ptr, size_type n)
+    {
+        if(ptr == nullptr) return;
+        alloc_stats<Tag>::counters().record_deallocate(n * sizeof(T));
+        base_traits::deallocate(this->get_alloc(), ptr, n);
+    }
+
+    stats_allocator select_on_container_copy_construction() const
+    {
+        return stats_allocator(base_traits::select_on_container_copy_construction(base()));
+    }
+
+    const base_allocator& base() const noexcept { return this->get_alloc(); }
+
+    static alloc_stats_snapshot stats() noexcept { return alloc_stats<Tag>::snapshot(); }
+};
+
+template <typename T1, typename T2, typename Tag, typename A1, typename A2>
+bool operator== (const stats_allocator<T1, Tag, A1>& lhs, const stats_allocator<T2, Tag, A2>& rhs)
+{
+    return lhs.base() == rhs.base();
+}
+
+template <typename T1, typename T2, typename Tag, typename A1, typename A2>
+bool operator!= (const stats_allocator<T1, Tag, A1>& lhs, const stats_allocator<T2, Tag, A2>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+} // end of namespace mystl
+#endif // !STATS_ALLOCATOR_H_
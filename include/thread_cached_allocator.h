@@ -0,0 +1,331 @@
+// -- thread_cached_allocator.h 带线程缓存的小对象分配器
+// 沿用 pool_allocator 的大小类别，但把锁从热路径上移开：
+// * 每个线程为每个大小类别持有一个 magazine (空闲区块链表)，分配与释放只访问本线程的 magazine
+// * magazine 为空时从中心仓库 (depot) 取回一整批区块，超过 2 * THREAD_CACHE_BATCH 时归还一整批
+// * 区块不归属于某个线程，由其他线程释放的区块进入释放者的 magazine，随批次流回 depot
+// * 线程退出时 magazine 中剩余的区块全部归还 depot
+// * depot 的空闲区块以区块自身的 next 串成链表，归还区块从不分配内存，释放路径不会抛出异常
+#ifndef THREAD_CACHED_ALLOCATOR_H_
+#define THREAD_CACHED_ALLOCATOR_H_
+
+#include <cstddef>
+#include <new>
+#include <mutex>
+#include "pool_allocator.h"
+
+namespace mystl
+{
+
+#ifndef THREAD_CACHE_BATCH
+#define THREAD_CACHE_BATCH 32
+#endif
+
+#ifndef THREAD_CACHE_CHUNK
+#define THREAD_CACHE_CHUNK (64 * 1024)
+#endif
+
+// 中心仓库：每个大小类别一把锁，归还的各批区块首尾相接成一条空闲链表
+// 最小的区块只放得下一个指针，无法再记录批次的边界，取出时从链表头部截下至多一批
+class thread_cache_depot
+{
+public:
+    typedef pool_alloc_base::free_obj free_obj;
+
+    // 仓库在进程退出时不析构，避免与线程缓存的析构顺序冲突
+    static thread_cache_depot& instance()
+    {
+        static thread_cache_depot* depot = new thread_cache_depot;
+        return *depot;
+    }
+
+    size_t pop_batch(size_t index, free_obj*& head);
+    void   push_batch(size_t index, free_obj* head, size_t count) noexcept;
+
+    size_t heap_size()
+    {
+        std::lock_guard<std::mutex> lock(_chunk_mutex);
+        return _heap_size;
+    }
+
+private:
+    thread_cache_depot() = default;
+    size_t carve(size_t index, free_obj*& head);
+
+private:
+    struct central_list
+    {
+        std::mutex  mutex;
+        free_obj*   head = nullptr;
+        size_t      count = 0;
+    };
+
+    central_list    _lists[POOL_NFREELISTS];
+    std::mutex      _chunk_mutex;
+    char*           _start_free = nullptr;
+    char*           _end_free = nullptr;
+    size_t          _heap_size = 0;
+};
+
+// 取出至多一批区块，仓库为空时从 chunk 中切出新的一批，返回区块个数
+inline size_t thread_cache_depot::pop_batch(size_t index, free_obj*& head)
+{
+    {
+        central_list& list = _lists[index];
+        std::lock_guard<std::mutex> lock(list.mutex);
+        if(list.head != nullptr)
+        {
+            const size_t n = list.count < THREAD_CACHE_BATCH ? list.count : THREAD_CACHE_BATCH;
+            free_obj* last = list.head;
+            for(size_t i = 1; i < n; ++i)
+            {
+                last = last->next;
+            }
+            head = list.head;
+            list.head = last->next;
+            list.count -= n;
+            last->next = nullptr;
+            return n;
+        }
+    }
+    return carve(index, head);
+}
+
+// 归还以 nullptr 结尾的 count 个区块，在锁外找到链尾后整段接到链表头部
+inline void thread_cache_depot::push_batch(size_t index, free_obj* head, size_t count) noexcept
+{
+    free_obj* last = head;
+    while(last->next != nullptr)
+    {
+        last = last->next;
+    }
+    central_list& list = _lists[index];
+    std::lock_guard<std::mutex> lock(list.mutex);
+    last->next = list.head;
+    list.head = head;
+    list.count += count;
+}
+
+inline size_t thread_cache_depot::carve(size_t index, free_obj*& head)
+{
+    const size_t bytes = (index + 1) * POOL_ALIGN;
+    const size_t need = bytes * THREAD_CACHE_BATCH;
+    char* start = nullptr;
+    size_t nobjs = THREAD_CACHE_BATCH;
+    {
+        std::lock_guard<std::mutex> lock(_chunk_mutex);
+        size_t left = static_cast<size_t>(_end_free - _start_free);
+        if(left < bytes)
+        {
+            // 剩余的零头作为单独一批放回对应的类别
+            if(left > 0)
+            {
+                free_obj* rest = reinterpret_cast<free_obj*>(_start_free);
+                rest->next = nullptr;
+                push_batch(pool_alloc_base::freelist_index(left), rest, 1);
+            }
+            const size_t get_bytes = need > THREAD_CACHE_CHUNK ? need : THREAD_CACHE_CHUNK;
+            _start_free = static_cast<char*>(::operator new(get_bytes));
+            _end_free = _start_free + get_bytes;
+            _heap_size += get_bytes;
+            left = get_bytes;
+        }
+        if(left < need)
+        {
+            nobjs = left / bytes;
+        }
+        start = _start_free;
+        _start_free += bytes * nobjs;
+    }
+
+    // 在锁外串起这一批区块
+    free_obj* cur = reinterpret_cast<free_obj*>(start);
+    head = cur;
+    for(size_t i = 1; i < nobjs; ++i)
+    {
+        free_obj* next = reinterpret_cast<free_obj*>(reinterpret_cast<char*>(cur) + bytes);
+        cur->next = next;
+        cur = next;
+    }
+    cur->next = nullptr;
+    return nobjs;
+}
+
+// 线程缓存
+class thread_cache
+{
+public:
+    typedef pool_alloc_base::free_obj free_obj;
+
+    // 当前线程的缓存，线程缓存已析构时返回 nullptr
+    static thread_cache* current()
+    {
+        if(_destroyed) return nullptr;
+        static thread_local thread_cache cache;
+        return &cache;
+    }
+
+    void* allocate(size_t bytes);
+    void  deallocate(void* ptr, size_t bytes) noexcept;
+
+    ~thread_cache();
+
+private:
+    struct magazine
+    {
+        free_obj*   head = nullptr;
+        size_t      count = 0;
+    };
+
+    magazine    _mags[POOL_NFREELISTS];
+
+    static inline thread_local bool _destroyed = false;
+};
+
+inline void* thread_cache::allocate(size_t bytes)
+{
+    const size_t index = pool_alloc_base::freelist_index(bytes);
+    magazine& mag = _mags[index];
+    if(mag.head == nullptr)
+    {
+        mag.count = thread_cache_depot::instance().pop_batch(index, mag.head);
+    }
+    free_obj* result = mag.head;
+    mag.head = result->next;
+    --mag.count;
+    return result;
+}
+
+inline void thread_cache::deallocate(void* ptr, size_t bytes) noexcept
+{
+    const size_t index = pool_alloc_base::freelist_index(bytes);
+    magazine& mag = _mags[index];
+    free_obj* obj = static_cast<free_obj*>(ptr);
+    obj->next = mag.head;
+    mag.head = obj;
+    if(++mag.count <= 2 * THREAD_CACHE_BATCH)
+    {
+        return;
+    }
+
+    // magazine 过满，从头部截下一整批归还 depot
+    free_obj* last = mag.head;
+    for(size_t i = 1; i < THREAD_CACHE_BATCH; ++i)
+    {
+        last = last->next;
+    }
+    free_obj* head = mag.head;
+    mag.head = last->next;
+    mag.count -= THREAD_CACHE_BATCH;
+    last->next = nullptr;
+    thread_cache_depot::instance().push_batch(index, head, THREAD_CACHE_BATCH);
+}
+
+inline thread_cache::~thread_cache()
+{
+    for(size_t i = 0; i < POOL_NFREELISTS; ++i)
+    {
+        if(_mags[i].head != nullptr)
+        {
+            thread_cache_depot::instance().push_batch(i, _mags[i].head, _mags[i].count);
+            _mags[i].head = nullptr;
+            _mags[i].count = 0;
+        }
+    }
+    _destroyed = true;
+}
+
+// thread_cached_allocator
+// 无状态分配器，任意线程分配的区块可以在任意线程释放
+template <typename T>
+class thread_cached_allocator
+{
+public:
+    typedef T           value_type;
+    typedef T*          pointer;
+    typedef const T*    const_pointer;
+    typedef T&          reference;
+    typedef const T&    const_reference;
+    typedef size_t      size_type;
+    typedef ptrdiff_t   difference_type;
+
+    typedef m_true_type propagate_on_container_move_assignment;
+    typedef m_true_type is_always_equal;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef thread_cached_allocator<U> other;
+    };
+
+    thread_cached_allocator() noexcept = default;
+    template <typename U>
+    thread_cached_allocator(const thread_cached_allocator<U>&) noexcept {}
+
+    static constexpr bool use_cache = alignof(T) <= POOL_ALIGN;
+
+    static T* allocate(size_type n);
+    static void deallocate(T* ptr, size_type n) noexcept;
+};
+
+template <typename T>
+T* thread_cached_allocator<T>::allocate(size_type n)
+{
+    if(n == 0) return nullptr;
+    const size_t bytes = n * sizeof(T);
+    if(!use_cache || bytes > static_cast<size_t>(POOL_MAX_BYTES))
+    {
+        return static_cast<T*>(mystl::aligned_new(bytes, alignof(T)));
+    }
+    thread_cache* cache = thread_cache::current();
+    if(cache != nullptr)
+    {
+        return static_cast<T*>(cache->allocate(bytes));
+    }
+
+    // 线程缓存已析构 (线程退出阶段)，直接与 depot 交换单个区块
+    const size_t index = pool_alloc_base::freelist_index(bytes);
+    thread_cache_depot::free_obj* head = nullptr;
+    size_t count = thread_cache_depot::instance().pop_batch(index, head);
+    thread_cache_depot::free_obj* result = head;
+    if(count > 1)
+    {
+        thread_cache_depot::instance().push_batch(index, head->next, count - 1);
+    }
+    return reinterpret_cast<T*>(result);
+}
+
+template <typename T>
+void thread_cached_allocator<T>::deallocate(T* ptr, size_type n) noexcept
+{
+    if(ptr == nullptr) return;
+    const size_t bytes = n * sizeof(T);
+    if(!use_cache || bytes > static_cast<size_t>(POOL_MAX_BYTES))
+    {
+        mystl::aligned_delete(ptr, alignof(T));
+        return;
+    }
+    thread_cache* cache = thread_cache::current();
+    if(cache != nullptr)
+    {
+        cache->deallocate(ptr, bytes);
+        return;
+    }
+    thread_cache_depot::free_obj* obj = reinterpret_cast<thread_cache_depot::free_obj*>(ptr);
+    obj->next = nullptr;
+    thread_cache_depot::instance().push_batch(pool_alloc_base::freelist_index(bytes), obj, 1);
+}
+
+template <typename T1, typename T2>
+bool operator== (const thread_cached_allocator<T1>&, const thread_cached_allocator<T2>&) noexcept
+{
+    return true;
+}
+
+template <typename T1, typename T2>
+bool operator!= (const thread_cached_allocator<T1>&, const thread_cached_allocator<T2>&) noexcept
+{
+    return false;
+}
+
+} // end of namespace mystl
+#endif // !THREAD_CACHED_ALLOCATOR_H_
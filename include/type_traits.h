@@ -35,6 +35,20 @@ struct is_pair: mystl::m_false_type {} ;
 template <typename T1, typename T2> 
 struct is_pair<mystl::pair<T1, T2>>: m_true_type {}; 
 
+// is_trivially_relocatable 
+// 可平凡重定位: 把对象按字节复制到新地址并且不再调用原对象的析构函数，与"移动构造 + 析构原对象"等价
+// 默认只认可平凡移动构造且平凡析构的类型；对象内部不含指向自身的指针的类型可以特化为 true，
+// 如 mystl 的各个容器 (见各容器头文件末尾)
+// 注意: libstdc++ 的 std::string 在短字符串优化时保存指向自身的指针，不可平凡重定位
+template <typename T> 
+struct is_trivially_relocatable: m_bool_constant<
+    std::is_trivially_move_constructible<T>::value && 
+    std::is_trivially_destructible<T>::value> {}; 
+
+template <typename T1, typename T2> 
+struct is_trivially_relocatable<mystl::pair<T1, T2>>: m_bool_constant<
+    is_trivially_relocatable<T1>::value && is_trivially_relocatable<T2>::value> {}; 
+
 
 } // end of mystl 
 
@@ -6,11 +6,22 @@
 #include "iterator.h"
 #include "type_traits.h"
 #include "util.h" 
+#include <algorithm> 
+#include <cstring> 
 #include <memory> 
 
 namespace mystl
 {
 
+// 未初始化空间上的构造只有在构造与赋值都平凡时才能用 std::copy / std::fill / std::move 的赋值代替
+template <typename T> 
+using uninit_copy_by_assign = std::integral_constant<bool, 
+    std::is_trivially_copy_constructible<T>::value && std::is_trivially_copy_assignable<T>::value>; 
+
+template <typename T> 
+using uninit_move_by_assign = std::integral_constant<bool, 
+    std::is_trivially_move_constructible<T>::value && std::is_trivially_move_assignable<T>::value>; 
+
 // uninitialized copy -> is_trivially_copy_assignable == true
 template<typename InputIter, typename ForwardIter> 
 ForwardIter
@@ -39,6 +50,7 @@ unchecked_uninit_copy(InputIter first, InputIter last, ForwardIter result, std::
         {
             mystl::destroy(&*result); 
         }
+        throw; 
     }
     return cur; 
 }
@@ -48,8 +60,7 @@ template<typename InputIter, typename ForwardIter>
 ForwardIter uninitialized_copy(InputIter first, InputIter last, ForwardIter result)
 {
     return mystl::unchecked_uninit_copy(first, last, result , 
-        std::is_trivially_copy_assignable< 
-        typename iterator_traits<ForwardIter>::value_type>{}
+        uninit_copy_by_assign<typename iterator_traits<ForwardIter>::value_type>{}
     ); 
 }
 
@@ -81,6 +92,7 @@ unchecked_uninit_copy_n(InputIter first, Size n, ForwardIter result, std::false_
         {
             mystl::destroy(&*result); 
         }
+        throw; 
     }
     return cur; 
 }
@@ -91,8 +103,7 @@ ForwardIter
 uninitialized_copy_n(InputIter first, Size n, ForwardIter result)
 {
     return unchecked_uninit_copy_n(first, n, result, 
-    std::is_trivially_copy_assignable<
-    typename iterator_traits<InputIter>::value_type>{}
+    uninit_copy_by_assign<typename iterator_traits<InputIter>::value_type>{}
     ); 
 }
 
@@ -124,6 +135,7 @@ unchecked_uninit_fill(ForwardIter first, ForwardIter last, const T& value, std::
         {
             mystl::destroy(&*first); 
         }
+        throw; 
     }
 }
 
@@ -132,7 +144,7 @@ template <typename ForwardIter, typename T>
 void uninitialized_fill(ForwardIter first, ForwardIter last, const T& value)
 {
     mystl::unchecked_uninit_fill(first, last, value, 
-        std::is_trivially_copy_assignable<typename iterator_traits<ForwardIter>::value_type>{} 
+        uninit_copy_by_assign<typename iterator_traits<ForwardIter>::value_type>{} 
     ); 
 }
 
@@ -165,6 +177,7 @@ unchecked_uninit_fill_n(ForwardIter first, Size n, const T& value, std::false_ty
         {
             mystl::destroy(&*first); 
         }
+        throw; 
     }
     return curr; 
 }
@@ -175,7 +188,7 @@ ForwardIter
 uninitialized_fill_n(ForwardIter first, Size n, const T&value)
 {
     return unchecked_uninit_fill_n(first, n, value, 
-        std::is_trivially_copy_assignable<typename  iterator_traits<ForwardIter>::value_type>{}
+        uninit_copy_by_assign<typename iterator_traits<ForwardIter>::value_type>{}
         ); 
 }
 
@@ -204,6 +217,7 @@ unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::
     catch(...)
     {
         mystl::destroy(result, curr);
+        throw; 
     }
     return curr; 
 }
@@ -214,7 +228,7 @@ ForwardIter
 uninitialized_move(InputIter first, InputIter last, ForwardIter result)
 {
     return mystl::unchecked_uninit_move(first, last, result, 
-        std::is_trivially_move_assignable<typename iterator_traits<InputIter>::value_type>{} 
+        uninit_move_by_assign<typename iterator_traits<InputIter>::value_type>{} 
         ); 
 }
 
@@ -246,6 +260,7 @@ unchecked_uninit_move_n(InputIter first, Size n, ForwardIter result, std::false_
        {
            mystl::destroy(&*result); 
        }
+       throw; 
     }
     return curr; 
 }
@@ -256,9 +271,146 @@ ForwardIter
 uninitialized_move_n(InputIter first, Size n, ForwardIter result)
 {
     return unchecked_uninit_move_n(first, n, result,    
-        std::is_trivially_move_assignable<typename iterator_traits<InputIter>::value_type>{}
+        uninit_move_by_assign<typename iterator_traits<InputIter>::value_type>{}
 
     ); 
 }
+
+// uninitialized_move_if_noexcept 
+// 元素的移动构造不会抛出异常 (或者元素无法复制) 时移动，否则复制
+// 复制过程中抛出异常时源区间保持不变，调用者可以据此提供强异常安全保证
+template <typename InputIter, typename ForwardIter> 
+ForwardIter 
+unchecked_uninit_move_if_noexcept(InputIter first, InputIter last, ForwardIter result, std::true_type)
+{
+    return mystl::uninitialized_move(first, last, result); 
+}
+
+template <typename InputIter, typename ForwardIter> 
+ForwardIter 
+unchecked_uninit_move_if_noexcept(InputIter first, InputIter last, ForwardIter result, std::false_type)
+{
+    return mystl::uninitialized_copy(first, last, result); 
+}
+
+template <typename InputIter, typename ForwardIter> 
+ForwardIter 
+uninitialized_move_if_noexcept(InputIter first, InputIter last, ForwardIter result)
+{
+    typedef typename iterator_traits<InputIter>::value_type value_type; 
+    return mystl::unchecked_uninit_move_if_noexcept(first, last, result, 
+        std::integral_constant<bool, std::is_nothrow_move_constructible<value_type>::value || 
+                                     !std::is_copy_constructible<value_type>::value>{} 
+        ); 
+}
+
+// uninitialized_relocate 
+// 把 [first, last) 上的对象重定位到 result 为起始的未初始化空间: 完成后源区间不再含有存活对象，
+// 调用者只需释放源区间的内存，不再析构。返回重定位结束的位置
+// 可平凡重定位且源、目标都是指针时整体 memmove，允许区间重叠；
+// 否则逐个移动构造并析构源对象，此时只允许 result 不在 (first, last) 之内 
+// 逐个重定位时若抛出异常，源区间与目标区间中剩余的对象都会被析构
+
+// 逐个移动构造 + 析构
+template <typename InputIter, typename ForwardIter> 
+ForwardIter 
+unchecked_uninit_relocate(InputIter first, InputIter last, ForwardIter result, m_false_type)
+{
+    ForwardIter curr = result; 
+    try
+    {
+        for(; first != last; ++first, ++curr)
+        {
+            mystl::_construct(&*curr, mystl::move(*first)); 
+            mystl::destroy(&*first); 
+        }
+    }
+    catch(...)
+    {
+        mystl::destroy(result, curr); 
+        mystl::destroy(first, last); 
+        throw; 
+    }
+    return curr; 
+}
+
+// 可平凡重定位: 按字节搬移
+template <typename T> 
+T* 
+unchecked_uninit_relocate(T* first, T* last, T* result, m_true_type) noexcept
+{
+    const size_t n = static_cast<size_t>(last - first); 
+    if(n != 0)
+    {
+        std::memmove(static_cast<void*>(result), static_cast<const void*>(first), n * sizeof(T)); 
+    }
+    return result + n; 
+}
+
+template <typename InputIter, typename ForwardIter> 
+ForwardIter 
+uninitialized_relocate(InputIter first, InputIter last, ForwardIter result)
+{
+    return mystl::unchecked_uninit_relocate(first, last, result, 
+        m_bool_constant<std::is_pointer<InputIter>::value && 
+                        std::is_same<InputIter, ForwardIter>::value && 
+                        is_trivially_relocatable<typename iterator_traits<InputIter>::value_type>::value>{} 
+        ); 
+}
+
+// uninitialized_relocate_n 
+// 重定位从 first 开始的 n 个对象，返回重定位结束的位置
+template <typename InputIter, typename Size, typename ForwardIter> 
+ForwardIter 
+uninitialized_relocate_n(InputIter first, Size n, ForwardIter result)
+{
+    InputIter last = first; 
+    mystl::advance(last, n); 
+    return mystl::uninitialized_relocate(first, last, result); 
+}
+
+// uninitialized_default_construct_n 
+// 在从 first 开始的 n 个位置上默认初始化对象 (不做值初始化)，返回结束的位置
+// 可平凡默认构造的类型不写入任何内容，内存保持原样
+template <typename ForwardIter, typename Size> 
+ForwardIter 
+unchecked_uninit_default_n(ForwardIter first, Size n, std::true_type)
+{
+    mystl::advance(first, n); 
+    return first; 
+}
+
+template <typename ForwardIter, typename Size> 
+ForwardIter 
+unchecked_uninit_default_n(ForwardIter first, Size n, std::false_type)
+{
+    typedef typename iterator_traits<ForwardIter>::value_type value_type; 
+    auto curr = first; 
+    try
+    {
+        for(; n > 0; --n, ++curr)
+        {
+            ::new (static_cast<void*>(&*curr)) value_type; 
+        }
+    }
+    catch(...)
+    {
+        for(; first != curr; ++first)
+        {
+            mystl::destroy(&*first); 
+        }
+        throw; 
+    }
+    return curr; 
+}
+
+template <typename ForwardIter, typename Size> 
+ForwardIter 
+uninitialized_default_construct_n(ForwardIter first, Size n)
+{
+    return unchecked_uninit_default_n(first, n, 
+        std::is_trivially_default_constructible<typename iterator_traits<ForwardIter>::value_type>{}); 
+}
+
 } // end of mystl 
 #endif // !UNINITIALIZED_H_ 
\ No newline at end of file
@@ -1,5 +1,5 @@
 // --util.h  not tested 
-// 通用工具集: 函数 move, forward, swap 
+// 通用工具集: 函数 move, forward, move_if_noexcept, swap, floor_pow2, floor_log2 
 // 模版类 pair 
 #ifndef UTIL_H_ 
 #define UTIL_H_ 
@@ -12,25 +12,37 @@ namespace mystl
 {
 // move 移动语义
 template <typename T> 
-typename std::remove_reference<T>::type&& move(T&& arg) noexcept
+constexpr typename std::remove_reference<T>::type&& move(T&& arg) noexcept
 {
     return static_cast<typename std::remove_reference<T>::type&& >(arg); 
 }
 
 // forward 完美转发
 template <typename T>  
-T&& forward(typename std::remove_reference<T>::type& arg) noexcept
+constexpr T&& forward(typename std::remove_reference<T>::type& arg) noexcept
 {
     return static_cast<T&&>(arg); 
 }
 
 template<typename T> 
-T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
+constexpr T&& forward(typename std::remove_reference<T>::type&& arg) noexcept
 {
     static_assert(!std::is_lvalue_reference<T>::value, "bad forward");
     return static_cast<T&&> (arg);
 }
 
+// move_if_noexcept 
+// 移动构造不会抛出异常 (或者无法复制) 时返回右值引用，否则返回 const 左值引用，
+// 扩容时据此选择移动还是复制元素，以保证强异常安全
+template <typename T> 
+typename std::conditional<
+    !std::is_nothrow_move_constructible<T>::value && std::is_copy_constructible<T>::value, 
+    const T&, T&&>::type 
+move_if_noexcept(T& arg) noexcept
+{
+    return mystl::move(arg); 
+}
+
 // swap 
 template <typename Tp> 
 void swap(Tp& lhs, Tp& rhs)
@@ -59,6 +71,18 @@ void swap(Tp(&a)[N], Tp(&b)[N])
     mystl::swap_range(a, a + N, b); 
 }
 
+// floor_pow2 不超过 n 的最大的 2 的幂，n 为 0 时返回 1 
+constexpr size_t floor_pow2(size_t n) noexcept 
+{
+    return n < 2 ? 1 : 2 * floor_pow2(n / 2); 
+}
+
+// floor_log2 向下取整的以 2 为底的对数，n 为 2 的幂时即移位量 
+constexpr size_t floor_log2(size_t n) noexcept 
+{
+    return n < 2 ? 0 : 1 + floor_log2(n / 2); 
+}
+
 // pair 目前并不能与STL完全兼容
 // pair.first, pair.second; 
 template<typename T1, typename T2> 
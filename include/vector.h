@@ -8,11 +8,15 @@
 // * emplace 
 // * emplace_back
 // * push_back
-// 当std::is_nothrow_move_assignable<T>::value == true_type时 以下函数
-// 也满足强异常安全保证
+// 扩容时元素的移动构造不抛出异常则移动，否则复制 (move_if_noexcept)，因此以下函数
+// 在扩容时也满足强异常安全保证 (元素只能移动且移动可能抛出异常时除外)
 // * reserve 
 // * resize
 // * insert 
+// 可平凡重定位的元素 (is_trivially_relocatable) 扩容时直接按字节搬移
+// 扩容策略由模版参数 Growth 决定，见 growth_1_5x / growth_2x / usable_size_growth
+// 元素可平凡重定位且分配器提供 reallocate (如 mremap_allocator) 时，扩容由分配器调整原有空间的大小，
+// 不再分配新空间后逐个搬移；以区间插入 (copy_insert) 扩容时除外，区间可能位于容器内
 
 #include <algorithm> 
 #include <initializer_list> 
@@ -24,35 +28,90 @@
 namespace mystl
 {
 
-template <typename T>   
-class vector
+// 扩容策略
+// Growth()(old_cap, add_size, max_size) 返回新的容量，old_cap 为 0 时即初始容量
+// vector 保证结果不小于 old_cap + add_size 且不超过 max_size
+struct growth_1_5x
+{
+    template <typename SizeType>
+    SizeType operator()(SizeType old_cap, SizeType add_size, SizeType max_size) const noexcept
+    {
+        if(old_cap > max_size - old_cap / 2)
+        {
+            return old_cap + add_size > max_size - 16 ? 
+                    old_cap + add_size : old_cap + add_size + 16; 
+        }
+        return 0 == old_cap ? 
+            std::max(add_size, static_cast<SizeType>(16)) : 
+            std::max(old_cap + old_cap / 2, old_cap + add_size); 
+    }
+}; 
+
+struct growth_2x
+{
+    template <typename SizeType>
+    SizeType operator()(SizeType old_cap, SizeType add_size, SizeType max_size) const noexcept
+    {
+        if(old_cap > max_size - old_cap) return max_size; 
+        return 0 == old_cap ? 
+            std::max(add_size, static_cast<SizeType>(16)) : 
+            std::max(old_cap * 2, old_cap + add_size); 
+    }
+}; 
+
+// 按 Base 计算容量，但通过 allocator_traits::allocate_at_least 向分配器申请，
+// 分配器实际给出的空间 (如 malloc 的 size class) 更大时，多出的部分也记入容量
+template <typename Base = growth_1_5x>
+struct usable_size_growth: Base
+{
+    typedef m_true_type usable_size; 
+}; 
+
+template <typename Growth, typename = void>
+struct growth_uses_usable_size: m_false_type {}; 
+template <typename Growth>
+struct growth_uses_usable_size<Growth, std::void_t<typename Growth::usable_size>>: 
+    m_bool_constant<Growth::usable_size::value> {}; 
+
+template <typename T, typename Alloc = mystl::allocator<T>, typename Growth = mystl::growth_1_5x>   
+class vector: private mystl::alloc_holder<
+    typename mystl::allocator_traits<Alloc>::template rebind_alloc<T>>
 {
     static_assert(!std::is_same<bool, T>::value, "vector<bool> is abandoned in mystl"); 
 public: 
     // traits 
-    typedef mystl::allocator<T>                     allocator_type; 
-    typedef mystl::allocator<T>                     data_allocator; 
-
-    typedef typename allocator_type::value_type         value_type; 
-    typedef typename allocator_type::pointer            pointer; 
-    typedef typename allocator_type::const_pointer      const_pointer; 
-    typedef typename allocator_type::reference          reference; 
-    typedef typename allocator_type::const_reference    const_reference;
-    typedef typename allocator_type::size_type          size_type; 
-    typedef typename allocator_type::difference_type    difference_type; 
+    typedef typename mystl::allocator_traits<Alloc>::template rebind_alloc<T> allocator_type; 
+    typedef allocator_type                              data_allocator; 
+    typedef mystl::allocator_traits<data_allocator>     data_traits; 
+
+    typedef typename data_traits::value_type            value_type; 
+    typedef typename data_traits::pointer               pointer; 
+    typedef typename data_traits::const_pointer         const_pointer; 
+    typedef value_type&                                 reference; 
+    typedef const value_type&                           const_reference;
+    typedef typename data_traits::size_type             size_type; 
+    typedef typename data_traits::difference_type       difference_type; 
 
     typedef value_type*                                 iterator;           // T*
     typedef const value_type*                           const_iterator;     // const T* 
     typedef mystl::reverse_iterator<iterator>           reverse_iterator; 
     typedef mystl::reverse_iterator<const_iterator>     const_reverse_iterator; 
 
-    allocator_type  get_allocator() {return data_allocator(); }
+    allocator_type  get_allocator() const {return get_alloc(); }
+
+protected:  
+    typedef mystl::alloc_holder<data_allocator>         alloc_base; 
+    using alloc_base::get_alloc; 
 
-private:  
     iterator _begin; 
     iterator _end; 
     iterator _cap; 
 
+    // 以 [buf, buf + n) 作为初始空间而不分配，空间由 alloc 负责回收；供 small_vector 使用内联存储
+    struct adopt_storage_tag {}; 
+    vector(adopt_storage_tag, pointer buf, size_type n, const allocator_type& alloc) noexcept
+    : alloc_base(alloc), _begin(buf), _end(buf), _cap(buf + n) {}
+
 public:
     // ctors 
     vector() noexcept 
@@ -60,12 +119,18 @@ public:
         try_init(); 
     }
 
-    explicit vector(size_type n)
+    explicit vector(const allocator_type& alloc) noexcept: alloc_base(alloc)
+    {
+        try_init(); 
+    }
+
+    explicit vector(size_type n, const allocator_type& alloc = allocator_type()): alloc_base(alloc)
     {
         fill_init(n, value_type()); 
     }
 
-    vector(size_type n, const value_type& value)
+    vector(size_type n, const value_type& value, 
+        const allocator_type& alloc = allocator_type()): alloc_base(alloc)
     {
         fill_init(n, value); 
     }
@@ -73,7 +138,8 @@ public:
     // [first, last) 
     template<typename Iter, typename std::enable_if< 
         mystl::is_input_iterator<Iter>::value, int>::type = 0>  
-    vector(Iter first, Iter last)
+    vector(Iter first, Iter last, const allocator_type& alloc = allocator_type())
+    : alloc_base(alloc)
     {
         MYSTL_DEBUG(!(last < first)); 
         range_init(first, last); 
@@ -81,12 +147,19 @@ public:
 
     // copy ctor 
     vector(const vector& rhs)
+    : alloc_base(data_traits::select_on_container_copy_construction(rhs.get_alloc()))
+    {
+        range_init(rhs._begin, rhs._end); 
+    }
+
+    vector(const vector& rhs, const allocator_type& alloc): alloc_base(alloc)
     {
         range_init(rhs._begin, rhs._end); 
     }
 
     // move ctor 
     vector(vector&& rhs) noexcept: 
+    alloc_base(mystl::move(rhs.get_alloc())), 
     _begin(rhs._begin), _end(rhs._end), _cap(rhs._cap)
     {
         rhs._begin = nullptr; 
@@ -94,19 +167,52 @@ public:
         rhs._cap = nullptr; 
     }
 
+    // 分配器不相等时无法接管 rhs 的空间，只能逐个移动元素
+    vector(vector&& rhs, const allocator_type& alloc): alloc_base(alloc)
+    {
+        if(mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+        {
+            _begin = rhs._begin; 
+            _end = rhs._end; 
+            _cap = rhs._cap; 
+            rhs._begin = nullptr; 
+            rhs._end = nullptr; 
+            rhs._cap = nullptr; 
+        }
+        else 
+        {
+            const size_type n = rhs.size(); 
+            init_space(n, get_init_capacity(n)); 
+            try
+            {
+                mystl::uninitialized_move(rhs._begin, rhs._end, _begin); 
+            }
+            catch(...)
+            {
+                data_traits::deallocate(get_alloc(), _begin, _cap - _begin); 
+                _begin = _end = _cap = nullptr; 
+                throw; 
+            }
+        }
+    }
+
     // initialized list 
-    vector(std::initializer_list<value_type> initlist)
+    vector(std::initializer_list<value_type> initlist, 
+        const allocator_type& alloc = allocator_type()): alloc_base(alloc)
     {
         range_init(initlist.begin(), initlist.end()); 
     }
 
     // assign 
     vector& operator= (const vector& rhs); 
-    vector& operator= (vector&& rhs) noexcept; 
+    // 分配器不相等且不传播时需要逐个移动元素，可能抛出异常
+    vector& operator= (vector&& rhs) noexcept(
+        data_traits::propagate_on_container_move_assignment::value || 
+        data_traits::is_always_equal::value); 
 
     vector& operator= (std::initializer_list<value_type> initlist)
     {
-        vector temp(initlist.begin(), initlist.end()); 
+        vector temp(initlist.begin(), initlist.end(), get_alloc()); 
         this->swap(temp); 
         return *this; 
     }
@@ -303,10 +409,26 @@ public:
 
     void reverse() {std::reverse(begin(), end()); }
 
+    // 跳过值初始化的 resize / 追加，用于随后由 I/O 或 SIMD 内核写入全部元素的场景
+    // 新增的元素只做默认初始化: 可平凡默认构造的元素不写入任何内容
+    void resize_default_init(size_type new_size); 
+
+    // 在末尾追加 n 个默认初始化的元素，返回它们所在的区间 [first, last)
+    mystl::pair<pointer, pointer> append_uninitialized(size_type n); 
+
+    // 大小调整为 n (新增元素默认初始化) 后调用 op(data(), n)，
+    // op 返回需要保留的元素个数 r (r <= n)，之后大小为 r
+    template <typename Op> 
+    void resize_and_overwrite(size_type n, Op op); 
+
     // swap 
     void swap(vector& rhs) noexcept; 
 
 private:  
+    // 扩容时能否由分配器就地调整空间大小
+    typedef m_bool_constant<mystl::is_trivially_relocatable<T>::value && 
+        mystl::alloc_has_reallocate<data_allocator>::value> use_reallocate; 
+
     // auxiliary methods 
     // initialize && destroy 
 
@@ -314,6 +436,11 @@ private:
 
     void init_space(size_type size, size_type cap); 
 
+    // 分配至少 n 个元素的空间，n 更新为实际得到的容量
+    pointer allocate_capacity(size_type& n); 
+    pointer allocate_capacity(size_type& n, m_true_type); 
+    pointer allocate_capacity(size_type& n, m_false_type); 
+
     void fill_init(size_type n, const value_type& value); 
 
     template <typename Iter>   
@@ -323,6 +450,7 @@ private:
 
     // calculate grow size 
     size_type get_new_capacity(size_type add_size); 
+    static size_type get_init_capacity(size_type n) noexcept; 
 
     // assign 
     void fill_assign(size_type n, const value_type& value); 
@@ -339,6 +467,20 @@ private:
 
     void reallocate_insert(iterator pos, const value_type& value); 
 
+    template <typename ConstructGap>
+    void reallocate_gap(iterator pos, size_type n, ConstructGap construct_gap); 
+
+    template <typename ConstructGap>
+    void remap_gap(iterator pos, size_type n, ConstructGap construct_gap); 
+
+    // relocate 
+    void relocate_to(iterator pos, iterator new_begin, iterator new_pos); 
+    void relocate_to(iterator pos, iterator new_begin, iterator new_pos, m_true_type) noexcept; 
+    void relocate_to(iterator pos, iterator new_begin, iterator new_pos, m_false_type); 
+
+    template <typename... Args>
+    void relocate_emplace(iterator pos, Args&& ...args); 
+
     // shrink_to_fit
     void reinsert(size_type size); 
 
@@ -349,60 +491,105 @@ private:
 }; 
 
 // copy assign 
-template <typename T> 
-vector<T>& vector<T>::operator= (const vector& rhs)
+template <typename T, typename Alloc, typename Growth> 
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator= (const vector& rhs)
 {
     if(this != &rhs)
     {
+        // 需要传播分配器且两者不相等时，旧空间只能由旧分配器回收
+        if(data_traits::propagate_on_container_copy_assignment::value && 
+            !mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+        {
+            destroy_and_recover(_begin, _end, _cap - _begin); 
+            _begin = nullptr; 
+            _end = nullptr; 
+            _cap = nullptr; 
+        }
+        mystl::alloc_on_copy(get_alloc(), rhs.get_alloc()); 
+
         const auto len = rhs.size(); 
         // 1 长度超出了capacity
         if(len > capacity())
         {
-            vector temp(rhs.begin(), rhs.end()); 
+            vector temp(rhs.begin(), rhs.end(), get_alloc()); 
             swap(temp); 
         }
         else if(size() >= len)  // 2. 在size范围内能够容纳
         {
             auto ite = std::copy(rhs.begin(), rhs.end(), begin()); 
-            data_allocator::destroy(ite, end()); 
+            data_traits::destroy(get_alloc(), ite, end()); 
             _end = _begin + len; 
         }
         else
         {
             std::copy(rhs.begin(), rhs.begin() + size(), _begin); 
             mystl::uninitialized_copy(rhs.begin()+ size(), rhs.end(), _end);
-            _cap = _end = _begin + len;  
+            _end = _begin + len;  
         }
     }
     return *this; 
 }
 
 // move assign 
-template <typename T> 
-vector<T>& vector<T>::operator=(vector&& rhs) noexcept
-{
-    destroy_and_recover(_begin, _end, _cap - _begin); 
-    _begin = rhs._begin; 
-    _end = rhs._end; 
-    _cap = rhs._cap; 
-    rhs._begin = nullptr; 
-    rhs._end = nullptr; 
-    rhs._cap = nullptr; 
+template <typename T, typename Alloc, typename Growth> 
+vector<T, Alloc, Growth>& vector<T, Alloc, Growth>::operator=(vector&& rhs) noexcept(
+    data_traits::propagate_on_container_move_assignment::value || 
+    data_traits::is_always_equal::value)
+{
+    if(this == &rhs)
+    {
+        return *this; 
+    }
+    if(data_traits::propagate_on_container_move_assignment::value || 
+        mystl::alloc_equal(get_alloc(), rhs.get_alloc()))
+    {
+        destroy_and_recover(_begin, _end, _cap - _begin); 
+        mystl::alloc_on_move(get_alloc(), rhs.get_alloc()); 
+        _begin = rhs._begin; 
+        _end = rhs._end; 
+        _cap = rhs._cap; 
+        rhs._begin = nullptr; 
+        rhs._end = nullptr; 
+        rhs._cap = nullptr; 
+    }
+    else 
+    {
+        // 分配器不相等且不传播：保留自身空间，逐个移动元素
+        clear(); 
+        reserve(rhs.size()); 
+        _end = mystl::uninitialized_move(rhs._begin, rhs._end, _begin); 
+        rhs.clear(); 
+    }
     return *this; 
 }
 
 // reverse: reallocate when n is larger than capacity 
-template <typename T> 
-void vector<T>:: reserve(size_type n)
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>:: reserve(size_type n)
 {
     if(capacity() < n)
     {
         THROW_LENGTH_ERROR_IF(n > max_size(),
              "n cannot be larger than max_size() is vector<T>"); 
         const auto old_size = size(); 
-        auto temp = data_allocator::allocate(n); //     reallocate n 
-        mystl::uninitialized_move(_begin, _end, temp); 
-        data_allocator::deallocate(_begin, _cap - _begin); 
+        if(use_reallocate::value) 
+        {
+            _begin = data_traits::reallocate(get_alloc(), _begin, capacity(), n); 
+            _end = _begin + old_size; 
+            _cap = _begin + n; 
+            return; 
+        }
+        auto temp = allocate_capacity(n); //     reallocate n 
+        try
+        {
+            relocate_to(_end, temp, temp + old_size); 
+        }
+        catch(...)
+        {
+            data_traits::deallocate(get_alloc(), temp, n); 
+            throw; 
+        }
+        data_traits::deallocate(get_alloc(), _begin, _cap - _begin); 
         _begin = temp; 
         _end = temp + old_size; 
         _cap = _begin + n; 
@@ -410,8 +597,8 @@ void vector<T>:: reserve(size_type n)
 }
 
 // shrink to fit 
-template<typename T> 
-void vector<T>:: shrink_to_fit()
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>:: shrink_to_fit()
 {
     if(_end < _cap)
     {
@@ -420,10 +607,10 @@ void vector<T>:: shrink_to_fit()
 }
 
 // emplace 
-template <typename T> 
+template <typename T, typename Alloc, typename Growth> 
 template <typename ...Args> 
-typename vector<T>::iterator 
-vector<T>::emplace(const_iterator pos, Args&& ...args)
+typename vector<T, Alloc, Growth>::iterator 
+vector<T, Alloc, Growth>::emplace(const_iterator pos, Args&& ...args)
 {
     MYSTL_DEBUG(pos>=begin() && pos <= end()); 
     iterator xpos = const_cast<iterator>(pos); 
@@ -432,17 +619,23 @@ vector<T>::emplace(const_iterator pos, Args&& ...args)
     // emplace_back 
     if(_end != _cap && xpos == _end)
     {
-        data_allocator::construct(mystl::address_of(*_end), mystl::forward<Args>(args)...); 
+        data_traits::construct(get_alloc(), mystl::address_of(*_end), mystl::forward<Args>(args)...); 
         ++_end; 
     }
 
+    else if(_end != _cap && mystl::is_trivially_relocatable<value_type>::value) 
+    {
+        relocate_emplace(xpos, mystl::forward<Args>(args)...); 
+    }
+
     else if(_end != _cap) 
     {
-        //auto new_end = _end; 
-        data_allocator::construct(mystl::address_of(*_end), *(_end - 1)); 
+        // 先构造新元素，args 可能引用容器中的元素
+        value_type value_copy(mystl::forward<Args>(args)...); 
+        data_traits::construct(get_alloc(), mystl::address_of(*_end), mystl::move(*(_end - 1))); 
         ++_end; 
-        std::copy_backward(xpos, _end - 1, _end); // first, last, result 
-        *xpos = value_type(mystl::forward<Args>(args)...); // value_type ctor 
+        std::move_backward(xpos, _end - 2, _end - 1); // first, last, result 
+        *xpos = mystl::move(value_copy); 
     }
     else 
     {
@@ -452,13 +645,13 @@ vector<T>::emplace(const_iterator pos, Args&& ...args)
 }
 
 // empalce_back 
-template <typename T>  
+template <typename T, typename Alloc, typename Growth>  
 template <typename ...Args>  
-void vector<T>:: emplace_back(Args&& ...args)
+void vector<T, Alloc, Growth>:: emplace_back(Args&& ...args)
 {
     if(_end < _cap)
     {
-        data_allocator::construct(mystl::address_of(*_end), mystl::forward<Args>(args)...); 
+        data_traits::construct(get_alloc(), mystl::address_of(*_end), mystl::forward<Args>(args)...); 
         ++_end;
     }
     else
@@ -468,12 +661,12 @@ void vector<T>:: emplace_back(Args&& ...args)
 }
 
 // push_back 
-template <typename T> 
-void vector<T>::push_back(const value_type& value)
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::push_back(const value_type& value)
 {
     if(_end != _cap)
     {
-        data_allocator::construct(mystl::address_of(*_end), value); 
+        data_traits::construct(get_alloc(), mystl::address_of(*_end), value); 
         ++_end; 
     }
     else 
@@ -484,75 +677,79 @@ void vector<T>::push_back(const value_type& value)
 }
 
 // pop_back 
-template <typename T> 
-void vector<T>::pop_back()
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::pop_back()
 {
     MYSTL_DEBUG(!empty()); 
-    data_allocator::destroy(_end - 1);
+    data_traits::destroy(get_alloc(), _end - 1);
     --_end; 
 }
 
 // insert at pos 
-template <typename T> 
-typename vector<T>::iterator 
-vector<T>::insert(const_iterator pos, const value_type& value)
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>::iterator 
+vector<T, Alloc, Growth>::insert(const_iterator pos, const value_type& value)
 {
     MYSTL_DEBUG(pos >= begin() && pos <= end()); 
     iterator xpos = const_cast<iterator>(pos); 
     const size_type n = pos - _begin; 
     if(_end != _cap && xpos == _end)
     {
-        data_allocator::construct(mystl::address_of(*_end), value); 
+        data_traits::construct(get_alloc(), mystl::address_of(*_end), value); 
         ++_end; 
     }
+    else if(_end != _cap && mystl::is_trivially_relocatable<value_type>::value) 
+    {
+        relocate_emplace(xpos, value); 
+    }
     else if (_end != _cap) 
     {
         auto new_end = _end; 
-        data_allocator::construct(mystl::address_of(*_end), *(_end - 1)); 
-        ++new_end; 
         auto value_copy = value; 
-        std::copy_backward(xpos, _end - 1, _end); 
+        data_traits::construct(get_alloc(), mystl::address_of(*_end), mystl::move(*(_end - 1))); 
+        ++new_end; 
+        std::move_backward(xpos, _end - 1, _end); 
         *xpos = mystl::move(value_copy);
         _end = new_end; 
     }
     else 
     {
-        reallocate_copy(xpos, value); 
+        reallocate_insert(xpos, value); 
     }
     return _begin + n; 
 }
 
 // erase pos 
-template <typename T> 
-typename vector<T> :: iterator 
-vector<T>::erase(const_iterator pos)
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth> :: iterator 
+vector<T, Alloc, Growth>::erase(const_iterator pos)
 {
     MYSTL_DEBUG(pos >= begin() && pos < end()); 
     iterator xpos = _begin + (pos - begin()); 
     // move 要求迭代器不能是const_iterator 
     std::move(xpos + 1, _end, xpos); 
-    data_allocator::destroy(_end -1); 
+    data_traits::destroy(get_alloc(), _end -1); 
     --_end; 
     return xpos; 
 }
 
 // 区间删除算法
-template <typename T> 
-typename vector<T>::iterator 
-vector<T> ::erase(const_iterator first, const_iterator last)
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>::iterator 
+vector<T, Alloc, Growth> ::erase(const_iterator first, const_iterator last)
 {
     MYSTL_DEBUG(first >= begin() && last <= end() && !(last < first)); 
     const auto n = first - begin(); 
 
     iterator r = _begin + n; 
-    data_allocator::destroy(std::move(r + (last - first), _end, r), _end); 
+    data_traits::destroy(get_alloc(), std::move(r + (last - first), _end, r), _end); 
     _end = _end - (last - first); 
     return _begin + n; 
 }
 
 // resize 
-template <typename T> 
-void vector<T>::resize(size_type new_size, const value_type& value)
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::resize(size_type new_size, const value_type& value)
 {
     if(new_size < size())
     {
@@ -566,29 +763,70 @@ void vector<T>::resize(size_type new_size, const value_type& value)
     }
 }
 
-// swap with another vector<T> 
-template <typename T> 
-void vector<T>::swap (vector<T>& rhs) noexcept 
+// resize_default_init 
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::resize_default_init(size_type new_size)
+{
+    if(new_size < size())
+    {
+        erase(begin() + new_size, end()); 
+    }
+    else 
+    {
+        append_uninitialized(new_size - size()); 
+    }
+}
+
+// append_uninitialized 
+template <typename T, typename Alloc, typename Growth> 
+mystl::pair<typename vector<T, Alloc, Growth>::pointer, typename vector<T, Alloc, Growth>::pointer> 
+vector<T, Alloc, Growth>::append_uninitialized(size_type n)
+{
+    if(static_cast<size_type>(_cap - _end) < n) 
+    {
+        reserve(get_new_capacity(n)); 
+    }
+    const auto first = _end; 
+    _end = mystl::uninitialized_default_construct_n(_end, n); 
+    return mystl::pair<pointer, pointer>(first, _end); 
+}
+
+// resize_and_overwrite 
+template <typename T, typename Alloc, typename Growth> 
+template <typename Op> 
+void vector<T, Alloc, Growth>::resize_and_overwrite(size_type n, Op op)
+{
+    resize_default_init(n); 
+    const auto r = static_cast<size_type>(op(_begin, n)); 
+    MYSTL_DEBUG(r <= n); 
+    erase(begin() + r, end()); 
+}
+
+// swap with another vector<T, Alloc, Growth> 
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::swap (vector<T, Alloc, Growth>& rhs) noexcept 
 {
     if(this != &rhs)
     {
         mystl::swap(_begin, rhs._begin); 
         mystl::swap(_end, rhs._end);
         mystl::swap(_cap, rhs._cap); 
+        mystl::alloc_on_swap(get_alloc(), rhs.get_alloc()); 
     }
 }
 
 // auxiliary methods 
 
-// try_init 分配失败忽略，不抛出异常 默认 16个元素
-template<typename T>  
-void vector<T>::try_init() noexcept
+// try_init 分配失败忽略，不抛出异常 默认容量由扩容策略决定 (16个元素)
+template <typename T, typename Alloc, typename Growth>  
+void vector<T, Alloc, Growth>::try_init() noexcept
 {
     try
     {
-        _begin = data_allocator::allocate(16); 
+        size_type n = get_init_capacity(0); 
+        _begin = allocate_capacity(n); 
         _end  = _begin; 
-        _cap = _begin + 16; 
+        _cap = _begin + n; 
     }
     catch(...)
     {
@@ -599,12 +837,12 @@ void vector<T>::try_init() noexcept
 }
 
 // init_space 指定空间大小
-template<typename T> 
-void vector<T>::init_space(size_type size, size_type capacity)
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::init_space(size_type size, size_type capacity)
 {
     try
     {
-        _begin = data_allocator::allocate(capacity); 
+        _begin = allocate_capacity(capacity); 
         _end = _begin + size; 
         _cap = _begin + capacity;
     }
@@ -617,63 +855,86 @@ void vector<T>::init_space(size_type size, size_type capacity)
     }
 }
 
+// allocate_capacity 
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>::pointer 
+vector<T, Alloc, Growth>::allocate_capacity(size_type& n)
+{
+    return allocate_capacity(n, growth_uses_usable_size<Growth>{}); 
+}
+
+// 分配器给出的空间多于 n 个元素时全部记入容量
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>::pointer 
+vector<T, Alloc, Growth>::allocate_capacity(size_type& n, m_true_type)
+{
+    auto result = data_traits::allocate_at_least(get_alloc(), n); 
+    n = result.count; 
+    return result.ptr; 
+}
+
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>::pointer 
+vector<T, Alloc, Growth>::allocate_capacity(size_type& n, m_false_type)
+{
+    return data_traits::allocate(get_alloc(), n); 
+}
+
 // fill_init 
-template<typename T> 
-void vector<T>:: fill_init(size_type n, const value_type& value)
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>:: fill_init(size_type n, const value_type& value)
 {
-    const size_type init_size = std::max(static_cast<size_type>(16), n); 
-    init_space(n, init_size); 
+    init_space(n, get_init_capacity(n)); 
     mystl::uninitialized_fill_n(_begin, n, value); 
 }
 
 // range_init 
-template <typename T> 
+template <typename T, typename Alloc, typename Growth> 
 template <typename Iter> 
-void vector<T>:: range_init(Iter first, Iter last)
+void vector<T, Alloc, Growth>:: range_init(Iter first, Iter last)
 {
-    // 这样填充后的capacity 最小也是16 
-    const size_type init_size = std::max(static_cast<size_type>(16), 
-                                         static_cast<size_type>(last - first));    
-    init_space(static_cast<size_type>(last -first), init_size); 
-    mystl::uninitialized_copy_n(first, last, _begin); 
+    const size_type n = static_cast<size_type>(last - first); 
+    init_space(n, get_init_capacity(n)); 
+    mystl::uninitialized_copy(first, last, _begin); 
 }
 
 // destroy and recover 销毁对象并回收空间
-template <typename T> 
-void vector<T>:: destroy_and_recover (iterator first, iterator last, size_type n) 
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>:: destroy_and_recover (iterator first, iterator last, size_type n) 
 {
-    data_allocator::destroy(first, last); 
-    data_allocator::deallocate(first, n); 
+    data_traits::destroy(get_alloc(), first, last); 
+    data_traits::deallocate(get_alloc(), first, n); 
 }
 
 // get new capacity 扩容策略
-template <typename T> 
-typename vector<T>:: size_type
-vector<T>:: get_new_capacity (size_type add_size)
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>:: size_type
+vector<T, Alloc, Growth>:: get_new_capacity (size_type add_size)
 {
-    // 应该转用加倍策略 
     const auto old_size = capacity(); 
     THROW_LENGTH_ERROR_IF(old_size > max_size() - add_size, "vector<T>'s size too big"); 
-    if(old_size > max_size() - old_size/2)
-    {
-        return old_size + add_size > max_size() - 16 ? 
-                old_size + add_size : old_size + add_size + 16; 
-    }
-
-    const size_type new_size = 0 == old_size  ?  
-        std::max(add_size, static_cast<size_type>(16)) : 
-        std::max(old_size + old_size/2, old_size + add_size); 
+    const size_type new_size = Growth()(old_size, add_size, max_size()); 
+    return std::min(std::max(new_size, old_size + add_size), max_size()); 
+}
 
-    return new_size;
+// get_init_capacity 容纳 n 个元素的初始容量
+// 构造函数中调用时成员尚未初始化，因此不读取任何成员
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>:: size_type
+vector<T, Alloc, Growth>:: get_init_capacity(size_type n) noexcept
+{
+    const size_type max_n = static_cast<size_type>(-1) / sizeof(T); 
+    const size_type init_size = Growth()(static_cast<size_type>(0), n, max_n); 
+    return std::min(std::max(init_size, n), max_n); 
 }
 
 // fill_assign 
-template <typename T> 
-void vector<T>::  fill_assign(size_type n, const value_type& value)
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::  fill_assign(size_type n, const value_type& value)
 {
     if(n > capacity())
     {
-        vector temp(n, value); 
+        vector temp(n, value, get_alloc()); 
         swap(temp); 
     }
     else if(n > size())
@@ -688,9 +949,9 @@ void vector<T>::  fill_assign(size_type n, const value_type& value)
 }
 
 // copy_assign 
-template<typename T>   
+template <typename T, typename Alloc, typename Growth>   
 template <typename InputIter> 
-void vector<T>:: copy_assign(InputIter first, InputIter last, input_iterator_tag)
+void vector<T, Alloc, Growth>:: copy_assign(InputIter first, InputIter last, input_iterator_tag)
 {
     auto curr = _begin; 
     for(; first != last && curr != _end; ++first, ++curr )
@@ -708,21 +969,21 @@ void vector<T>:: copy_assign(InputIter first, InputIter last, input_iterator_tag
 }
 
 // copy_assign: [first, last) 
-template <typename T>
+template <typename T, typename Alloc, typename Growth>
 template <typename ForwardIter> 
-void vector<T>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
+void vector<T, Alloc, Growth>::copy_assign(ForwardIter first, ForwardIter last, forward_iterator_tag)
 {
     const size_type len = mystl::distance(first, last); 
     if(len > capacity())
     {
-        vector temp(first, last); 
+        vector temp(first, last, get_alloc()); 
         swap(temp); 
     }
 
     else if(size() >= len)
     {
         auto new_end = std::copy(first, last, _begin); 
-        data_allocator::destroy(new_end, _end); 
+        data_traits::destroy(get_alloc(), new_end, _end); 
         _end = new_end; 
     }
 
@@ -731,73 +992,176 @@ void vector<T>::copy_assign(ForwardIter first, ForwardIter last, forward_iterato
         auto mid = first; 
         mystl::advance(mid, size()); 
         std::copy(first, mid, _begin); 
-        auto new_end = mystl::uninitialized_copy_n(mid, last, _end); 
+        auto new_end = mystl::uninitialized_copy(mid, last, _end); 
         _end = new_end; 
     }
 }
 
 // reallocate_emplace 重新分配空间并在pos处就地构造元素
-template <typename T>
+template <typename T, typename Alloc, typename Growth>
 template<typename... Args> 
-void vector<T>::  
+void vector<T, Alloc, Growth>::  
 reallocate_emplace(iterator pos, Args&& ...args)
 {
-    const auto new_size = get_new_capacity(1); 
-    auto new_begin = data_allocator::allocate(new_size); 
-    auto new_end = new_begin; 
+    if(use_reallocate::value) 
+    {
+        // 先在临时空间构造新元素: args 可能引用容器中的元素，调整空间大小后原地址不再有效
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type buf; 
+        auto tmp = reinterpret_cast<pointer>(&buf); 
+        data_traits::construct(get_alloc(), tmp, mystl::forward<Args>(args)...); 
+        try
+        {
+            remap_gap(pos, 1, [&](iterator gap) {
+                mystl::uninitialized_relocate(tmp, tmp + 1, gap); 
+            }); 
+        }
+        catch(...)
+        {
+            data_traits::destroy(get_alloc(), tmp); 
+            throw; 
+        }
+        return; 
+    }
+    reallocate_gap(pos, 1, [&](iterator gap) {
+        data_traits::construct(get_alloc(), gap, mystl::forward<Args>(args)...); 
+    }); 
+}
+
+// reallocate_insert 重新分配空间并在 pos 处插入元素
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::reallocate_insert(iterator pos, const value_type& value)
+{
+    if(use_reallocate::value) 
+    {
+        reallocate_emplace(pos, value); 
+        return; 
+    }
+    reallocate_gap(pos, 1, [&](iterator gap) {
+        data_traits::construct(get_alloc(), gap, value); 
+    }); 
+}
+
+// reallocate_gap 
+// 重新分配空间，在 pos 对应的位置留出 n 个位置并用 construct_gap 构造其中的元素，再把原有元素重定位过去
+// 先构造新元素: 新元素可能引用容器中的元素，此时原有元素仍然有效
+template <typename T, typename Alloc, typename Growth> 
+template <typename ConstructGap> 
+void vector<T, Alloc, Growth>::reallocate_gap(iterator pos, size_type n, ConstructGap construct_gap)
+{
+    auto new_size = get_new_capacity(n); 
+    const size_type old_size = size(); 
+    auto new_begin = allocate_capacity(new_size); 
+    auto gap = new_begin + (pos - _begin); 
 
     try
     {
-        new_end = mystl::uninitialized_move(_begin, pos, new_begin);
-        data_allocator::construct(mystl::address_of(*new_end), mystl::forward<Args>(args)...); 
-        ++new_end; 
-        new_end = mystl::uninitialized_move(pos, _end, new_end); 
+        construct_gap(gap); 
     }
     catch(...)
     {
-        data_allocator::deallocate(new_begin, new_size); 
+        data_traits::deallocate(get_alloc(), new_begin, new_size); 
         throw; 
     }
-    
-    destroy_and_recover(_begin, _end, _cap - _begin); 
+
+    try
+    {
+        relocate_to(pos, new_begin, gap + n); 
+    }
+    catch(...)
+    {
+        data_traits::destroy(get_alloc(), gap, gap + n); 
+        data_traits::deallocate(get_alloc(), new_begin, new_size); 
+        throw; 
+    }
+
+    data_traits::deallocate(get_alloc(), _begin, _cap - _begin); 
     _begin = new_begin; 
-    _end = new_end; 
+    _end = new_begin + old_size + n; 
     _cap = new_begin + new_size; 
 }
 
-// reallocate_insert 重新分配空间并在 pos 处插入元素
-template <typename T> 
-void vector<T>::reallocate_insert(iterator pos, const value_type& value)
+// remap_gap 
+// 由分配器调整空间大小后把 [pos, _end) 后移 n 位，在留出的位置用 construct_gap 构造元素，
+// 构造失败时移回原位，容器内容不变 (容量已经扩大)
+// construct_gap 不能引用容器中的元素
+template <typename T, typename Alloc, typename Growth> 
+template <typename ConstructGap> 
+void vector<T, Alloc, Growth>::remap_gap(iterator pos, size_type n, ConstructGap construct_gap)
+{
+    const size_type new_size = get_new_capacity(n); 
+    const size_type old_size = size(); 
+    const size_type offset = pos - _begin; 
+    _begin = data_traits::reallocate(get_alloc(), _begin, capacity(), new_size); 
+    _end = _begin + old_size; 
+    _cap = _begin + new_size; 
+
+    auto gap = _begin + offset; 
+    mystl::uninitialized_relocate(gap, _end, gap + n); 
+    try
+    {
+        construct_gap(gap); 
+    }
+    catch(...)
+    {
+        mystl::uninitialized_relocate(gap + n, _end + n, gap); 
+        throw; 
+    }
+    _end += n; 
+}
+
+// relocate_to 
+// 把 [_begin, pos) 重定位到 new_begin，[pos, _end) 重定位到 new_pos，完成后旧空间中不再有存活对象
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::relocate_to(iterator pos, iterator new_begin, iterator new_pos)
 {
-    const auto new_size = get_new_capacity(1); 
-    auto new_begin = data_allocator::allocate(new_size); 
-    auto new_end = new_begin; 
-    const value_type& value_copy = value; 
+    relocate_to(pos, new_begin, new_pos, mystl::is_trivially_relocatable<value_type>{}); 
+}
 
+// 可平凡重定位: 直接按字节搬移，不会抛出异常
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::relocate_to(iterator pos, iterator new_begin, iterator new_pos, m_true_type) noexcept
+{
+    mystl::uninitialized_relocate(_begin, pos, new_begin); 
+    mystl::uninitialized_relocate(pos, _end, new_pos); 
+}
+
+// 否则移动构造不抛出异常时移动，否则复制；全部成功后再析构旧元素，
+// 复制抛出异常时已构造的元素被析构，旧元素保持不变
+template <typename T, typename Alloc, typename Growth> 
+void vector<T, Alloc, Growth>::relocate_to(iterator pos, iterator new_begin, iterator new_pos, m_false_type)
+{
+    auto mid = mystl::uninitialized_move_if_noexcept(_begin, pos, new_begin); 
     try
     {
-        new_end = mystl::uninitialized_move(_begin, pos, new_begin);
-        data_allocator::construct(mystl::address_of(*new_end), value_copy); 
-        ++new_end; 
-        new_end = mystl::uninitialized_move(pos, _end, new_end); 
-        
+        mystl::uninitialized_move_if_noexcept(pos, _end, new_pos); 
     }
     catch(...)
     {
-        data_allocator::deallocate(new_begin, new_size); 
+        data_traits::destroy(get_alloc(), new_begin, mid); 
         throw; 
     }
+    data_traits::destroy(get_alloc(), _begin, _end); 
+}
 
-    destroy_and_recover(_begin, _end, _cap - _begin); 
-    _begin = new_begin; 
-    _end = new_end; 
-    _cap = new_begin + new_size; 
+// relocate_emplace 
+// 备用空间足够时在 pos 处构造元素，仅用于可平凡重定位的类型:
+// 先在临时空间构造新元素，再把 [pos, _end) 整体后移一位，最后把新元素搬入 pos，后两步不会抛出异常
+template <typename T, typename Alloc, typename Growth> 
+template <typename... Args> 
+void vector<T, Alloc, Growth>::relocate_emplace(iterator pos, Args&& ...args)
+{
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type buf; 
+    auto tmp = reinterpret_cast<pointer>(&buf); 
+    data_traits::construct(get_alloc(), tmp, mystl::forward<Args>(args)...); 
+    mystl::uninitialized_relocate(pos, _end, pos + 1); 
+    mystl::uninitialized_relocate(tmp, tmp + 1, pos); 
+    ++_end; 
 }
 
 // fill_insert 
-template<typename T> 
-typename vector<T>::iterator 
-vector<T>:: fill_insert(iterator pos, size_type n, const value_type& value)
+template <typename T, typename Alloc, typename Growth> 
+typename vector<T, Alloc, Growth>::iterator 
+vector<T, Alloc, Growth>:: fill_insert(iterator pos, size_type n, const value_type& value)
 {
     if(n == 0)
     {
@@ -811,53 +1175,53 @@ vector<T>:: fill_insert(iterator pos, size_type n, const value_type& value)
         // 不需要扩容
         const size_type after_elems = _end - pos; 
         auto old_end = _end; 
-        if(after_elems > n)  
+        if(mystl::is_trivially_relocatable<value_type>::value) 
+        {
+            // 整体后移 n 位，构造失败时移回
+            mystl::uninitialized_relocate(pos, _end, pos + n); 
+            try
+            {
+                mystl::uninitialized_fill_n(pos, n, value_copy); 
+            }
+            catch(...)
+            {
+                mystl::uninitialized_relocate(pos + n, _end + n, pos); 
+                throw; 
+            }
+            _end += n; 
+        }
+        else if(after_elems > n)  
         {
-            mystl::uninitialized_copy(_end - n, _end, _end); 
+            mystl::uninitialized_move(_end - n, _end, _end); 
             _end += n; 
             std::move_backward(pos, old_end - n, old_end); 
-            mystl::uninitialized_fill_n(pos, n, value_copy); 
+            std::fill_n(pos, n, value_copy); 
         }
         else  
         {
             _end = mystl::uninitialized_fill_n(_end, n - after_elems, value_copy);
             _end = mystl::uninitialized_move(pos, old_end, _end); 
-            mystl::uninitialized_fill_n(pos, after_elems, value_copy); 
+            std::fill_n(pos, after_elems, value_copy); 
         }
     }
     else    
     {
         // 需要扩容
-        const auto new_size = get_new_capacity(n); 
-        auto new_begin = data_allocator::allocate(new_size); 
-        auto new_end = new_begin; 
-
-        try
-        {
-            new_end = mystl::uninitialized_move(_begin, pos, new_begin);
-            new_end = mystl::uninitialized_fill_n(new_end, n, value); 
-            new_end = mystl::uninitialized_move(pos, _end, new_end); 
-        }
-        catch(...)
-        {
-            destroy_and_recover(new_begin, new_end, new_size);
-            throw; 
-        }
-        
-        data_allocator::deallocate(_begin, _cap - _begin); 
-        _begin = new_begin; 
-        _end = new_end; 
-        _cap = _begin + new_size; 
-
-
+        auto construct_gap = [&](iterator gap) {
+            mystl::uninitialized_fill_n(gap, n, value_copy); 
+        }; 
+        if(use_reallocate::value) 
+            remap_gap(pos, n, construct_gap); 
+        else 
+            reallocate_gap(pos, n, construct_gap); 
     }
     return _begin + xpos; 
 }
 
 //copy insert 
-template <typename T> 
+template <typename T, typename Alloc, typename Growth> 
 template <typename InputIter>  
-void vector<T>::copy_insert(iterator pos, InputIter first, InputIter last)
+void vector<T, Alloc, Growth>::copy_insert(iterator pos, InputIter first, InputIter last)
 {
     if(first == last) return; 
 
@@ -866,11 +1230,25 @@ void vector<T>::copy_insert(iterator pos, InputIter first, InputIter last)
     {
         const auto after_elems = _end - pos; 
         auto old_end = _end; 
-        if(after_elems > n) 
+        if(mystl::is_trivially_relocatable<value_type>::value) 
+        {
+            mystl::uninitialized_relocate(pos, _end, pos + n); 
+            try
+            {
+                mystl::uninitialized_copy(first, last, pos); 
+            }
+            catch(...)
+            {
+                mystl::uninitialized_relocate(pos + n, _end + n, pos); 
+                throw; 
+            }
+            _end += n; 
+        }
+        else if(after_elems > n) 
         {
-            _end = mystl::uninitialized_copy(_end - n, _end, _end);
+            _end = mystl::uninitialized_move(_end - n, _end, _end);
             std::move_backward(pos, old_end -n, old_end); 
-            mystl::uninitialized_copy(first, last, pos); 
+            std::copy(first, last, pos); 
         }
         else  
         {
@@ -878,102 +1256,103 @@ void vector<T>::copy_insert(iterator pos, InputIter first, InputIter last)
             mystl::advance(mid, after_elems); 
             _end = mystl::uninitialized_copy(mid, last, _end); 
             _end = mystl::uninitialized_move(pos, old_end, _end); 
-            mystl::uninitialized_copy(first, mid, pos); 
+            std::copy(first, mid, pos); 
         }
     }
     else 
     {
         // 备用空间不足
-        const auto new_size = get_new_capacity(n); 
-        auto new_begin = data_allocator::allocate(new_size); 
-        auto new_end = new_begin; 
-
-        try
-        {
-            new_end = mystl::uninitialized_move(_begin, pos, new_begin); 
-            new_end = mystl::uninitialized_copy(first, last, new_end); 
-            new_end = mystl::uninitialized_move(pos, _end, new_end); 
-        }
-        catch(...)
-        {
-            destroy_and_recover(new_begin, new_end, new_size);
-            throw; 
-        }
-        
-        data_allocator::deallocate(_begin, _cap - _begin); 
-        _begin = new_begin; 
-        _end = new_end; 
-        _cap = _begin + new_size; 
+        reallocate_gap(pos, n, [&](iterator gap) {
+            mystl::uninitialized_copy(first, last, gap); 
+        }); 
     }
 
 }
 
 // reinsert 
-template <typename T>  
-void vector<T>::reinsert(size_type size)
+template <typename T, typename Alloc, typename Growth>  
+void vector<T, Alloc, Growth>::reinsert(size_type size)
 {
+    if(use_reallocate::value) 
+    {
+        _begin = data_traits::reallocate(get_alloc(), _begin, capacity(), size); 
+        _end = _begin + size; 
+        _cap = _begin + size; 
+        return; 
+    }
 
-    auto new_begin = data_allocator::allocate(size); 
+    auto new_begin = data_traits::allocate(get_alloc(), size); 
     try
     {
-        mystl::uninitialized_move(_begin, _end, new_begin); 
+        relocate_to(_end, new_begin, new_begin + size); 
     }
     catch(...)
     {
-        data_allocator::deallocate(new_begin, size); 
+        data_traits::deallocate(get_alloc(), new_begin, size); 
         throw; 
     }
     
-    data_allocator::deallocate(_begin, _cap - _begin); 
+    data_traits::deallocate(get_alloc(), _begin, _cap - _begin); 
     _begin = new_begin; 
     _end = _begin + size; 
     _cap = _begin + size; 
 }
 
 // 重载比较运算符
-template<typename T> 
-bool operator== (const vector<T>& lhs, const vector<T>& rhs)
+template <typename T, typename Alloc, typename Growth> 
+bool operator== (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
     return lhs.size() == rhs.size() && 
         std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
 
-template<typename T>  
-bool operator< (const vector<T>& lhs, const vector<T>& rhs)
+template <typename T, typename Alloc, typename Growth>  
+bool operator< (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
     return std::lexicographical_compare(lhs.begin(), lhs.end(), 
                         rhs.begin(), rhs.end()); 
 }
 
-template<typename T> 
-bool operator!= (const vector<T>& lhs, const vector<T>& rhs)
+template <typename T, typename Alloc, typename Growth> 
+bool operator!= (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
     return !(lhs == rhs); 
 }
 
-template<typename T>  
-bool operator> (const vector<T>& lhs, const vector<T>& rhs)
+template <typename T, typename Alloc, typename Growth>  
+bool operator> (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
     return rhs < lhs; 
 }
 
-template<typename T>  
-bool operator<= (const vector<T>& lhs, const vector<T>& rhs)
+template <typename T, typename Alloc, typename Growth>  
+bool operator<= (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
    return !(rhs < lhs);
 }
 
-template<typename T>  
-bool operator>= (const vector<T>& lhs, const vector<T>& rhs)
+template <typename T, typename Alloc, typename Growth>  
+bool operator>= (const vector<T, Alloc, Growth>& lhs, const vector<T, Alloc, Growth>& rhs)
 {
    return !(lhs < rhs); 
 }
 
 // mystl::swap overload 
-template <typename T> 
-void swap(vector<T>& lhs, vector<T>& rhs)
+template <typename T, typename Alloc, typename Growth> 
+void swap(vector<T, Alloc, Growth>& lhs, vector<T, Alloc, Growth>& rhs)
 {
     lhs.swap(rhs); 
 }
+
+// vector 只保存指向堆空间的指针，分配器可平凡重定位时 vector 也可以
+template <typename T, typename Alloc, typename Growth> 
+struct is_trivially_relocatable<mystl::vector<T, Alloc, Growth>>: 
+    is_trivially_relocatable<Alloc> {}; 
+
+namespace pmr
+{
+template <typename T>
+using vector = mystl::vector<T, polymorphic_allocator<T>>;
+}
 } // end of namespace mystl 
 #endif // !VECTOR_H_ 
\ No newline at end of file
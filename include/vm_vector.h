@@ -0,0 +1,375 @@
+// -- vm_vector.h 模版类 vm_vector
+// 预留一大段虚拟地址、按需提交页面的 vector，扩容从不复制元素
+#ifndef VM_VECTOR_H_
+#define VM_VECTOR_H_
+
+// notes:
+// * 第一次需要空间时以 mmap(PROT_NONE) 预留 max_size() 个元素的地址空间，不占用物理内存
+// * 扩容只对预留区间的后续页面 mprotect(PROT_READ | PROT_WRITE)，元素不移动，
+//   指针、引用与迭代器在 vm_vector 的生命周期内一直有效 (移动、交换之后归属于另一个对象)
+// * 提交的字节数至少翻倍，不小于 VM_VECTOR_COMMIT；提交只改变页表权限，页面第一次写入时才占用物理内存
+// * 大小超过 max_size() 时抛出 std::length_error，容器保持不变；提交按页取整，capacity() 不超过 max_size()
+// * shrink_to_fit 把 size() 之后的页面交还内核 (madvise(MADV_DONTNEED)) 并恢复为 PROT_NONE
+// * 地址空间上限默认 VM_VECTOR_RESERVE 字节，可用 vm_limit 在构造时指定元素个数
+// * 接口与 vector 相同，插入、删除、赋值与比较由 inplace_vector_base 提供
+// * 依赖 mmap / mprotect，只支持 Linux；其他平台上编译失败
+//   (一次分配整段上限会占用内存，逐步分配又要移动元素，都违背了 vm_vector 的用途)
+
+#if !defined(__linux__)
+#error "vm_vector requires mmap / mprotect and is only supported on Linux"
+#endif
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <sys/mman.h>
+#include "inplace_vector_base.h"
+#include "iterator.h"
+#include "mremap_allocator.h"
+#include "uninitialized.h"
+#include "util.h"
+#include "exceptdef.h"
+
+namespace mystl
+{
+
+#ifndef VM_VECTOR_RESERVE
+#define VM_VECTOR_RESERVE (sizeof(void*) >= 8 ? (size_t(1) << 36) : (size_t(1) << 28))
+#endif
+
+#ifndef VM_VECTOR_COMMIT
+#define VM_VECTOR_COMMIT (64 * 1024)
+#endif
+
+// 与类型无关的地址空间预留、提交、归还与释放，长度均为页的整数倍
+struct vm_region
+{
+    static void* reserve(size_t bytes);
+    static void  commit(void* ptr, size_t bytes);
+    static void  decommit(void* ptr, size_t bytes) noexcept;
+    static void  release(void* ptr, size_t bytes) noexcept;
+};
+
+inline void* vm_region::reserve(size_t bytes)
+{
+    void* ptr = ::mmap(nullptr, bytes, PROT_NONE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(ptr == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+inline void vm_region::commit(void* ptr, size_t bytes)
+{
+    if(::mprotect(ptr, bytes, PROT_READ | PROT_WRITE) != 0)
+    {
+        throw std::bad_alloc();
+    }
+}
+
+inline void vm_region::decommit(void* ptr, size_t bytes) noexcept
+{
+    ::madvise(ptr, bytes, MADV_DONTNEED);
+    ::mprotect(ptr, bytes, PROT_NONE);
+}
+
+inline void vm_region::release(void* ptr, size_t bytes) noexcept
+{
+    ::munmap(ptr, bytes);
+}
+
+// 构造时指定 vm_vector 最多容纳的元素个数
+struct vm_limit
+{
+    size_t max_elements;
+    explicit vm_limit(size_t n) noexcept: max_elements(n) {}
+};
+
+template <typename T>
+class vm_vector: public mystl::inplace_vector_base<vm_vector<T>, T>
+{
+    typedef mystl::inplace_vector_base<vm_vector<T>, T>    base;
+    friend base;
+
+    static_assert(alignof(T) <= 4096, "vm_vector: alignment larger than a page is not supported");
+
+public:
+    typedef T                                       value_type;
+    typedef T*                                      pointer;
+    typedef const T*                                const_pointer;
+    typedef T&                                      reference;
+    typedef const T&                                const_reference;
+    typedef size_t                                  size_type;
+    typedef ptrdiff_t                               difference_type;
+
+    typedef value_type*                             iterator;
+    typedef const value_type*                       const_iterator;
+    typedef mystl::reverse_iterator<iterator>       reverse_iterator;
+    typedef mystl::reverse_iterator<const_iterator> const_reverse_iterator;
+
+private:
+    pointer     _begin;         // 预留区间的起始，第一次提交之前为 nullptr
+    size_type   _size;
+    size_type   _committed;     // 已提交的字节数
+    size_type   _max;           // 最多容纳的元素个数
+
+public:
+    // 构造、复制、移动、析构函数
+    // 其余构造函数都委托给前两个，函数体抛出异常时析构函数会被调用，释放已提交的页面
+    vm_vector() noexcept
+    : _begin(nullptr), _size(0), _committed(0), _max(VM_VECTOR_RESERVE / sizeof(T)) {}
+
+    explicit vm_vector(vm_limit limit) noexcept
+    : _begin(nullptr), _size(0), _committed(0), _max(limit.max_elements)
+    {
+        if(_max > static_cast<size_type>(-1) / 2 / sizeof(T))
+            _max = static_cast<size_type>(-1) / 2 / sizeof(T);
+    }
+
+    explicit vm_vector(size_type n): vm_vector()
+    {
+        resize(n);
+    }
+
+    vm_vector(size_type n, const value_type& value): vm_vector()
+    {
+        this->resize(n, value);
+    }
+
+    template <typename Iter, typename std::enable_if<
+        mystl::is_input_iterator<Iter>::value, int>::type = 0>
+    vm_vector(Iter first, Iter last): vm_vector()
+    {
+        this->assign(first, last);
+    }
+
+    vm_vector(std::initializer_list<value_type> initlist)
+    : vm_vector(initlist.begin(), initlist.end()) {}
+
+    vm_vector(const vm_vector& rhs): vm_vector(vm_limit(rhs._max))
+    {
+        this->assign(rhs.begin(), rhs.end());
+    }
+
+    // 移动后 rhs 为空，上限不变
+    vm_vector(vm_vector&& rhs) noexcept
+    : _begin(rhs._begin), _size(rhs._size), _committed(rhs._committed), _max(rhs._max)
+    {
+        rhs._begin = nullptr;
+        rhs._size = 0;
+        rhs._committed = 0;
+    }
+
+    vm_vector& operator=(const vm_vector& rhs)
+    {
+        if(this != &rhs)
+            this->assign(rhs.begin(), rhs.end());
+        return *this;
+    }
+
+    vm_vector& operator=(vm_vector&& rhs) noexcept
+    {
+        vm_vector tmp(mystl::move(rhs));
+        swap(tmp);
+        return *this;
+    }
+
+    vm_vector& operator=(std::initializer_list<value_type> initlist)
+    {
+        this->assign(initlist.begin(), initlist.end());
+        return *this;
+    }
+
+    ~vm_vector()
+    {
+        clear();
+        release();
+    }
+
+public:
+    // 迭代器相关
+    iterator        begin()         noexcept { return _begin; }
+    const_iterator  begin()   const noexcept { return _begin; }
+    iterator        end()           noexcept { return _begin + _size; }
+    const_iterator  end()     const noexcept { return _begin + _size; }
+
+    reverse_iterator        rbegin()        noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator  rbegin()  const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator        rend()          noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator  rend()    const noexcept { return const_reverse_iterator(begin()); }
+
+    const_iterator          cbegin()  const noexcept { return begin(); }
+    const_iterator          cend()    const noexcept { return end(); }
+    const_reverse_iterator  crbegin() const noexcept { return rbegin(); }
+    const_reverse_iterator  crend()   const noexcept { return rend(); }
+
+    // 容量相关
+    bool        empty()     const noexcept { return _size == 0; }
+    size_type   size()      const noexcept { return _size; }
+    size_type   max_size()  const noexcept { return _max; }
+    size_type   capacity()  const noexcept { return std::min(_committed / sizeof(T), _max); }
+
+    // 提交能容纳 n 个元素的页面
+    void reserve(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size(),
+                              "n can not larger than max_size() in vm_vector<T>::reserve(n)");
+        if(n > capacity())
+            commit_to(n * sizeof(T));
+    }
+
+    void shrink_to_fit() noexcept;
+
+    // 访问元素相关
+    reference operator[](size_type n)
+    {
+        MYSTL_DEBUG(n < size());
+        return _begin[n];
+    }
+    const_reference operator[](size_type n) const
+    {
+        MYSTL_DEBUG(n < size());
+        return _begin[n];
+    }
+
+    reference at(size_type n)
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < size()), "vm_vector<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+    const_reference at(size_type n) const
+    {
+        THROW_OUT_OF_RANGE_IF(!(n < size()), "vm_vector<T>::at() subscript out of range");
+        return (*this)[n];
+    }
+
+    reference       front()       { MYSTL_DEBUG(!empty()); return *begin(); }
+    const_reference front() const { MYSTL_DEBUG(!empty()); return *begin(); }
+    reference       back()        { MYSTL_DEBUG(!empty()); return *(end() - 1); }
+    const_reference back()  const { MYSTL_DEBUG(!empty()); return *(end() - 1); }
+
+    pointer       data()       noexcept { return _begin; }
+    const_pointer data() const noexcept { return _begin; }
+
+    // 修改容器相关操作
+
+    // emplace_back
+    template <typename ...Args>
+    reference emplace_back(Args&& ...args)
+    {
+        if(_size == capacity())
+            grow(1);
+        pointer p = end();
+        mystl::_construct(p, mystl::forward<Args>(args)...);
+        ++_size;
+        return *p;
+    }
+
+    // push_back / pop_back
+    void push_back(const value_type& value) { emplace_back(value); }
+    void push_back(value_type&& value) { emplace_back(mystl::move(value)); }
+
+    void pop_back()
+    {
+        MYSTL_DEBUG(!empty());
+        --_size;
+        mystl::destroy(end());
+    }
+
+    // clear
+    void clear() noexcept
+    {
+        mystl::destroy(begin(), end());
+        _size = 0;
+    }
+
+    // resize
+    using base::resize;
+    void resize(size_type new_size) { this->resize(new_size, value_type()); }
+
+    void swap(vm_vector& rhs) noexcept
+    {
+        mystl::swap(_begin, rhs._begin);
+        mystl::swap(_size, rhs._size);
+        mystl::swap(_committed, rhs._committed);
+        mystl::swap(_max, rhs._max);
+    }
+
+private:
+    // helper functions
+
+    size_type reserved_bytes() const noexcept
+    {
+        return mremap_base::round_up(_max * sizeof(T));
+    }
+
+    // inplace_vector_base 所需的接口
+    void require_size(size_type n) { reserve(n); }
+    void require_room(size_type n) { grow(n); }
+    void set_size(size_type n) noexcept { _size = n; }
+    static void destroy_elements(pointer first, pointer last) noexcept { mystl::destroy(first, last); }
+
+    // 保证还能容纳 n 个元素，提交的字节数至少翻倍
+    void grow(size_type n)
+    {
+        THROW_LENGTH_ERROR_IF(n > max_size() - size(), "vm_vector<T>'s size too big");
+        const size_type need = (size() + n) * sizeof(T);
+        if(need <= _committed) return;
+        commit_to(std::max(need, std::max(_committed * 2, static_cast<size_type>(VM_VECTOR_COMMIT))));
+    }
+
+    void commit_to(size_type bytes);
+    void release() noexcept;
+};
+
+/*****************************************************************************************/
+
+// commit_to: 已提交部分之后的页面改为可读写，第一次调用时预留整段地址空间
+template <typename T>
+void vm_vector<T>::commit_to(size_type bytes)
+{
+    const size_type limit = reserved_bytes();
+    bytes = std::min(mremap_base::round_up(bytes), limit);
+    if(bytes <= _committed) return;
+    if(_begin == nullptr)
+        _begin = static_cast<pointer>(vm_region::reserve(limit));
+    vm_region::commit(reinterpret_cast<char*>(_begin) + _committed, bytes - _committed);
+    _committed = bytes;
+}
+
+template <typename T>
+void vm_vector<T>::release() noexcept
+{
+    if(_begin == nullptr) return;
+    vm_region::release(_begin, reserved_bytes());
+    _begin = nullptr;
+    _committed = 0;
+}
+
+// shrink_to_fit: 地址空间仍然保留，之后的增长照常提交
+template <typename T>
+void vm_vector<T>::shrink_to_fit() noexcept
+{
+    const size_type keep = mremap_base::round_up(_size * sizeof(T));
+    if(keep >= _committed) return;
+    vm_region::decommit(reinterpret_cast<char*>(_begin) + keep, _committed - keep);
+    _committed = keep;
+}
+
+// mystl::swap overload
+template <typename T>
+void swap(vm_vector<T>& lhs, vm_vector<T>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+// 只保存指向映射区的指针与大小
+template <typename T>
+struct is_trivially_relocatable<mystl::vm_vector<T>>: m_true_type {};
+
+} // end of namespace mystl
+#endif // !VM_VECTOR_H_
@@ -0,0 +1,111 @@
+// --aligned_allocatortest.cpp 对齐分配器测试与向量化内核性能对比
+#include <gtest/gtest.h>
+#include "aligned_allocator.h"
+#include "allocator.h"
+#include "vector.h"
+#include "deque.h"
+#include "list.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+struct alignas(64) cache_line
+{
+    double value[8];
+};
+
+static bool is_aligned(const void* p, size_t alignment)
+{
+    return reinterpret_cast<uintptr_t>(p) % alignment == 0;
+}
+
+TEST(test1, aligned_allocator)
+{
+    mystl::aligned_allocator<float, 64> a;
+    for(size_t n = 1; n < 100; n += 7)
+    {
+        float* p = a.allocate(n);
+        EXPECT_TRUE(is_aligned(p, 64));
+        a.deallocate(p, n);
+    }
+    EXPECT_EQ(a.allocate(0), nullptr);
+
+    typedef mystl::allocator_traits<mystl::aligned_allocator<char, 128>> traits;
+    EXPECT_TRUE((std::is_same<traits::rebind_alloc<int>, mystl::aligned_allocator<int, 128>>::value));
+    EXPECT_TRUE((mystl::aligned_allocator<int, 32>() == mystl::aligned_allocator<char, 32>()));
+    EXPECT_TRUE((mystl::aligned_allocator<int, 32>() != mystl::aligned_allocator<int, 64>()));
+}
+
+TEST(test2, containers)
+{
+    mystl::vector<float, mystl::aligned_allocator<float, 64>> v;
+    for(int i = 0; i < 1000; ++i)
+    {
+        v.push_back(static_cast<float>(i));
+        EXPECT_TRUE(is_aligned(v.data(), 64));
+    }
+    mystl::deque<float, mystl::aligned_allocator<float, 64>> d(100, 1.0f);
+    EXPECT_TRUE(is_aligned(&d[0], 64));
+}
+
+TEST(test3, default_allocator_over_aligned)
+{
+    // 默认分配器遵守 alignof(T)
+    mystl::allocator<cache_line> a;
+    cache_line* p = a.allocate(3);
+    EXPECT_TRUE(is_aligned(p, 64));
+    a.deallocate(p, 3);
+
+    mystl::vector<cache_line> v(10);
+    EXPECT_TRUE(is_aligned(v.data(), 64));
+    mystl::list<cache_line> l;
+    for(int i = 0; i < 10; ++i)
+    {
+        l.push_back(cache_line());
+        EXPECT_TRUE(is_aligned(&l.back(), 64));
+    }
+    mystl::deque<cache_line> d(5);
+    EXPECT_TRUE(is_aligned(&d[0], 64));
+}
+
+// y = a * x + y，以 64 字节为单位处理；对齐的版本告诉编译器指针满足对齐
+static void saxpy_aligned(float a, const float* x, float* y, size_t n)
+{
+    const float* ax = static_cast<const float*>(__builtin_assume_aligned(x, 64));
+    float* ay = static_cast<float*>(__builtin_assume_aligned(y, 64));
+    for(size_t i = 0; i < n; ++i)
+        ay[i] = a * ax[i] + ay[i];
+}
+
+static void saxpy(float a, const float* x, float* y, size_t n)
+{
+    for(size_t i = 0; i < n; ++i)
+        y[i] = a * x[i] + y[i];
+}
+
+TEST(test4, benchmark_saxpy)
+{
+    const size_t n = 4096;
+    const int rounds = 20000;
+    mystl::vector<float, mystl::aligned_allocator<float, 64>> ax(n, 1.0f), ay(n, 2.0f);
+    // 偏移一个元素得到不对齐于 64 字节的缓冲区
+    mystl::vector<float> ux(n + 1, 1.0f), uy(n + 1, 2.0f);
+    const float* x = ux.data() + 1;
+    float* y = uy.data() + 1;
+
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+        saxpy_aligned(1.0001f, ax.data(), ay.data(), n);
+    auto mid = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+        saxpy(1.0001f, x, y, n);
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "aligned: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << " us ("
+              << ay[n - 1] << ")\n"
+              << "unaligned: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count() << " us ("
+              << y[n - 1] << ")\n";
+    EXPECT_FLOAT_EQ(ay[n - 1], y[n - 1]);
+}
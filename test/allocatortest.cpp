@@ -0,0 +1,191 @@
+// --allocatortest.cpp 分配器与 allocator_traits 测试
+#include <gtest/gtest.h>
+#include "allocator.h"
+#include "vector.h"
+#include "deque.h"
+#include "list.h"
+#include "map.h"
+#include "set.h"
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// 有状态的计数分配器: id 不同的实例互不相等
+template <typename T>
+struct counting_allocator
+{
+    typedef T       value_type;
+
+    int     id;
+    long*   live;       // 当前尚未释放的元素个数
+
+    counting_allocator(int i, long* l): id(i), live(l) {}
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& rhs): id(rhs.id), live(rhs.live) {}
+
+    T* allocate(size_t n)
+    {
+        *live += static_cast<long>(n);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        if(p == nullptr) return;
+        *live -= static_cast<long>(n);
+        ::operator delete(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const counting_allocator<T>& lhs, const counting_allocator<U>& rhs)
+{ return lhs.id == rhs.id; }
+
+template <typename T, typename U>
+bool operator!=(const counting_allocator<T>& lhs, const counting_allocator<U>& rhs)
+{ return !(lhs == rhs); }
+
+TEST(test1, allocator_traits)
+{
+    typedef mystl::allocator_traits<mystl::allocator<int>>        traits;
+    typedef mystl::allocator_traits<counting_allocator<int>>      ctraits;
+
+    EXPECT_TRUE((std::is_same<traits::pointer, int*>::value));
+    EXPECT_TRUE((std::is_same<ctraits::size_type, size_t>::value));
+    EXPECT_TRUE((std::is_same<traits::rebind_alloc<double>, mystl::allocator<double>>::value));
+    EXPECT_TRUE((std::is_same<ctraits::rebind_alloc<double>, counting_allocator<double>>::value));
+    EXPECT_TRUE(traits::is_always_equal::value);
+    EXPECT_FALSE(ctraits::is_always_equal::value);
+    EXPECT_FALSE(ctraits::propagate_on_container_swap::value);
+
+    mystl::allocator<std::string> a;
+    auto p = mystl::allocator_traits<mystl::allocator<std::string>>::allocate(a, 2);
+    mystl::allocator_traits<mystl::allocator<std::string>>::construct(a, p, "mystl");
+    mystl::allocator_traits<mystl::allocator<std::string>>::construct(a, p + 1);
+    EXPECT_EQ(p[0], "mystl");
+    EXPECT_TRUE(p[1].empty());
+    mystl::allocator_traits<mystl::allocator<std::string>>::destroy(a, p, p + 2);
+    mystl::allocator_traits<mystl::allocator<std::string>>::deallocate(a, p, 2);
+}
+
+TEST(test2, empty_base_optimization)
+{
+    std::cout << "sizeof vector<int>: " << sizeof(mystl::vector<int>) << "\n";
+    std::cout << "sizeof list<int>: " << sizeof(mystl::list<int>) << "\n";
+    EXPECT_EQ(sizeof(mystl::vector<int>), 3 * sizeof(void*));
+    EXPECT_EQ(sizeof(mystl::list<int>), 2 * sizeof(void*));
+    EXPECT_GT(sizeof(mystl::vector<int, counting_allocator<int>>), 3 * sizeof(void*));
+}
+
+TEST(test3, stateful_vector)
+{
+    long live = 0;
+    {
+        counting_allocator<int> alloc(1, &live);
+        mystl::vector<int, counting_allocator<int>> v(alloc);
+        for(int i = 0; i < 100; ++i)
+        {
+            v.push_back(i);
+        }
+        EXPECT_EQ(v.get_allocator().id, 1);
+        EXPECT_EQ(static_cast<size_t>(live), v.capacity());
+
+        mystl::vector<int, counting_allocator<int>> copy(v);
+        EXPECT_EQ(copy.get_allocator().id, 1);
+        EXPECT_TRUE(copy == v);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+TEST(test4, stateful_node_containers)
+{
+    long live = 0;
+    {
+        counting_allocator<int> alloc(2, &live);
+        mystl::list<int, counting_allocator<int>> l(alloc);
+        mystl::deque<int, counting_allocator<int>> d(alloc);
+        for(int i = 0; i < 1000; ++i)
+        {
+            l.push_back(i);
+            d.push_back(i);
+        }
+        EXPECT_EQ(l.get_allocator().id, 2);
+        EXPECT_EQ(d.get_allocator().id, 2);
+        EXPECT_GT(live, 0);
+
+        typedef counting_allocator<mystl::pair<const int, std::string>> map_alloc;
+        mystl::map<int, std::string, mystl::less<int>, map_alloc> m(map_alloc(3, &live));
+        m[1] = "one";
+        m[2] = "two";
+        EXPECT_EQ(m.get_allocator().id, 3);
+        EXPECT_EQ(m.size(), 2u);
+
+        mystl::set<int, mystl::less<int>, counting_allocator<int>> s(alloc);
+        s.insert(5);
+        s.insert(5);
+        EXPECT_EQ(s.size(), 1u);
+    }
+    EXPECT_EQ(live, 0);
+}
+
+TEST(test5, move_assign_unequal_allocator)
+{
+    long live = 0;
+    {
+        mystl::vector<std::string, counting_allocator<std::string>> v1(counting_allocator<std::string>(1, &live));
+        mystl::vector<std::string, counting_allocator<std::string>> v2(counting_allocator<std::string>(2, &live));
+        v2.push_back("hello");
+        v2.push_back("mystl");
+        v1 = mystl::move(v2);
+        // 分配器不传播：v1 保留自己的分配器，元素被逐个移动过来
+        EXPECT_EQ(v1.get_allocator().id, 1);
+        EXPECT_EQ(v1.size(), 2u);
+        EXPECT_EQ(v1[1], "mystl");
+        EXPECT_TRUE(v2.empty());
+    }
+    EXPECT_EQ(live, 0);
+}
+
+// 第 countdown 次移动构造时抛出异常
+struct throwing_move
+{
+    static int countdown;
+    int value;
+    throwing_move(int v = 0): value(v) {}
+    throwing_move(const throwing_move& rhs): value(rhs.value) {}
+    throwing_move(throwing_move&& rhs): value(rhs.value)
+    {
+        if(--countdown == 0) throw std::runtime_error("move");
+    }
+};
+int throwing_move::countdown = -1;
+
+TEST(test6, move_unequal_allocator_may_throw)
+{
+    typedef mystl::vector<int, counting_allocator<int>> cvector;
+    typedef mystl::list<int, counting_allocator<int>> clist;
+    // 分配器可能不相等且不传播时，移动赋值不能声明为 noexcept
+    EXPECT_TRUE(std::is_nothrow_move_assignable<mystl::vector<int>>::value);
+    EXPECT_TRUE(std::is_nothrow_move_assignable<mystl::list<int>>::value);
+    EXPECT_FALSE(std::is_nothrow_move_assignable<cvector>::value);
+    EXPECT_FALSE(std::is_nothrow_move_assignable<clist>::value);
+
+    long live = 0;
+    {
+        typedef counting_allocator<throwing_move> alloc;
+        mystl::vector<throwing_move, alloc> v(alloc(1, &live));
+        for(int i = 0; i < 5; ++i)
+        {
+            v.emplace_back(i);
+        }
+        const long before = live;
+        throwing_move::countdown = 3;
+        EXPECT_THROW((mystl::vector<throwing_move, alloc>(mystl::move(v), alloc(2, &live))),
+                     std::runtime_error);
+        throwing_move::countdown = -1;
+        // 构造失败时新分配的空间已归还
+        EXPECT_EQ(live, before);
+        EXPECT_EQ(v.size(), 5u);
+    }
+    EXPECT_EQ(live, 0);
+}
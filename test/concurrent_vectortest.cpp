@@ -0,0 +1,200 @@
+// --concurrent_vectortest.cpp concurrent_vector 测试与多线程追加时与加锁 vector 的性能对比
+#include <gtest/gtest.h>
+#include "concurrent_vector.h"
+#include "vector.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct counted
+{
+    static std::atomic<int> live;
+    static int countdown;
+    int value;
+    counted(int v = 0): value(v)
+    {
+        if(countdown-- == 0) throw std::runtime_error("construct");
+        ++live;
+    }
+    counted(const counted& rhs): value(rhs.value) { ++live; }
+    ~counted() { --live; }
+};
+std::atomic<int> counted::live(0);
+int counted::countdown = -1;
+
+TEST(test1, single_thread)
+{
+    mystl::concurrent_vector<std::string> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 0u);
+
+    // 空追加不领取下标，也不分配段
+    EXPECT_TRUE(v.grow_by(0) == v.end());
+    std::vector<std::string> none;
+    EXPECT_TRUE(v.grow_by(none.begin(), none.end()) == v.end());
+    v.grow_by(std::initializer_list<std::string>{});
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 0u);
+
+    auto it = v.push_back("0");
+    EXPECT_EQ(*it, "0");
+    const std::string* first = &v[0];
+    for(int i = 1; i < 1000; ++i)
+        v.emplace_back(std::to_string(i));
+    // 段不移动，已有元素的地址不变
+    EXPECT_EQ(first, &v[0]);
+    EXPECT_EQ(v.size(), 1000u);
+    EXPECT_EQ(v.capacity(), 1024u);
+    EXPECT_EQ(v[63], "63");
+    EXPECT_EQ(v[64], "64");
+    EXPECT_EQ(v[511], "511");
+    EXPECT_EQ(v.back(), "999");
+    EXPECT_TRUE(v.ready(999));
+    EXPECT_FALSE(v.ready(1000));
+    EXPECT_THROW(v.at(1000), std::out_of_range);
+
+    auto g = v.grow_by(3, "x");
+    EXPECT_EQ(g - v.begin(), 1000);
+    EXPECT_EQ(v[1002], "x");
+    std::vector<std::string> src{"a", "b"};
+    g = v.grow_by(src.begin(), src.end());
+    EXPECT_EQ(*g, "a");
+    v.grow_by({"c"});
+    v.grow_by(2);
+    EXPECT_EQ(v.size(), 1008u);
+    EXPECT_EQ(v[1005], "c");
+    EXPECT_EQ(v[1007], "");
+    EXPECT_EQ(static_cast<size_t>(v.end() - v.begin()), v.size());
+    EXPECT_EQ(*v.rbegin(), "");
+
+    size_t n = 0;
+    for(const auto& s : v)
+        n += !s.empty();
+    EXPECT_EQ(n, 1006u);
+
+    v.reserve(5000);
+    EXPECT_EQ(v.capacity(), 8192u);
+    EXPECT_EQ(first, &v[0]);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 8192u);
+}
+
+TEST(test2, exception_leaves_hole)
+{
+    {
+        mystl::concurrent_vector<counted> v;
+        v.grow_by(10);
+        counted::countdown = 2;
+        EXPECT_THROW(v.grow_by(5), std::runtime_error);
+        // 领取的 5 个位置中前两个已构造，其余永远不会就绪
+        EXPECT_EQ(v.size(), 15u);
+        EXPECT_TRUE(v.ready(11));
+        EXPECT_FALSE(v.ready(12));
+        EXPECT_FALSE(v.ready(14));
+        EXPECT_THROW(v.at(12), std::out_of_range);
+        v.push_back(counted(7));
+        EXPECT_EQ(v[15].value, 7);
+        EXPECT_EQ(counted::live, 13);
+    }
+    EXPECT_EQ(counted::live, 0);
+}
+
+TEST(test3, concurrent_append_and_read)
+{
+    const int nthreads = 8;
+    const int n = 50000;
+    mystl::concurrent_vector<uint64_t> v;
+    std::atomic<bool> done(false);
+    std::atomic<size_t> checked(0);
+
+    // 读线程只读取已就绪的元素，值按 (线程 << 32 | 序号) 编码
+    std::thread reader([&]() {
+        while(!done.load())
+        {
+            const size_t size = v.size();
+            for(size_t i = size > 64 ? size - 64 : 0; i < size; ++i)
+            {
+                if(!v.ready(i)) continue;
+                const uint64_t x = v[i];
+                if((x >> 32) < static_cast<uint64_t>(nthreads) && (x & 0xffffffff) < static_cast<uint64_t>(n))
+                    ++checked;
+            }
+        }
+    });
+
+    std::vector<std::thread> writers;
+    for(int t = 0; t < nthreads; ++t)
+    {
+        writers.emplace_back([&v, t, n]() {
+            for(int i = 0; i < n; ++i)
+            {
+                if(i % 100 == 0)
+                    v.grow_by({(uint64_t(t) << 32) | uint64_t(i)});
+                else
+                    EXPECT_EQ(*v.push_back((uint64_t(t) << 32) | uint64_t(i)), (uint64_t(t) << 32) | uint64_t(i));
+            }
+        });
+    }
+    for(auto& th : writers) th.join();
+    done = true;
+    reader.join();
+
+    ASSERT_EQ(v.size(), static_cast<size_t>(nthreads) * n);
+    std::vector<uint64_t> all(v.begin(), v.end());
+    std::sort(all.begin(), all.end());
+    for(int t = 0; t < nthreads; ++t)
+        for(int i = 0; i < n; ++i)
+            ASSERT_EQ(all[t * n + i], (uint64_t(t) << 32) | uint64_t(i));
+    std::cout << "reader checked " << checked.load() << " elements\n";
+}
+
+// 1 到 64 个线程共同追加 n 个元素
+template <typename Append>
+long long bench_append(int nthreads, size_t n, Append append)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for(int t = 0; t < nthreads; ++t)
+    {
+        threads.emplace_back([&append, t, nthreads, n]() {
+            for(size_t i = t; i < n; i += nthreads)
+                append(i);
+        });
+    }
+    for(auto& th : threads) th.join();
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(test4, benchmark_scaling)
+{
+    const size_t n = 4000000;
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+    for(int nthreads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        mystl::vector<uint64_t> locked;
+        std::mutex lock;
+        const long long locked_us = bench_append(nthreads, n, [&](size_t i) {
+            std::lock_guard<std::mutex> guard(lock);
+            locked.push_back(i);
+        });
+
+        mystl::concurrent_vector<uint64_t> cv;
+        const long long concurrent_us = bench_append(nthreads, n, [&](size_t i) {
+            cv.push_back(i);
+        });
+
+        EXPECT_EQ(locked.size(), n);
+        EXPECT_EQ(cv.size(), n);
+        std::cout << "x" << nthreads << "  mutex + mystl::vector: " << locked_us << " us"
+                  << "  mystl::concurrent_vector: " << concurrent_us << " us\n";
+    }
+}
@@ -2,6 +2,13 @@
 #include "deque.h" 
 #include <iostream>  
 #include <string>  
+#include <deque> 
+#include <chrono> 
+#include <cstdint> 
+#include <random> 
+#include <vector> 
+#include "vector.h" 
+#include "stats_allocator.h" 
 
 
 
@@ -517,4 +524,313 @@ TEST(test29, generic_swap)
     std::cout << ' ' << *it;
   std::cout << '\n';
 
-}
\ No newline at end of file
+}
+
+TEST(test30, relocate_shift)
+{
+    // 可平凡重定位: 插入与删除时按缓冲区整段搬移
+    mystl::deque<int> d; 
+    std::deque<int> ref; 
+    for(int i = 0; i < 1000; ++i) 
+    {
+        d.push_back(i); 
+        ref.push_back(i); 
+    }
+    for(int i = 0; i < 300; ++i) 
+    {
+        const size_t pos = (i * 37) % (d.size() + 1); 
+        d.insert(d.begin() + pos, -i); 
+        ref.insert(ref.begin() + pos, -i); 
+    }
+    for(int i = 0; i < 200; ++i) 
+    {
+        const size_t pos = (i * 53) % d.size(); 
+        d.erase(d.begin() + pos); 
+        ref.erase(ref.begin() + pos); 
+    }
+    d.erase(d.begin() + 10, d.begin() + 500); 
+    ref.erase(ref.begin() + 10, ref.begin() + 500); 
+    d.erase(d.end() - 300, d.end() - 5); 
+    ref.erase(ref.end() - 300, ref.end() - 5); 
+    ASSERT_EQ(d.size(), ref.size()); 
+    EXPECT_TRUE(std::equal(d.begin(), d.end(), ref.begin())); 
+
+    // 元素本身是容器
+    mystl::deque<mystl::deque<int>> dd; 
+    for(int i = 0; i < 100; ++i) dd.emplace_back(i, i); 
+    dd.emplace(dd.begin() + 10, 3, -1); 
+    dd.erase(dd.begin() + 80); 
+    EXPECT_EQ(dd.size(), 100u); 
+    EXPECT_EQ(dd[10].size(), 3u); 
+    EXPECT_EQ(dd[11].size(), 10u); 
+    EXPECT_EQ(dd[99].size(), 99u); 
+}
+
+// 统计复制次数，移动构造不抛出异常
+struct copy_counter
+{
+    static int copies; 
+    int value; 
+    copy_counter(int v = 0): value(v) {}
+    copy_counter(const copy_counter& rhs): value(rhs.value) { ++copies; }
+    copy_counter(copy_counter&& rhs) noexcept: value(rhs.value) {}
+    copy_counter& operator=(const copy_counter& rhs) { value = rhs.value; ++copies; return *this; }
+    copy_counter& operator=(copy_counter&& rhs) noexcept { value = rhs.value; return *this; }
+    ~copy_counter() {}
+}; 
+int copy_counter::copies = 0; 
+
+TEST(test31, no_copy_on_shift)
+{
+    mystl::deque<copy_counter> d; 
+    for(int i = 0; i < 1000; ++i) 
+    {
+        d.emplace_back(i); 
+        d.emplace_front(-i); 
+    }
+    copy_counter::copies = 0; 
+    d.emplace(d.begin() + 100, 1); 
+    d.emplace(d.end() - 100, 2); 
+    d.insert(d.begin() + 10, 50, copy_counter(3)); 
+    d.insert(d.end() - 10, 50, copy_counter(4)); 
+    d.erase(d.begin() + 5); 
+    d.erase(d.end() - 5); 
+    d.erase(d.begin() + 20, d.begin() + 40); 
+    // 只有 insert(pos, n, value) 复制 value 本身
+    EXPECT_EQ(copy_counter::copies, 2 * (50 + 1)); 
+    EXPECT_EQ(d.size(), 2000u + 2 + 100 - 2 - 20); 
+}
+
+TEST(test32, uninitialized_resize)
+{
+    mystl::deque<int> d(3, 1); 
+    const size_t n = 3 * mystl::deque_buf_size<int>::value + 5; 
+    auto range = d.append_uninitialized(n); 
+    EXPECT_EQ(range.first, d.begin() + 3); 
+    EXPECT_EQ(range.second, d.end()); 
+    for(auto it = range.first; it != range.second; ++it) *it = 2; 
+    EXPECT_EQ(d.size(), n + 3); 
+    EXPECT_EQ(d[2], 1); 
+    EXPECT_EQ(d[n + 2], 2); 
+
+    d.resize_default_init(10); 
+    EXPECT_EQ(d.size(), 10u); 
+    EXPECT_EQ(d[9], 2); 
+
+    // 按缓冲区分段写入，每段都在同一缓冲区内
+    d.push_front(0); 
+    size_t segments = 0; 
+    int next = 0; 
+    d.resize_and_overwrite(n, [&](int* p, size_t count) {
+        ++segments; 
+        for(size_t i = 0; i < count; ++i) p[i] = next++; 
+        return count; 
+    }); 
+    EXPECT_EQ(d.size(), n); 
+    EXPECT_GE(segments, 4u); 
+    for(size_t i = 0; i < n; ++i) EXPECT_EQ(d[i], static_cast<int>(i)); 
+
+    // 某段没有写满时停止
+    d.resize_and_overwrite(n, [](int*, size_t count) { return count / 2; }); 
+    EXPECT_LT(d.size(), mystl::deque_buf_size<int>::value); 
+
+    mystl::deque<std::string> s; 
+    s.resize_default_init(5); 
+    EXPECT_TRUE(s[4].empty()); 
+}
+
+TEST(test33, block_size)
+{
+    static_assert(mystl::deque_buf_size<int>::value == 1024, ""); 
+    static_assert(mystl::deque_buf_size<char[48]>::value == 64, ""); 
+    static_assert(mystl::deque_buf_size<char[300]>::value == 16, ""); 
+    static_assert(mystl::deque<int, mystl::allocator<int>, 4>::buffer_shift == 2, ""); 
+
+    // 缓冲区很小时跨越多个缓冲区的跳转
+    mystl::deque<int, mystl::allocator<int>, 4> d; 
+    std::deque<int> ref; 
+    for(int i = 0; i < 50; ++i) 
+    {
+        d.push_back(i); 
+        d.push_front(-i); 
+        ref.push_back(i); 
+        ref.push_front(-i); 
+    }
+    d.insert(d.begin() + 7, 3, 100); 
+    ref.insert(ref.begin() + 7, 3, 100); 
+    d.erase(d.begin() + 30, d.begin() + 41); 
+    ref.erase(ref.begin() + 30, ref.begin() + 41); 
+    ASSERT_EQ(d.size(), ref.size()); 
+    for(size_t i = 0; i < d.size(); ++i) 
+        EXPECT_EQ(d[i], ref[i]); 
+    for(int from = 0; from < static_cast<int>(d.size()); from += 3) 
+    {
+        auto it = d.begin() + from; 
+        for(int k = -from; k < static_cast<int>(d.size()) - from; k += 5) 
+        {
+            EXPECT_EQ(*(it + k), ref[from + k]); 
+            EXPECT_EQ((it + k) - it, k); 
+        }
+    }
+    auto copy = d; 
+    EXPECT_TRUE(copy == d); 
+    mystl::swap(copy, d); 
+    EXPECT_EQ(d.back(), ref.back()); 
+}
+
+// 随机下标访问与迭代器跳转，元素大小不同
+template <size_t N> 
+struct blob 
+{
+    uint64_t key; 
+    char pad[N - sizeof(uint64_t)]; 
+}; 
+
+template <typename Container> 
+long long bench_random_access(const Container& c, const std::vector<uint32_t>& idx, uint64_t& sum) 
+{
+    auto start = std::chrono::steady_clock::now(); 
+    for(uint32_t i : idx) 
+        sum += c[i].key; 
+    auto it = c.begin(); 
+    size_t pos = 0; 
+    for(uint32_t i : idx) 
+    {
+        it += static_cast<ptrdiff_t>(i) - static_cast<ptrdiff_t>(pos); 
+        pos = i; 
+        sum += it->key; 
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count(); 
+}
+
+template <size_t N> 
+void bench_blob(size_t n, const std::vector<uint32_t>& idx) 
+{
+    typedef blob<N> value_type; 
+    mystl::vector<value_type> v(n); 
+    mystl::deque<value_type> d(n); 
+    mystl::deque<value_type, mystl::allocator<value_type>, 16> small(n); 
+    for(size_t i = 0; i < n; ++i) 
+        v[i].key = d[i].key = small[i].key = i; 
+    uint64_t vs = 0, ds = 0, ss = 0; 
+    const long long vector_us = bench_random_access(v, idx, vs); 
+    const long long deque_us = bench_random_access(d, idx, ds); 
+    const long long small_us = bench_random_access(small, idx, ss); 
+    EXPECT_EQ(vs, ds); 
+    EXPECT_EQ(vs, ss); 
+    std::cout << "sizeof(T) = " << N << ": vector " << vector_us << " us, deque (buffer " 
+              << mystl::deque<value_type>::buffer_size << ") " << deque_us << " us, deque (buffer 16) " 
+              << small_us << " us\n"; 
+}
+
+TEST(test34, benchmark_random_access)
+{
+    const size_t n = 1 << 18; 
+    std::mt19937 rng(3); 
+    std::vector<uint32_t> idx(1 << 22); 
+    for(auto& i : idx) i = rng() % n; 
+    bench_blob<8>(n, idx); 
+    bench_blob<24>(n, idx); 
+    bench_blob<48>(n, idx); 
+    bench_blob<200>(n, idx); 
+}
+
+// 缓冲区缓存
+struct cache_tag {}; 
+
+TEST(test35, buffer_cache)
+{
+    typedef mystl::stats_allocator<int, cache_tag> alloc; 
+    typedef mystl::deque<int, alloc, 16> small_deque; 
+    mystl::alloc_stats<cache_tag>::reset(); 
+    {
+        small_deque d; 
+        EXPECT_EQ(d.buffer_cache_limit(), static_cast<size_t>(DEQUE_BUFFER_CACHE)); 
+        for(int i = 0; i < 100; ++i) d.push_back(i); 
+        for(int i = 0; i < 64; ++i) d.pop_front(); 
+        EXPECT_EQ(d.buffer_cache_size(), 4u); 
+        EXPECT_EQ(d.front(), 64); 
+
+        // 两端扩张都先取用缓存
+        const size_t allocations = mystl::alloc_stats<cache_tag>::snapshot().allocations; 
+        for(int i = 0; i < 32; ++i) d.push_back(100 + i); 
+        for(int i = 0; i < 16; ++i) d.push_front(-i); 
+        EXPECT_EQ(d.buffer_cache_size(), 1u); 
+        EXPECT_EQ(mystl::alloc_stats<cache_tag>::snapshot().allocations, allocations); 
+        EXPECT_EQ(d.size(), 84u); 
+        EXPECT_EQ(d[16], 64); 
+        EXPECT_EQ(d.back(), 131); 
+
+        d.set_buffer_cache_limit(0); 
+        EXPECT_EQ(d.buffer_cache_size(), 0u); 
+        for(int i = 0; i < 32; ++i) d.pop_back(); 
+        EXPECT_EQ(d.buffer_cache_size(), 0u); 
+        d.set_buffer_cache_limit(8); 
+        d.erase(d.begin() + 5, d.end() - 5); 
+        EXPECT_GT(d.buffer_cache_size(), 0u); 
+
+        auto copy = d; 
+        EXPECT_EQ(copy.buffer_cache_limit(), 8u); 
+        EXPECT_EQ(copy.buffer_cache_size(), 0u); 
+        auto moved = mystl::move(d); 
+        EXPECT_GT(moved.buffer_cache_size(), 0u); 
+        EXPECT_EQ(d.buffer_cache_size(), 0u); 
+        d = mystl::move(moved); 
+        EXPECT_GT(d.buffer_cache_size(), 0u); 
+        d.swap(copy); 
+        EXPECT_EQ(d.buffer_cache_size(), 0u); 
+        copy.shrink_to_fit(); 
+        EXPECT_EQ(copy.buffer_cache_size(), 0u); 
+        EXPECT_TRUE(copy == d); 
+    }
+    EXPECT_EQ(mystl::alloc_stats<cache_tag>::snapshot().live_allocations(), 0u); 
+}
+
+// 队列式使用: 长度约 n 的队列上 push_back + pop_front 一百万次
+struct message 
+{
+    uint64_t id; 
+    char body[56]; 
+}; 
+struct churn_tag {}; 
+
+template <typename Deque> 
+void bench_queue_churn(const char* name, size_t limit, size_t depth) 
+{
+    const size_t messages = 1000000; 
+    mystl::alloc_stats<churn_tag>::reset(); 
+    Deque q; 
+    q.set_buffer_cache_limit(limit); 
+    for(size_t i = 0; i < depth; ++i) q.push_back(typename Deque::value_type{}); 
+    const size_t before = mystl::alloc_stats<churn_tag>::snapshot().allocations; 
+    auto start = std::chrono::steady_clock::now(); 
+    for(size_t i = 0; i < messages; ++i) 
+    {
+        q.push_back(typename Deque::value_type{}); 
+        q.pop_front(); 
+    }
+    const long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count(); 
+    const size_t allocations = mystl::alloc_stats<churn_tag>::snapshot().allocations - before; 
+    std::cout << name << ", cache " << limit << ", depth " << depth << ": " 
+              << allocations << " allocations per 1M messages, " << us << " us\n"; 
+    // 缓存起初为空，尾部第一次跨缓冲区时头部还没有归还缓冲区，之后不再分配
+    if(limit > 0) 
+    {
+        EXPECT_LE(allocations, 1u); 
+    }
+}
+
+TEST(test36, benchmark_queue_churn)
+{
+    typedef mystl::deque<int, mystl::stats_allocator<int, churn_tag>> int_queue; 
+    typedef mystl::deque<message, mystl::stats_allocator<message, churn_tag>> message_queue; 
+    for(size_t depth : {10u, 1000u}) 
+    {
+        bench_queue_churn<int_queue>("deque<int>", 0, depth); 
+        bench_queue_churn<int_queue>("deque<int>", DEQUE_BUFFER_CACHE, depth); 
+        bench_queue_churn<message_queue>("deque<message>", 0, depth); 
+        bench_queue_churn<message_queue>("deque<message>", DEQUE_BUFFER_CACHE, depth); 
+    }
+}
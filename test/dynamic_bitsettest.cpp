@@ -0,0 +1,227 @@
+// --dynamic_bitsettest.cpp dynamic_bitset 测试与 std::vector<bool>、vector<char> 掩码的性能对比
+#include <gtest/gtest.h>
+#include "dynamic_bitset.h"
+#include "vector.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+TEST(test1, single_bits)
+{
+    mystl::dynamic_bitset<> b(70);
+    EXPECT_EQ(b.size(), 70u);
+    EXPECT_EQ(b.num_blocks(), 2u);
+    EXPECT_TRUE(b.none());
+    EXPECT_EQ(b.find_first(), mystl::dynamic_bitset<>::npos);
+
+    b.set(3);
+    b[64] = true;
+    b.set(69);
+    EXPECT_TRUE(b.test(3));
+    EXPECT_TRUE(b[64]);
+    EXPECT_FALSE(b[65]);
+    EXPECT_EQ(b.count(), 3u);
+    EXPECT_EQ(b.find_first(), 3u);
+    EXPECT_EQ(b.find_next(3), 64u);
+    EXPECT_EQ(b.find_next(64), 69u);
+    EXPECT_EQ(b.find_next(69), mystl::dynamic_bitset<>::npos);
+    EXPECT_THROW(b.at(70), std::out_of_range);
+
+    b[64].flip();
+    b.reset(3);
+    EXPECT_EQ(b.count(), 1u);
+    b.flip();
+    EXPECT_EQ(b.count(), 69u);
+    EXPECT_FALSE(b[69]);
+    EXPECT_FALSE(b.all());
+    b.set();
+    EXPECT_TRUE(b.all());
+    EXPECT_EQ(b.count(), 70u);
+    // 超出 size() 的位保持为 0
+    EXPECT_EQ(b.data()[1], (uint64_t(1) << 6) - 1);
+
+    mystl::dynamic_bitset<> s(std::string("0110001"));
+    EXPECT_EQ(s.to_string(), "0110001");
+    s.resize(10, true);
+    EXPECT_EQ(s.to_string(), "0110001111");
+    s.resize(3);
+    EXPECT_EQ(s.to_string(), "011");
+    s.push_back(true);
+    s.pop_back();
+    s.push_back(false);
+    EXPECT_EQ(s.to_string(), "0110");
+    EXPECT_THROW(mystl::dynamic_bitset<>(std::string("01x")), std::runtime_error);
+
+    mystl::dynamic_bitset<> p;
+    for(int i = 0; i < 200; ++i)
+        p.push_back(i % 3 == 0);
+    EXPECT_EQ(p.count(), 67u);
+    for(int i = 0; i < 100; ++i)
+        p.pop_back();
+    EXPECT_EQ(p.size(), 100u);
+    EXPECT_EQ(p.num_blocks(), 2u);
+    EXPECT_EQ(p.count(), 34u);
+}
+
+TEST(test2, bulk_operations)
+{
+    std::mt19937_64 rng(42);
+    for(size_t n : {0u, 1u, 63u, 64u, 65u, 255u, 256u, 1000u})
+    {
+        mystl::dynamic_bitset<> a(n), b(n);
+        std::vector<bool> ra(n), rb(n);
+        for(size_t i = 0; i < n; ++i)
+        {
+            ra[i] = rng() & 1;
+            rb[i] = rng() % 5 == 0;
+            a[i] = ra[i];
+            b[i] = rb[i];
+        }
+        auto check = [&](const mystl::dynamic_bitset<>& x, auto op) {
+            size_t count = 0;
+            for(size_t i = 0; i < n; ++i)
+            {
+                const bool expect = op(ra[i], rb[i]);
+                EXPECT_EQ(x[i], expect);
+                count += expect;
+            }
+            EXPECT_EQ(x.count(), count);
+        };
+        check(a & b, [](bool x, bool y) { return x && y; });
+        check(a | b, [](bool x, bool y) { return x || y; });
+        check(a ^ b, [](bool x, bool y) { return x != y; });
+        check(a - b, [](bool x, bool y) { return x && !y; });
+        check(~a, [](bool x, bool) { return !x; });
+
+        // find_next 遍历到的位与 test() 一致
+        size_t visited = 0;
+        for(size_t i = b.find_first(); i != mystl::dynamic_bitset<>::npos; i = b.find_next(i))
+        {
+            EXPECT_TRUE(rb[i]);
+            ++visited;
+        }
+        EXPECT_EQ(visited, b.count());
+    }
+}
+
+// 每组实现都与 generic 的结果相同
+TEST(test3, kernels_agree)
+{
+    std::vector<mystl::bitset_kernels> impls;
+    impls.push_back(mystl::bitset_kernels::generic());
+#if MYSTL_BITSET_SIMD
+    if(mystl::bitset_kernels::has_popcnt()) impls.push_back(mystl::bitset_kernels::popcnt());
+    if(mystl::bitset_kernels::has_avx2()) impls.push_back(mystl::bitset_kernels::avx2());
+#endif
+    std::cout << "selected kernels: " << mystl::bitset_kernels::get().name << "\n";
+
+    std::mt19937_64 rng(7);
+    const auto& g = impls[0];
+    for(size_t n = 0; n < 40; ++n)
+    {
+        std::vector<uint64_t> a(n), b(n);
+        for(auto& w : a) w = rng();
+        for(auto& w : b) w = rng() % 3 == 0 ? 0 : rng();
+        for(const auto& k : impls)
+        {
+            EXPECT_EQ(k.count(a.data(), n), g.count(a.data(), n)) << k.name;
+            for(size_t first = 0; first <= n; ++first)
+                EXPECT_EQ(k.find_nonzero(b.data(), first, n), g.find_nonzero(b.data(), first, n)) << k.name;
+
+            auto x = a, y = a;
+            k.and_assign(x.data(), b.data(), n); g.and_assign(y.data(), b.data(), n);
+            EXPECT_EQ(x, y) << k.name;
+            k.or_assign(x.data(), b.data(), n); g.or_assign(y.data(), b.data(), n);
+            EXPECT_EQ(x, y) << k.name;
+            k.xor_assign(x.data(), a.data(), n); g.xor_assign(y.data(), a.data(), n);
+            EXPECT_EQ(x, y) << k.name;
+            k.andnot_assign(x.data(), b.data(), n); g.andnot_assign(y.data(), b.data(), n);
+            EXPECT_EQ(x, y) << k.name;
+            k.flip(x.data(), n); g.flip(y.data(), n);
+            EXPECT_EQ(x, y) << k.name;
+        }
+    }
+}
+
+// 掩码求交、求异或并计数，再遍历稀疏掩码中的位
+TEST(test4, benchmark_masks)
+{
+    const size_t n = size_t(1) << 22;
+    const int rounds = 20;
+    std::mt19937_64 rng(1);
+    mystl::dynamic_bitset<> a(n), b(n), sparse(n);
+    std::vector<bool> va(n), vb(n), vsparse(n);
+    mystl::vector<char> ca(n), cb(n), csparse(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        const bool x = rng() & 1, y = rng() & 1, z = rng() % 1000 == 0;
+        a[i] = x;  b[i] = y;  sparse[i] = z;
+        va[i] = x; vb[i] = y; vsparse[i] = z;
+        ca[i] = x; cb[i] = y; csparse[i] = z;
+    }
+
+    size_t bitset_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+    {
+        auto c = a;
+        c &= b;
+        c ^= a;
+        bitset_sum += c.count();
+        for(size_t i = sparse.find_first(); i != sparse.npos; i = sparse.find_next(i))
+            bitset_sum += i & 1;
+    }
+    const long long bitset_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    size_t vbool_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+    {
+        auto c = va;
+        for(size_t i = 0; i < n; ++i) c[i] = c[i] && vb[i];
+        for(size_t i = 0; i < n; ++i) c[i] = c[i] != va[i];
+        vbool_sum += std::count(c.begin(), c.end(), true);
+        for(size_t i = 0; i < n; ++i)
+            if(vsparse[i]) vbool_sum += i & 1;
+    }
+    const long long vbool_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    size_t vchar_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+    {
+        auto c = ca;
+        for(size_t i = 0; i < n; ++i) c[i] &= cb[i];
+        for(size_t i = 0; i < n; ++i) c[i] ^= ca[i];
+        vchar_sum += std::count(c.begin(), c.end(), 1);
+        for(size_t i = 0; i < n; ++i)
+            if(csparse[i]) vchar_sum += i & 1;
+    }
+    const long long vchar_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(bitset_sum, vbool_sum);
+    EXPECT_EQ(bitset_sum, vchar_sum);
+    std::cout << "mystl::dynamic_bitset (" << mystl::bitset_kernels::get().name << "): "
+              << bitset_us << " us\n"
+              << "std::vector<bool>: " << vbool_us << " us\n"
+              << "mystl::vector<char>: " << vchar_us << " us\n";
+
+    // count() 各实现的对比
+    for(auto k : {mystl::bitset_kernels::generic(), mystl::bitset_kernels::get()})
+    {
+        size_t total = 0;
+        start = std::chrono::steady_clock::now();
+        for(int r = 0; r < rounds * 10; ++r)
+            total += k.count(a.data(), a.num_blocks());
+        const long long us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "count() " << k.name << ": " << us << " us\n";
+        EXPECT_EQ(total, a.count() * rounds * 10);
+    }
+}
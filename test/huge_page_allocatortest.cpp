@@ -0,0 +1,82 @@
+// --huge_page_allocatortest.cpp 大页分配器测试与随机访问性能对比
+#include <gtest/gtest.h>
+#include "huge_page_allocator.h"
+#include "allocator.h"
+#include "vector.h"
+#include "deque.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+TEST(test1, small_and_large)
+{
+    mystl::huge_page_allocator<double> a;
+    double* small = a.allocate(16);
+    small[15] = 1.0;
+    a.deallocate(small, 16);
+
+    const size_t n = (4 * 1024 * 1024) / sizeof(double) + 3;
+    double* big = a.allocate(n);
+#if defined(__linux__)
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(big) % HUGE_PAGE_SIZE, 0u);
+#endif
+    for(size_t i = 0; i < n; ++i) big[i] = static_cast<double>(i);
+    EXPECT_EQ(big[n - 1], static_cast<double>(n - 1));
+    a.deallocate(big, n);
+    a.deallocate(nullptr, n);
+
+    EXPECT_EQ(mystl::huge_page_base::round_up(1), static_cast<size_t>(HUGE_PAGE_SIZE));
+    EXPECT_TRUE(mystl::huge_page_allocator<int>() == mystl::huge_page_allocator<char>());
+}
+
+TEST(test2, containers)
+{
+    mystl::vector<double, mystl::huge_page_allocator<double>> v;
+    for(int i = 0; i < 1000000; ++i)
+    {
+        v.push_back(i * 0.5);
+    }
+    EXPECT_EQ(v[999999], 999999 * 0.5);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.size(), 1000000u);
+
+    mystl::deque<double, mystl::huge_page_allocator<double>> d;
+    for(int i = 0; i < 1000000; ++i)
+    {
+        d.push_back(i);
+        d.push_front(-i);
+    }
+    EXPECT_EQ(d.size(), 2000000u);
+    EXPECT_EQ(d.front(), -999999.0);
+    EXPECT_EQ(d.back(), 999999.0);
+}
+
+// 在大数组上做随机读取，页越小 TLB miss 越多
+template <typename Vec>
+static void random_access(const char* name, size_t n, size_t reads)
+{
+    Vec v(n, 1.0);
+    std::mt19937_64 gen(7);
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0.0;
+    uint64_t idx = gen();
+    for(size_t i = 0; i < reads; ++i)
+    {
+        // 线性同余生成下标，避免随机数生成本身成为瓶颈
+        idx = idx * 6364136223846793005ULL + 1442695040888963407ULL;
+        sum += v[(idx >> 17) % n];
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " us (" << sum << ")\n";
+}
+
+TEST(test3, benchmark_random_access)
+{
+    const size_t n = (256u * 1024 * 1024) / sizeof(double);
+    const size_t reads = 20000000;
+    random_access<mystl::vector<double>>("allocator", n, reads);
+    random_access<mystl::vector<double, mystl::huge_page_allocator<double>>>("huge_page_allocator", n, reads);
+}
@@ -0,0 +1,197 @@
+// --memory_resourcetest.cpp 多态内存资源测试与请求级构建/销毁性能对比
+#include <gtest/gtest.h>
+#include "memory_resource.h"
+#include "vector.h"
+#include "deque.h"
+#include "list.h"
+#include "map.h"
+#include "set.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+// 记录向上游申请/归还的字节数
+class tracking_resource: public mystl::pmr::memory_resource
+{
+public:
+    size_t  allocated = 0;
+    size_t  deallocated = 0;
+    size_t  calls = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override
+    {
+        allocated += bytes;
+        ++calls;
+        return mystl::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+    {
+        deallocated += bytes;
+        mystl::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+TEST(test1, default_resource)
+{
+    using namespace mystl::pmr;
+    EXPECT_EQ(get_default_resource(), new_delete_resource());
+    EXPECT_THROW(null_memory_resource()->allocate(8), std::bad_alloc);
+
+    tracking_resource tr;
+    memory_resource* old = set_default_resource(&tr);
+    EXPECT_EQ(old, new_delete_resource());
+    {
+        vector<int> v;
+        v.push_back(1);
+        EXPECT_EQ(v.get_allocator().resource(), &tr);
+    }
+    EXPECT_GT(tr.allocated, 0u);
+    EXPECT_EQ(tr.allocated, tr.deallocated);
+    set_default_resource(nullptr);
+    EXPECT_EQ(get_default_resource(), new_delete_resource());
+}
+
+TEST(test2, monotonic_buffer)
+{
+    tracking_resource upstream;
+    {
+        char buffer[256];
+        mystl::pmr::monotonic_buffer_resource mr(buffer, sizeof(buffer), &upstream);
+        void* p1 = mr.allocate(16, 8);
+        void* p2 = mr.allocate(1, 1);
+        void* p3 = mr.allocate(8, 8);
+        EXPECT_GE(static_cast<char*>(p1), buffer);
+        EXPECT_LT(static_cast<char*>(p3), buffer + sizeof(buffer));
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p3) % 8, 0u);
+        EXPECT_NE(p2, p3);
+        EXPECT_EQ(upstream.calls, 0u);
+
+        // 初始缓冲区耗尽后向上游申请
+        mr.allocate(1000, 64);
+        EXPECT_EQ(upstream.calls, 1u);
+        void* aligned = mr.allocate(10, 64);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0u);
+
+        mr.release();
+        EXPECT_EQ(upstream.allocated, upstream.deallocated);
+        EXPECT_EQ(mr.allocate(16, 8), static_cast<void*>(buffer));
+    }
+    EXPECT_EQ(upstream.allocated, upstream.deallocated);
+}
+
+TEST(test3, pool_resource)
+{
+    tracking_resource upstream;
+    {
+        mystl::pmr::pool_options opts;
+        opts.largest_required_pool_block = 512;
+        mystl::pmr::unsynchronized_pool_resource pool(opts, &upstream);
+        EXPECT_EQ(pool.options().largest_required_pool_block, 512u);
+
+        void* a = pool.allocate(24, 8);
+        pool.deallocate(a, 24, 8);
+        EXPECT_EQ(pool.allocate(20, 8), a);
+
+        void* b = pool.allocate(64, 64);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0u);
+
+        // 超过最大区块的请求直接交给上游
+        size_t before = upstream.calls;
+        void* big = pool.allocate(10000, 16);
+        EXPECT_EQ(upstream.calls, before + 1);
+        pool.deallocate(big, 10000, 16);
+
+        // release 之前未释放的块也会被归还
+        pool.allocate(100000, 16);
+        mystl::pmr::list<std::string> l(&pool);
+        for(int i = 0; i < 500; ++i) l.push_back(std::to_string(i));
+        EXPECT_EQ(l.back(), "499");
+    }
+    EXPECT_EQ(upstream.allocated, upstream.deallocated);
+
+    mystl::pmr::synchronized_pool_resource spool;
+    mystl::pmr::set<int> s(&spool);
+    for(int i = 0; i < 100; ++i) s.insert(i % 10);
+    EXPECT_EQ(s.size(), 10u);
+}
+
+TEST(test4, pmr_containers)
+{
+    mystl::pmr::monotonic_buffer_resource mr;
+    mystl::pmr::vector<int> v(&mr);
+    mystl::pmr::deque<int> d(&mr);
+    mystl::pmr::map<int, std::string> m(&mr);
+    mystl::pmr::multimap<int, int> mm(&mr);
+    mystl::pmr::multiset<int> ms(&mr);
+    for(int i = 0; i < 1000; ++i)
+    {
+        v.push_back(i);
+        d.push_front(i);
+        mm.insert(mystl::make_pair(i % 3, i));
+        ms.insert(i % 5);
+    }
+    m[1] = "one";
+    EXPECT_EQ(v.get_allocator().resource(), &mr);
+    EXPECT_EQ(d.get_allocator().resource(), &mr);
+    EXPECT_EQ(m.get_allocator().resource(), &mr);
+    EXPECT_EQ(v[999], 999);
+    EXPECT_EQ(d.front(), 999);
+    EXPECT_EQ(mm.count(1), 333u);
+    EXPECT_EQ(ms.count(4), 200u);
+
+    // 拷贝构造不传播资源，移动构造传播
+    mystl::pmr::vector<int> copy(v);
+    EXPECT_EQ(copy.get_allocator().resource(), mystl::pmr::get_default_resource());
+    mystl::pmr::vector<int> moved(mystl::move(v));
+    EXPECT_EQ(moved.get_allocator().resource(), &mr);
+    EXPECT_EQ(moved.size(), 1000u);
+}
+
+// 模拟一次请求：构建一个 map 与一个 vector，然后全部销毁
+template <typename Map, typename Vec, typename... Args>
+static size_t request_cycle(int n, Args&&... args)
+{
+    Map m(args...);
+    Vec v(args...);
+    for(int i = 0; i < n; ++i)
+    {
+        m.insert(mystl::make_pair(i * 31 % n, i));
+        v.push_back(i);
+    }
+    return m.size() + v.size();
+}
+
+TEST(test5, benchmark_request_scope)
+{
+    const int requests = 2000;
+    const int n = 200;
+    size_t sum = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < requests; ++r)
+    {
+        sum += request_cycle<mystl::map<int, int>, mystl::vector<int>>(n);
+    }
+    auto mid = std::chrono::steady_clock::now();
+
+    char buffer[64 * 1024];
+    for(int r = 0; r < requests; ++r)
+    {
+        mystl::pmr::monotonic_buffer_resource mr(buffer, sizeof(buffer));
+        sum += request_cycle<mystl::pmr::map<int, int>, mystl::pmr::vector<int>>(n, &mr);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    std::cout << "allocator: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << " us\n"
+              << "monotonic_buffer_resource: "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count() << " us ("
+              << sum << ")\n";
+}
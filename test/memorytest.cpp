@@ -0,0 +1,327 @@
+// --memorytest.cpp 智能指针测试与 shared_ptr 性能对比
+#include <gtest/gtest.h>
+#include "memory.h"
+#include "stats_allocator.h"
+#include "vector.h"
+#include "map.h"
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct counted
+{
+    static int live;
+    int value;
+    explicit counted(int v = 0): value(v) { ++live; }
+    virtual ~counted() { --live; }
+};
+int counted::live = 0;
+
+struct derived: counted
+{
+    explicit derived(int v): counted(v) {}
+};
+
+struct counting_deleter
+{
+    int* calls;
+    void operator()(counted* p) const
+    {
+        ++*calls;
+        delete p;
+    }
+};
+
+TEST(test1, unique_ptr)
+{
+    EXPECT_EQ(sizeof(mystl::unique_ptr<int>), sizeof(int*));
+    EXPECT_EQ(sizeof(mystl::unique_ptr<int[]>), sizeof(int*));
+    {
+        mystl::unique_ptr<counted> p(new counted(1));
+        EXPECT_EQ(counted::live, 1);
+        EXPECT_EQ(p->value, 1);
+        mystl::unique_ptr<counted> q(mystl::move(p));
+        EXPECT_TRUE(p == nullptr);
+        EXPECT_TRUE(q != nullptr);
+        q.reset(new counted(2));
+        EXPECT_EQ(counted::live, 1);
+        EXPECT_EQ((*q).value, 2);
+
+        mystl::unique_ptr<counted> b = mystl::make_unique<derived>(3);
+        EXPECT_EQ(b->value, 3);
+        b = mystl::move(q);
+        EXPECT_EQ(b->value, 2);
+        EXPECT_EQ(counted::live, 1);
+        delete b.release();
+        EXPECT_FALSE(b);
+    }
+    EXPECT_EQ(counted::live, 0);
+
+    int calls = 0;
+    {
+        mystl::unique_ptr<counted, counting_deleter> p(new counted(), counting_deleter{&calls});
+        EXPECT_EQ(sizeof(p), sizeof(counted*) + sizeof(counting_deleter));
+    }
+    EXPECT_EQ(calls, 1);
+
+    auto arr = mystl::make_unique<int[]>(10);
+    for(int i = 0; i < 10; ++i) EXPECT_EQ(arr[i], 0);
+    arr[3] = 3;
+    EXPECT_EQ(arr.get()[3], 3);
+}
+
+TEST(test2, shared_ptr)
+{
+    {
+        mystl::shared_ptr<counted> p(new counted(1));
+        EXPECT_EQ(p.use_count(), 1);
+        {
+            mystl::shared_ptr<counted> q = p;
+            EXPECT_EQ(p.use_count(), 2);
+            EXPECT_EQ(q->value, 1);
+        }
+        EXPECT_EQ(p.use_count(), 1);
+
+        mystl::shared_ptr<counted> d = mystl::make_shared<derived>(2);
+        auto dd = mystl::dynamic_pointer_cast<derived>(d);
+        EXPECT_TRUE(dd != nullptr);
+        EXPECT_EQ(d.use_count(), 2);
+        p = d;
+        EXPECT_EQ(counted::live, 1);
+        EXPECT_EQ(p.use_count(), 3);
+
+        // 别名构造
+        mystl::shared_ptr<int> v(p, &p->value);
+        EXPECT_EQ(*v, 2);
+        EXPECT_EQ(p.use_count(), 4);
+        p.reset();
+        d.reset();
+        dd.reset();
+        EXPECT_EQ(counted::live, 1);
+        EXPECT_EQ(v.use_count(), 1);
+    }
+    EXPECT_EQ(counted::live, 0);
+
+    int calls = 0;
+    {
+        mystl::shared_ptr<counted> p(new counted(), counting_deleter{&calls});
+        mystl::shared_ptr<counted> q(mystl::move(p));
+        EXPECT_FALSE(p);
+        EXPECT_EQ(q.use_count(), 1);
+    }
+    EXPECT_EQ(calls, 1);
+
+    {
+        mystl::unique_ptr<counted> u(new counted(5));
+        mystl::shared_ptr<counted> s(mystl::move(u));
+        EXPECT_FALSE(u);
+        EXPECT_EQ(s->value, 5);
+    }
+    EXPECT_EQ(counted::live, 0);
+
+    mystl::shared_ptr<const std::string> cs = mystl::make_shared<const std::string>(3, 'x');
+    EXPECT_EQ(*cs, "xxx");
+}
+
+TEST(test3, weak_ptr)
+{
+    mystl::weak_ptr<counted> w;
+    EXPECT_TRUE(w.expired());
+    EXPECT_FALSE(w.lock());
+    {
+        auto p = mystl::make_shared<counted>(7);
+        w = p;
+        EXPECT_FALSE(w.expired());
+        EXPECT_EQ(w.use_count(), 1);
+        auto q = w.lock();
+        EXPECT_EQ(q->value, 7);
+        EXPECT_EQ(p.use_count(), 2);
+        mystl::shared_ptr<counted> r(w);
+        EXPECT_EQ(p.use_count(), 3);
+    }
+    EXPECT_TRUE(w.expired());
+    EXPECT_EQ(counted::live, 0);
+    EXPECT_FALSE(w.lock());
+    EXPECT_THROW(mystl::shared_ptr<counted>{w}, std::bad_weak_ptr);
+}
+
+// 控制块与对象只有一次分配
+struct shared_tag {};
+
+TEST(test4, allocate_shared_single_allocation)
+{
+    typedef mystl::alloc_stats<shared_tag> st;
+    {
+        auto p = mystl::allocate_shared<std::string>(mystl::stats_allocator<std::string, shared_tag>(), "abc");
+        EXPECT_EQ(*p, "abc");
+        EXPECT_EQ(st::snapshot().allocations, 1u);
+        mystl::weak_ptr<std::string> w = p;
+        p.reset();
+        // 对象已析构，但控制块仍被 weak_ptr 持有
+        EXPECT_TRUE(w.expired());
+        EXPECT_EQ(st::snapshot().live_allocations(), 1u);
+    }
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+
+    struct throws
+    {
+        throws() { throw 1; }
+    };
+    EXPECT_THROW(mystl::allocate_shared<throws>(mystl::stats_allocator<throws, shared_tag>()), int);
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+}
+
+// 创建、复制、销毁的混合负载
+template <template <typename> class Ptr, typename Make>
+long long churn(Make make, int rounds)
+{
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for(int r = 0; r < rounds; ++r)
+    {
+        Ptr<int> p = make(r);
+        Ptr<int> copies[8];
+        for(auto& c : copies) c = p;
+        sum += *copies[r % 8] + static_cast<long long>(p.use_count());
+    }
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_GT(sum, 0);
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+// 在创建任何线程之前运行，此时引用计数不使用原子的读-改-写
+TEST(test5, benchmark_churn)
+{
+    const int rounds = 1000000;
+    auto my_make = [](int v) { return mystl::make_shared<int>(v); };
+    auto std_make = [](int v) { return std::make_shared<int>(v); };
+    std::cout << "mystl::shared_ptr: " << churn<mystl::shared_ptr>(my_make, rounds) << " us\n"
+              << "std::shared_ptr: " << churn<std::shared_ptr>(std_make, rounds) << " us\n";
+}
+
+TEST(test6, concurrent_refcount)
+{
+    auto p = mystl::make_shared<counted>(1);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([p]() {
+            for(int i = 0; i < 100000; ++i)
+            {
+                mystl::shared_ptr<counted> q = p;
+                mystl::weak_ptr<counted> w = q;
+                EXPECT_TRUE(w.lock());
+            }
+        });
+    }
+    for(auto& th : threads) th.join();
+    EXPECT_EQ(p.use_count(), 1);
+    p.reset();
+    EXPECT_EQ(counted::live, 0);
+}
+
+struct config_node: mystl::ref_counted<config_node>
+{
+    static int live;
+    int value;
+    mystl::vector<mystl::intrusive_ptr<config_node>> children;
+    explicit config_node(int v): value(v) { ++live; }
+    config_node(const config_node& rhs): mystl::ref_counted<config_node>(rhs), value(rhs.value) { ++live; }
+    ~config_node() { --live; }
+};
+int config_node::live = 0;
+
+struct local_node: mystl::ref_counted<local_node, false>
+{
+    int value = 0;
+};
+
+TEST(test7, intrusive_ptr)
+{
+    EXPECT_EQ(sizeof(mystl::intrusive_ptr<config_node>), sizeof(config_node*));
+    EXPECT_TRUE(mystl::is_trivially_relocatable<mystl::intrusive_ptr<config_node>>::value);
+    EXPECT_TRUE(mystl::is_trivially_relocatable<mystl::shared_ptr<int>>::value);
+    EXPECT_TRUE(mystl::is_trivially_relocatable<mystl::unique_ptr<int>>::value);
+    {
+        auto root = mystl::make_intrusive<config_node>(0);
+        EXPECT_EQ(root->use_count(), 1);
+        for(int i = 1; i <= 3; ++i)
+            root->children.push_back(mystl::make_intrusive<config_node>(i));
+        // 共享子树
+        auto shared = root->children[1];
+        root->children.push_back(shared);
+        EXPECT_EQ(shared->use_count(), 3);
+        EXPECT_EQ(config_node::live, 4);
+
+        // 从裸指针重新得到所有权，计数仍在对象内
+        config_node* raw = shared.get();
+        mystl::intrusive_ptr<config_node> again(raw);
+        EXPECT_EQ(raw->use_count(), 4);
+        EXPECT_TRUE(again == shared);
+
+        // 复制对象不复制计数
+        mystl::intrusive_ptr<config_node> copy(new config_node(*raw));
+        EXPECT_EQ(copy->use_count(), 1);
+
+        config_node* detached = again.detach();
+        EXPECT_FALSE(again);
+        mystl::intrusive_ptr<config_node> adopted(detached, false);
+        EXPECT_EQ(raw->use_count(), 4);
+    }
+    EXPECT_EQ(config_node::live, 0);
+
+    mystl::intrusive_ptr<local_node> l(new local_node);
+    mystl::intrusive_ptr<local_node> m = l;
+    EXPECT_EQ(l->use_count(), 2);
+    m.reset();
+    EXPECT_EQ(l->use_count(), 1);
+}
+
+TEST(test8, intrusive_ptr_in_containers)
+{
+    {
+        // 扩容时按字节搬移，计数不变
+        mystl::vector<mystl::intrusive_ptr<config_node>> v;
+        for(int i = 0; i < 1000; ++i)
+            v.push_back(mystl::make_intrusive<config_node>(i));
+        v.insert(v.begin(), v[999]);
+        v.erase(v.begin() + 500);
+        EXPECT_EQ(config_node::live, 999);
+        EXPECT_EQ(v[0]->use_count(), 2);
+        EXPECT_EQ(v[1]->use_count(), 1);
+
+        mystl::map<int, mystl::intrusive_ptr<config_node>> m;
+        for(auto& p : v)
+            m[p->value] = p;
+        EXPECT_EQ(m.size(), 999u);
+        EXPECT_EQ(m[999]->use_count(), 3);
+        v.clear();
+        EXPECT_EQ(m[0]->use_count(), 1);
+        m.erase(0);
+        EXPECT_EQ(config_node::live, 998);
+    }
+    EXPECT_EQ(config_node::live, 0);
+}
+
+TEST(test9, intrusive_concurrent_refcount)
+{
+    auto p = mystl::make_intrusive<config_node>(1);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([p]() {
+            for(int i = 0; i < 100000; ++i)
+            {
+                mystl::intrusive_ptr<config_node> q = p;
+                EXPECT_TRUE(q);
+            }
+        });
+    }
+    for(auto& th : threads) th.join();
+    EXPECT_EQ(p->use_count(), 1);
+    p.reset();
+    EXPECT_EQ(config_node::live, 0);
+}
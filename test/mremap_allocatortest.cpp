@@ -0,0 +1,110 @@
+// --mremap_allocatortest.cpp mremap 分配器测试与大型 vector 追加性能对比
+#include <gtest/gtest.h>
+#include "mremap_allocator.h"
+#include "allocator.h"
+#include "vector.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+TEST(test1, allocate_and_reallocate)
+{
+    typedef mystl::mremap_allocator<uint64_t> alloc;
+    const size_t small = 100;
+    const size_t large = (4 * 1024 * 1024) / sizeof(uint64_t);
+
+    uint64_t* p = alloc::allocate(small);
+    for(size_t i = 0; i < small; ++i) p[i] = i;
+    // 小 -> 大: 复制
+    p = alloc::reallocate(p, small, large);
+    EXPECT_EQ(p[small - 1], small - 1);
+    for(size_t i = small; i < large; ++i) p[i] = i;
+    // 大 -> 更大: mremap
+    p = alloc::reallocate(p, large, large * 4);
+#if defined(__linux__)
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % mystl::mremap_base::page_size(), 0u);
+#endif
+    EXPECT_EQ(p[large - 1], large - 1);
+    p[large * 4 - 1] = 7;
+    // 大 -> 小
+    p = alloc::reallocate(p, large * 4, small);
+    EXPECT_EQ(p[small - 1], small - 1);
+    alloc::deallocate(p, small);
+
+    EXPECT_EQ(alloc::reallocate(nullptr, 0, 0), nullptr);
+    EXPECT_TRUE(mystl::alloc_has_reallocate<alloc>::value);
+    EXPECT_FALSE(mystl::alloc_has_reallocate<mystl::allocator<uint64_t>>::value);
+
+    // 未提供 reallocate 的分配器由 allocator_traits 分配新空间并复制
+    mystl::allocator<int> a;
+    int* q = a.allocate(4);
+    q[3] = 3;
+    q = mystl::allocator_traits<mystl::allocator<int>>::reallocate(a, q, 4, 8);
+    EXPECT_EQ(q[3], 3);
+    a.deallocate(q, 8);
+}
+
+// 可平凡重定位，但构造可能抛出异常
+struct maybe_throw
+{
+    int value;
+    maybe_throw(int v): value(v)
+    {
+        if(v < 0) throw v;
+    }
+};
+
+TEST(test2, vector_growth)
+{
+    mystl::vector<uint64_t, mystl::mremap_allocator<uint64_t>> v;
+    const size_t n = 2000000;
+    for(size_t i = 0; i < n; ++i) v.push_back(i);
+    EXPECT_EQ(v[n - 1], n - 1);
+
+    // 扩容时插入的元素引用容器自身
+    while(v.size() != v.capacity()) v.push_back(0);
+    v.push_back(v[1]);
+    EXPECT_EQ(v.back(), 1u);
+    while(v.size() != v.capacity()) v.push_back(0);
+    v.insert(v.begin() + 1, v[2]);
+    EXPECT_EQ(v[1], 2u);
+    EXPECT_EQ(v[3], 2u);
+    while(v.size() != v.capacity()) v.push_back(0);
+    v.insert(v.begin(), 3, v[10]);
+    EXPECT_EQ(v[0], 9u);
+    EXPECT_EQ(v[2], 9u);
+    EXPECT_EQ(v[3], 0u);
+
+    v.resize(10);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 10u);
+    v.reserve(1000000);
+    EXPECT_EQ(v[9], 5u);
+
+    mystl::vector<maybe_throw, mystl::mremap_allocator<maybe_throw>> w;
+    while(w.size() != w.capacity()) w.emplace_back(1);
+    const size_t size = w.size();
+    EXPECT_THROW(w.emplace_back(-1), int);
+    EXPECT_EQ(w.size(), size);
+}
+
+// 逐个追加 bytes 字节的 uint64_t
+template <typename Vec>
+long long append(size_t bytes)
+{
+    auto start = std::chrono::steady_clock::now();
+    Vec v;
+    const size_t n = bytes / sizeof(uint64_t);
+    for(size_t i = 0; i < n; ++i) v.push_back(i);
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_EQ(v[n - 1], n - 1);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+}
+
+TEST(test3, benchmark_append_1gb)
+{
+    const size_t bytes = static_cast<size_t>(1) << 30;
+    std::cout << "mremap_allocator: "
+              << append<mystl::vector<uint64_t, mystl::mremap_allocator<uint64_t>>>(bytes) << " ms\n"
+              << "allocator: " << append<mystl::vector<uint64_t>>(bytes) << " ms\n";
+}
@@ -0,0 +1,116 @@
+// --pool_allocatortest.cpp 内存池分配器测试与性能对比
+#include <gtest/gtest.h>
+#include "pool_allocator.h"
+#include "allocator.h"
+#include "list.h"
+#include "map.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+TEST(test1, size_class)
+{
+    EXPECT_EQ(mystl::pool_alloc_base::round_up(1), 8u);
+    EXPECT_EQ(mystl::pool_alloc_base::round_up(8), 8u);
+    EXPECT_EQ(mystl::pool_alloc_base::round_up(9), 16u);
+    EXPECT_EQ(mystl::pool_alloc_base::freelist_index(1), 0u);
+    EXPECT_EQ(mystl::pool_alloc_base::freelist_index(8), 0u);
+    EXPECT_EQ(mystl::pool_alloc_base::freelist_index(256), 31u);
+}
+
+TEST(test2, reuse_freed_block)
+{
+    mystl::pool_allocator<int> a;
+    int* p = a.allocate(3);
+    a.deallocate(p, 3);
+    // 同一大小类别的空闲链表是后进先出的
+    int* q = a.allocate(4);
+    EXPECT_EQ(p, q);
+    a.deallocate(q, 4);
+    a.deallocate(nullptr, 1);
+    EXPECT_EQ(a.allocate(0), nullptr);
+}
+
+TEST(test3, large_and_overaligned)
+{
+    mystl::pool_allocator<char> a;
+    char* big = a.allocate(4096);
+    for(int i = 0; i < 4096; ++i) big[i] = static_cast<char>(i);
+    EXPECT_EQ(big[4095], static_cast<char>(4095));
+    a.deallocate(big, 4096);
+
+    struct alignas(32) wide { char c[32]; };
+    EXPECT_FALSE(mystl::pool_allocator<wide>::use_pool);
+    mystl::pool_allocator<wide> w;
+    wide* pw = w.allocate(2);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(pw) % alignof(std::max_align_t), 0u);
+    w.deallocate(pw, 2);
+}
+
+TEST(test4, traits_and_rebind)
+{
+    typedef mystl::allocator_traits<mystl::pool_allocator<int>> traits;
+    EXPECT_TRUE(traits::is_always_equal::value);
+    EXPECT_TRUE((std::is_same<traits::rebind_alloc<double>, mystl::pool_allocator<double>>::value));
+    EXPECT_TRUE(mystl::pool_allocator<int>() == mystl::pool_allocator<double>());
+    EXPECT_EQ(sizeof(mystl::list<int, mystl::pool_allocator<int>>), 2 * sizeof(void*));
+}
+
+TEST(test5, containers)
+{
+    mystl::list<std::string, mystl::pool_allocator<std::string>> l;
+    mystl::map<int, int, mystl::less<int>, mystl::pool_allocator<mystl::pair<const int, int>>> m;
+    for(int i = 0; i < 1000; ++i)
+    {
+        l.push_back(std::to_string(i));
+        m[i] = i * i;
+    }
+    EXPECT_EQ(l.size(), 1000u);
+    EXPECT_EQ(l.back(), "999");
+    EXPECT_EQ(m[30], 900);
+    for(int i = 0; i < 1000; i += 2)
+    {
+        m.erase(i);
+    }
+    EXPECT_EQ(m.size(), 500u);
+    l.clear();
+    EXPECT_TRUE(l.empty());
+}
+
+// 节点容器反复插入、删除时两种分配器的耗时对比
+template <typename List, typename Map>
+static void node_churn(const char* name, int n, int rounds)
+{
+    auto start = std::chrono::steady_clock::now();
+    long sum = 0;
+    for(int r = 0; r < rounds; ++r)
+    {
+        List l;
+        Map m;
+        for(int i = 0; i < n; ++i)
+        {
+            l.push_back(i);
+            m.insert(mystl::make_pair(i * 7 % n, i));
+        }
+        for(int i = 0; i < n; i += 2)
+        {
+            l.pop_front();
+            m.erase(i);
+        }
+        sum += static_cast<long>(l.size() + m.size());
+    }
+    auto end = std::chrono::steady_clock::now();
+    std::cout << name << ": "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " us (" << sum << ")\n";
+}
+
+TEST(test6, benchmark_node_churn)
+{
+    const int n = 100000;
+    const int rounds = 5;
+    typedef mystl::pair<const int, int> value_type;
+    node_churn<mystl::list<int>, mystl::map<int, int>>("allocator", n, rounds);
+    node_churn<mystl::list<int, mystl::pool_allocator<int>>,
+               mystl::map<int, int, mystl::less<int>, mystl::pool_allocator<value_type>>>("pool_allocator", n, rounds);
+}
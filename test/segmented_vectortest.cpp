@@ -0,0 +1,269 @@
+// --segmented_vectortest.cpp segmented_vector 测试与追加、遍历时与 vector、deque 的性能对比
+#include <gtest/gtest.h>
+#include "segmented_vector.h"
+#include "vector.h"
+#include "deque.h"
+#include "heap_algo.h"
+#include "numeric.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+
+struct counted
+{
+    static int live;
+    static int countdown;
+    int value;
+    counted(int v = 0): value(v)
+    {
+        if(countdown-- == 0) throw std::runtime_error("construct");
+        ++live;
+    }
+    counted(const counted& rhs): value(rhs.value)
+    {
+        if(countdown-- == 0) throw std::runtime_error("copy");
+        ++live;
+    }
+    counted& operator=(const counted&) = default;
+    ~counted() { --live; }
+};
+int counted::live = 0;
+int counted::countdown = -1;
+
+// 复制赋值、交换时传播的有状态分配器，按编号记录各实例尚未释放的元素个数
+template <typename T>
+struct tagged_allocator
+{
+    typedef T               value_type;
+    typedef std::true_type  propagate_on_container_copy_assignment;
+    typedef std::true_type  propagate_on_container_move_assignment;
+    typedef std::true_type  propagate_on_container_swap;
+
+    int   id;
+    long* live;
+
+    tagged_allocator(int i, long* l) noexcept: id(i), live(l) {}
+    template <typename U>
+    tagged_allocator(const tagged_allocator<U>& rhs) noexcept: id(rhs.id), live(rhs.live) {}
+
+    T* allocate(size_t n)
+    {
+        live[id] += static_cast<long>(n);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n)
+    {
+        live[id] -= static_cast<long>(n);
+        ::operator delete(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs)
+{ return lhs.id == rhs.id; }
+
+template <typename T, typename U>
+bool operator!=(const tagged_allocator<T>& lhs, const tagged_allocator<U>& rhs)
+{ return !(lhs == rhs); }
+
+TEST(test1, stable_addresses)
+{
+    mystl::segmented_vector<std::string, 4> v;
+    static_assert(decltype(v)::block_shift == 2, "");
+    static_assert(mystl::segmented_block_size<int>::value == 1024, "");
+    static_assert(mystl::segmented_block_size<char[3]>::value == 1024, "");
+    EXPECT_TRUE(v.empty());
+
+    v.push_back("0");
+    const std::string* first = &v[0];
+    for(int i = 1; i < 100; ++i)
+        v.emplace_back(std::to_string(i));
+    // 扩容不移动元素，指针与引用都有效
+    EXPECT_EQ(first, &v[0]);
+    EXPECT_EQ(v.size(), 100u);
+    EXPECT_EQ(v.capacity(), 100u);
+    EXPECT_EQ(v.block_count(), 25u);
+    EXPECT_EQ(&v[5], v.block_data(1) + 1);
+
+    std::vector<const std::string*> addr;
+    for(auto& s : v) addr.push_back(&s);
+    v.reserve(1000);
+    v.resize(500, "x");
+    for(size_t i = 0; i < addr.size(); ++i)
+        EXPECT_EQ(addr[i], &v[i]);
+
+    EXPECT_EQ(v[42], "42");
+    EXPECT_EQ(v.back(), "x");
+    EXPECT_THROW(v.at(500), std::out_of_range);
+    v.pop_back();
+    v.resize(100);
+    EXPECT_EQ(v.back(), "99");
+    EXPECT_EQ(v.capacity(), 1000u);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 100u);
+    EXPECT_EQ(first, &v[0]);
+
+    auto w = v;
+    EXPECT_TRUE(w == v);
+    w[3] = "three";
+    EXPECT_TRUE(w != v);
+    EXPECT_TRUE(v < w);
+    // 迭代器只引用块表，移动与 swap 后仍指向原来的元素
+    auto it = w.begin() + 3;
+    auto m = mystl::move(w);
+    EXPECT_TRUE(w.empty());
+    EXPECT_EQ(m[3], "three");
+    EXPECT_EQ(&*it, &m[3]);
+    m.swap(v);
+    EXPECT_EQ(v[3], "three");
+    EXPECT_EQ(&*it, &v[3]);
+    EXPECT_TRUE(it + 97 == v.end());
+    // 可平凡重定位: 按字节搬移容器后迭代器仍然有效
+    typedef decltype(v) svec;
+    static_assert(mystl::is_trivially_relocatable<svec>::value, "");
+    alignas(svec) unsigned char buf[sizeof(svec)];
+    svec* moved = reinterpret_cast<svec*>(buf);
+    mystl::uninitialized_relocate(&v, &v + 1, moved);
+    EXPECT_EQ(&*it, &(*moved)[3]);
+    mystl::uninitialized_relocate(moved, moved + 1, &v);
+    v = {"a", "b"};
+    EXPECT_EQ(v.size(), 2u);
+    std::list<std::string> l{"c", "d", "e"};
+    v.assign(l.begin(), l.end());
+    EXPECT_EQ(v.front(), "c");
+    EXPECT_EQ(*v.rbegin(), "e");
+    v.clear();
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(test2, random_access_algorithms)
+{
+    mystl::segmented_vector<int, 8> v(100);
+    mystl::iota(v.begin(), v.end(), 0);
+    EXPECT_EQ(mystl::accumulate(v.begin(), v.end(), 0), 4950);
+    EXPECT_EQ(v.end() - v.begin(), 100);
+    EXPECT_EQ(v.begin()[37], 37);
+    EXPECT_EQ(*(3 + v.begin()), 3);
+
+    // 打乱后用堆排序恢复有序
+    for(size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<int>((i * 37) % 100);
+    mystl::make_heap(v.begin(), v.end());
+    EXPECT_EQ(v.front(), 99);
+    mystl::sort_heap(v.begin(), v.end());
+    for(int i = 0; i < 100; ++i)
+        EXPECT_EQ(v[i], i);
+
+    const auto& cv = v;
+    mystl::segmented_vector<int, 8>::const_iterator cit = v.begin();
+    EXPECT_TRUE(cit == cv.begin());
+    std::vector<int> diff(100);
+    mystl::adjacent_difference(cv.begin(), cv.end(), diff.begin());
+    EXPECT_EQ(mystl::accumulate(diff.begin(), diff.end(), 0), 99);
+}
+
+TEST(test3, exception_safety)
+{
+    {
+        mystl::segmented_vector<counted, 4> v;
+        for(int i = 0; i < 6; ++i)
+            v.emplace_back(i);
+        EXPECT_EQ(counted::live, 6);
+
+        // 构造失败时已有元素不受影响
+        counted::countdown = 0;
+        EXPECT_THROW(v.emplace_back(6), std::runtime_error);
+        EXPECT_EQ(v.size(), 6u);
+        EXPECT_EQ(counted::live, 6);
+
+        counted::countdown = 3;
+        EXPECT_THROW(v.resize(20), std::runtime_error);
+        EXPECT_EQ(static_cast<size_t>(counted::live), v.size());
+        EXPECT_EQ(v[5].value, 5);
+
+        counted::countdown = 4;
+        EXPECT_THROW((mystl::segmented_vector<counted, 4>(v)), std::runtime_error);
+        EXPECT_EQ(static_cast<size_t>(counted::live), v.size());
+        counted::countdown = -1;
+
+        mystl::segmented_vector<counted, 4> copy(v);
+        EXPECT_EQ(static_cast<size_t>(counted::live), 2 * v.size());
+        copy.clear();
+        EXPECT_EQ(static_cast<size_t>(counted::live), v.size());
+        copy = v;
+        EXPECT_EQ(copy.size(), v.size());
+    }
+    EXPECT_EQ(counted::live, 0);
+}
+
+// 分配器随复制赋值、交换传播，每个实例只释放自己分配的内存
+TEST(test4, allocator_propagation)
+{
+    typedef mystl::segmented_vector<int, 4, tagged_allocator<int>> vec;
+    long live[3] = {0, 0, 0};
+    {
+        vec a(tagged_allocator<int>(1, live));
+        vec b(tagged_allocator<int>(2, live));
+        for(int i = 0; i < 10; ++i)
+            a.push_back(i);
+        b.push_back(100);
+
+        a.swap(b);
+        EXPECT_EQ(a.get_allocator().id, 2);
+        EXPECT_EQ(b.get_allocator().id, 1);
+        EXPECT_EQ(b.size(), 10u);
+        EXPECT_EQ(a[0], 100);
+        b.shrink_to_fit();
+        a.push_back(101);
+        a.pop_back();
+        a.shrink_to_fit();
+
+        vec c(tagged_allocator<int>(0, live));
+        c.push_back(7);
+        c = b;
+        EXPECT_EQ(c.get_allocator().id, 1);
+        EXPECT_EQ(c.size(), 10u);
+        EXPECT_EQ(c[9], 9);
+        EXPECT_EQ(live[0], 0);
+    }
+    EXPECT_EQ(live[0], 0);
+    EXPECT_EQ(live[1], 0);
+    EXPECT_EQ(live[2], 0);
+}
+
+// 追加 n 个元素后按下标、按迭代器各求和一次
+template <typename Container>
+long long bench_push_and_sum(uint64_t& sum)
+{
+    const size_t n = 2000000;
+    const int rounds = 10;
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+    {
+        Container c;
+        for(size_t i = 0; i < n; ++i)
+            c.push_back(i);
+        for(size_t i = 0; i < n; ++i)
+            sum += c[i];
+        for(auto x : c)
+            sum += x;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+TEST(test5, benchmark_push_back_and_sum)
+{
+    uint64_t vector_sum = 0, deque_sum = 0, segmented_sum = 0;
+    const long long vector_us = bench_push_and_sum<mystl::vector<uint64_t>>(vector_sum);
+    const long long deque_us = bench_push_and_sum<mystl::deque<uint64_t>>(deque_sum);
+    const long long segmented_us = bench_push_and_sum<mystl::segmented_vector<uint64_t>>(segmented_sum);
+    EXPECT_EQ(vector_sum, deque_sum);
+    EXPECT_EQ(vector_sum, segmented_sum);
+    std::cout << "mystl::vector: " << vector_us << " us\n"
+              << "mystl::deque: " << deque_us << " us\n"
+              << "mystl::segmented_vector: " << segmented_us << " us\n";
+}
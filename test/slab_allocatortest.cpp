@@ -0,0 +1,164 @@
+// --slab_allocatortest.cpp slab 节点分配器测试与遍历性能对比
+#include <gtest/gtest.h>
+#include "slab_allocator.h"
+#include "allocator.h"
+#include "list.h"
+#include "map.h"
+#include "set.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <algorithm>
+#include <vector>
+#include <string>
+
+typedef mystl::pair<const int, int> value_type;
+typedef mystl::map<int, int, mystl::less<int>, mystl::slab_allocator<value_type>> slab_map;
+
+TEST(test1, arena)
+{
+    mystl::slab_allocator<long> a;
+    long* p1 = a.allocate(1);
+    long* p2 = a.allocate(1);
+    // 同一 slab 中相邻切出
+    EXPECT_EQ(p2, p1 + 1);
+    EXPECT_EQ(a.live(), 2u);
+    a.deallocate(p1, 1);
+    EXPECT_EQ(a.allocate(1), p1);
+
+    struct alignas(64) line { char c[64]; };
+    mystl::slab_allocator<line> b(a);
+    EXPECT_TRUE(a == b);
+    line* l = b.allocate(1);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(l) % 64, 0u);
+    b.deallocate(l, 1);
+
+    // 多个元素的请求回退到 ::operator new
+    long* arr = a.allocate(100);
+    a.deallocate(arr, 100);
+    EXPECT_EQ(a.live(), 2u);
+
+    mystl::slab_allocator<long> other;
+    EXPECT_TRUE(a != other);
+    EXPECT_TRUE(a.select_on_container_copy_construction() != a);
+    a.release();
+    EXPECT_EQ(a.live(), 0u);
+}
+
+TEST(test2, list_release)
+{
+    mystl::list<std::string, mystl::slab_allocator<std::string>> l;
+    for(int i = 0; i < 2000; ++i)
+    {
+        l.push_back(std::to_string(i) + " - a string long enough to live on the heap");
+    }
+    l.erase(l.begin());
+    EXPECT_EQ(l.size(), 1999u);
+    l.clear();
+    EXPECT_TRUE(l.empty());
+    l.push_back("again");
+    EXPECT_EQ(l.front(), "again");
+
+    // 共享 arena 的另一个容器仍有节点时不能整体回收
+    mystl::list<int, mystl::slab_allocator<int>> a;
+    a.push_back(1);
+    mystl::list<int, mystl::slab_allocator<int>> b(a.get_allocator());
+    b.push_back(2);
+    b.push_back(3);
+    b.clear();
+    EXPECT_EQ(a.front(), 1);
+    a.push_back(4);
+    EXPECT_EQ(a.size(), 2u);
+}
+
+TEST(test3, tree_release)
+{
+    slab_map m;
+    for(int i = 0; i < 10000; ++i)
+    {
+        m[i] = i;
+    }
+    for(int i = 0; i < 10000; i += 3)
+    {
+        m.erase(i);
+    }
+    EXPECT_EQ(m.size(), 6666u);
+
+    // 拷贝得到的容器使用独立的 arena
+    slab_map copy(m);
+    EXPECT_TRUE(copy.get_allocator() != m.get_allocator());
+    EXPECT_TRUE(copy == m);
+
+    // arena 不同，元素被逐个移动到目标容器的 arena 中
+    slab_map moved;
+    auto moved_alloc = moved.get_allocator();
+    moved = mystl::move(copy);
+    EXPECT_TRUE(moved.get_allocator() == moved_alloc);
+    EXPECT_TRUE(moved == m);
+
+    m.clear();
+    EXPECT_TRUE(m.empty());
+    m[1] = 1;
+    EXPECT_EQ(m.size(), 1u);
+    EXPECT_EQ(moved[9998], 9998);
+
+    typedef mystl::set<std::string, mystl::less<std::string>, mystl::slab_allocator<std::string>> slab_set;
+    slab_set s1, s2;
+    for(int i = 0; i < 1000; ++i)
+    {
+        s1.insert(std::to_string(i) + " - a string long enough to live on the heap");
+    }
+    s2.insert("x");
+    auto alloc1 = s1.get_allocator();
+    // swap 传播分配器，节点与其 arena 一起交换
+    s1.swap(s2);
+    EXPECT_TRUE(s2.get_allocator() == alloc1);
+    EXPECT_EQ(s2.size(), 1000u);
+    EXPECT_EQ(s1.size(), 1u);
+}
+
+// 以随机顺序插入构建 map，再顺序遍历
+template <typename Map>
+static void iterate_map(const char* name, int n)
+{
+    std::mt19937 gen(42);
+    std::vector<int> keys(n);
+    for(int i = 0; i < n; ++i) keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), gen);
+
+    Map m;
+    // 默认分配器下穿插其他分配，模拟长时间运行后分散的堆
+    std::vector<std::string*> noise;
+    for(int i = 0; i < n; ++i)
+    {
+        m.insert(mystl::make_pair(keys[i], i));
+        if(i % 4 == 0) noise.push_back(new std::string(40, 'x'));
+    }
+    for(auto p : noise) delete p;
+
+    auto start = std::chrono::steady_clock::now();
+    long sum = 0;
+    for(int r = 0; r < 5; ++r)
+    {
+        for(auto it = m.begin(); it != m.end(); ++it)
+        {
+            sum += it->second;
+        }
+    }
+    auto mid = std::chrono::steady_clock::now();
+    m.clear();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << name << ": iterate "
+              << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count()
+              << " us, clear "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count()
+              << " us (" << sum << ")\n";
+}
+
+TEST(test4, benchmark_map_iteration)
+{
+    const int n = 1000000;
+    iterate_map<mystl::map<int, int>>("allocator", n);
+    iterate_map<slab_map>("slab_allocator", n);
+}
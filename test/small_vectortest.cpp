@@ -0,0 +1,181 @@
+// --small_vectortest.cpp 内联存储的 small_vector 测试与小规模负载下与 vector 的性能对比
+#include <gtest/gtest.h>
+#include "small_vector.h"
+#include "stats_allocator.h"
+#include "vector.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+
+struct inline_tag {};
+struct spill_tag {};
+struct move_tag {};
+
+template <typename T, size_t N, typename Tag>
+using counted_small_vector = mystl::small_vector<T, N, mystl::stats_allocator<T, Tag>>;
+
+struct tracked
+{
+    static int live;
+    int value;
+    tracked(int v = 0): value(v) { ++live; }
+    tracked(const tracked& rhs): value(rhs.value) { ++live; }
+    tracked(tracked&& rhs) noexcept: value(rhs.value) { rhs.value = -1; ++live; }
+    tracked& operator=(const tracked&) = default;
+    tracked& operator=(tracked&&) = default;
+    ~tracked() { --live; }
+};
+int tracked::live = 0;
+
+bool operator==(const tracked& lhs, const tracked& rhs) { return lhs.value == rhs.value; }
+bool operator<(const tracked& lhs, const tracked& rhs) { return lhs.value < rhs.value; }
+
+TEST(test1, inline_storage)
+{
+    typedef mystl::alloc_stats<inline_tag> st;
+    {
+        counted_small_vector<std::string, 8, inline_tag> v;
+        EXPECT_TRUE(v.is_inline());
+        EXPECT_EQ(v.capacity(), 8u);
+        for(int i = 0; i < 7; ++i)
+            v.push_back(std::to_string(i));
+        v.insert(v.begin() + 2, "x");
+        v.erase(v.begin());
+        v.emplace(v.end() - 1, "y");
+        EXPECT_TRUE(v.is_inline());
+        EXPECT_EQ(v.size(), 8u);
+        EXPECT_EQ(v[1], "x");
+        EXPECT_EQ(v[6], "y");
+        EXPECT_EQ(v.back(), "6");
+        EXPECT_EQ(st::snapshot().allocations, 0u);
+        EXPECT_GT(sizeof(v), 8 * sizeof(std::string));
+    }
+    EXPECT_EQ(st::snapshot().allocations, 0u);
+}
+
+TEST(test2, spill_and_shrink)
+{
+    typedef mystl::alloc_stats<spill_tag> st;
+    {
+        counted_small_vector<int, 4, spill_tag> v = {1, 2, 3, 4};
+        EXPECT_TRUE(v.is_inline());
+        v.push_back(5);
+        EXPECT_FALSE(v.is_inline());
+        EXPECT_EQ(st::snapshot().allocations, 1u);
+        v.insert(v.begin(), 3, 0);
+        EXPECT_EQ(v.size(), 8u);
+        EXPECT_EQ(v[3], 1);
+        EXPECT_EQ(v[7], 5);
+
+        v.resize(3);
+        v.shrink_to_fit();
+        EXPECT_TRUE(v.is_inline());
+        EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+        EXPECT_EQ(v.size(), 3u);
+
+        // 堆空间在使用时请求少量元素不会拿到已被占用的内联缓冲区
+        v.assign({1, 2, 3, 4, 5, 6});
+        EXPECT_FALSE(v.is_inline());
+        v.assign(2, 7);
+        EXPECT_EQ(v.size(), 2u);
+        EXPECT_EQ(v[1], 7);
+    }
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+}
+
+TEST(test3, copy_move_swap)
+{
+    typedef mystl::alloc_stats<move_tag> st;
+    {
+        typedef counted_small_vector<tracked, 4, move_tag> sv;
+        sv a = {1, 2, 3};
+        sv b(a);
+        EXPECT_TRUE(b.is_inline());
+        EXPECT_TRUE(a == b);
+
+        // 内联: 逐个移动
+        sv c(mystl::move(a));
+        EXPECT_TRUE(a.empty());
+        EXPECT_TRUE(c.is_inline());
+        EXPECT_EQ(c[2].value, 3);
+
+        // 堆上: 接管空间
+        sv d;
+        for(int i = 0; i < 10; ++i) d.emplace_back(i);
+        const tracked* heap = d.data();
+        sv e(mystl::move(d));
+        EXPECT_EQ(e.data(), heap);
+        EXPECT_TRUE(d.is_inline());
+        EXPECT_TRUE(d.empty());
+        d.push_back(tracked(42));
+        EXPECT_EQ(d[0].value, 42);
+
+        c = mystl::move(e);
+        EXPECT_EQ(c.data(), heap);
+        EXPECT_EQ(c.size(), 10u);
+        e = c;
+        EXPECT_TRUE(e == c);
+
+        // 内联与堆交换
+        b.swap(c);
+        EXPECT_EQ(b.data(), heap);
+        EXPECT_TRUE(c.is_inline());
+        EXPECT_EQ(c.size(), 3u);
+        EXPECT_EQ(b.size(), 10u);
+        mystl::swap(b, e);
+        EXPECT_EQ(b.size(), 10u);
+        EXPECT_EQ(e.data(), heap);
+        EXPECT_TRUE(b < c);
+        EXPECT_EQ(tracked::live, 3 + 10 + 10 + 1);
+    }
+    EXPECT_EQ(tracked::live, 0);
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+}
+
+TEST(test4, same_results_as_vector)
+{
+    mystl::small_vector<int, 8> s;
+    mystl::vector<int> v;
+    for(int i = 0; i < 100; ++i)
+    {
+        const size_t pos = static_cast<size_t>(i * 7) % (s.size() + 1);
+        s.insert(s.begin() + pos, i);
+        v.insert(v.begin() + pos, i);
+        if(i % 5 == 4)
+        {
+            s.erase(s.begin() + pos / 2);
+            v.erase(v.begin() + pos / 2);
+        }
+    }
+    ASSERT_EQ(s.size(), v.size());
+    EXPECT_TRUE(std::equal(s.begin(), s.end(), v.begin()));
+    EXPECT_THROW(s.at(s.size()), std::out_of_range);
+}
+
+// 大量生命周期很短、元素很少的容器
+template <typename Vec>
+long long small_churn(int rounds, int n)
+{
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for(int r = 0; r < rounds; ++r)
+    {
+        Vec v;
+        for(int i = 0; i < n; ++i) v.push_back(r + i);
+        sum += v[n / 2];
+    }
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_NE(sum, 0);
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+TEST(test5, benchmark_small_sizes)
+{
+    const int rounds = 2000000;
+    for(int n : {1, 4, 8})
+    {
+        std::cout << n << " elements: small_vector<int, 8>: "
+                  << small_churn<mystl::small_vector<int, 8>>(rounds, n) << " us, vector<int>: "
+                  << small_churn<mystl::vector<int>>(rounds, n) << " us\n";
+    }
+}
@@ -0,0 +1,221 @@
+// --soa_vectortest.cpp 按列存放的 soa_vector 测试与按列筛选求和时与 vector 的性能对比
+#include <gtest/gtest.h>
+#include "soa_vector.h"
+#include "vector.h"
+#include "slab_allocator.h"
+#include "stats_allocator.h"
+#include <chrono>
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+struct throws_on_copy
+{
+    static int live;
+    static int countdown;
+    int value;
+    throws_on_copy(int v = 0): value(v) { ++live; }
+    throws_on_copy(const throws_on_copy& rhs): value(rhs.value)
+    {
+        if(countdown-- == 0) throw std::runtime_error("copy");
+        ++live;
+    }
+    throws_on_copy& operator=(const throws_on_copy&) = default;
+    ~throws_on_copy() { --live; }
+};
+int throws_on_copy::live = 0;
+int throws_on_copy::countdown = -1;
+
+TEST(test1, rows_and_columns)
+{
+    mystl::soa_vector<int, std::string, double> v;
+    EXPECT_TRUE(v.empty());
+    for(int i = 0; i < 100; ++i)
+        v.emplace_back(i, std::to_string(i), i * 0.5);
+    EXPECT_EQ(v.size(), 100u);
+    EXPECT_GE(v.capacity(), 100u);
+
+    // 代理引用: 读、写、结构化绑定
+    auto [id, name, weight] = v[10];
+    EXPECT_EQ(id, 10);
+    EXPECT_EQ(name, "10");
+    EXPECT_EQ(weight, 5.0);
+    name = "ten";
+    EXPECT_EQ(v.data<1>()[10], "ten");
+    v[11] = std::make_tuple(-1, std::string("x"), 0.0);
+    EXPECT_EQ(std::get<0>(v[11]), -1);
+    v[12] = v[0];
+    EXPECT_EQ(std::get<1>(v[12]), "0");
+
+    // 每一列是连续的
+    auto ids = v.column<0>();
+    EXPECT_EQ(ids.size(), 100u);
+    EXPECT_EQ(&ids[1], &ids[0] + 1);
+    long long sum = 0;
+    for(int x : ids) sum += x;
+    EXPECT_EQ(sum, 4950 - 11 - 1 - 12);
+
+    v.push_back(std::make_tuple(100, std::string("100"), 50.0));
+    v.push_back(v[100]);
+    EXPECT_EQ(std::get<1>(v.back()), "100");
+    v.pop_back();
+    v.erase(v.begin() + 5, v.begin() + 10);
+    EXPECT_EQ(v.size(), 96u);
+    EXPECT_EQ(std::get<0>(v[5]), 10);
+    v.erase(v.begin());
+    EXPECT_EQ(std::get<0>(v.front()), 1);
+    EXPECT_THROW(v.at(95), std::out_of_range);
+
+    size_t rows = 0;
+    for(auto row : v)
+    {
+        EXPECT_EQ(std::get<0>(row), std::get<0>(v[rows]));
+        ++rows;
+    }
+    EXPECT_EQ(rows, v.size());
+
+    auto w = v;
+    EXPECT_TRUE(w == v);
+    std::get<2>(w[3]) = 1e9;
+    EXPECT_TRUE(w != v);
+    w.resize(3);
+    EXPECT_EQ(w.size(), 3u);
+    w.resize(5);
+    EXPECT_EQ(std::get<1>(w[4]), "");
+    w.shrink_to_fit();
+    EXPECT_EQ(w.capacity(), 5u);
+    auto m = mystl::move(w);
+    EXPECT_TRUE(w.empty());
+    EXPECT_EQ(m.size(), 5u);
+}
+
+TEST(test2, strong_guarantee)
+{
+    {
+        mystl::soa_vector<std::string, throws_on_copy> v;
+        v.reserve(4);
+        for(int i = 0; i < 4; ++i)
+            v.emplace_back(std::to_string(i), throws_on_copy(i));
+        EXPECT_EQ(throws_on_copy::live, 4);
+
+        // 第二列构造失败时第一列已构造的元素被析构
+        const std::string long_name(100, 'x');
+        throws_on_copy t(9);
+        throws_on_copy::countdown = 0;
+        EXPECT_THROW(v.emplace_back(long_name, t), std::runtime_error);
+        EXPECT_EQ(v.size(), 4u);
+        EXPECT_EQ(throws_on_copy::live, 5);
+
+        // 扩容时复制失败，原有的行保持不变
+        throws_on_copy::countdown = 3;
+        EXPECT_THROW(v.emplace_back(long_name, t), std::runtime_error);
+        EXPECT_EQ(v.size(), 4u);
+        EXPECT_EQ(v.capacity(), 4u);
+        EXPECT_EQ(std::get<0>(v[3]), "3");
+        EXPECT_EQ(std::get<1>(v[3]).value, 3);
+        EXPECT_EQ(throws_on_copy::live, 5);
+
+        throws_on_copy::countdown = -1;
+        v.emplace_back(long_name, t);
+        EXPECT_EQ(v.size(), 5u);
+    }
+    EXPECT_EQ(throws_on_copy::live, 0);
+}
+
+// 按列筛选后求和
+struct order
+{
+    uint64_t id;
+    double   price;
+    int32_t  quantity;
+    int32_t  flags;
+    char     note[40];
+};
+
+TEST(test3, benchmark_filter_sum)
+{
+    const size_t n = 4000000;
+    const int rounds = 10;
+    mystl::vector<order> aos;
+    mystl::soa_vector<uint64_t, double, int32_t, int32_t, std::array<char, 40>> soa;
+    aos.reserve(n);
+    soa.reserve(n);
+    for(size_t i = 0; i < n; ++i)
+    {
+        const double price = static_cast<double>(i % 1000) * 0.25;
+        const int32_t quantity = static_cast<int32_t>((i * 7919) % 100);
+        aos.push_back(order{i, price, quantity, 0, {}});
+        soa.emplace_back(i, price, quantity, 0, std::array<char, 40>{});
+    }
+
+    double aos_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+    {
+        for(const auto& o : aos)
+            if(o.quantity > 50) aos_sum += o.price;
+    }
+    auto aos_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    double soa_sum = 0;
+    start = std::chrono::steady_clock::now();
+    for(int r = 0; r < rounds; ++r)
+    {
+        const double* price = soa.data<1>();
+        const int32_t* quantity = soa.data<2>();
+        const size_t rows = soa.size();
+        for(size_t i = 0; i < rows; ++i)
+            if(quantity[i] > 50) soa_sum += price[i];
+    }
+    auto soa_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    EXPECT_EQ(aos_sum, soa_sum);
+    std::cout << "mystl::vector<order>: " << aos_us << " us\n"
+              << "mystl::soa_vector: " << soa_us << " us\n";
+}
+
+// 每一列使用 rebind 后的分配器
+struct soa_tag {};
+
+TEST(test4, allocator)
+{
+    typedef mystl::basic_soa_vector<mystl::stats_allocator<char, soa_tag>, int, double, std::string> stats_soa;
+    mystl::alloc_stats<soa_tag>::reset();
+    {
+        stats_soa v;
+        for(int i = 0; i < 100; ++i)
+            v.emplace_back(i, i * 0.5, std::to_string(i));
+        EXPECT_EQ(mystl::alloc_stats<soa_tag>::snapshot().live_allocations(), 3u);
+        EXPECT_EQ(mystl::alloc_stats<soa_tag>::snapshot().live_bytes,
+                  v.capacity() * (sizeof(int) + sizeof(double) + sizeof(std::string)));
+        stats_soa copy(v);
+        EXPECT_TRUE(copy == v);
+        EXPECT_EQ(mystl::alloc_stats<soa_tag>::snapshot().live_allocations(), 6u);
+    }
+    EXPECT_EQ(mystl::alloc_stats<soa_tag>::snapshot().live_allocations(), 0u);
+
+    // 分配器不相等且不传播时逐列移动元素，双方保留各自的分配器
+    typedef mystl::basic_soa_vector<mystl::slab_allocator<char>, int, std::string> slab_soa;
+    slab_soa a, b;
+    a.emplace_back(1, "one");
+    a.emplace_back(2, "two");
+    EXPECT_FALSE(a.get_allocator() == b.get_allocator());
+    const int* a_data = a.data<0>();
+    b = mystl::move(a);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(b.size(), 2u);
+    EXPECT_EQ(std::get<1>(b[1]), "two");
+    EXPECT_NE(b.data<0>(), a_data);
+    // 分配器相等时直接接管各列
+    const int* b_data = b.data<0>();
+    slab_soa c(mystl::move(b), b.get_allocator());
+    EXPECT_EQ(c.data<0>(), b_data);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(std::get<0>(c[0]), 1);
+    EXPECT_FALSE(std::is_nothrow_move_assignable<slab_soa>::value);
+    EXPECT_TRUE(std::is_nothrow_move_assignable<mystl::soa_vector<int>>::value);
+}
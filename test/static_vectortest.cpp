@@ -0,0 +1,216 @@
+// --static_vectortest.cpp 定长 static_vector 测试与报文解析负载下与 vector 的性能对比
+#include <gtest/gtest.h>
+#include "static_vector.h"
+#include "vector.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+struct tracked
+{
+    static int live;
+    int value;
+    tracked(int v = 0): value(v) { ++live; }
+    tracked(const tracked& rhs): value(rhs.value) { ++live; }
+    tracked(tracked&& rhs) noexcept: value(rhs.value) { rhs.value = -1; ++live; }
+    tracked& operator=(const tracked&) = default;
+    tracked& operator=(tracked&&) = default;
+    ~tracked() { --live; }
+};
+int tracked::live = 0;
+
+bool operator==(const tracked& lhs, const tracked& rhs) { return lhs.value == rhs.value; }
+bool operator<(const tracked& lhs, const tracked& rhs) { return lhs.value < rhs.value; }
+
+TEST(test1, modifiers)
+{
+    mystl::static_vector<std::string, 8> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 8u);
+    for(int i = 0; i < 5; ++i)
+        v.push_back(std::to_string(i));
+    v.insert(v.begin() + 2, "x");
+    v.erase(v.begin());
+    v.emplace(v.end() - 1, "y");
+    v.insert(v.begin(), 2, "z");
+    EXPECT_EQ(v.size(), 8u);
+    EXPECT_TRUE(v.full());
+    const char* expect[] = {"z", "z", "1", "x", "2", "3", "y", "4"};
+    for(int i = 0; i < 8; ++i)
+        EXPECT_EQ(v[i], expect[i]);
+
+    v.erase(v.begin() + 1, v.begin() + 4);
+    EXPECT_EQ(v.size(), 5u);
+    EXPECT_EQ(v.front(), "z");
+    EXPECT_EQ(v.back(), "4");
+
+    // 区间插入，包括引用自身元素的插入
+    std::string more[] = {"a", "b"};
+    v.insert(v.begin() + 1, more, more + 2);
+    v.insert(v.end(), v[0]);
+    EXPECT_EQ(v.size(), 8u);
+    EXPECT_EQ(v[1], "a");
+    EXPECT_EQ(v[2], "b");
+    EXPECT_EQ(v.back(), "z");
+
+    mystl::static_vector<std::string, 8> w(v);
+    EXPECT_TRUE(w == v);
+    w.resize(3);
+    EXPECT_TRUE(w < v);
+    w.swap(v);
+    EXPECT_EQ(v.size(), 3u);
+    EXPECT_EQ(w.size(), 8u);
+    w.assign({"p", "q"});
+    EXPECT_EQ(w.size(), 2u);
+    EXPECT_EQ(w.at(1), "q");
+    EXPECT_THROW(w.at(2), std::out_of_range);
+    w.resize(4, "r");
+    EXPECT_EQ(w[3], "r");
+    w.reverse();
+    EXPECT_EQ(w[0], "r");
+    EXPECT_EQ(w[3], "p");
+}
+
+TEST(test2, overflow_policy)
+{
+    mystl::static_vector<int, 4> v = {1, 2, 3, 4};
+    EXPECT_THROW(v.push_back(5), std::length_error);
+    EXPECT_THROW(v.insert(v.begin(), 1, 0), std::length_error);
+    EXPECT_THROW(v.resize(5), std::length_error);
+    EXPECT_THROW(v.assign(5, 0), std::length_error);
+    typedef mystl::static_vector<int, 4> static_vector4;
+    EXPECT_THROW(static_vector4({1, 2, 3, 4, 5}), std::length_error);
+    // 溢出时容器保持不变
+    EXPECT_EQ(v.size(), 4u);
+    EXPECT_EQ(v[0], 1);
+    EXPECT_EQ(v.try_push_back(5), nullptr);
+
+    v.pop_back();
+    int* p = v.try_push_back(6);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(*p, 6);
+    EXPECT_EQ(p, &v.back());
+
+    mystl::static_vector<int, 2, mystl::static_vector_checked> c;
+    EXPECT_NE(c.try_emplace_back(1), nullptr);
+    c.push_back(2);
+    EXPECT_EQ(c.try_emplace_back(3), nullptr);
+    EXPECT_DEATH(c.push_back(3), "");
+}
+
+// 平凡类型: 可平凡复制并可用于常量表达式
+struct field
+{
+    unsigned short offset;
+    unsigned short length;
+};
+
+constexpr mystl::static_vector<int, 8> squares()
+{
+    mystl::static_vector<int, 8> v;
+    for(int i = 0; i < 6; ++i)
+        v.push_back(i * i);
+    v.pop_back();
+    v.emplace_back(100);
+    return v;
+}
+
+TEST(test3, trivial_layout)
+{
+    static_assert(std::is_trivially_copyable<mystl::static_vector<field, 16>>::value, "");
+    static_assert(!std::is_trivially_copyable<mystl::static_vector<std::string, 16>>::value, "");
+    static_assert(mystl::is_trivially_relocatable<mystl::static_vector<int, 4>>::value, "");
+    static_assert(squares().size() == 6, "");
+    static_assert(squares()[4] == 16, "");
+    static_assert(squares().back() == 100, "");
+    EXPECT_EQ(sizeof(mystl::static_vector<field, 16>), 16 * sizeof(field) + sizeof(size_t));
+
+    mystl::static_vector<field, 16> f;
+    for(unsigned short i = 0; i < 10; ++i)
+        f.push_back(field{static_cast<unsigned short>(i * 4), 4});
+    mystl::static_vector<field, 16> g;
+    std::memcpy(static_cast<void*>(&g), static_cast<const void*>(&f), sizeof(f));
+    EXPECT_EQ(g.size(), 10u);
+    EXPECT_EQ(g[9].offset, 36);
+
+    // 区间操作走 memmove
+    mystl::static_vector<int, 16> v(4, 7);
+    int a[] = {1, 2, 3};
+    v.insert(v.begin() + 1, a, a + 3);
+    v.erase(v.begin());
+    EXPECT_EQ(v.size(), 6u);
+    EXPECT_EQ(v[0], 1);
+    EXPECT_EQ(v[3], 7);
+    v.resize_default_init(8);
+    EXPECT_EQ(v.size(), 8u);
+}
+
+TEST(test4, element_lifetime)
+{
+    {
+        mystl::static_vector<tracked, 10> v;
+        for(int i = 0; i < 6; ++i)
+            v.emplace_back(i);
+        v.insert(v.begin() + 2, 3, tracked(9));
+        EXPECT_EQ(tracked::live, 9);
+        EXPECT_EQ(v[2].value, 9);
+        EXPECT_EQ(v[5].value, 2);
+
+        mystl::static_vector<tracked, 10> w(mystl::move(v));
+        EXPECT_EQ(w.size(), 9u);
+        EXPECT_EQ(tracked::live, 18);
+        v = w;
+        EXPECT_TRUE(v == w);
+        v.erase(v.begin(), v.begin() + 4);
+        EXPECT_EQ(tracked::live, 14);
+        v = mystl::move(w);
+        EXPECT_EQ(v.size(), 9u);
+        EXPECT_EQ(tracked::live, 18);
+        w.clear();
+        EXPECT_EQ(tracked::live, 9);
+        w.resize(2);
+        mystl::swap(v, w);
+        EXPECT_EQ(v.size(), 2u);
+        EXPECT_EQ(w.size(), 9u);
+        EXPECT_EQ(tracked::live, 11);
+    }
+    EXPECT_EQ(tracked::live, 0);
+
+    // 输入迭代器只能遍历一次
+    std::istringstream in("4 5 6");
+    mystl::static_vector<int, 8> v = {1, 2, 3};
+    auto it = v.insert(v.begin() + 1, std::istream_iterator<int>(in), std::istream_iterator<int>());
+    EXPECT_EQ(it, v.begin() + 1);
+    int expect[] = {1, 4, 5, 6, 2, 3};
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expect));
+}
+
+// 报文解析: 每个报文切分为至多 16 个字段
+template <typename Fields>
+long long parse_packets(int rounds)
+{
+    auto start = std::chrono::steady_clock::now();
+    long long sum = 0;
+    for(int r = 0; r < rounds; ++r)
+    {
+        Fields fields;
+        const int n = 4 + r % 12;
+        for(int i = 0; i < n; ++i)
+            fields.push_back(field{static_cast<unsigned short>(i * 8), static_cast<unsigned short>(r & 7)});
+        for(auto& f : fields)
+            sum += f.offset + f.length;
+    }
+    auto end = std::chrono::steady_clock::now();
+    EXPECT_GT(sum, 0);
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+
+TEST(test5, benchmark_parse)
+{
+    const int rounds = 2000000;
+    std::cout << "mystl::vector: " << parse_packets<mystl::vector<field>>(rounds) << " us\n"
+              << "mystl::static_vector: " << parse_packets<mystl::static_vector<field, 16>>(rounds) << " us\n";
+}
@@ -0,0 +1,159 @@
+// --stats_allocatortest.cpp 统计分配器测试，同时作为各容器分配次数的回归测试
+#include <gtest/gtest.h>
+#include "stats_allocator.h"
+#include "vector.h"
+#include "deque.h"
+#include "list.h"
+#include "map.h"
+#include "set.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 每个测试使用独立的 Tag，计数互不干扰
+struct vector_tag {};
+struct list_tag {};
+struct tree_tag {};
+struct deque_tag {};
+struct thread_tag {};
+
+template <typename T, typename Tag>
+using stats = mystl::stats_allocator<T, Tag>;
+
+TEST(test1, counters_and_json)
+{
+    struct tag {};
+    mystl::stats_allocator<int, tag> a;
+    int* p = a.allocate(10);
+    int* q = a.allocate(1);
+    a.deallocate(q, 1);
+
+    auto s = mystl::alloc_stats<tag>::snapshot();
+    EXPECT_EQ(s.allocations, 2u);
+    EXPECT_EQ(s.deallocations, 1u);
+    EXPECT_EQ(s.bytes_allocated, 11 * sizeof(int));
+    EXPECT_EQ(s.live_bytes, 10 * sizeof(int));
+    EXPECT_EQ(s.peak_bytes, 11 * sizeof(int));
+    EXPECT_EQ(s.live_allocations(), 1u);
+    EXPECT_EQ(s.histogram[mystl::alloc_stats_counters::bucket(40)], 1u);
+    EXPECT_EQ(s.histogram[2], 1u);
+
+    std::string json = mystl::alloc_stats<tag>::to_json();
+    std::cout << json << "\n";
+    EXPECT_NE(json.find("\"allocations\":2"), std::string::npos);
+    EXPECT_NE(json.find("\"peak_bytes\":" + std::to_string(11 * sizeof(int))), std::string::npos);
+    EXPECT_NE(json.find("\"32\":1"), std::string::npos);
+
+    a.deallocate(p, 10);
+    mystl::alloc_stats<tag>::reset();
+    s = mystl::alloc_stats<tag>::snapshot();
+    EXPECT_EQ(s.allocations, 0u);
+    EXPECT_EQ(s.live_bytes, 0u);
+    EXPECT_EQ(s.peak_bytes, 0u);
+}
+
+TEST(test2, vector_allocation_count)
+{
+    typedef mystl::alloc_stats<vector_tag> st;
+    {
+        mystl::vector<int, stats<int, vector_tag>> v;
+        v.reserve(100);
+        const size_t after_reserve = st::snapshot().allocations;
+        for(int i = 0; i < 100; ++i) v.push_back(i);
+        EXPECT_EQ(st::snapshot().allocations, after_reserve);
+        EXPECT_EQ(st::snapshot().live_allocations(), 1u);
+    }
+    EXPECT_EQ(st::snapshot().live_bytes, 0u);
+
+    st::reset();
+    {
+        // 每次容量变化恰好一次分配
+        mystl::vector<std::string, stats<std::string, vector_tag>> v;
+        size_t growth = 0;
+        size_t cap = v.capacity();
+        for(int i = 0; i < 1000; ++i)
+        {
+            v.emplace_back("x");
+            if(v.capacity() != cap)
+            {
+                ++growth;
+                cap = v.capacity();
+            }
+        }
+        EXPECT_EQ(st::snapshot().allocations, growth + 1);     // 默认构造时的初始分配
+        EXPECT_EQ(st::snapshot().live_allocations(), 1u);
+    }
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+}
+
+TEST(test3, list_allocation_count)
+{
+    typedef mystl::alloc_stats<list_tag> st;
+    {
+        mystl::list<int, stats<int, list_tag>> l;
+        EXPECT_EQ(st::snapshot().allocations, 1u);     // 哨兵节点
+        for(int i = 0; i < 100; ++i) l.push_back(i);
+        EXPECT_EQ(st::snapshot().allocations, 101u);
+        l.sort();
+        l.reverse();
+        EXPECT_EQ(st::snapshot().allocations, 101u);
+    }
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+    EXPECT_EQ(st::snapshot().live_bytes, 0u);
+}
+
+TEST(test4, tree_allocation_count)
+{
+    typedef mystl::alloc_stats<tree_tag> st;
+    typedef mystl::pair<const int, int> value_type;
+    {
+        mystl::map<int, int, mystl::less<int>, stats<value_type, tree_tag>> m;
+        EXPECT_EQ(st::snapshot().allocations, 1u);     // header
+        for(int i = 0; i < 100; ++i) m[i] = i;
+        EXPECT_EQ(st::snapshot().allocations, 101u);
+        // 已存在的键不应分配节点
+        for(int i = 0; i < 100; ++i) m[i] = -i;
+        EXPECT_EQ(st::snapshot().allocations, 101u);
+
+        mystl::set<int, mystl::less<int>, stats<int, tree_tag>> s;
+        for(int i = 0; i < 10; ++i) s.insert(i % 5);
+        EXPECT_EQ(s.size(), 5u);
+    }
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+}
+
+TEST(test5, deque_balance)
+{
+    typedef mystl::alloc_stats<deque_tag> st;
+    {
+        mystl::deque<int, stats<int, deque_tag>> d;
+        for(int i = 0; i < 10000; ++i)
+        {
+            d.push_back(i);
+            d.push_front(i);
+        }
+        d.erase(d.begin() + 100, d.begin() + 5000);
+        EXPECT_GT(st::snapshot().peak_bytes, 20000 * sizeof(int));
+    }
+    EXPECT_EQ(st::snapshot().live_allocations(), 0u);
+    EXPECT_EQ(st::snapshot().live_bytes, 0u);
+}
+
+TEST(test6, concurrent_counting)
+{
+    typedef mystl::alloc_stats<thread_tag> st;
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([]() {
+            mystl::list<int, stats<int, thread_tag>> l;
+            for(int i = 0; i < 10000; ++i) l.push_back(i);
+        });
+    }
+    for(auto& th : threads) th.join();
+    auto s = st::snapshot();
+    EXPECT_EQ(s.allocations, 4u * 10001);
+    EXPECT_EQ(s.deallocations, s.allocations);
+    EXPECT_EQ(s.live_bytes, 0u);
+}
@@ -0,0 +1,154 @@
+// --thread_cached_allocatortest.cpp 线程缓存分配器测试与多线程性能对比
+#include <gtest/gtest.h>
+#include "thread_cached_allocator.h"
+#include "pool_allocator.h"
+#include "allocator.h"
+#include "list.h"
+#include "map.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+typedef mystl::list<int, mystl::thread_cached_allocator<int>> tc_list;
+typedef mystl::map<int, int, mystl::less<int>,
+                   mystl::thread_cached_allocator<mystl::pair<const int, int>>> tc_map;
+
+TEST(test1, single_thread)
+{
+    mystl::thread_cached_allocator<long> a;
+    long* p = a.allocate(1);
+    *p = 42;
+    a.deallocate(p, 1);
+    // 本线程 magazine 后进先出
+    EXPECT_EQ(a.allocate(1), p);
+    a.deallocate(p, 1);
+    a.deallocate(nullptr, 1);
+    EXPECT_EQ(a.allocate(0), nullptr);
+
+    char* big = mystl::thread_cached_allocator<char>().allocate(1000);
+    mystl::thread_cached_allocator<char>().deallocate(big, 1000);
+
+    typedef mystl::allocator_traits<mystl::thread_cached_allocator<int>> traits;
+    EXPECT_TRUE(traits::is_always_equal::value);
+    EXPECT_TRUE((std::is_same<traits::rebind_alloc<char>, mystl::thread_cached_allocator<char>>::value));
+}
+
+TEST(test2, containers)
+{
+    tc_list l;
+    tc_map m;
+    for(int i = 0; i < 10000; ++i)
+    {
+        l.push_back(i);
+        m[i] = -i;
+    }
+    for(int i = 0; i < 10000; i += 2)
+    {
+        m.erase(i);
+    }
+    EXPECT_EQ(l.size(), 10000u);
+    EXPECT_EQ(m.size(), 5000u);
+    EXPECT_EQ(m[9999], -9999);
+}
+
+TEST(test3, cross_thread_free)
+{
+    // 生产者线程分配，消费者线程释放；区块经 depot 回到下一轮的生产者，堆不再增长
+    size_t heap = 0;
+    for(int round = 0; round < 6; ++round)
+    {
+        tc_list l;
+        std::thread producer([&l]() {
+            for(int i = 0; i < 20000; ++i) l.push_back(i);
+        });
+        producer.join();
+        EXPECT_EQ(l.size(), 20000u);
+
+        std::thread consumer([&l]() { l.clear(); });
+        consumer.join();
+        EXPECT_TRUE(l.empty());
+
+        if(round == 1)
+        {
+            heap = mystl::thread_cache_depot::instance().heap_size();
+        }
+        else if(round > 1)
+        {
+            EXPECT_EQ(mystl::thread_cache_depot::instance().heap_size(), heap);
+        }
+    }
+}
+
+TEST(test4, concurrent_exchange)
+{
+    const int nthreads = 4;
+    const int n = 20000;
+    std::vector<tc_list> lists(nthreads);
+    std::vector<std::thread> threads;
+    for(int t = 0; t < nthreads; ++t)
+    {
+        threads.emplace_back([&lists, t, n]() {
+            for(int i = 0; i < n; ++i) lists[t].push_back(i);
+        });
+    }
+    for(auto& th : threads) th.join();
+    threads.clear();
+
+    // 每个线程释放另一个线程分配的节点
+    for(int t = 0; t < nthreads; ++t)
+    {
+        threads.emplace_back([&lists, t, nthreads]() {
+            lists[(t + 1) % nthreads].clear();
+        });
+    }
+    for(auto& th : threads) th.join();
+    for(auto& l : lists) EXPECT_TRUE(l.empty());
+}
+
+// N 个线程同时反复构造、销毁节点容器
+template <typename List, typename Map>
+static void mt_churn(const char* name, int nthreads, int n, int rounds)
+{
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for(int t = 0; t < nthreads; ++t)
+    {
+        threads.emplace_back([n, rounds]() {
+            for(int r = 0; r < rounds; ++r)
+            {
+                List l;
+                Map m;
+                for(int i = 0; i < n; ++i)
+                {
+                    l.push_back(i);
+                    m.insert(mystl::make_pair(i * 7 % n, i));
+                }
+                for(int i = 0; i < n; i += 2)
+                {
+                    l.pop_front();
+                    m.erase(i);
+                }
+            }
+        });
+    }
+    for(auto& th : threads) th.join();
+    auto end = std::chrono::steady_clock::now();
+    std::cout << name << " x" << nthreads << ": "
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+              << " us\n";
+}
+
+TEST(test5, benchmark_mt_churn)
+{
+    const int nthreads = static_cast<int>(std::max(2u, std::min(8u, std::thread::hardware_concurrency())));
+    const int n = 20000;
+    const int rounds = 5;
+    typedef mystl::pair<const int, int> value_type;
+    mt_churn<mystl::list<int>, mystl::map<int, int>>("allocator", nthreads, n, rounds);
+    mt_churn<mystl::list<int, mystl::pool_allocator<int>>,
+             mystl::map<int, int, mystl::less<int>, mystl::pool_allocator<value_type>>>(
+        "pool_allocator", nthreads, n, rounds);
+    mt_churn<tc_list, tc_map>("thread_cached_allocator", nthreads, n, rounds);
+}
@@ -2,6 +2,12 @@
 #include "type_traits.h"
 #include <gtest/gtest.h> 
 #include "util.h"
+#include "vector.h"
+#include "list.h"
+#include "deque.h"
+#include "map.h"
+#include "set.h"
+#include <string>
 
 
 TEST(test1, traits)
@@ -21,4 +27,25 @@ TEST(test1, traits)
     cout << mystl::is_pair<pair<int,double>>::value << endl; 
 }
 
+TEST(test2, is_trivially_relocatable)
+{
+    using mystl::is_trivially_relocatable; 
+    struct with_dtor { ~with_dtor() {} }; 
+
+    EXPECT_TRUE(is_trivially_relocatable<int>::value); 
+    EXPECT_TRUE(is_trivially_relocatable<int*>::value); 
+    EXPECT_FALSE(is_trivially_relocatable<with_dtor>::value); 
+    EXPECT_FALSE(is_trivially_relocatable<std::string>::value); 
 
+    EXPECT_TRUE((is_trivially_relocatable<mystl::pair<int, double>>::value)); 
+    EXPECT_TRUE((is_trivially_relocatable<mystl::pair<const int, mystl::vector<int>>>::value)); 
+    EXPECT_FALSE((is_trivially_relocatable<mystl::pair<int, std::string>>::value)); 
+
+    EXPECT_TRUE(is_trivially_relocatable<mystl::vector<std::string>>::value); 
+    EXPECT_TRUE(is_trivially_relocatable<mystl::list<std::string>>::value); 
+    EXPECT_TRUE(is_trivially_relocatable<mystl::deque<int>>::value); 
+    EXPECT_TRUE((is_trivially_relocatable<mystl::map<int, std::string>>::value)); 
+    EXPECT_TRUE((is_trivially_relocatable<mystl::multimap<int, int>>::value)); 
+    EXPECT_TRUE(is_trivially_relocatable<mystl::set<int>>::value); 
+    EXPECT_TRUE(is_trivially_relocatable<mystl::multiset<int>>::value); 
+}
@@ -2,6 +2,10 @@
 #include <gtest/gtest.h>
 #include <string>
 #include "memory.h" 
+#include <chrono> 
+#include <cstdlib> 
+#include <numeric> 
+#include <vector> 
 
 // test code for  cppreference.com  
 # if 1
@@ -19,7 +23,7 @@ TEST(test1, uninitialized_copy)
       std::cout << result.first[i] << " ";
     std::cout << '\n';
    
-    std::return_temporary_buffer(result.first);
+    mystl::release_temporary_buffer(result.first);
   }
 
 
@@ -34,7 +38,7 @@ TEST(test1, uninitialized_copy)
     std::cout << '\n';
 
     // deallocate buffer 
-    std::return_temporary_buffer(result1.first);
+    mystl::release_temporary_buffer(result1.first);
   }
 
 
@@ -254,3 +258,127 @@ TEST(test10, isTagSame)
     cout << nameStr2 << endl; 
 
 }
+
+// 记录存活对象个数，用来检查重定位后源对象不再存活
+struct live_counter
+{
+    static int live; 
+    int value; 
+    live_counter(int v): value(v) { ++live; }
+    live_counter(live_counter&& rhs): value(rhs.value) { rhs.value = -1; ++live; }
+    ~live_counter() { --live; }
+}; 
+int live_counter::live = 0; 
+
+TEST(test11, uninitialized_relocate)
+{
+    // 可平凡重定位: memmove，允许重叠
+    int a[8] = {1, 2, 3, 4, 5, 6, 0, 0}; 
+    int* end = mystl::uninitialized_relocate(a, a + 6, a + 2); 
+    EXPECT_EQ(end, a + 8); 
+    EXPECT_EQ(a[2], 1); 
+    EXPECT_EQ(a[7], 6); 
+    end = mystl::uninitialized_relocate_n(a + 2, 6, a); 
+    EXPECT_EQ(end, a + 6); 
+    EXPECT_EQ(a[0], 1); 
+    EXPECT_EQ(a[5], 6); 
+
+    // 逐个移动 + 析构
+    typedef std::aligned_storage<sizeof(live_counter), alignof(live_counter)>::type storage; 
+    storage src[4], dst[4]; 
+    live_counter* s = reinterpret_cast<live_counter*>(src); 
+    live_counter* d = reinterpret_cast<live_counter*>(dst); 
+    for(int i = 0; i < 4; ++i) new (s + i) live_counter(i); 
+    EXPECT_EQ(live_counter::live, 4); 
+    EXPECT_EQ(mystl::uninitialized_relocate(s, s + 4, d), d + 4); 
+    EXPECT_EQ(live_counter::live, 4); 
+    for(int i = 0; i < 4; ++i) EXPECT_EQ(d[i].value, i); 
+    mystl::destroy(d, d + 4); 
+    EXPECT_EQ(live_counter::live, 0); 
+}
+
+TEST(test12, scratch_arena)
+{
+    mystl::scratch_arena& arena = mystl::scratch_arena::local(); 
+    arena.trim(); 
+    EXPECT_EQ(arena.capacity(), 0u); 
+
+    // 同一块空间被反复使用
+    auto a = mystl::get_temporary_buffer<int>(1000); 
+    ASSERT_EQ(a.second, 1000); 
+    const size_t cap = arena.capacity(); 
+    EXPECT_GE(cap, 1000 * sizeof(int)); 
+    mystl::release_temporary_buffer(a.first); 
+    EXPECT_EQ(arena.in_use(), 0u); 
+    auto b = mystl::get_temporary_buffer<int>(1000); 
+    EXPECT_EQ(b.first, a.first); 
+    EXPECT_EQ(arena.capacity(), cap); 
+
+    // 嵌套申请与乱序释放
+    auto c = mystl::get_temporary_buffer<double>(10); 
+    auto d = mystl::get_temporary_buffer<char>(10); 
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c.first) % alignof(double), 0u); 
+    mystl::release_temporary_buffer(c.first); 
+    EXPECT_GT(arena.in_use(), 0u); 
+    mystl::release_temporary_buffer(b.first); 
+    EXPECT_GT(arena.in_use(), 0u); 
+    mystl::release_temporary_buffer(d.first); 
+    EXPECT_EQ(arena.in_use(), 0u); 
+
+    // 块空闲时几何增长
+    auto e = mystl::get_temporary_buffer<int>(cap); 
+    EXPECT_GE(arena.capacity(), 2 * cap); 
+    mystl::release_temporary_buffer(e.first); 
+
+    // 超过上限的请求不保留
+    arena.set_cap(cap); 
+    EXPECT_EQ(arena.capacity(), 0u); 
+    auto f = mystl::get_temporary_buffer<int>(cap); 
+    EXPECT_EQ(f.second, static_cast<ptrdiff_t>(cap)); 
+    EXPECT_EQ(arena.capacity(), 0u); 
+    mystl::release_temporary_buffer(f.first); 
+    arena.set_cap(SCRATCH_ARENA_DEFAULT_CAP); 
+
+    {
+        std::string s[3] = {"a", "b", "c"}; 
+        mystl::temporary_buffer<std::string*, std::string> buf(s, s + 3); 
+        EXPECT_EQ(buf.size(), 3); 
+        EXPECT_EQ(buf.begin()[2], "a"); 
+        EXPECT_GT(arena.in_use(), 0u); 
+    }
+    EXPECT_EQ(arena.in_use(), 0u); 
+    arena.trim(); 
+    EXPECT_EQ(arena.capacity(), 0u); 
+}
+
+TEST(test13, benchmark_temporary_buffer)
+{
+    const size_t n = 1000000; 
+    const int rounds = 100; 
+    std::vector<int> data(n); 
+    std::iota(data.begin(), data.end(), 0); 
+    long long sum1 = 0, sum2 = 0; 
+
+    auto start = std::chrono::steady_clock::now(); 
+    for(int r = 0; r < rounds; ++r) 
+    {
+        mystl::temporary_buffer<int*, int> buf(data.data(), data.data() + n); 
+        std::copy(data.begin(), data.end(), buf.begin()); 
+        sum1 += buf.begin()[r]; 
+    }
+    auto mid = std::chrono::steady_clock::now(); 
+    for(int r = 0; r < rounds; ++r) 
+    {
+        int* buf = static_cast<int*>(malloc(n * sizeof(int))); 
+        std::copy(data.begin(), data.end(), buf); 
+        sum2 += buf[r]; 
+        free(buf); 
+    }
+    auto end = std::chrono::steady_clock::now(); 
+
+    std::cout << "temporary_buffer (scratch arena): " 
+              << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << " us\n"
+              << "malloc / free: " 
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count() << " us\n"; 
+    EXPECT_EQ(sum1, sum2); 
+}
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h> 
 #include "vector.h"
+#include "stats_allocator.h"
 #include <vector> 
+#include <string> 
+#include <chrono> 
+#include <fcntl.h> 
+#include <unistd.h> 
 
 
 TEST(test1, create_vector)
@@ -562,4 +567,333 @@ TEST(test31, general_swap)
         std::cout << ' ' << *it;
     std::cout << '\n';
 
-}
\ No newline at end of file
+}
+
+// 统计存活对象，检查扩容与插入后旧元素都被析构
+struct tracked
+{
+    static int live; 
+    int value; 
+    tracked(int v = 0): value(v) { ++live; }
+    tracked(const tracked& rhs): value(rhs.value) { ++live; }
+    tracked(tracked&& rhs): value(rhs.value) { ++live; }
+    tracked& operator=(const tracked&) = default; 
+    tracked& operator=(tracked&&) = default; 
+    ~tracked() { --live; }
+}; 
+int tracked::live = 0; 
+
+TEST(test32, relocate_on_growth)
+{
+    {
+        mystl::vector<tracked> v; 
+        for(int i = 0; i < 100; ++i) v.emplace_back(i); 
+        v.insert(v.begin() + 3, 5, tracked(-1)); 
+        v.reserve(1000); 
+        v.shrink_to_fit(); 
+        EXPECT_EQ(tracked::live, 105); 
+        EXPECT_EQ(v[3].value, -1); 
+        EXPECT_EQ(v[8].value, 3); 
+    }
+    EXPECT_EQ(tracked::live, 0); 
+
+    // 可平凡重定位的元素: 扩容与中间插入都整体搬移
+    mystl::vector<mystl::vector<int>> vv; 
+    for(int i = 0; i < 100; ++i) vv.emplace_back(i, i); 
+    vv.emplace(vv.begin(), 3, -1); 
+    vv.insert(vv.begin() + 50, mystl::vector<int>(2, 7)); 
+    vv.insert(vv.begin() + 1, 2, vv[0]); 
+    EXPECT_EQ(vv.size(), 104u); 
+    EXPECT_EQ(vv[0].size(), 3u); 
+    EXPECT_EQ(vv[2][0], -1); 
+    EXPECT_EQ(vv[3].size(), 0u); 
+    EXPECT_EQ(vv[52][0], 7); 
+    EXPECT_EQ(vv[103].size(), 99u); 
+    for(size_t i = 4; i < 52; ++i) EXPECT_EQ(vv[i].size(), i - 3); 
+}
+
+// 与 mystl::vector<int> 相同，但自定义了析构函数，因而只能逐个移动
+struct moved_vector
+{
+    mystl::vector<int> v; 
+    moved_vector(size_t n, int x): v(n, x) {}
+    moved_vector(moved_vector&& rhs) noexcept: v(mystl::move(rhs.v)) {}
+    ~moved_vector() {}
+}; 
+
+// 交替 shrink_to_fit 与 reserve，每次都把全部元素搬到新空间
+template <typename Vec> 
+long long time_relocations(Vec& v, int rounds)
+{
+    auto start = std::chrono::steady_clock::now(); 
+    for(int r = 0; r < rounds; ++r) 
+    {
+        v.reserve(v.size() * 2); 
+        v.shrink_to_fit(); 
+    }
+    auto end = std::chrono::steady_clock::now(); 
+    return std::chrono::duration_cast<std::chrono::microseconds>(end - start).count(); 
+}
+
+TEST(test33, benchmark_growth)
+{
+    const int n = 100000; 
+    const int rounds = 20; 
+    mystl::vector<mystl::vector<int>> a; 
+    mystl::vector<moved_vector> b; 
+    mystl::vector<std::string> c; 
+    for(int i = 0; i < n; ++i) 
+    {
+        a.emplace_back(4, i); 
+        b.emplace_back(4, i); 
+        c.emplace_back(32, 'x'); 
+    }
+    std::cout << "vector<vector<int>> (relocated): " << time_relocations(a, rounds) << " us\n"
+              << "vector<moved_vector> (moved): " << time_relocations(b, rounds) << " us\n"
+              << "vector<std::string> (moved): " << time_relocations(c, rounds) << " us\n"; 
+    EXPECT_EQ(a[n - 1][0], n - 1); 
+    EXPECT_EQ(b[n - 1].v[0], n - 1); 
+    EXPECT_EQ(c[n - 1].size(), 32u); 
+}
+
+// 统计复制与移动次数；Nothrow 决定移动构造是否声明为 noexcept
+template <bool Nothrow> 
+struct copy_counter
+{
+    static int copies; 
+    static int moves; 
+    int value; 
+    copy_counter(int v = 0): value(v) {}
+    copy_counter(const copy_counter& rhs): value(rhs.value) { ++copies; }
+    copy_counter(copy_counter&& rhs) noexcept(Nothrow): value(rhs.value) { ++moves; }
+    copy_counter& operator=(const copy_counter& rhs) { value = rhs.value; ++copies; return *this; }
+    copy_counter& operator=(copy_counter&& rhs) noexcept(Nothrow) { value = rhs.value; ++moves; return *this; }
+    ~copy_counter() {}
+
+    static void reset() { copies = moves = 0; }
+}; 
+template <bool Nothrow> int copy_counter<Nothrow>::copies = 0; 
+template <bool Nothrow> int copy_counter<Nothrow>::moves = 0; 
+
+TEST(test34, move_if_noexcept_growth)
+{
+    typedef copy_counter<true> nothrow_t; 
+    EXPECT_TRUE((std::is_same<decltype(mystl::move_if_noexcept(std::declval<nothrow_t&>())), nothrow_t&&>::value)); 
+    {
+        nothrow_t::reset(); 
+        mystl::vector<nothrow_t> v; 
+        for(int i = 0; i < 1000; ++i) v.emplace_back(i); 
+        v.reserve(5000); 
+        v.insert(v.begin() + 10, nothrow_t(-1)); 
+        v.emplace(v.begin() + 20, -2); 
+        v.shrink_to_fit(); 
+        v.emplace_back(1000); 
+        v.push_back(nothrow_t(1001)); 
+        EXPECT_EQ(nothrow_t::copies, 0); 
+        EXPECT_GT(nothrow_t::moves, 0); 
+        EXPECT_EQ(v[10].value, -1); 
+        EXPECT_EQ(v[20].value, -2); 
+        EXPECT_EQ(v.back().value, 1001); 
+    }
+
+    // 移动构造可能抛出异常时扩容只复制，保证强异常安全
+    typedef copy_counter<false> throwing_t; 
+    EXPECT_TRUE((std::is_same<decltype(mystl::move_if_noexcept(std::declval<throwing_t&>())), const throwing_t&>::value)); 
+    {
+        throwing_t::reset(); 
+        mystl::vector<throwing_t> v; 
+        const int cap = static_cast<int>(v.capacity()); 
+        for(int i = 0; i < cap; ++i) v.emplace_back(i); 
+        EXPECT_EQ(throwing_t::copies, 0); 
+        v.emplace_back(cap); 
+        EXPECT_EQ(throwing_t::copies, cap); 
+        EXPECT_EQ(throwing_t::moves, 0); 
+    }
+}
+
+// 每次扩容都把容量设为恰好容纳新元素
+struct growth_exact
+{
+    template <typename SizeType> 
+    SizeType operator()(SizeType old_cap, SizeType add_size, SizeType) const noexcept
+    {
+        return old_cap + add_size; 
+    }
+}; 
+
+template <typename Vec> 
+mystl::vector<size_t> capacities(Vec& v, int n) 
+{
+    mystl::vector<size_t> caps(1, v.capacity()); 
+    for(int i = 0; i < n; ++i) 
+    {
+        v.push_back(i); 
+        if(v.capacity() != caps.back()) caps.push_back(v.capacity()); 
+    }
+    return caps; 
+}
+
+TEST(test35, growth_policy)
+{
+    mystl::vector<int> a; 
+    mystl::vector<int, mystl::allocator<int>, mystl::growth_1_5x> b; 
+    EXPECT_TRUE(capacities(a, 1000) == capacities(b, 1000)); 
+
+    mystl::vector<int, mystl::allocator<int>, mystl::growth_2x> c; 
+    auto caps = capacities(c, 1000); 
+    EXPECT_EQ(caps[0], 16u); 
+    for(size_t i = 1; i < caps.size(); ++i) EXPECT_EQ(caps[i], caps[i - 1] * 2); 
+
+    mystl::vector<int, mystl::allocator<int>, growth_exact> d(3, 1); 
+    EXPECT_EQ(d.capacity(), 3u); 
+    d.push_back(2); 
+    EXPECT_EQ(d.capacity(), 4u); 
+    d.insert(d.begin(), 5, 0); 
+    EXPECT_EQ(d.capacity(), 9u); 
+    EXPECT_EQ(d[5], 1); 
+    EXPECT_EQ(d[8], 2); 
+}
+
+struct exact_tag {}; 
+struct usable_tag {}; 
+
+TEST(test36, usable_size_growth)
+{
+    // 与同一扩容策略相比，容量只会因分配器给出的额外空间而更大
+    mystl::vector<int, mystl::allocator<int>, growth_exact> a; 
+    mystl::vector<int, mystl::allocator<int>, mystl::usable_size_growth<growth_exact>> b; 
+    size_t extra = 0; 
+    for(int i = 0; i < 100; ++i) 
+    {
+        a.push_back(i); 
+        b.push_back(i); 
+        EXPECT_GE(b.capacity(), a.capacity()); 
+        extra += b.capacity() - a.capacity(); 
+        EXPECT_EQ(a[i], b[i]); 
+    }
+    // glibc malloc 按 16 字节对齐的 size class 分配，多出的空间记入容量 (sanitizer 下为 0)
+    std::cout << "extra capacity from malloc_usable_size: " << extra << " elements\n"; 
+    b.shrink_to_fit(); 
+    EXPECT_EQ(b.capacity(), b.size()); 
+
+    // stats_allocator 按实际得到的个数计数
+    struct at_least_tag {}; 
+    typedef mystl::stats_allocator<int, at_least_tag> stats_alloc; 
+    stats_alloc alloc; 
+    auto r = mystl::allocator_traits<stats_alloc>::allocate_at_least(alloc, 10); 
+    EXPECT_GE(r.count, 10u); 
+    EXPECT_EQ(mystl::alloc_stats<at_least_tag>::snapshot().bytes_allocated, r.count * sizeof(int)); 
+    alloc.deallocate(r.ptr, r.count); 
+    EXPECT_EQ(mystl::alloc_stats<at_least_tag>::snapshot().live_bytes, 0u); 
+}
+
+// 大量 push_back，比较重新分配次数与分配的总字节数
+template <typename Tag, typename Growth> 
+void push_back_heavy(const char* name, int vectors, int n) 
+{
+    typedef mystl::alloc_stats<Tag> st; 
+    st::reset(); 
+    size_t slack = 0; 
+    auto start = std::chrono::steady_clock::now(); 
+    for(int k = 0; k < vectors; ++k) 
+    {
+        mystl::vector<int, mystl::stats_allocator<int, Tag>, Growth> v; 
+        const int len = 1 + (k * 7919) % n; 
+        for(int i = 0; i < len; ++i) v.push_back(i); 
+        slack += v.capacity() - v.size(); 
+    }
+    auto end = std::chrono::steady_clock::now(); 
+    auto s = st::snapshot(); 
+    std::cout << name << ": " << s.allocations << " allocations, " 
+              << s.bytes_allocated << " bytes allocated, " 
+              << slack * sizeof(int) << " bytes of spare capacity, " 
+              << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n"; 
+    EXPECT_EQ(s.live_bytes, 0u); 
+}
+
+TEST(test37, benchmark_usable_size)
+{
+    push_back_heavy<exact_tag, mystl::growth_1_5x>("growth_1_5x", 20000, 4000); 
+    push_back_heavy<usable_tag, mystl::usable_size_growth<>>("usable_size_growth", 20000, 4000); 
+    EXPECT_LE(mystl::alloc_stats<usable_tag>::snapshot().allocations, 
+              mystl::alloc_stats<exact_tag>::snapshot().allocations); 
+}
+
+TEST(test38, uninitialized_resize)
+{
+    mystl::vector<int> v(4, 1); 
+    auto range = v.append_uninitialized(100); 
+    EXPECT_EQ(range.first, v.data() + 4); 
+    EXPECT_EQ(range.second, v.data() + 104); 
+    for(auto p = range.first; p != range.second; ++p) *p = 2; 
+    EXPECT_EQ(v.size(), 104u); 
+    EXPECT_EQ(v[3], 1); 
+    EXPECT_EQ(v[103], 2); 
+
+    v.resize_default_init(10); 
+    EXPECT_EQ(v.size(), 10u); 
+    v.resize_default_init(1000); 
+    EXPECT_EQ(v.size(), 1000u); 
+    EXPECT_EQ(v[9], 2); 
+
+    // op 只写入前一部分
+    v.resize_and_overwrite(2000, [](int* p, size_t n) {
+        EXPECT_EQ(p[0], 1); 
+        for(size_t i = 0; i < n / 2; ++i) p[i] = static_cast<int>(i); 
+        return n / 2; 
+    }); 
+    EXPECT_EQ(v.size(), 1000u); 
+    EXPECT_EQ(v[999], 999); 
+
+    // 非平凡类型仍然默认构造
+    mystl::vector<std::string> s(1, "a"); 
+    auto sr = s.append_uninitialized(20); 
+    EXPECT_EQ(sr.second - sr.first, 20); 
+    EXPECT_TRUE(s[20].empty()); 
+    s.resize_and_overwrite(3, [](std::string* p, size_t) {
+        p[1] = "b"; 
+        return 2; 
+    }); 
+    EXPECT_EQ(s.size(), 2u); 
+    EXPECT_EQ(s[0], "a"); 
+    EXPECT_EQ(s[1], "b"); 
+}
+
+// 从 fd 读取 n 字节到 p
+static size_t read_fully(int fd, char* p, size_t n) 
+{
+    size_t done = 0; 
+    while(done < n) 
+    {
+        const ssize_t r = ::read(fd, p + done, std::min(n - done, static_cast<size_t>(1) << 30)); 
+        if(r <= 0) break; 
+        done += static_cast<size_t>(r); 
+    }
+    return done; 
+}
+
+TEST(test39, benchmark_fill_from_read)
+{
+    const size_t bytes = static_cast<size_t>(1) << 30; 
+    const int fd = ::open("/dev/zero", O_RDONLY); 
+    ASSERT_GE(fd, 0); 
+
+    auto start = std::chrono::steady_clock::now(); 
+    {
+        mystl::vector<char> v(bytes); 
+        EXPECT_EQ(read_fully(fd, v.data(), bytes), bytes); 
+    }
+    auto mid = std::chrono::steady_clock::now(); 
+    {
+        mystl::vector<char> v; 
+        v.resize_and_overwrite(bytes, [fd](char* p, size_t n) { return read_fully(fd, p, n); }); 
+        EXPECT_EQ(v.size(), bytes); 
+    }
+    auto end = std::chrono::steady_clock::now(); 
+    ::close(fd); 
+
+    std::cout << "vector(n) + read: " 
+              << std::chrono::duration_cast<std::chrono::milliseconds>(mid - start).count() << " ms\n" 
+              << "resize_and_overwrite + read: " 
+              << std::chrono::duration_cast<std::chrono::milliseconds>(end - mid).count() << " ms\n"; 
+}
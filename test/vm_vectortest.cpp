@@ -0,0 +1,158 @@
+// --vm_vectortest.cpp vm_vector 测试与追加大量元素时与 vector 的吞吐量、常驻内存对比
+#include <gtest/gtest.h>
+#include "vm_vector.h"
+#include "vector.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+
+// 当前进程的常驻内存 (字节)，无法读取时返回 0
+static size_t resident_bytes()
+{
+    size_t pages = 0, resident = 0;
+#if defined(__linux__)
+    if(FILE* f = std::fopen("/proc/self/statm", "r"))
+    {
+        if(std::fscanf(f, "%zu %zu", &pages, &resident) != 2) resident = 0;
+        std::fclose(f);
+    }
+#endif
+    return resident * mystl::mremap_base::page_size();
+}
+
+TEST(test1, stable_growth)
+{
+    mystl::vm_vector<uint64_t> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 0u);
+    EXPECT_EQ(v.data(), nullptr);
+
+    v.push_back(0);
+    const uint64_t* first = v.data();
+    EXPECT_EQ(v.capacity(), VM_VECTOR_COMMIT / sizeof(uint64_t));
+    for(uint64_t i = 1; i < 1000000; ++i)
+        v.push_back(i);
+    // 扩容只提交新的页面，起始地址不变
+    EXPECT_EQ(first, v.data());
+    EXPECT_GE(v.capacity(), 1000000u);
+    EXPECT_EQ(v[999999], 999999u);
+    EXPECT_THROW(v.at(1000000), std::out_of_range);
+
+    v.resize(10);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), mystl::mremap_base::page_size() / sizeof(uint64_t));
+    EXPECT_EQ(v.back(), 9u);
+    v.resize(100000, 7);
+    EXPECT_EQ(first, v.data());
+    EXPECT_EQ(v[99999], 7u);
+
+    // 超过上限时抛出 length_error，容器不变
+    mystl::vm_vector<int> small(mystl::vm_limit(1000));
+    EXPECT_EQ(small.max_size(), 1000u);
+    small.resize(1000);
+    EXPECT_THROW(small.push_back(1), std::length_error);
+    EXPECT_THROW(small.reserve(1001), std::length_error);
+    EXPECT_EQ(small.size(), 1000u);
+    EXPECT_EQ(small.capacity(), 1000u);
+}
+
+TEST(test2, vector_interface)
+{
+    mystl::vm_vector<std::string> v{"a", "b", "c"};
+    v.insert(v.begin() + 1, "x");
+    v.insert(v.end(), 2, "y");
+    v.emplace(v.begin(), 3, 'z');
+    std::list<std::string> l{"l1", "l2"};
+    v.insert(v.begin() + 2, l.begin(), l.end());
+    EXPECT_EQ(v.size(), 9u);
+    EXPECT_EQ(v.front(), "zzz");
+    EXPECT_EQ(v[2], "l1");
+    EXPECT_EQ(v[4], "x");
+    v.emplace(v.begin(), v[4]);
+    EXPECT_EQ(v.front(), "x");
+    v.erase(v.begin(), v.begin() + 3);
+    v.erase(v.end() - 1);
+    EXPECT_EQ(v.size(), 6u);
+    EXPECT_EQ(v[0], "l1");
+    EXPECT_EQ(*v.rbegin(), "y");
+
+    auto w = v;
+    EXPECT_TRUE(w == v);
+    w.assign(3, "q");
+    EXPECT_TRUE(w != v);
+    EXPECT_TRUE(w > v);
+    w.assign({"1", "2"});
+    EXPECT_EQ(w.size(), 2u);
+    const std::string* p = w.data();
+    auto m = mystl::move(w);
+    EXPECT_TRUE(w.empty());
+    EXPECT_EQ(m.data(), p);
+    m.swap(v);
+    EXPECT_EQ(v.size(), 2u);
+    v = m;
+    EXPECT_EQ(v, m);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    v.resize_default_init(5);
+    EXPECT_EQ(v[4], "");
+}
+
+#if defined(__linux__)
+TEST(test3, shrink_returns_memory)
+{
+    const size_t n = size_t(1) << 22;
+    mystl::vm_vector<uint64_t> v;
+    v.reserve(n);
+    const size_t before = resident_bytes();
+    for(size_t i = 0; i < n; ++i)
+        v.push_back(i);
+    const size_t filled = resident_bytes();
+    v.resize(1);
+    v.shrink_to_fit();
+    const size_t shrunk = resident_bytes();
+    // 提交本身不占物理内存，写入后才占用，shrink_to_fit 后归还
+    EXPECT_GE(filled - before, n * sizeof(uint64_t) / 2);
+    EXPECT_GE(filled - shrunk, n * sizeof(uint64_t) / 2);
+    v.push_back(1);
+    EXPECT_EQ(v.size(), 2u);
+}
+#endif
+
+// 追加 n 个元素的用时，以及追加后常驻内存的增量
+template <typename Container, typename Prepare>
+void bench_append(const char* name, size_t n, Prepare prepare)
+{
+    const int rounds = 5;
+    long long total_us = 0;
+    size_t rss = 0;
+    for(int r = 0; r < rounds; ++r)
+    {
+        const size_t before = resident_bytes();
+        auto start = std::chrono::steady_clock::now();
+        Container c;
+        prepare(c);
+        for(size_t i = 0; i < n; ++i)
+            c.push_back(i);
+        total_us += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        rss = resident_bytes() - before;
+        EXPECT_EQ(c.size(), n);
+    }
+    std::cout << name << ": " << total_us / rounds << " us, rss +" << (rss >> 20) << " MiB\n";
+}
+
+TEST(test4, benchmark_append)
+{
+    const size_t n = size_t(1) << 24;
+    bench_append<mystl::vector<uint64_t>>("mystl::vector", n, [](mystl::vector<uint64_t>&) {});
+    bench_append<mystl::vector<uint64_t>>("mystl::vector + reserve(n)", n,
+        [n](mystl::vector<uint64_t>& v) { v.reserve(n); });
+    // 最终大小未知时只能按上限预留
+    bench_append<mystl::vector<uint64_t>>("mystl::vector + reserve(4n)", n,
+        [n](mystl::vector<uint64_t>& v) { v.reserve(4 * n); });
+    bench_append<mystl::vm_vector<uint64_t>>("mystl::vm_vector", n, [](mystl::vm_vector<uint64_t>&) {});
+}